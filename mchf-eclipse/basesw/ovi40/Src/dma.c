@@ -72,7 +72,8 @@ void MX_DMA_Init(void)
 
   /* DMA interrupt init */
   /* DMA1_Stream4_IRQn interrupt configuration */
-  HAL_NVIC_SetPriority(DMA1_Stream4_IRQn, 0, 0);
+  /* SPI2 TX (display), runs the display command queue, must not delay the audio DMA, same as on the mcHF */
+  HAL_NVIC_SetPriority(DMA1_Stream4_IRQn, 14, 0);
   HAL_NVIC_EnableIRQ(DMA1_Stream4_IRQn);
   /* DMA2_Stream0_IRQn interrupt configuration */
   HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, 0, 0);
@@ -0,0 +1,1250 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     bench_dsp.c                                                     **
+ **  Description:   speed and regression tests of the audio DSP kernels             **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+/*
+ * Runs each of the hot DSP kernels on a synthetic, deterministic input signal,
+ * reports the time per input sample and compares the output with the reference
+ * in bench/reference, similar to what misc/test_fdmdv.c does for the FreeDV modem.
+ *
+ * Signal kernels store their output as raw little endian float32 (<name>.f32) and
+ * must reach a minimum SNR against it, decoders store the decoded text (<name>.txt)
+ * which must match exactly.
+ *
+ * Build and run with "make host-bench". After an intended change of the results,
+ * regenerate the references with "hostbench-<trx> -u" and commit them together with the change.
+ *
+ * The kernels are called directly, audio_driver.c is included here to reach its static functions.
+ * The references are produced by the host build, the timing is only meaningful relative
+ * to another run on the same machine.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <math.h>
+
+#include "audio_driver.c"
+
+#include "audio_nr.h"
+#include "rtty.h"
+#include "psk.h"
+#include "psk_skimmer.h"
+#include "cw_decoder.h"
+#include "cw_bank.h"
+#include "host_dsp.h"
+
+#define BENCH_OUT_MAX       8192    // output samples of a signal kernel
+#define BENCH_TEXT_MAX      1024    // output characters of a decoder
+#define BENCH_LOOPS_DEFAULT 10
+#define BENCH_REF_DIR       "bench/reference"
+
+#define BENCH_DECIM_RATE    4       // 48ksps -> 12ksps, the rate of everything after the decimation
+#define BENCH_AUDIO_BLOCK   (IQ_BLOCK_SIZE / BENCH_DECIM_RATE)
+
+typedef struct
+{
+    float32_t out[BENCH_OUT_MAX];
+    uint32_t out_len;
+    char text[BENCH_TEXT_MAX];
+    uint32_t text_len;
+    uint32_t samples;       // input samples processed
+    uint64_t ns;            // time spent in the kernel
+} BenchRun;
+
+typedef struct
+{
+    const char* name;
+    void (*run)(BenchRun* r, const void* param);
+    float32_t min_snr;      // 0 means the kernel is a decoder and produces text
+    const void* param;      // passed to run, for kernels which are registered with several settings
+} BenchKernel;
+
+static BenchRun bench_run;
+
+static uint64_t Bench_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+// measures the statement and accounts the time to the run
+#define BENCH_TIMED(r, stmt) \
+    do { const uint64_t bench_start = Bench_Now(); stmt; (r)->ns += Bench_Now() - bench_start; } while(0)
+
+static uint32_t bench_seed;
+
+/**
+ * @returns deterministic white noise in -1.0 ... 1.0, independent of the C library
+ */
+static float32_t Bench_Noise(void)
+{
+    bench_seed = bench_seed * 1664525 + 1013904223;
+    return (float32_t)(int32_t)bench_seed / 2147483648.0;
+}
+
+static void Bench_Output(BenchRun* r, float32_t value)
+{
+    if (r->out_len < BENCH_OUT_MAX)
+    {
+        r->out[r->out_len++] = value;
+    }
+}
+
+static void Bench_TextOut(char ch)
+{
+    if (bench_run.text_len < BENCH_TEXT_MAX - 1)
+    {
+        bench_run.text[bench_run.text_len++] = ch;
+        bench_run.text[bench_run.text_len] = '\0';
+    }
+}
+
+/**
+ * @brief every kernel starts from the state of a freshly booted radio in the given mode
+ */
+static void Bench_InitRadio(uint8_t dmod_mode, uint8_t digital_mode, uint16_t width)
+{
+    bench_seed = 1;
+    HostDsp_TransceiverStateInit();
+    HostDsp_RadioInit();
+    HostDsp_SetDemodMode(dmod_mode, digital_mode, -1, width);
+    AudioDriver_SetRxAudioProcessing(ts.dmod_mode, true);
+}
+
+// I/Q of a carrier 7 kHz above the center, moved by the +6 kHz conversion
+static void Bench_FreqConversion(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_USB, DigitalMode_None, 2700);
+    ts.iq_freq_mode = FREQ_IQ_CONV_P6KHZ;
+
+    float32_t phase = 0;
+    while (r->samples < BENCH_OUT_MAX / 2)
+    {
+        for (int i = 0; i < IQ_BLOCK_SIZE; i++)
+        {
+            adb.i_buffer[i] = 4000.0 * cosf(phase) + 100.0 * Bench_Noise();
+            adb.q_buffer[i] = 4000.0 * sinf(phase) + 100.0 * Bench_Noise();
+            phase = fmodf(phase + 2 * PI * 7000.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+        }
+
+        BENCH_TIMED(r, AudioDriver_FreqConversion(adb.i_buffer, adb.q_buffer, IQ_BLOCK_SIZE, 1));
+        r->samples += IQ_BLOCK_SIZE;
+
+        for (int i = 0; i < IQ_BLOCK_SIZE; i++)
+        {
+            Bench_Output(r, adb.i_buffer[i]);
+            Bench_Output(r, adb.q_buffer[i]);
+        }
+    }
+}
+
+// AM carrier 300 Hz off center, 400 Hz modulation with 50%, the PLL has to lock first
+static void Bench_DemodSAM(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_SAM, DigitalMode_None, 5000);
+
+    float32_t phase = 0, mod_phase = 0;
+    while (r->out_len < 2048)
+    {
+        for (int i = 0; i < IQ_BLOCK_SIZE; i++)
+        {
+            const float32_t amplitude = 2000.0 * (1.0 + 0.5 * sinf(mod_phase));
+            adb.i_buffer[i] = amplitude * cosf(phase) + 50.0 * Bench_Noise();
+            adb.q_buffer[i] = amplitude * sinf(phase) + 50.0 * Bench_Noise();
+            phase = fmodf(phase + 2 * PI * 300.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+            mod_phase = fmodf(mod_phase + 2 * PI * 400.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+        }
+
+        BENCH_TIMED(r, AudioDriver_DemodSAM(IQ_BLOCK_SIZE));
+        r->samples += IQ_BLOCK_SIZE;
+
+        for (int i = 0; i < IQ_BLOCK_SIZE / ads.decimation_rate; i++)
+        {
+            Bench_Output(r, adb.a_buffer[0][i]);
+        }
+    }
+}
+
+// I/Q with a tone inside and one far outside the SSB passband, decimated to 12ksps and interpolated back to 48ksps
+static void Bench_ResampleIQ(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_USB, DigitalMode_None, 2700);
+
+    // the interpolation of the stereo audio path, which the mcHF does not have
+    static float32_t interp_coeffs[FIR_RXAUDIO_NUM_TAPS];
+    static float32_t interp_state[2 * (BENCH_AUDIO_BLOCK + FIR_RXAUDIO_NUM_TAPS)];
+    PolyphaseInterpolateIQ interpolate;
+    AudioPolyphase_InterpolateIQInit(&interpolate, ads.decimation_rate, FirRxInterpolate.phaseLength, FirRxInterpolate.pCoeffs,
+            interp_coeffs, interp_state, BENCH_AUDIO_BLOCK);
+    float32_t out_i[IQ_BLOCK_SIZE], out_q[IQ_BLOCK_SIZE];
+
+    float32_t phase = 0, phase_out = 0;
+    while (r->samples < 4096)
+    {
+        for (int i = 0; i < IQ_BLOCK_SIZE; i++)
+        {
+            adb.i_buffer[i] = 3000.0 * cosf(phase) + 1000.0 * cosf(phase_out) + 50.0 * Bench_Noise();
+            adb.q_buffer[i] = 3000.0 * sinf(phase) + 1000.0 * sinf(phase_out) + 50.0 * Bench_Noise();
+            phase = fmodf(phase + 2 * PI * 1000.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+            phase_out = fmodf(phase_out + 2 * PI * 11000.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+        }
+
+        BENCH_TIMED(r,
+                AudioDriver_RxDecimateIQ(adb.i_buffer, adb.q_buffer, IQ_BLOCK_SIZE);
+                AudioPolyphase_InterpolateIQ(&interpolate, adb.i_buffer, adb.q_buffer, out_i, out_q, BENCH_AUDIO_BLOCK));
+        r->samples += IQ_BLOCK_SIZE;
+
+        for (int i = 0; i < IQ_BLOCK_SIZE; i++)
+        {
+            Bench_Output(r, out_i[i]);
+            Bench_Output(r, out_q[i]);
+        }
+    }
+}
+
+// USB on one of the wide SSB paths: wanted tone in the upper, unwanted tone in the lower sideband
+static void Bench_HilbertDecimate(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_USB, DigitalMode_None, 3800);
+
+    float32_t phase = 0, phase_image = 0;
+    while (r->samples < 4096)
+    {
+        for (int i = 0; i < IQ_BLOCK_SIZE; i++)
+        {
+            adb.i_buffer[i] = 3000.0 * cosf(phase) + 3000.0 * cosf(phase_image) + 50.0 * Bench_Noise();
+            adb.q_buffer[i] = 3000.0 * sinf(phase) - 3000.0 * sinf(phase_image) + 50.0 * Bench_Noise();
+            phase = fmodf(phase + 2 * PI * 1000.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+            phase_image = fmodf(phase_image + 2 * PI * 1500.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+        }
+
+        // the reference was recorded with Hilbert filter, demodulation and decimation as separate steps
+        BENCH_TIMED(r,
+                AudioPolyphase_DecimateHilbert(&DECIMATE_RX_HILBERT, adb.i_buffer, adb.q_buffer, adb.i_buffer, adb.q_buffer, IQ_BLOCK_SIZE);
+                arm_add_f32(adb.i_buffer, adb.q_buffer, adb.a_buffer[0], BENCH_AUDIO_BLOCK));
+        r->samples += IQ_BLOCK_SIZE;
+
+        for (int i = 0; i < BENCH_AUDIO_BLOCK; i++)
+        {
+            Bench_Output(r, adb.a_buffer[0][i]);
+        }
+    }
+}
+
+// 128x zoom FFT decimation: two tones inside the 375 Hz wide zoom band, a strong one far outside
+static void Bench_ZoomDecimate(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_USB, DigitalMode_None, 2700);
+    sd.magnify = MAGNIFY_MAX;
+    AudioDriver_SetRxAudioProcessing(ts.dmod_mode, false);
+
+    float32_t out_i[IQ_BLOCK_SIZE], out_q[IQ_BLOCK_SIZE];
+    float32_t phase_a = 0, phase_b = 0, phase_out = 0;
+    while (r->samples < 65536)
+    {
+        for (int i = 0; i < IQ_BLOCK_SIZE; i++)
+        {
+            adb.i_buffer[i] = 1000.0 * cosf(phase_a) + 300.0 * cosf(phase_b) + 10000.0 * cosf(phase_out) + 5.0 * Bench_Noise();
+            adb.q_buffer[i] = 1000.0 * sinf(phase_a) + 300.0 * sinf(phase_b) + 10000.0 * sinf(phase_out) + 5.0 * Bench_Noise();
+            phase_a = fmodf(phase_a + 2 * PI * 40.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+            phase_b = fmodf(phase_b - 2 * PI * 100.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+            phase_out = fmodf(phase_out + 2 * PI * 5000.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+        }
+
+        uint32_t out_len;
+        BENCH_TIMED(r, out_len = AudioPolyphase_HalfbandCascade(&DECIMATE_ZOOM_FFT, adb.i_buffer, adb.q_buffer, out_i, out_q, IQ_BLOCK_SIZE));
+        r->samples += IQ_BLOCK_SIZE;
+
+        for (uint32_t i = 0; i < out_len; i++)
+        {
+            Bench_Output(r, out_i[i]);
+            Bench_Output(r, out_q[i]);
+        }
+    }
+}
+
+// AM broadcast station 900 Hz off the center: speech like modulation, two path fading and a second carrier
+// 4 kHz away, modelled on a 49m broadcast in the evening. The output is the carrier frequency the PLL tracks.
+static void Bench_SamLock(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_SAM, DigitalMode_None, 5000);
+    ads.sam_sideband = SAM_SIDEBAND_USB;
+
+    float32_t phase = 0, phase_qrm = 0, mod_phase[3] = { 0, 0, 0 }, fade_phase = 0;
+    const float32_t mod_freq[3] = { 310.0, 770.0, 1870.0 };
+    float32_t echo_i[IQ_BLOCK_SIZE], echo_q[IQ_BLOCK_SIZE];
+
+    while (r->samples < 48000)
+    {
+        for (int i = 0; i < IQ_BLOCK_SIZE; i++)
+        {
+            // syllable rate envelope on the modulation
+            const float32_t syllable = 0.5 + 0.5 * sinf(mod_phase[0] * 0.013);
+            float32_t mod = 0;
+            for (int m = 0; m < 3; m++)
+            {
+                mod += sinf(mod_phase[m]) / 3.0;
+                mod_phase[m] = fmodf(mod_phase[m] + 2 * PI * mod_freq[m] / IQ_SAMPLE_RATE_F, 2 * PI * 1000);
+            }
+            const float32_t amplitude = 2000.0 * (1.0 + 0.8 * syllable * mod);
+            // the sky wave echo comes with a slowly rotating phase, so the carrier fades in and out
+            const float32_t echo = 0.7 * cosf(fade_phase);
+            adb.i_buffer[i] = amplitude * cosf(phase);
+            adb.q_buffer[i] = amplitude * sinf(phase);
+            echo_i[i] = echo * adb.i_buffer[i] - 0.7 * sinf(fade_phase) * adb.q_buffer[i];
+            echo_q[i] = echo * adb.q_buffer[i] + 0.7 * sinf(fade_phase) * adb.i_buffer[i];
+            adb.i_buffer[i] += echo_i[i] + 300.0 * cosf(phase_qrm) + 40.0 * Bench_Noise();
+            adb.q_buffer[i] += echo_q[i] + 300.0 * sinf(phase_qrm) + 40.0 * Bench_Noise();
+
+            phase = fmodf(phase + 2 * PI * 900.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+            phase_qrm = fmodf(phase_qrm + 2 * PI * 4900.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+            fade_phase = fmodf(fade_phase + 2 * PI * 0.7 / IQ_SAMPLE_RATE_F, 2 * PI);
+        }
+
+        BENCH_TIMED(r, AudioDriver_DemodSAM(IQ_BLOCK_SIZE));
+        r->samples += IQ_BLOCK_SIZE;
+
+        Bench_Output(r, sam_pll.omega2 * IQ_SAMPLE_RATE_F / (ads.decimation_rate * 2 * PI));
+    }
+}
+
+// 1 kHz tone with 2.5 kHz deviation
+static void Bench_DemodFM(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_FM, DigitalMode_None, 0);
+    ts.iq_freq_mode = FREQ_IQ_CONV_P6KHZ;
+
+    float32_t phase = 0, mod_phase = 0;
+    while (r->samples < 4096)
+    {
+        for (int i = 0; i < IQ_BLOCK_SIZE; i++)
+        {
+            adb.i_buffer[i] = 3000.0 * cosf(phase) + 100.0 * Bench_Noise();
+            adb.q_buffer[i] = 3000.0 * sinf(phase) + 100.0 * Bench_Noise();
+            phase = fmodf(phase + 2 * PI * 2500.0 * sinf(mod_phase) / IQ_SAMPLE_RATE_F, 2 * PI);
+            mod_phase = fmodf(mod_phase + 2 * PI * 1000.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+        }
+
+        BENCH_TIMED(r, AudioDriver_DemodFM(IQ_BLOCK_SIZE));
+        r->samples += IQ_BLOCK_SIZE;
+
+        for (int i = 0; i < IQ_BLOCK_SIZE; i++)
+        {
+            Bench_Output(r, adb.a_buffer[0][i]);
+        }
+    }
+}
+
+// half a second of band noise, then a carrier with 1 kHz audio and a 88.5 Hz CTCSS tone
+// exercises the noise squelch and the subaudible tone decoder, the output is the audio gate state per block
+static void Bench_DemodFMCtcss(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_FM, DigitalMode_None, 0);
+    ts.iq_freq_mode = FREQ_IQ_CONV_P6KHZ;
+    ts.fm_sql_threshold = 6;
+    ts.fm_subaudible_tone_det_select = 9; // 88.5 Hz
+    AudioManagement_CalcSubaudibleDetFreq();
+
+    float32_t phase = 0, mod_phase = 0, tone_phase = 0;
+    while (r->samples < 72000)
+    {
+        const float32_t carrier = r->samples < 24000 ? 0.0 : 3000.0;
+        for (int i = 0; i < IQ_BLOCK_SIZE; i++)
+        {
+            adb.i_buffer[i] = carrier * cosf(phase) + 40.0 * Bench_Noise();
+            adb.q_buffer[i] = carrier * sinf(phase) + 40.0 * Bench_Noise();
+            phase = fmodf(phase + 2 * PI * (2000.0 * sinf(mod_phase) + 300.0 * sinf(tone_phase)) / IQ_SAMPLE_RATE_F, 2 * PI);
+            mod_phase = fmodf(mod_phase + 2 * PI * 1000.0 / IQ_SAMPLE_RATE_F, 2 * PI);
+            tone_phase = fmodf(tone_phase + 2 * PI * 88.5 / IQ_SAMPLE_RATE_F, 2 * PI);
+        }
+
+        BENCH_TIMED(r, AudioDriver_DemodFM(IQ_BLOCK_SIZE));
+        r->samples += IQ_BLOCK_SIZE;
+
+        Bench_Output(r, ads.fm_squelched + 2 * ads.fm_subaudible_tone_detected);
+        Bench_Output(r, ads.fm_sql_avg * 10);
+        Bench_Output(r, adb.a_buffer[0][IQ_BLOCK_SIZE - 1]);
+    }
+}
+
+// 800 Hz tone which jumps by 40 dB up and down again, so attack, hang and decay are all exercised
+static void Bench_RxAgcWdsp(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_USB, DigitalMode_None, 2700);
+
+    float32_t phase = 0;
+    while (r->samples < 4096)
+    {
+        const float32_t level = (r->samples >= 1024 && r->samples < 2048) ? 5000.0 : 50.0;
+        for (int i = 0; i < BENCH_AUDIO_BLOCK; i++)
+        {
+            adb.a_buffer[0][i] = level * sinf(phase) + 5.0 * Bench_Noise();
+            adb.a_buffer[1][i] = adb.a_buffer[0][i];
+            phase = fmodf(phase + 2 * PI * 800.0 / (IQ_SAMPLE_RATE_F / BENCH_DECIM_RATE), 2 * PI);
+        }
+
+#ifdef USE_TWO_CHANNEL_AUDIO
+        BENCH_TIMED(r, AudioDriver_RxAgcWdsp(BENCH_AUDIO_BLOCK, adb.a_buffer[0], adb.a_buffer[1]));
+#else
+        BENCH_TIMED(r, AudioDriver_RxAgcWdsp(BENCH_AUDIO_BLOCK, adb.a_buffer[0]));
+#endif
+        r->samples += BENCH_AUDIO_BLOCK;
+
+        for (int i = 0; i < BENCH_AUDIO_BLOCK; i++)
+        {
+            Bench_Output(r, adb.a_buffer[0][i]);
+        }
+    }
+}
+
+static const uint8_t bench_nr_256 = NR_FFT_SIZE_SEL_256;
+static const uint8_t bench_nr_128 = NR_FFT_SIZE_SEL_128;
+
+// two tones in white noise, one frame of the noise reduction at a time
+// param is the frame length selection, one of NR_FFT_SIZE_SEL_xxx
+static void Bench_SpectralNoiseReduction(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_USB, DigitalMode_None, 2700);
+    AudioNr_SetFftSize(*(const uint8_t*)param);
+    const int hop = ts.NR_FFT_L / 2;
+
+    float32_t frame[NR_FFT_SIZE];
+    float32_t phase1 = 0, phase2 = 0;
+    while (r->samples < 4096)
+    {
+        for (int i = 0; i < hop; i++)
+        {
+            frame[i] = 400.0 * sinf(phase1) + 200.0 * sinf(phase2) + 300.0 * Bench_Noise();
+            phase1 = fmodf(phase1 + 2 * PI * 700.0 / 12000.0, 2 * PI);
+            phase2 = fmodf(phase2 + 2 * PI * 1300.0 / 12000.0, 2 * PI);
+        }
+
+        BENCH_TIMED(r, spectral_noise_reduction_3(frame));
+        r->samples += hop;
+
+        for (int i = 0; i < hop; i++)
+        {
+            Bench_Output(r, frame[i]);
+        }
+    }
+}
+
+#define BENCH_NR_SKIP_FRAMES 20
+
+// a tone through the NR worker, which finds the frames 8 and 12 queued together with the next one and passes
+// them through unprocessed. During the first 20 processed frames the NR only learns the noise and all its
+// gains are 1, so the output has to be exactly the input delayed by one frame, also at and after the skipped
+// frames, without a gap or a repeated frame. One character per frame, s for a skipped one, X for a frame which
+// deviates by more than 1% of the tone.
+static void Bench_NrSkip(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_USB, DigitalMode_None, 2700);
+    AudioNr_SetFftSize(NR_FFT_SIZE_SEL_256);
+    ts.dsp_active |= DSP_NR_ENABLE;
+    NR_in_buffer_reset();
+    NR_out_buffer_reset();
+    const int hop = ts.NR_FFT_L / 2;
+
+    static float32_t in[BENCH_NR_SKIP_FRAMES * NR_FFT_SIZE];
+    static float32_t out[BENCH_NR_SKIP_FRAMES * NR_FFT_SIZE];
+    int out_frames = 0;
+    float32_t phase = 0;
+    for (int frame_idx = 0; frame_idx < BENCH_NR_SKIP_FRAMES; frame_idx++)
+    {
+        NR_Buffer* const buf = &mmb.nr_audio_buff[frame_idx % NR_BUFFER_NUM];
+        for (int i = 0; i < hop; i++)
+        {
+            in[frame_idx * hop + i] = 1000.0 * sinf(phase) + 10.0 * Bench_Noise();
+            phase = fmodf(phase + 2 * PI * 700.0 / 12000.0, 2 * PI);
+        }
+        memcpy(&buf->samples[0].real, &in[frame_idx * hop], hop * sizeof(float32_t));
+        NR_in_buffer_add(buf);
+
+        if (frame_idx != 8 && frame_idx != 12)
+        {
+            while (NR_in_has_data())
+            {
+                BENCH_TIMED(r, alternateNR_handle());
+                r->samples += hop;
+            }
+            NR_Buffer* out_buf;
+            while (NR_out_buffer_remove(&out_buf) != 0)
+            {
+                memcpy(&out[out_frames++ * hop], &out_buf->samples[NR_FFT_SIZE/2].real, hop * sizeof(float32_t));
+            }
+        }
+    }
+
+    for (int frame_idx = 1; frame_idx < out_frames; frame_idx++)
+    {
+        float32_t deviation = 0;
+        for (int i = 0; i < hop; i++)
+        {
+            deviation = fmaxf(deviation, fabsf(out[frame_idx * hop + i] - in[(frame_idx - 1) * hop + i]));
+        }
+        Bench_TextOut(deviation > 10.0 ? 'X' : frame_idx == 8 || frame_idx == 12 ? 's' : '.');
+    }
+    Bench_TextOut('\n');
+}
+
+// a tone with an impulse every third frame
+static void Bench_AltNoiseBlanking(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_USB, DigitalMode_None, 2700);
+    ts.nb_setting = 10;
+
+    float32_t frame[NR_FFT_SIZE];
+    float32_t phase = 0;
+    for (int frame_idx = 0; r->samples < 4096; frame_idx++)
+    {
+        for (int i = 0; i < NR_FFT_SIZE; i++)
+        {
+            frame[i] = 1000.0 * sinf(phase) + 20.0 * Bench_Noise();
+            phase = fmodf(phase + 2 * PI * 600.0 / 12000.0, 2 * PI);
+        }
+        if (frame_idx % 3 == 2)
+        {
+            const int pos = 30 + frame_idx % 60;
+            frame[pos]     += 15000.0;
+            frame[pos + 1] -= 8000.0;
+            frame[pos + 2] += 3000.0;
+        }
+
+        BENCH_TIMED(r, alt_noise_blanking(frame, NR_FFT_SIZE, 10, NULL));
+        r->samples += NR_FFT_SIZE;
+
+        for (int i = 0; i < NR_FFT_SIZE; i++)
+        {
+            Bench_Output(r, frame[i]);
+        }
+    }
+}
+
+static const char bench_message[] = "CQ CQ DE DF9TS DF9TS K";
+
+/**
+ * @brief fills the digimodes TX buffer with the test message for the RTTY/PSK modulators
+ */
+static void Bench_TxMessage(void)
+{
+    DigiModes_TxBufferReset();
+    for (const char* c = bench_message; *c != '\0'; c++)
+    {
+        DigiModes_TxBufferPutChar(*c);
+    }
+}
+
+/**
+ * @brief the modulators generate 48ksps like in TX, the decoders run on the decimated audio
+ * @param noise peak amplitude of the white noise added to the decimated signal
+ */
+static float32_t Bench_DecimateModulatorNoise(int16_t (*gen_sample)(void), float32_t noise)
+{
+    float32_t retval = gen_sample();
+    for (int i = 1; i < BENCH_DECIM_RATE; i++)
+    {
+        gen_sample();
+    }
+    return retval / 16.0 + noise * Bench_Noise();
+}
+
+static float32_t Bench_DecimateModulator(int16_t (*gen_sample)(void))
+{
+    return Bench_DecimateModulatorNoise(gen_sample, 200.0);
+}
+
+typedef struct
+{
+    rtty_speed_t speed;
+    rtty_shift_t shift;
+    float32_t noise;
+} BenchRttyMode;
+
+static const BenchRttyMode bench_rtty_45 = { RTTY_SPEED_45, RTTY_SHIFT_170, 200.0 };
+// the per sample IIR decoder this replaced lost characters at this noise level
+static const BenchRttyMode bench_rtty_weak = { RTTY_SPEED_45, RTTY_SHIFT_170, 7000.0 };
+static const BenchRttyMode bench_rtty_75 = { RTTY_SPEED_75, RTTY_SHIFT_170, 200.0 };
+static const BenchRttyMode bench_rtty_100 = { RTTY_SPEED_100, RTTY_SHIFT_850, 200.0 };
+
+/**
+ * @param param the BenchRttyMode to decode
+ */
+static void Bench_RttyDecoder(BenchRun* r, const void* param)
+{
+    const BenchRttyMode* mode = param;
+
+    Bench_InitRadio(DEMOD_DIGI, DigitalMode_RTTY, 2700);
+    rtty_ctrl_config.speed_idx = mode->speed;
+    rtty_ctrl_config.shift_idx = mode->shift;
+    RttyDecoder_Init();
+    Rtty_Modulator_StartTX();
+    Bench_TxMessage();
+
+    // 45 baud with 1.5 stop bits is 6 characters per second, 7s are enough for the message
+    while (r->samples < 7 * 12000)
+    {
+        float32_t block[BENCH_AUDIO_BLOCK];
+        for (int i = 0; i < BENCH_AUDIO_BLOCK; i++)
+        {
+            block[i] = Bench_DecimateModulatorNoise(Rtty_Modulator_GenSample, mode->noise);
+        }
+        BENCH_TIMED(r, RttyDecoder_ProcessBlock(block, BENCH_AUDIO_BLOCK));
+        r->samples += BENCH_AUDIO_BLOCK;
+    }
+    rtty_ctrl_config.speed_idx = RTTY_SPEED_45;
+    rtty_ctrl_config.shift_idx = RTTY_SHIFT_170;
+}
+
+static const psk_speed_t bench_bpsk_31 = PSK_SPEED_31;
+static const psk_speed_t bench_bpsk_63 = PSK_SPEED_63;
+static const psk_speed_t bench_bpsk_125 = PSK_SPEED_125;
+
+/**
+ * @param param the psk_speed_t to decode
+ */
+static void Bench_BpskDecoder(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_DIGI, DigitalMode_BPSK, 2700);
+    psk_ctrl_config.speed_idx = *(const psk_speed_t*)param;
+    PskDecoder_Init();
+    Bench_TxMessage();
+
+    // the message has about 250 bits including the character gaps, 8s at 31.25 baud
+    while (r->samples < 10 * 12000)
+    {
+        float32_t block[BENCH_AUDIO_BLOCK];
+        for (int i = 0; i < BENCH_AUDIO_BLOCK; i++)
+        {
+            block[i] = Bench_DecimateModulator(Psk_Modulator_GenSample);
+        }
+        BENCH_TIMED(r, BpskDecoder_ProcessBlock(block, BENCH_AUDIO_BLOCK));
+        r->samples += BENCH_AUDIO_BLOCK;
+    }
+    psk_ctrl_config.speed_idx = PSK_SPEED_31;
+}
+
+typedef struct
+{
+    float32_t freq;
+    float32_t amplitude;
+    const char* message;
+    uint8_t bits[512];      // 0 is a phase reversal
+    uint16_t bits_len;
+} BenchPskCarrier;
+
+/**
+ * @brief PSK31 signal of a carrier: 32 reversals, the varicode of the message with two 0 bits after each character, then carrier
+ */
+static void Bench_PskCarrierInit(BenchPskCarrier* carrier)
+{
+    carrier->bits_len = 0;
+    for (int i = 0; i < 32; i++)
+    {
+        carrier->bits[carrier->bits_len++] = 0;
+    }
+    for (const char* c = carrier->message; *c != '\0'; c++)
+    {
+        for (uint16_t code = Bpsk_FindCharReversed(*c); code != 0; code /= 2)
+        {
+            carrier->bits[carrier->bits_len++] = code % 2;
+        }
+        carrier->bits[carrier->bits_len++] = 0;
+        carrier->bits[carrier->bits_len++] = 0;
+    }
+}
+
+/**
+ * @returns sample n of the carrier, reversals have the cosine shaped envelope of the PSK31 standard
+ */
+static float32_t Bench_PskCarrierSample(const BenchPskCarrier* carrier, uint32_t n)
+{
+    const uint32_t symbol = n / 384;
+    float32_t sign = 1, envelope = 1;
+    for (uint32_t i = 0; i < symbol && i < carrier->bits_len; i++)
+    {
+        sign = carrier->bits[i] == 0 ? -sign : sign;
+    }
+    if (symbol < carrier->bits_len && carrier->bits[symbol] == 0)
+    {
+        envelope = cosf(PI * (n % 384) / 384.0);
+    }
+    return carrier->amplitude * sign * envelope * cosf(2 * PI * fmodf(carrier->freq * n / 12000.0, 1.0));
+}
+
+// five PSK31 stations between the channels of the filter bank, two only 100Hz apart;
+// the decoded text of every channel is listed by frequency
+static void Bench_PskSkimmer(BenchRun* r, const void* param)
+{
+    static BenchPskCarrier carriers[] =
+    {
+        { 733.0,    3000.0, "CQ CQ DE DF9TS DF9TS K" },
+        { 1062.5,   2000.0, "CQ DE DL1ABC PSE K" },
+        { 1517.0,   1500.0, "TEST DE OE3XYZ" },
+        { 1619.0,   1500.0, "UR RST 599 599" },
+        { 2250.0,   1000.0, "DE G4ABC TU 73" },
+    };
+    const uint16_t num = sizeof(carriers) / sizeof(carriers[0]);
+    float32_t block[BENCH_AUDIO_BLOCK];
+
+    Bench_InitRadio(DEMOD_DIGI, DigitalMode_BPSK, 2700);
+    PskSkimmer_Init();
+    for (uint16_t c = 0; c < num; c++)
+    {
+        Bench_PskCarrierInit(&carriers[c]);
+    }
+
+    while (r->samples < 10 * 12000)
+    {
+        for (int i = 0; i < BENCH_AUDIO_BLOCK; i++)
+        {
+            block[i] = 200.0 * Bench_Noise();
+            for (uint16_t c = 0; c < num; c++)
+            {
+                block[i] += Bench_PskCarrierSample(&carriers[c], r->samples + i);
+            }
+        }
+        BENCH_TIMED(r, PskSkimmer_ProcessBlock(block, BENCH_AUDIO_BLOCK));
+        r->samples += BENCH_AUDIO_BLOCK;
+    }
+
+    for (uint16_t printed = 0, last_freq = 0; printed < PSK_SKIM_CHANNELS; printed++)
+    {
+        int16_t next = -1;
+        for (uint16_t c = 0; c < PSK_SKIM_CHANNELS; c++)
+        {
+            const SkimmerText* text = &psk_skimmer_text[c];
+            if (text->text_count > 0 && text->freq > last_freq && (next < 0 || text->freq < psk_skimmer_text[next].freq))
+            {
+                next = c;
+            }
+        }
+        if (next < 0)
+        {
+            break;
+        }
+        const SkimmerText* text = &psk_skimmer_text[next];
+        r->text_len += snprintf(&r->text[r->text_len], BENCH_TEXT_MAX - r->text_len, "%u %.*s\n",
+                text->freq, (int)text->text_count, text->text);
+        last_freq = text->freq;
+    }
+}
+
+/**
+ * @returns morse code of the character as string of '.' and '-'
+ */
+static const char* Bench_Morse(char c)
+{
+    static const char* const letters[] =
+    {
+        ".-", "-...", "-.-.", "-..", ".", "..-.", "--.", "....", "..", ".---", "-.-", ".-..", "--",
+        "-.", "---", ".--.", "--.-", ".-.", "...", "-", "..-", "...-", ".--", "-..-", "-.--", "--.."
+    };
+    static const char* const digits[] =
+    {
+        "-----", ".----", "..---", "...--", "....-", ".....", "-....", "--...", "---..", "----."
+    };
+    const char* retval = "";
+
+    if (c >= 'A' && c <= 'Z')
+    {
+        retval = letters[c - 'A'];
+    }
+    else if (c >= '0' && c <= '9')
+    {
+        retval = digits[c - '0'];
+    }
+    return retval;
+}
+
+// 20 wpm morse of the test message at the sidetone frequency, with 5ms rise and fall time
+typedef struct
+{
+    float32_t freq;
+    float32_t amplitude;
+    float32_t wpm;
+    const char* message;
+    // the fist, all 0 is machine sent standard timing
+    float32_t jitter;       // each element is up to this fraction longer or shorter
+    float32_t dah;          // length of a dah in dots, 0 is 3
+    float32_t weight;       // fraction of a dot the marks are longer and the spaces shorter
+    float32_t wpm_end;      // speed at the end of the message, 0 is wpm
+    // the path
+    float32_t qsb_hz;       // fading rate ...
+    float32_t qsb_depth;    // ... down to this fraction below the amplitude
+    uint32_t keying[512];   // on/off durations in samples
+    uint16_t keying_len;
+    uint16_t key_idx;
+    uint32_t key_remaining;
+    bool key_down;
+    float32_t envelope;
+    float32_t phase;
+    uint32_t n;
+} BenchCwCarrier;
+
+/**
+ * @brief keying of the message with the timing of the fist, starts after two dots of silence
+ */
+static void Bench_CwCarrierInit(BenchCwCarrier* carrier)
+{
+    float32_t dots[512];
+    uint16_t len = 0;
+
+    for (const char* c = carrier->message; *c != '\0'; c++)
+    {
+        if (*c == ' ')
+        {
+            dots[len - 1] = 7;      // replaces the gap after the last character
+            continue;
+        }
+        for (const char* m = Bench_Morse(*c); *m != '\0'; m++)
+        {
+            dots[len++] = *m == '-' ? (carrier->dah > 0 ? carrier->dah : 3) : 1;
+            dots[len++] = 1;
+        }
+        dots[len - 1] = 3;
+    }
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        const float32_t wpm = carrier->wpm_end > 0 ? carrier->wpm + (carrier->wpm_end - carrier->wpm) * i / len : carrier->wpm;
+        const float32_t dot_len = floorf(12000 * 1.2 / wpm);
+        float32_t samples = (dots[i] + (i % 2 == 0 ? carrier->weight : -carrier->weight)) * dot_len;
+        if (carrier->jitter > 0)
+        {
+            samples *= 1.0 + carrier->jitter * Bench_Noise();
+        }
+        carrier->keying[i] = lroundf(samples);
+    }
+    carrier->keying_len = len;
+    carrier->key_idx = 0;
+    carrier->key_remaining = 2 * 12000 * 1.2 / carrier->wpm;
+    carrier->key_down = false;
+    carrier->envelope = 0;
+    carrier->phase = 0;
+    carrier->n = 0;
+}
+
+/**
+ * @returns the next sample of the carrier, keyed with 5ms ramps
+ */
+static float32_t Bench_CwCarrierSample(BenchCwCarrier* carrier)
+{
+    const float32_t ramp = 12000 * 0.005;
+
+    if (carrier->key_remaining-- == 0)
+    {
+        if (carrier->key_idx < carrier->keying_len)
+        {
+            carrier->key_down = (carrier->key_idx % 2) == 0;
+            carrier->key_remaining = carrier->keying[carrier->key_idx++] - 1;
+        }
+        else
+        {
+            carrier->key_down = false;
+            carrier->key_remaining = UINT32_MAX;
+        }
+    }
+    carrier->envelope = carrier->key_down ? fminf(carrier->envelope + 1.0 / ramp, 1.0) : fmaxf(carrier->envelope - 1.0 / ramp, 0.0);
+    float32_t retval = carrier->amplitude * carrier->envelope * sinf(carrier->phase);
+    if (carrier->qsb_depth > 0)
+    {
+        retval *= 1.0 - carrier->qsb_depth * 0.5 * (1.0 - cosf(2 * PI * carrier->qsb_hz * carrier->n / 12000.0));
+    }
+    carrier->phase = fmodf(carrier->phase + 2 * PI * carrier->freq / 12000.0, 2 * PI);
+    carrier->n++;
+    return retval;
+}
+
+// the level is well above the fixed detection threshold of the decoder
+static void Bench_CwDecoder(BenchRun* r, const void* param)
+{
+    Bench_InitRadio(DEMOD_CW, DigitalMode_None, 500);
+    CwDecode_FilterInit();
+
+    BenchCwCarrier carrier = { .freq = ts.cw_sidetone_freq, .amplitude = 6000.0, .wpm = 20, .message = bench_message };
+    Bench_CwCarrierInit(&carrier);
+    float32_t block[BENCH_AUDIO_BLOCK];
+
+    // a few seconds of silence at the end, the decoder prints the last character after a timeout
+    while (r->samples < 16 * 12000)
+    {
+        for (int i = 0; i < BENCH_AUDIO_BLOCK; i++)
+        {
+            block[i] = Bench_CwCarrierSample(&carrier) + 100.0 * Bench_Noise();
+        }
+
+        BENCH_TIMED(r, CwDecode_RxProcessor(block, BENCH_AUDIO_BLOCK));
+        r->samples += BENCH_AUDIO_BLOCK;
+    }
+}
+
+// fists and paths the timing of the decoder has to cope with
+static const struct
+{
+    const char* name;
+    BenchCwCarrier carrier;
+} bench_cw_corpus[] =
+{
+    { "25wpm",      { .wpm = 25, .message = "CQ CQ DE DF9TS DF9TS PSE K" } },
+    { "35wpm_qsb",  { .wpm = 35, .jitter = 0.15, .qsb_hz = 0.4, .qsb_depth = 0.5, .message = "DL1ABC DE DF9TS UR RST 599 599 NAME TOM TOM BK" } },
+    { "40wpm_bug",  { .wpm = 40, .jitter = 0.08, .dah = 3.4, .weight = 0.3, .message = "TEST DF9TS 5NN 14 TEST DE OE3XYZ" } },
+    { "45wpm",      { .wpm = 45, .jitter = 0.12, .message = "CQ TEST DF9TS DF9TS TEST" } },
+    { "hand_key",   { .wpm = 18, .jitter = 0.3, .dah = 3.6, .message = "QTH NEAR MUNICH RIG HOMEMADE" } },
+    { "20to38wpm",  { .wpm = 20, .wpm_end = 38, .jitter = 0.1, .message = "GE OM TNX FER CALL UR SIGS FB ES SOLID 73 SK" } },
+};
+
+// each entry of the corpus decoded with both timing methods, one line each
+static void Bench_CwCorpus(BenchRun* r, const void* param)
+{
+    static const char* const timing_names[CW_TIMING_NUM] = { "classic", "bayes" };
+
+    for (uint16_t c = 0; c < sizeof(bench_cw_corpus) / sizeof(bench_cw_corpus[0]); c++)
+    {
+        for (uint8_t timing = 0; timing < CW_TIMING_NUM; timing++)
+        {
+            Bench_InitRadio(DEMOD_CW, DigitalMode_None, 500);
+            cw_decoder_config.timing = timing;
+            CwDecode_FilterInit();
+
+            BenchCwCarrier carrier = bench_cw_corpus[c].carrier;
+            carrier.freq = ts.cw_sidetone_freq;
+            carrier.amplitude = 6000.0;
+            Bench_CwCarrierInit(&carrier);
+
+            uint32_t len = 4 * 12000;   // the decoders print the last character after a timeout
+            for (uint16_t i = 0; i < carrier.keying_len; i++)
+            {
+                len += carrier.keying[i];
+            }
+
+            r->text_len += snprintf(&r->text[r->text_len], BENCH_TEXT_MAX - r->text_len, "%-10s %-7s ",
+                    bench_cw_corpus[c].name, timing_names[timing]);
+
+            float32_t block[BENCH_AUDIO_BLOCK];
+            for (uint32_t n = 0; n < len; n += BENCH_AUDIO_BLOCK)
+            {
+                for (int i = 0; i < BENCH_AUDIO_BLOCK; i++)
+                {
+                    block[i] = Bench_CwCarrierSample(&carrier) + 100.0 * Bench_Noise();
+                }
+                BENCH_TIMED(r, CwDecode_RxProcessor(block, BENCH_AUDIO_BLOCK));
+                r->samples += BENCH_AUDIO_BLOCK;
+            }
+            r->text_len += snprintf(&r->text[r->text_len], BENCH_TEXT_MAX - r->text_len, "\n");
+        }
+    }
+    cw_decoder_config.timing = CW_TIMING_CLASSIC;
+}
+
+// the filter bank locks to a 35 WPM carrier 180Hz off the sidetone, next to a weaker one it has to ignore;
+// Bayesian timing, the classic one needs a few characters to learn the speed, which cw_corpus covers
+static void Bench_CwBankLock(BenchRun* r, const void* param)
+{
+    static BenchCwCarrier carriers[] =
+    {
+        { .freq = 930.0,    .amplitude = 6000.0,    .wpm = 35, .message = "CQ TEST DE DF9TS DF9TS TEST" },
+        { .freq = 420.0,    .amplitude = 1500.0,    .wpm = 18, .message = "QRL QRL" },
+    };
+    const uint16_t num = sizeof(carriers) / sizeof(carriers[0]);
+    float32_t block[BENCH_AUDIO_BLOCK];
+
+    Bench_InitRadio(DEMOD_CW, DigitalMode_None, 1400);
+    CwDecode_FilterInit();
+    cw_decoder_config.bank_mode = CW_BANK_LOCK;
+    cw_decoder_config.timing = CW_TIMING_BAYES;
+    CwBank_Init();
+    for (uint16_t c = 0; c < num; c++)
+    {
+        Bench_CwCarrierInit(&carriers[c]);
+    }
+
+    while (r->samples < 12 * 12000)
+    {
+        for (int i = 0; i < BENCH_AUDIO_BLOCK; i++)
+        {
+            block[i] = 300.0 * Bench_Noise();
+            for (uint16_t c = 0; c < num; c++)
+            {
+                block[i] += Bench_CwCarrierSample(&carriers[c]);
+            }
+        }
+        BENCH_TIMED(r, CwBank_ProcessBlock(block, BENCH_AUDIO_BLOCK));
+        r->samples += BENCH_AUDIO_BLOCK;
+    }
+    cw_decoder_config.bank_mode = CW_BANK_OFF;
+    cw_decoder_config.timing = CW_TIMING_CLASSIC;
+}
+
+// four CW stations with different speeds and levels in a 1.4kHz filter, each gets its own decoder;
+// the decoded text of every channel is listed by frequency, Bayesian timing as in cw_lock
+static void Bench_CwBankSkimmer(BenchRun* r, const void* param)
+{
+    static BenchCwCarrier carriers[] =
+    {
+        { .freq = 320.0,    .amplitude = 3000.0,    .wpm = 22, .message = "CQ DE DL1ABC K" },
+        { .freq = 610.0,    .amplitude = 6000.0,    .wpm = 16, .message = "TEST OE3XYZ" },
+        { .freq = 880.0,    .amplitude = 2000.0,    .wpm = 35, .message = "UR 599 5NN TU" },
+        { .freq = 1190.0,   .amplitude = 4000.0,    .wpm = 28, .message = "DE G4ABC 73" },
+    };
+    const uint16_t num = sizeof(carriers) / sizeof(carriers[0]);
+    float32_t block[BENCH_AUDIO_BLOCK];
+
+    Bench_InitRadio(DEMOD_CW, DigitalMode_None, 1400);
+    CwDecode_FilterInit();
+    cw_decoder_config.bank_mode = CW_BANK_SKIM;
+    cw_decoder_config.timing = CW_TIMING_BAYES;
+    CwBank_Init();
+    for (uint16_t c = 0; c < num; c++)
+    {
+        Bench_CwCarrierInit(&carriers[c]);
+    }
+
+    while (r->samples < 12 * 12000)
+    {
+        for (int i = 0; i < BENCH_AUDIO_BLOCK; i++)
+        {
+            block[i] = 300.0 * Bench_Noise();
+            for (uint16_t c = 0; c < num; c++)
+            {
+                block[i] += Bench_CwCarrierSample(&carriers[c]);
+            }
+        }
+        BENCH_TIMED(r, CwBank_ProcessBlock(block, BENCH_AUDIO_BLOCK));
+        r->samples += BENCH_AUDIO_BLOCK;
+    }
+    cw_decoder_config.bank_mode = CW_BANK_OFF;
+    cw_decoder_config.timing = CW_TIMING_CLASSIC;
+
+    for (uint16_t printed = 0, last_freq = 0; printed < CW_SKIM_CHANNELS; printed++)
+    {
+        int16_t next = -1;
+        for (uint16_t c = 0; c < CW_SKIM_CHANNELS; c++)
+        {
+            const SkimmerText* text = &cw_skimmer_text[c];
+            if (text->text_count > 0 && text->freq > last_freq && (next < 0 || text->freq < cw_skimmer_text[next].freq))
+            {
+                next = c;
+            }
+        }
+        if (next < 0)
+        {
+            break;
+        }
+        const SkimmerText* text = &cw_skimmer_text[next];
+        r->text_len += snprintf(&r->text[r->text_len], BENCH_TEXT_MAX - r->text_len, "%u %.*s\n",
+                text->freq, (int)text->text_count, text->text);
+        last_freq = text->freq;
+    }
+}
+
+// the SNR limits leave room for optimizations which change the rounding, not the algorithm
+static const BenchKernel bench_kernels[] =
+{
+    { "freqconv",   Bench_FreqConversion,           100.0 },
+    { "demod_sam",  Bench_DemodSAM,                 60.0 },
+    { "sam_lock",   Bench_SamLock,                  40.0 },
+    { "demod_fm",   Bench_DemodFM,                  60.0 },
+    { "fm_ctcss",   Bench_DemodFMCtcss,             40.0 },
+    { "resample",   Bench_ResampleIQ,               100.0 },
+    { "hilbert_dec", Bench_HilbertDecimate,         100.0 },
+    { "zoom",       Bench_ZoomDecimate,             100.0 },
+    { "agc_wdsp",   Bench_RxAgcWdsp,                80.0 },
+    { "nr3",        Bench_SpectralNoiseReduction,   60.0, &bench_nr_256 },
+    { "nr3_128",    Bench_SpectralNoiseReduction,   60.0, &bench_nr_128 },
+    { "nr3_skip",   Bench_NrSkip,                   0 },
+    { "nb",         Bench_AltNoiseBlanking,         80.0 },
+#ifdef USE_RTTY_PROCESSOR
+    { "rtty",       Bench_RttyDecoder,              0, &bench_rtty_45 },
+    { "rtty_weak",  Bench_RttyDecoder,              0, &bench_rtty_weak },
+    { "rtty75",     Bench_RttyDecoder,              0, &bench_rtty_75 },
+    { "rtty100",    Bench_RttyDecoder,              0, &bench_rtty_100 },
+#endif
+    { "bpsk",       Bench_BpskDecoder,              0, &bench_bpsk_31 },
+    { "bpsk63",     Bench_BpskDecoder,              0, &bench_bpsk_63 },
+    { "bpsk125",    Bench_BpskDecoder,              0, &bench_bpsk_125 },
+    { "psk_skim",   Bench_PskSkimmer,               0 },
+    { "cw",         Bench_CwDecoder,                0 },
+    { "cw_corpus",  Bench_CwCorpus,                 0 },
+    { "cw_lock",    Bench_CwBankLock,               0 },
+    { "cw_skim",    Bench_CwBankSkimmer,            0 },
+    { NULL,         NULL,                           0 }
+};
+
+/**
+ * @returns SNR of the output relative to the reference in dB, INFINITY if they are identical
+ */
+static float64_t Bench_Snr(const float32_t* out, const float32_t* ref, uint32_t len)
+{
+    float64_t signal = 0, error = 0;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        signal += (float64_t)ref[i] * ref[i];
+        error += ((float64_t)out[i] - ref[i]) * ((float64_t)out[i] - ref[i]);
+    }
+    return error == 0 ? INFINITY : 10.0 * log10(signal / error);
+}
+
+/**
+ * @returns true if the run matches the reference, with update set the reference is written instead
+ */
+static bool Bench_Compare(const BenchKernel* k, const BenchRun* r, const char* ref_dir, bool update, float64_t* snr)
+{
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s.%s", ref_dir, k->name, k->min_snr > 0 ? "f32" : "txt");
+
+    const void* data = k->min_snr > 0 ? (const void*)r->out : (const void*)r->text;
+    const size_t len = k->min_snr > 0 ? r->out_len * sizeof(float32_t) : r->text_len;
+    bool retval = false;
+
+    if (update)
+    {
+        FILE* f = fopen(path, "wb");
+        if (f != NULL)
+        {
+            retval = fwrite(data, 1, len, f) == len;
+            fclose(f);
+        }
+        if (retval == false)
+        {
+            printf("  %s: %s\n", path, strerror(errno));
+        }
+        *snr = INFINITY;
+    }
+    else
+    {
+        static uint8_t ref[BENCH_OUT_MAX * sizeof(float32_t)];
+        size_t ref_len = 0;
+
+        FILE* f = fopen(path, "rb");
+        if (f != NULL)
+        {
+            ref_len = fread(ref, 1, sizeof(ref), f);
+            fclose(f);
+        }
+        else
+        {
+            printf("  %s: %s\n", path, strerror(errno));
+        }
+
+        if (ref_len == len)
+        {
+            if (k->min_snr > 0)
+            {
+                *snr = Bench_Snr(r->out, (const float32_t*)ref, r->out_len);
+                retval = *snr >= k->min_snr;
+            }
+            else
+            {
+                retval = memcmp(ref, r->text, len) == 0;
+            }
+        }
+        if (retval == false && k->min_snr == 0 && f != NULL)
+        {
+            printf("  expected \"%.*s\"\n  decoded  \"%s\"\n", (int)ref_len, ref, r->text);
+        }
+    }
+    return retval;
+}
+
+static void Bench_Usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -k <kernel>  run only this kernel\n"
+            "  -d <dir>     reference directory (default %s)\n"
+            "  -n <loops>   repetitions for the timing (default %d)\n"
+            "  -u           write the references instead of comparing\n"
+            "kernels:",
+            prog, BENCH_REF_DIR, BENCH_LOOPS_DEFAULT);
+    for (const BenchKernel* k = bench_kernels; k->name != NULL; k++)
+    {
+        fprintf(stderr, " %s", k->name);
+    }
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char* argv[])
+{
+    const char* only = NULL;
+    const char* ref_dir = BENCH_REF_DIR;
+    int loops = BENCH_LOOPS_DEFAULT;
+    bool update = false;
+    int failed = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "k:d:n:u")) != -1)
+    {
+        switch (opt)
+        {
+        case 'k':
+            only = optarg;
+            break;
+        case 'd':
+            ref_dir = optarg;
+            break;
+        case 'n':
+            loops = atoi(optarg) > 0 ? atoi(optarg) : 1;
+            break;
+        case 'u':
+            update = true;
+            break;
+        default:
+            Bench_Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    HostDsp_TextOut = Bench_TextOut;
+
+    printf("%-12s %12s %10s  %s\n", "kernel", "ns/sample", "SNR dB", "result");
+    for (const BenchKernel* k = bench_kernels; k->name != NULL; k++)
+    {
+        if (only != NULL && strcmp(only, k->name) != 0)
+        {
+            continue;
+        }
+
+        // the first run is checked, the fastest of all runs is reported
+        float64_t ns_per_sample = INFINITY;
+        float64_t snr = 0;
+        bool ok = true;
+        for (int loop = 0; loop < loops; loop++)
+        {
+            memset(&bench_run, 0, sizeof(bench_run));
+            k->run(&bench_run, k->param);
+            ns_per_sample = fmin(ns_per_sample, (float64_t)bench_run.ns / bench_run.samples);
+            if (loop == 0)
+            {
+                ok = Bench_Compare(k, &bench_run, ref_dir, update, &snr);
+            }
+        }
+
+        char snr_str[16] = "-";
+        if (k->min_snr > 0)
+        {
+            snprintf(snr_str, sizeof(snr_str), isinf(snr) ? "exact" : "%.1f", snr);
+        }
+        printf("%-12s %12.2f %10s  %s\n", k->name, ns_per_sample, snr_str, update ? "updated" : ok ? "ok" : "FAILED");
+        if (ok == false)
+        {
+            failed++;
+        }
+    }
+
+    return failed != 0;
+}
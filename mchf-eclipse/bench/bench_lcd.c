@@ -0,0 +1,472 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     bench_lcd.c                                                     **
+ **  Description:   display bandwidth and rendering regression tests                **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+/*
+ * Runs a fixed sequence of UI drawing actions through the real display driver and
+ * spectrum display on the emulated displays of support/host-dsp/host_lcd.c
+ * (HY28B 320x240 and ILI9486 480x320) and reports for each action what goes over the bus:
+ * GRAM write windows, pixels written, pixels which actually changed on the screen,
+ * 16 bit cycles on the FSMC and bytes on the SPI bus of the SPI variant of the display.
+ *
+ * After each action the framebuffer hash is compared with bench/reference/lcd_<display>.txt,
+ * so a change which alters what is on the screen is noticed. If that was intended, regenerate
+ * the references with "hostlcd-<trx> -u" and check the snapshots written with "-o <dir>" (PPM).
+ *
+ * The actions build on each other like the UI does: the retained text and box updates
+ * are drawn once and then redrawn with small or no changes. The widgets are drawn with
+ * the same calls and positions as the functions of ui_driver.c they are named after.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+
+#include "uhsdr_board.h"
+#include "ui_lcd_hy28.h"
+#include "ui_spectrum.h"
+#include "audio_driver.h"
+#include "radio_management.h"
+#include "ui_configuration.h"
+#include "host_dsp.h"
+#include "host_lcd.h"
+
+#define BENCH_REF_DIR           "bench/reference"
+#define BENCH_LCD_ACTIONS_MAX   32
+#define BENCH_LCD_FRAMES        16      // spectrum frames per spectrum action
+#define BENCH_LCD_REDRAW_MAX    64      // calls of UiSpectrum_Redraw() for a frame before we give up
+
+typedef struct
+{
+    const char* name;
+    void (*run)(void);
+} BenchLcdAction;
+
+typedef struct
+{
+    const char* name;
+    uint16_t device_code;
+} BenchLcdDisplay;
+
+static const BenchLcdDisplay bench_lcd_displays[] =
+{
+    { "320x240", 0x9325 },
+    { "480x320", 0x9486 },
+};
+
+static uint32_t bench_lcd_noise = 1;
+
+static void BenchLcd_Clear(void)
+{
+    UiLcdHy28_LcdClear(Black);
+}
+
+static void BenchLcd_Text(void)
+{
+    uint16_t y = 0;
+    for (uint8_t font = 0; font < 5; font++)
+    {
+        UiLcdHy28_PrintText(0, y, "UHSDR 14.074 USB", White, Black, font);
+        y += UiLcdHy28_TextHeight(font) + 2;
+    }
+}
+
+// UiDriver_UpdateFreqDisplay(), large digits
+static void BenchLcd_FreqDisplay(uint32_t freq)
+{
+    char line[16];
+    snprintf(line, sizeof(line), "%3u.%03u.%03u", (unsigned)(freq / 1000000), (unsigned)(freq / 1000 % 1000), (unsigned)(freq % 1000));
+    UiLcdHy28_PrintTextRetainedPitch(ts.Layout->TUNE_FREQ.x - LARGE_FONT_WIDTH, ts.Layout->TUNE_FREQ.y, LARGE_FONT_WIDTH, line, White, Black, 1);
+}
+
+static void BenchLcd_FreqDraw(void)
+{
+    BenchLcd_FreqDisplay(14074000);
+}
+
+static void BenchLcd_FreqStep(void)
+{
+    BenchLcd_FreqDisplay(14074010);
+}
+
+static void BenchLcd_FreqSame(void)
+{
+    BenchLcd_FreqDisplay(14074010);
+}
+
+static void BenchLcd_FreqBand(void)
+{
+    BenchLcd_FreqDisplay(7074000);
+}
+
+// UiDriver_LeftBoxDisplay(), values of the DSP, AGC, RF gain and NB boxes
+static void BenchLcd_LeftBox(uint8_t row, const char* label, const char* value, bool encoder_active)
+{
+    const uint32_t color = encoder_active ? Black : White;
+    const uint32_t bg_color = encoder_active ? Orange : Blue;
+    uint16_t posX, posY;
+
+    if (ts.Layout->LEFTBOXES_MODE == MODE_HORIZONTAL)
+    {
+        posX = ts.Layout->LEFTBOXES_IND.x + (row * LEFTBOX_WIDTH);
+        posY = ts.Layout->LEFTBOXES_IND.y;
+    }
+    else
+    {
+        posX = ts.Layout->LEFTBOXES_IND.x;
+        posY = ts.Layout->LEFTBOXES_IND.y + (row * LEFTBOX_ROW_H);
+    }
+
+    UiLcdHy28_DrawEmptyRectRetained(posX, posY, LEFTBOX_ROW_H - 2, LEFTBOX_WIDTH - 2, bg_color);
+    UiLcdHy28_PrintTextCenteredRetained(posX + 1, posY + 1, LEFTBOX_WIDTH - 3, label, color, bg_color, 0);
+    UiLcdHy28_DrawFullRectRetained(posX + 1, posY + 1 + 12, LEFTBOX_ROW_H - 4 - 11, LEFTBOX_WIDTH - 3, Black);
+    UiLcdHy28_PrintTextCenteredRetained(posX + 1, posY + 1 + 12, LEFTBOX_WIDTH - 3, value, White, Black, 0);
+}
+
+static void BenchLcd_Boxes(void)
+{
+    BenchLcd_LeftBox(0, "DSP", "NR", false);
+    BenchLcd_LeftBox(1, "AGC", "Med", false);
+    BenchLcd_LeftBox(2, "RFG", "50", false);
+    BenchLcd_LeftBox(3, "NB", "OFF", false);
+}
+
+static void BenchLcd_BoxesActive(void)
+{
+    BenchLcd_LeftBox(0, "DSP", "NR", false);
+    BenchLcd_LeftBox(1, "AGC", "Med", false);
+    BenchLcd_LeftBox(2, "RFG", "51", true);
+    BenchLcd_LeftBox(3, "NB", "OFF", false);
+}
+
+static void BenchLcd_Lines(void)
+{
+    const uint16_t w = mchf_display.MAX_X, h = mchf_display.MAX_Y;
+    UiLcdHy28_DrawEmptyRect(0, 0, h - 1, w - 1, Grey);
+    UiLcdHy28_DrawStraightLine(0, h / 2, w, LCD_DIR_HORIZONTAL, Grey);
+    UiLcdHy28_DrawStraightLine(w / 2, 0, h, LCD_DIR_VERTICAL, Grey);
+    UiLcdHy28_DrawHorizLineWithGrad(0, h - 2, w, COL_SPECTRUM_GRAD);
+}
+
+/**
+ * @brief fills the next spectrum frame the way AudioDriver_SpectrumCollectSamples() does,
+ * with a few carriers and some noise, in the units of the codec samples
+ */
+static void BenchLcd_SpectrumFrame(uint32_t frame)
+{
+    static const float32_t carrier_bins[] = { 17.0, 64.5, 100.25, 180.0 };
+    float32_t* dst = sd.FFT_Frame[sd.frames_filled & 1];
+    const uint16_t len = sd.fft_iq_len / 2;
+
+    for (uint16_t n = 0; n < len; n++)
+    {
+        float32_t i = 0, q = 0;
+        for (uint16_t c = 0; c < sizeof(carrier_bins) / sizeof(carrier_bins[0]); c++)
+        {
+            // carriers fade in and out over the frames, so the scope has something to redraw
+            const float32_t amp = 2000.0 / (c + 1) * (1 + sinf(frame * 0.4 + c));
+            const float32_t phase = 2 * PI * carrier_bins[c] * n / len;
+            i += amp * cosf(phase);
+            q += amp * sinf(phase);
+        }
+        bench_lcd_noise = bench_lcd_noise * 1664525 + 1013904223;
+        i += ((int32_t)bench_lcd_noise >> 16) * 0.01;
+        bench_lcd_noise = bench_lcd_noise * 1664525 + 1013904223;
+        q += ((int32_t)bench_lcd_noise >> 16) * 0.01;
+
+        dst[2 * n] = q;
+        dst[2 * n + 1] = i;
+    }
+    sd.frames_filled++;
+}
+
+static void BenchLcd_SpectrumFrames(void)
+{
+    for (uint32_t frame = 0; frame < BENCH_LCD_FRAMES; frame++)
+    {
+        // the schedulers are counted down by the 1ms tick on the radio, we are always due
+        ts.scope_scheduler = 0;
+        ts.waterfall.scheduler = 0;
+        BenchLcd_SpectrumFrame(frame);
+
+        bool started = false;
+        for (int call = 0; call < BENCH_LCD_REDRAW_MAX; call++)
+        {
+            UiSpectrum_Redraw();
+            if (sd.state != 0)
+            {
+                started = true;
+            }
+            else if (started)
+            {
+                break;
+            }
+        }
+    }
+}
+
+static void BenchLcd_SpectrumInit(uint16_t flags)
+{
+    ts.flags1 = (ts.flags1 & ~(FLAGS1_SCOPE_ENABLED | FLAGS1_WFALL_ENABLED)) | flags;
+    UiSpectrum_Init();
+}
+
+static void BenchLcd_ScopeInit(void)
+{
+    BenchLcd_SpectrumInit(FLAGS1_SCOPE_ENABLED);
+}
+
+static void BenchLcd_WaterfallInit(void)
+{
+    BenchLcd_SpectrumInit(FLAGS1_WFALL_ENABLED);
+}
+
+static void BenchLcd_DualInit(void)
+{
+    BenchLcd_SpectrumInit(FLAGS1_SCOPE_ENABLED | FLAGS1_WFALL_ENABLED);
+}
+
+// the waterfall on a display which can scroll it, like the RA8875
+static void BenchLcd_ScrollInit(void)
+{
+    HostLcd_ScrollWindowEnable(true);
+    BenchLcd_SpectrumInit(FLAGS1_WFALL_ENABLED);
+}
+
+// UiAction_ToggleMenuMode(), the menu is drawn where the spectrum was
+static void BenchLcd_MenuOpen(void)
+{
+    UiSpectrum_Clear();
+    for (uint16_t pos = 0; pos < ts.Layout->MENUSIZE; pos++)
+    {
+        char label[16];
+        snprintf(label, sizeof(label), "Menu Item %u", pos + 1);
+        UiLcdHy28_PrintText(ts.Layout->MENU_IND.x, ts.Layout->MENU_IND.y + (12 * pos), label, White, Black, 0);
+        UiLcdHy28_PrintTextRight(ts.Layout->MENU_CURSOR_X - 4, ts.Layout->MENU_IND.y + (12 * pos), "  1", White, Black, 0);
+    }
+}
+
+static const BenchLcdAction bench_lcd_actions[] =
+{
+    { "clear",          BenchLcd_Clear },
+    { "text",           BenchLcd_Text },
+    { "lines",          BenchLcd_Lines },
+    { "clear2",         BenchLcd_Clear },
+    { "freq_draw",      BenchLcd_FreqDraw },
+    { "freq_step",      BenchLcd_FreqStep },
+    { "freq_same",      BenchLcd_FreqSame },
+    { "freq_band",      BenchLcd_FreqBand },
+    { "boxes",          BenchLcd_Boxes },
+    { "boxes_active",   BenchLcd_BoxesActive },
+    { "boxes_same",     BenchLcd_BoxesActive },
+    { "scope_init",     BenchLcd_ScopeInit },
+    { "scope",          BenchLcd_SpectrumFrames },
+    { "wfall_init",     BenchLcd_WaterfallInit },
+    { "wfall",          BenchLcd_SpectrumFrames },
+    { "dual_init",      BenchLcd_DualInit },
+    { "dual",           BenchLcd_SpectrumFrames },
+    { "scroll_init",    BenchLcd_ScrollInit },
+    { "scroll",         BenchLcd_SpectrumFrames },
+    { "menu_open",      BenchLcd_MenuOpen },
+    { NULL,             NULL }
+};
+
+/**
+ * @brief the state after startup of the radio, with the emulated display attached
+ * @returns false if the display driver does not detect the display
+ */
+static bool BenchLcd_Init(const BenchLcdDisplay* display)
+{
+    HostLcd_Attach(display->device_code);
+
+    HostDsp_TransceiverStateInit();
+    HostDsp_RadioInit();
+    HostDsp_SetDemodMode(DEMOD_USB, DigitalMode_None, -1, 2700);
+    df.tune_new = 14074000 * TUNE_MULT;
+    // normally calculated by the radio management from the codec gain, the spectrum divides by it
+    ads.codec_gain_calc = 1;
+    bench_lcd_noise = 1;
+    // the spectrum starts as after power up, not with the averages, AGC and waterfall of the previous display
+    memset(&sd, 0, sizeof(sd));
+
+    UiLcdHy28_Init();
+    UiLcdHy28_RetainedReset();
+    ts.display = &mchf_display;
+
+    // the defaults of the configuration, see ui_configuration.c
+    ts.flags1 = FLAGS1_CONFIG_DEFAULT;
+    ts.scope_speed = SPECTRUM_SCOPE_SPEED_DEFAULT;
+    ts.spectrum_filter = SPECTRUM_FILTER_DEFAULT;
+    ts.spectrum_avg_mode = SPECTRUM_AVG_DEFAULT;
+    ts.spectrum_db_scale = DB_DIV_ADJUST_DEFAULT;
+    ts.spectrum_agc_rate = SPECTRUM_SCOPE_AGC_DEFAULT;
+    ts.spectrum_size = SPECTRUM_SIZE_DEFAULT;
+    ts.scope_trace_colour = SPEC_COLOUR_TRACE_DEFAULT;
+    ts.scope_trace_BW_colour = SPEC_COLOUR_TRACEBW_DEFAULT;
+    ts.scope_backgr_BW_colour = SPEC_COLOUR_BACKGRBW_DEFAULT;
+    ts.scope_grid_colour = SPEC_COLOUR_GRID_DEFAULT;
+    ts.spectrum_centre_line_colour = SPEC_COLOUR_GRID_DEFAULT;
+    ts.spectrum_freqscale_colour = SPEC_COLOUR_SCALE_DEFAULT;
+    ts.waterfall.color_scheme = WATERFALL_COLOR_DEFAULT;
+    ts.waterfall.vert_step_size = WATERFALL_STEP_SIZE_DEFAULT;
+    ts.waterfall.contrast = WATERFALL_CONTRAST_DEFAULT;
+    ts.waterfall.speed = WATERFALL_SPEED_DEFAULT;
+
+    return mchf_display.DeviceCode == display->device_code;
+}
+
+// the digital mode decoders print their text, not of interest here
+static void BenchLcd_TextOut(char ch)
+{
+}
+
+/**
+ * @returns true if the hash matches the one in the reference file, with update set it is stored there instead
+ */
+static bool BenchLcd_Compare(char refs[][64], uint16_t idx, const char* name, uint32_t hash, bool update)
+{
+    char line[64];
+    snprintf(line, sizeof(line), "%s %08x", name, hash);
+
+    bool retval = strcmp(refs[idx], line) == 0;
+    if (update)
+    {
+        strcpy(refs[idx], line);
+        retval = true;
+    }
+    return retval;
+}
+
+static void BenchLcd_Usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -d <dir>     reference directory (default %s)\n"
+            "  -o <dir>     write a PPM snapshot after each action\n"
+            "  -u           write the references instead of comparing\n",
+            prog, BENCH_REF_DIR);
+}
+
+int main(int argc, char* argv[])
+{
+    const char* ref_dir = BENCH_REF_DIR;
+    const char* snap_dir = NULL;
+    bool update = false;
+    int failed = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "d:o:u")) != -1)
+    {
+        switch (opt)
+        {
+        case 'd':
+            ref_dir = optarg;
+            break;
+        case 'o':
+            snap_dir = optarg;
+            break;
+        case 'u':
+            update = true;
+            break;
+        default:
+            BenchLcd_Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    HostDsp_TextOut = BenchLcd_TextOut;
+
+    printf("%-8s %-13s %8s %8s %8s %8s %9s  %s\n", "display", "action", "windows", "pixels", "changed", "fsmc", "spi bytes", "result");
+    for (uint16_t disp = 0; disp < sizeof(bench_lcd_displays) / sizeof(bench_lcd_displays[0]); disp++)
+    {
+        const BenchLcdDisplay* display = &bench_lcd_displays[disp];
+        static char refs[BENCH_LCD_ACTIONS_MAX][64];
+        char ref_path[256];
+
+        memset(refs, 0, sizeof(refs));
+        snprintf(ref_path, sizeof(ref_path), "%s/lcd_%s.txt", ref_dir, display->name);
+        if (update == false)
+        {
+            FILE* f = fopen(ref_path, "r");
+            if (f != NULL)
+            {
+                for (uint16_t idx = 0; idx < BENCH_LCD_ACTIONS_MAX && fgets(refs[idx], sizeof(refs[idx]), f) != NULL; idx++)
+                {
+                    refs[idx][strcspn(refs[idx], "\r\n")] = '\0';
+                }
+                fclose(f);
+            }
+            else
+            {
+                printf("  %s: %s\n", ref_path, strerror(errno));
+            }
+        }
+
+        if (BenchLcd_Init(display) == false)
+        {
+            printf("%-8s %-13s %44s  %s\n", display->name, "detect", "", "FAILED");
+            failed++;
+            continue;
+        }
+
+        uint16_t idx = 0;
+        for (const BenchLcdAction* a = bench_lcd_actions; a->name != NULL; a++, idx++)
+        {
+            HostLcd_StatsReset();
+            a->run();
+            const HostLcd_Stats* stats = HostLcd_StatsGet();
+
+            const bool ok = BenchLcd_Compare(refs, idx, a->name, HostLcd_Hash(), update);
+            printf("%-8s %-13s %8u %8u %8u %8u %9u  %s\n", display->name, a->name,
+                    stats->windows, stats->pixels, stats->pixels_changed,
+                    HostLcd_BusWords(stats), HostLcd_SpiBytes(stats),
+                    update ? "updated" : ok ? "ok" : "FAILED");
+            if (ok == false)
+            {
+                failed++;
+            }
+
+            if (snap_dir != NULL)
+            {
+                char path[256];
+                snprintf(path, sizeof(path), "%s/lcd_%s_%02u_%s.ppm", snap_dir, display->name, idx, a->name);
+                if (HostLcd_WritePpm(path) == false)
+                {
+                    printf("  %s: %s\n", path, strerror(errno));
+                }
+            }
+        }
+
+        if (update)
+        {
+            FILE* f = fopen(ref_path, "w");
+            if (f != NULL)
+            {
+                for (uint16_t i = 0; i < idx; i++)
+                {
+                    fprintf(f, "%s\n", refs[i]);
+                }
+                fclose(f);
+            }
+            else
+            {
+                printf("  %s: %s\n", ref_path, strerror(errno));
+                failed++;
+            }
+        }
+    }
+
+    return failed != 0;
+}
@@ -29,6 +29,7 @@
 
 #include "audio_driver.h"
 #include "audio_nr.h"
+#include "audio_polyphase.h"
 #include "audio_management.h"
 #include "radio_management.h"
 #include "usbd_audio_if.h"
@@ -39,7 +40,9 @@
 #include "uhsdr_hw_i2s.h"
 #include "rtty.h"
 #include "psk.h"
+#include "psk_skimmer.h"
 #include "cw_decoder.h"
+#include "cw_bank.h"
 #include "freedv_uhsdr.h"
 
 
@@ -102,6 +105,8 @@ typedef struct
 	float32_t hang_backmult;
 	float32_t onemhang_backmult;
 	float32_t hang_decay_mult;
+	float32_t noise_thresh;     // threshold in dB derived from the noise floor, used if ts.agc_wdsp_thresh_auto is set
+	bool noise_thresh_valid;
 } agc_variables_t;
 
 agc_variables_t agc_wdsp;
@@ -184,18 +189,31 @@ float32_t           __MCHF_SPECIALMEM decimState_I[FIR_RXAUDIO_BLOCK_SIZE + 43];
 // Audio RX - Decimator in Q-path
 static  arm_fir_decimate_instance_f32   DECIMATE_RX_Q;
 float32_t           __MCHF_SPECIALMEM decimState_Q[FIR_RXAUDIO_BLOCK_SIZE + 43];
-
-// Decimator for Zoom FFT
-static	arm_fir_decimate_instance_f32	DECIMATE_ZOOM_FFT_I;
-float32_t			__MCHF_SPECIALMEM decimZoomFFTIState[FIR_RXAUDIO_BLOCK_SIZE + FIR_RXAUDIO_NUM_TAPS];
-
-// Decimator for Zoom FFT
-static	arm_fir_decimate_instance_f32	DECIMATE_ZOOM_FFT_Q;
-float32_t			__MCHF_SPECIALMEM decimZoomFFTQState[FIR_RXAUDIO_BLOCK_SIZE + FIR_RXAUDIO_NUM_TAPS];
+// Audio RX - Decimator for I and Q in one pass, used instead of the two above unless the filter path asks for cmsis_resampler
+static  PolyphaseDecimateIQ             DECIMATE_RX_IQ;
+float32_t           __MCHF_SPECIALMEM decimState_IQ[2 * (FIR_RXAUDIO_BLOCK_SIZE + 43)];
+static  bool                            rx_resampler_polyphase;
+// Audio RX - Hilbert filter and decimator fused into one filter for the wide SSB/CW paths, see FilterPathDescriptor.hilbert_decimate
+#define RX_HILBERT_DECIMATE_NUM_TAPS_MAX (IQ_RX_NUM_TAPS + FIR_RXAUDIO_NUM_TAPS - 1)
+static  PolyphaseDecimateHilbert        DECIMATE_RX_HILBERT;
+float32_t           __MCHF_SPECIALMEM decimHilbertCoeffs_I[RX_HILBERT_DECIMATE_NUM_TAPS_MAX];
+float32_t           __MCHF_SPECIALMEM decimHilbertCoeffs_Q[RX_HILBERT_DECIMATE_NUM_TAPS_MAX];
+float32_t           __MCHF_SPECIALMEM decimHilbertState[2 * (FIR_RXAUDIO_BLOCK_SIZE + RX_HILBERT_DECIMATE_NUM_TAPS_MAX)];
+static  bool                            rx_hilbert_decimate;
+
+// Decimator for Zoom FFT, a half band stage per magnification step
+static  PolyphaseHalfbandCascade        DECIMATE_ZOOM_FFT;
+float32_t           __MCHF_SPECIALMEM decimZoomFFTState[4 * ((POLYPHASE_HALFBAND_STAGES_MAX - 1) * FIR_ZOOM_HALFBAND_NUM_TAPS + FIR_ZOOM_HALFBAND_LAST_NUM_TAPS)];
 
 // Audio RX - Interpolator
 static	arm_fir_interpolate_instance_f32 INTERPOLATE_RX[NUM_AUDIO_CHANNELS];
 float32_t			__MCHF_SPECIALMEM interpState[NUM_AUDIO_CHANNELS][FIR_RXAUDIO_BLOCK_SIZE + FIR_RXAUDIO_NUM_TAPS];
+#ifdef USE_TWO_CHANNEL_AUDIO
+// Audio RX - Interpolator for both channels in one pass
+static	PolyphaseInterpolateIQ INTERPOLATE_RX_STEREO;
+float32_t			__MCHF_SPECIALMEM interpState_Stereo[2 * (FIR_RXAUDIO_BLOCK_SIZE + FIR_RXAUDIO_NUM_TAPS)];
+static	float32_t	interpCoeffs_Stereo[FIR_RXAUDIO_NUM_TAPS];
+#endif
 
 
 
@@ -294,35 +312,6 @@ static arm_biquad_casd_df1_inst_f32 IIR_TX_biquad =
         } // 3 x 4 = 12 state variables
 };
 
-// variables for ZoomFFT lowpass filtering
-static arm_biquad_casd_df1_inst_f32 IIR_biquad_Zoom_FFT_I =
-{
-        .numStages = 4,
-        .pCoeffs = (float32_t *)(float32_t [])
-        {
-            1,0,0,0,0,  1,0,0,0,0 // passthru
-        }, // 2 x 5 = 10 coefficients
-
-        .pState = (float32_t *)(float32_t [])
-        {
-            0,0,0,0,   0,0,0,0,    0,0,0,0,   0,0,0,0
-        } // 4 x 4 = 16 state variables
-};
-
-static arm_biquad_casd_df1_inst_f32 IIR_biquad_Zoom_FFT_Q =
-{
-        .numStages = 4,
-        .pCoeffs = (float32_t *)(float32_t [])
-        {
-            1,0,0,0,0,  1,0,0,0,0 // passthru
-        }, // 2 x 5 = 10 coefficients
-
-        .pState = (float32_t *)(float32_t [])
-        {
-            0,0,0,0,   0,0,0,0,   0,0,0,0,   0,0,0,0
-        } // 4 x 4 = 16 state variables
-};
-
 // sr = 12ksps, Fstop = 2k7, we lowpass-filtered the audio already in the main aido path (IIR),
 // so only the minimum size filter (4 taps) is used here
 static float32_t NR_decimate_coeffs [4] = {0.099144206287089282, 0.492752007869707798, 0.492752007869707798, 0.099144206287089282};
@@ -334,162 +323,6 @@ static float32_t NR_interpolate_coeffs [NR_INTERPOLATE_NO_TAPS] = {-495.07575866
 // 6ksps, Fstop = 2k65, KAISER
 //static float32_t NR_interpolate_coeffs [NR_INTERPOLATE_NO_TAPS] = {-903.6623076669911820E-6, 0.001594488333496738,-0.002320508982899863, 0.002832351511451895,-0.002797105957386612, 0.001852836963547170, 308.6133633078010230E-6,-0.003842008360761881, 0.008649943961959465,-0.014305251526745446, 0.020012524686320185,-0.024618364878703208, 0.026664997481476788,-0.024458388333600374, 0.016080841021827566, 818.1032282579135430E-6,-0.029933800539235892, 0.079833661336890141,-0.182038248016552551, 0.626273078268197225, 0.626273078268197225,-0.182038248016552551, 0.079833661336890141,-0.029933800539235892, 818.1032282579135430E-6, 0.016080841021827566,-0.024458388333600374, 0.026664997481476788,-0.024618364878703208, 0.020012524686320185,-0.014305251526745446, 0.008649943961959465,-0.003842008360761881, 308.6133633078010230E-6, 0.001852836963547170,-0.002797105957386612, 0.002832351511451895,-0.002320508982899863, 0.001594488333496738,-903.6623076669911820E-6};
 
-static float32_t* mag_coeffs[MAGNIFY_NUM] =
-
-{
-
-        // for Index 0 [1xZoom == no zoom] the mag_coeffs will a NULL  ptr, since the filter is not going to be used in this  mode!
-        (float32_t*)NULL,
-
-        (float32_t*)(const float32_t[]){
-            // 2x magnify - index 1
-            // 12kHz, sample rate 48k, 60dB stopband, elliptic
-            // a1 and coeffs[A2] negated! order: coeffs[B0], coeffs[B1], coeffs[B2], a1, coeffs[A2]
-            // Iowa Hills IIR Filter Designer, DD4WH Aug 16th 2016
-            0.228454526413293696,
-            0.077639329099949764,
-            0.228454526413293696,
-            0.635534925142242080,
-            -0.170083307068779194,
-
-            0.436788292542003964,
-            0.232307972937606161,
-            0.436788292542003964,
-            0.365885230717786780,
-            -0.471769788739400842,
-
-            0.535974654742658707,
-            0.557035600464780845,
-            0.535974654742658707,
-            0.125740787233286133,
-            -0.754725697183384336,
-
-            0.501116342273565607,
-            0.914877831284765408,
-            0.501116342273565607,
-            0.013862536615004284,
-            -0.930973052446900984  },
-
-            (float32_t*)(const float32_t[]){
-                // 4x magnify - index 2
-                // 6kHz, sample rate 48k, 60dB stopband, elliptic
-                // a1 and coeffs[A2] negated! order: coeffs[B0], coeffs[B1], coeffs[B2], a1, coeffs[A2]
-                // Iowa Hills IIR Filter Designer, DD4WH Aug 16th 2016
-                0.182208761527446556,
-                -0.222492493114674145,
-                0.182208761527446556,
-                1.326111070880959810,
-                -0.468036100821178802,
-
-                0.337123762652097259,
-                -0.366352718812586853,
-                0.337123762652097259,
-                1.337053579516321200,
-                -0.644948386007929031,
-
-                0.336163175380826074,
-                -0.199246162162897811,
-                0.336163175380826074,
-                1.354952684569386670,
-                -0.828032873168141115,
-
-                0.178588201750411041,
-                0.207271695028067304,
-                0.178588201750411041,
-                1.386486967455699220,
-                -0.950935065984588657  },
-
-                (float32_t*)(const float32_t[]){
-                    // 8x magnify - index 3
-                    // 3kHz, sample rate 48k, 60dB stopband, elliptic
-                    // a1 and coeffs[A2] negated! order: coeffs[B0], coeffs[B1], coeffs[B2], a1, coeffs[A2]
-                    // Iowa Hills IIR Filter Designer, DD4WH Aug 16th 2016
-                    0.185643392652478922,
-                    -0.332064345389014803,
-                    0.185643392652478922,
-                    1.654637402827731090,
-                    -0.693859842743674182,
-
-                    0.327519300813245984,
-                    -0.571358085216950418,
-                    0.327519300813245984,
-                    1.715375037176782860,
-                    -0.799055553586324407,
-
-                    0.283656142708241688,
-                    -0.441088976843048652,
-                    0.283656142708241688,
-                    1.778230635987093860,
-                    -0.904453944560528522,
-
-                    0.079685368654848945,
-                    -0.011231810140649204,
-                    0.079685368654848945,
-                    1.825046003243238070,
-                    -0.973184930412286708  },
-
-                    (float32_t*)(const float32_t[]){
-                        // 16x magnify - index 4
-                        // 1k5, sample rate 48k, 60dB stopband, elliptic
-                        // a1 and coeffs[A2] negated! order: coeffs[B0], coeffs[B1], coeffs[B2], a1, coeffs[A2]
-                        // Iowa Hills IIR Filter Designer, DD4WH Aug 16th 2016
-                        0.194769868656866380,
-                        -0.379098413160710079,
-                        0.194769868656866380,
-                        1.824436402073870810,
-                        -0.834877726226893380,
-
-                        0.333973874901496770,
-                        -0.646106479315673776,
-                        0.333973874901496770,
-                        1.871892825636887640,
-                        -0.893734096124207178,
-
-                        0.272903880596429671,
-                        -0.513507745397738469,
-                        0.272903880596429671,
-                        1.918161772571113750,
-                        -0.950461788366234739,
-
-                        0.053535383722369843,
-                        -0.069683422367188122,
-                        0.053535383722369843,
-                        1.948900719896301760,
-                        -0.986288064973853129 },
-
-                        (float32_t*)(const float32_t[]){
-                            // 32x magnify - index 5
-                            // 750Hz, sample rate 48k, 60dB stopband, elliptic
-                            // a1 and coeffs[A2] negated! order: coeffs[B0], coeffs[B1], coeffs[B2], a1, coeffs[A2]
-                            // Iowa Hills IIR Filter Designer, DD4WH Aug 16th 2016
-                            0.201507402588557594,
-                            -0.400273615727755550,
-                            0.201507402588557594,
-                            1.910767558906650840,
-                            -0.913508748356010480,
-
-                            0.340295203367131205,
-                            -0.674930558961690075,
-                            0.340295203367131205,
-                            1.939398230905991390,
-                            -0.945058078678563840,
-
-                            0.271859921641011359,
-                            -0.535453706265515361,
-                            0.271859921641011359,
-                            1.966439529620203740,
-                            -0.974705666636711099,
-
-                            0.047026497485465592,
-                            -0.084562104085501480,
-                            0.047026497485465592,
-                            1.983564238653704900,
-                            -0.993055129539134551 }
-
-
-
-};
-
 //******* From here 2 set of filters for the I/Q FreeDV aliasing filter**********
 
 // I- and Q- Filter instances for FreeDV downsampling aliasing filters
@@ -645,6 +478,8 @@ void AudioDriver_Init(void)
 
     RttyDecoder_Init();
     PskDecoder_Init();
+    PskSkimmer_Init();
+    CwBank_Init();
 
     // Audio filter disabled
     ts.dsp_inhibit = 1;
@@ -741,6 +576,45 @@ void AudioDriver_Init(void)
 
 }
 
+/*
+ * SAM / AM block engine
+ * The PLL is a feedback loop and has to run sample by sample. Everything which does not feed back into it,
+ * the sideband separating allpass chains, the output combination and the fade leveler, runs afterwards as
+ * block passes over the samples the PLL loop produced. The loop itself uses a table NCO and a polynomial
+ * atan2 instead of sincosf / atan2f.
+ */
+#define SAM_NCO_TABLE_SIZE  512     // power of 2, linear interpolation gives better than 90dB spur suppression
+
+typedef struct
+{
+    float32_t   phs;
+    float32_t   omega2;
+    float32_t   fil_out;
+    float32_t   lowpass;
+    uint16_t    count;
+
+    float32_t   dsI;                // delayed sample, I path
+    float32_t   dsQ;                // delayed sample, Q path
+    float32_t   allpass[4][SAM_PLL_HILBERT_STAGES][4];  // per filter and stage: x[n-1], x[n-2], y[n-1], y[n-2]
+} SamPllState;
+
+static SamPllState sam_pll;
+
+// sine table covering 1 1/4 periods, cos(x) = sin(x + PI/2)
+static float32_t __MCHF_SPECIALMEM sam_nco_table[SAM_NCO_TABLE_SIZE + SAM_NCO_TABLE_SIZE / 4 + 1];
+
+// block buffers of the SAM engine, filled by the PLL loop: ai delayed, bi, bq delayed, aq and the in-phase correlation
+static float32_t __MCHF_SPECIALMEM sam_sb_buffer[4][IQ_BLOCK_SIZE];
+static float32_t __MCHF_SPECIALMEM sam_corr_buffer[IQ_BLOCK_SIZE];
+
+static void AudioDriver_SamInitNco(void)
+{
+    for (int i = 0; i < SAM_NCO_TABLE_SIZE + SAM_NCO_TABLE_SIZE / 4 + 1; i++)
+    {
+        sam_nco_table[i] = sinf(2.0 * PI * i / SAM_NCO_TABLE_SIZE);
+    }
+}
+
 void AudioDriver_SetSamPllParameters()
 {
 
@@ -783,6 +657,9 @@ void AudioDriver_SetRxAudioProcessingSAM(uint8_t dmod_mode)
 {
 
     AudioDriver_SetSamPllParameters();
+    AudioDriver_SamInitNco();
+    // omega2 is scaled by the decimation rate, a new filter path has to lock again from the center
+    memset(&sam_pll, 0, sizeof(sam_pll));
 
     //sideband separation, these values never change
     adb.c0[0] = -0.328201924180698;
@@ -1190,19 +1067,6 @@ void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr)
     // initialize the goertzel filter used to detect CW signals at a given frequency in the audio stream
     CwDecode_FilterInit();
 
-    // this sets the coefficients for the ZoomFFT decimation filter
-    // according to the desired magnification mode sd.magnify
-    // sd.magnify 0 = 1x magnification
-    // sd.magnify 1 = 2x
-    // sd.magnify 2 = 4x
-    // sd.magnify 3 = 8x
-    // sd.magnify 4 = 16x
-    // sd.magnify 5 = 32x
-    //
-    // for 0 the mag_coeffs will a NULL  ptr, since the filter is not going to be used in this  mode!
-    IIR_biquad_Zoom_FFT_I.pCoeffs = mag_coeffs[sd.magnify];
-    IIR_biquad_Zoom_FFT_Q.pCoeffs = mag_coeffs[sd.magnify];
-
     /*+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
      * End of coefficient calculation and setting for cascaded biquad
      ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++*/
@@ -1350,26 +1214,17 @@ void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr)
 //    ads.agc_decimation_scaling = ads.decimation_rate;
 //    ads.agc_delay_buflen = AUDIO_DELAY_BUFSIZE/(ulong)ads.decimation_rate;	// calculate post-AGC delay based on post-decimation sampling rate
 
-    // Set up ZOOM FFT FIR decimation filters
-    // switch right FIR decimation filter depending on sd.magnify
+    // Set up ZOOM FFT decimation
+    // one half band decimation by 2 for each magnification step sd.magnify, 0 = 1x ... 7 = 128x
     if(sd.magnify > MAGNIFY_MAX)
     {
         sd.magnify = MAGNIFY_MIN;
     }
 
-    arm_fir_decimate_init_f32(&DECIMATE_ZOOM_FFT_I,
-            FirZoomFFTDecimate[sd.magnify].numTaps,
-            (1 << sd.magnify),          // Decimation factor
-            FirZoomFFTDecimate[sd.magnify].pCoeffs,
-            decimZoomFFTIState,            // Filter state variables
-            FIR_RXAUDIO_BLOCK_SIZE);
-
-    arm_fir_decimate_init_f32(&DECIMATE_ZOOM_FFT_Q,
-            FirZoomFFTDecimate[sd.magnify].numTaps,
-            (1 << sd.magnify),          // Decimation factor
-            FirZoomFFTDecimate[sd.magnify].pCoeffs,
-            decimZoomFFTQState,            // Filter state variables
-            FIR_RXAUDIO_BLOCK_SIZE);
+    AudioPolyphase_HalfbandCascadeInit(&DECIMATE_ZOOM_FFT, sd.magnify,
+            FIR_ZOOM_HALFBAND_NUM_TAPS, FirZoomFFTHalfband,
+            FIR_ZOOM_HALFBAND_LAST_NUM_TAPS, FirZoomFFTHalfbandLast,
+            decimZoomFFTState);
 
     // Set up RX decimation/filter
     if (FilterPathInfo[ts.filter_path].dec != NULL)
@@ -1403,6 +1258,30 @@ void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr)
                 dec->pCoeffs,       // Filter coefficients
                 decimState_Q,            // Filter state variables
                 FIR_RXAUDIO_BLOCK_SIZE);
+
+        AudioPolyphase_DecimateIQInit(&DECIMATE_RX_IQ,
+                dec->numTaps,
+                ads.decimation_rate,
+                dec->pCoeffs,
+                decimState_IQ,
+                FIR_RXAUDIO_BLOCK_SIZE);
+
+        rx_hilbert_decimate = FilterPathInfo[ts.filter_path].hilbert_decimate
+                && FilterPathInfo[ts.filter_path].FIR_numTaps + dec->numTaps - 1 <= RX_HILBERT_DECIMATE_NUM_TAPS_MAX;
+        if (rx_hilbert_decimate)
+        {
+            AudioPolyphase_DecimateHilbertInit(&DECIMATE_RX_HILBERT,
+                    FilterPathInfo[ts.filter_path].FIR_numTaps,
+                    FilterPathInfo[ts.filter_path].FIR_I_coeff_file,
+                    FilterPathInfo[ts.filter_path].FIR_Q_coeff_file,
+                    dec->numTaps,
+                    ads.decimation_rate,
+                    dec->pCoeffs,
+                    decimHilbertCoeffs_I,
+                    decimHilbertCoeffs_Q,
+                    decimHilbertState,
+                    FIR_RXAUDIO_BLOCK_SIZE);
+        }
     }
     else
     {
@@ -1410,7 +1289,9 @@ void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr)
         DECIMATE_RX_I.pCoeffs = NULL;
         DECIMATE_RX_Q.numTaps = 0;
         DECIMATE_RX_Q.pCoeffs = NULL;
+        rx_hilbert_decimate = false;
     }
+    rx_resampler_polyphase = FilterPathInfo[ts.filter_path].cmsis_resampler == false;
 
     // Set up RX interpolation/filter
     // NOTE:  Phase Length MUST be an INTEGER and is the number of taps divided by the decimation rate, and it must be greater than 1.
@@ -1430,6 +1311,17 @@ void AudioDriver_SetRxAudioProcessing(uint8_t dmod_mode, bool reset_dsp_nr)
             INTERPOLATE_RX[chan].pCoeffs = NULL;
         }
     }
+#ifdef USE_TWO_CHANNEL_AUDIO
+    if (FilterPathInfo[ts.filter_path].interpolate != NULL)
+    {
+        AudioPolyphase_InterpolateIQInit(&INTERPOLATE_RX_STEREO,
+                ads.decimation_rate,
+                FilterPathInfo[ts.filter_path].interpolate->phaseLength,
+                FilterPathInfo[ts.filter_path].interpolate->pCoeffs,
+                interpCoeffs_Stereo,
+                interpState_Stereo, IQ_BLOCK_SIZE);
+    }
+#endif
 
     arm_fir_decimate_init_f32(&DECIMATE_NR, 4, 2, NR_decimate_coeffs, decimNRState, FIR_RXAUDIO_BLOCK_SIZE);
     // should be a very light lowpass @2k7
@@ -1581,6 +1473,24 @@ static void AudioDriver_NoiseBlanker(AudioSample_t * const src, int16_t blockSiz
 }
 #endif
 
+/**
+ * @brief RX decimation of two channels (I/Q or left/right audio) in place, with the filter of the current filter path
+ * runs the polyphase I/Q bank unless the filter path selects the separate CMSIS instances
+ * @param blockSize input samples per channel, the output has blockSize / ads.decimation_rate
+ */
+static void AudioDriver_RxDecimateIQ(float32_t* i_buffer, float32_t* q_buffer, uint16_t blockSize)
+{
+    if (rx_resampler_polyphase)
+    {
+        AudioPolyphase_DecimateIQ(&DECIMATE_RX_IQ, i_buffer, q_buffer, i_buffer, q_buffer, blockSize);
+    }
+    else
+    {
+        arm_fir_decimate_f32(&DECIMATE_RX_I, i_buffer, i_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
+        arm_fir_decimate_f32(&DECIMATE_RX_Q, q_buffer, q_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
+    }
+}
+
 //
 //*----------------------------------------------------------------------------
 //* Function Name       : audio_rx_freq_conv [KA7OEI]
@@ -1598,6 +1508,7 @@ static void AudioDriver_FreqConversion(float32_t* i_buffer, float32_t* q_buffer,
     static float32_t                   Osc_Q_buffer[IQ_BLOCK_SIZE];
 
     assert(blockSize <= IQ_BLOCK_SIZE);
+    profileStageStart(ProfileFreqConversion);
 
 
     //
@@ -1748,6 +1659,7 @@ static void AudioDriver_FreqConversion(float32_t* i_buffer, float32_t* q_buffer,
             arm_sub_f32(f_buffer, e_buffer, i_buffer, blockSize);	// difference for Q channel
         }
     }
+    profileStageStop(ProfileFreqConversion);
 }
 
 #ifdef USE_FREEDV
@@ -2006,23 +1918,10 @@ return true;
 #ifdef USE_RTTY_PROCESSOR
 static void AudioDriver_RxProcessor_Rtty(float32_t * const src, int16_t blockSize)
 {
-
-    for (uint16_t idx = 0; idx < blockSize; idx++)
-    {
-        RttyDecoder_ProcessSample(src[idx]);
-    }
+    RttyDecoder_ProcessBlock(src, blockSize);
 }
 #endif
 
-static void AudioDriver_RxProcessor_Bpsk(float32_t * const src, int16_t blockSize)
-{
-
-    for (uint16_t idx = 0; idx < blockSize; idx++)
-    {
-        BpskDecoder_ProcessSample(src[idx]);
-    }
-}
-
 void AudioDriver_SetupAgcWdsp()
 {
     static bool initialised = false;
@@ -2153,7 +2052,8 @@ void AudioDriver_SetupAgcWdsp()
     //  max_gain = out_target / var_gain * powf (10.0, (thresh + noise_offset) / 20.0));
     agc_wdsp.tau_hang_decay = (float32_t)ts.agc_wdsp_tau_hang_decay / 1000.0;
     agc_wdsp.tau_decay = (float32_t)ts.agc_wdsp_tau_decay[ts.agc_wdsp_mode] / 1000.0;
-    agc_wdsp.max_gain = powf (10.0, (float32_t)ts.agc_wdsp_thresh / 20.0);
+    const float32_t thresh = (ts.agc_wdsp_thresh_auto && agc_wdsp.noise_thresh_valid) ? agc_wdsp.noise_thresh : (float32_t)ts.agc_wdsp_thresh;
+    agc_wdsp.max_gain = powf (10.0, thresh / 20.0);
     agc_wdsp.fixed_gain = agc_wdsp.max_gain / 10.0;
     // attack_buff_size is 48 for sample rate == 12000 and
     // 96 for sample rate == 24000
@@ -2208,6 +2108,45 @@ void AudioDriver_SetupAgcWdsp()
     agc_wdsp.hang_decay_mult = 1.0 - expf(-1.0 / (sample_rate * agc_wdsp.tau_hang_decay));
 }
 
+// the automatic threshold puts the knee this many dB above the rms noise, the envelope of noise has peaks well above its rms value
+#define AGC_WDSP_NOISE_MARGIN       10.0
+// the AGC is set up again only if the threshold derived from the noise changes by this many dB
+#define AGC_WDSP_NOISE_HYSTERESIS   2.0
+
+/**
+ * @brief keeps the AGC threshold (the knee) just above the noise if ts.agc_wdsp_thresh_auto is set
+ * Called by the spectrum display with every new noise floor estimate.
+ * @param noise_rms rms noise within the receive filter bandwidth, in units of the AGC input
+ */
+void AudioDriver_AgcWdspSetNoiseLevel(float32_t noise_rms)
+{
+    if (noise_rms > 0 && agc_wdsp.out_target > 0)
+    {
+        // the knee is the input level min_volts = out_target / (var_gain * max_gain)
+        float32_t thresh = 20.0 * log10f(agc_wdsp.out_target / (agc_wdsp.var_gain * noise_rms)) - AGC_WDSP_NOISE_MARGIN;
+
+        // same range as the manual setting
+        if (thresh < -20.0)
+        {
+            thresh = -20.0;
+        }
+        else if (thresh > 120.0)
+        {
+            thresh = 120.0;
+        }
+
+        if (agc_wdsp.noise_thresh_valid == false || fabsf(thresh - agc_wdsp.noise_thresh) >= AGC_WDSP_NOISE_HYSTERESIS)
+        {
+            agc_wdsp.noise_thresh = thresh;
+            agc_wdsp.noise_thresh_valid = true;
+            if (ts.agc_wdsp_thresh_auto)
+            {
+                AudioDriver_SetupAgcWdsp();
+            }
+        }
+    }
+}
+
 #ifdef USE_TWO_CHANNEL_AUDIO
 void AudioDriver_RxAgcWdsp(int16_t blockSize, float32_t *agcbuffer1, float32_t *agcbuffer2)
 #else
@@ -2592,8 +2531,71 @@ static void AudioDriver_RxAgcProcessor(int16_t blockSize, float32_t *agcbuffer)
 
 }
 #endif
-//
-//
+
+/**
+ * @brief atan2 approximation for the SAM phase detector and the FM discriminator
+ * maximum error about 1e-5 rad, i.e. about 100dB below full deviation
+ * returns 0 for (0,0) as atan2f does
+ */
+static inline float32_t AudioDriver_FastAtan2(float32_t y, float32_t x)
+{
+    const float32_t ax = fabsf(x);
+    const float32_t ay = fabsf(y);
+    const float32_t mx = ay > ax ? ay : ax;
+    const float32_t mn = ay > ax ? ax : ay;
+
+    if (mx == 0.0)
+    {
+        return 0.0;
+    }
+
+    const float32_t a = mn / mx;
+    const float32_t s = a * a;
+    float32_t r = ((((0.0208351 * s - 0.0851330) * s + 0.1801410) * s - 0.3302995) * s + 0.9998660) * a;
+
+    if (ay > ax)
+    {
+        r = PI / 2.0 - r;
+    }
+    if (x < 0.0)
+    {
+        r = PI - r;
+    }
+    return y < 0.0 ? -r : r;
+}
+
+/**
+ * @brief one sample through the FM squelch high pass, the lattice filter of arm_iir_lattice_f32 with a state of numStages values
+ * The state is that of IIR_Squelch_HPF, so the filter stays interchangeable with the CMSIS function.
+ */
+static inline float32_t AudioDriver_SquelchHpf(float32_t in)
+{
+    const float32_t* pk = IIR_Squelch_HPF.pkCoeffs;
+    const float32_t* pv = IIR_Squelch_HPF.pvCoeffs;
+    float32_t* state = IIR_Squelch_HPF.pState;
+    const uint16_t numStages = IIR_Squelch_HPF.numStages;
+
+    float32_t f = in;
+    float32_t acc = 0.0;
+
+    for (uint16_t j = 0; j < numStages; j++)
+    {
+        const float32_t g = state[j];
+        f = f - pk[j] * g;
+        const float32_t gnext = g + pk[j] * f;
+        acc += gnext * pv[j];
+        // g of stage j is the delayed input of stage j - 1 in the next sample, g of the last stage is not needed
+        if (j > 0)
+        {
+            state[j - 1] = gnext;
+        }
+    }
+    acc += f * pv[numStages];
+    state[numStages - 1] = f;
+
+    return acc;
+}
+
 //*----------------------------------------------------------------------------
 //* Function Name       : audio_demod_fm
 //* Object              : FM demodulator (October, 2015 - KA7OEI)
@@ -2605,8 +2607,7 @@ static void AudioDriver_RxAgcProcessor(int16_t blockSize, float32_t *agcbuffer)
 static void AudioDriver_DemodFM(const int16_t blockSize)
 {
 
-	float r, s, angle, x, y, a, b;
-	float32_t goertzel_buf[blockSize], squelch_buf[blockSize];
+	float r, s, b;
 	bool tone_det_enabled;
 	static float i_prev, q_prev, lpf_prev, hpf_prev_a, hpf_prev_b;// used in FM detection and low/high pass processing
 
@@ -2619,59 +2620,62 @@ static void AudioDriver_DemodFM(const int16_t blockSize)
 
 		tone_det_enabled = ts.fm_subaudible_tone_det_select ? 1 : 0;// set a quick flag for checking to see if tone detection is enabled
 
+		// high-pass audio only if we are un-squelched (to save processor time), otherwise mute it
+		// the decision is taken on the squelch and tone state of the previous block
+		const bool audio_open = ((!ads.fm_squelched) && (!tone_det_enabled))
+				|| ((ads.fm_subaudible_tone_detected) && (tone_det_enabled))
+				|| ((!ts.fm_sql_threshold));
+
+		// Goertzel tone detectors, their state is kept in registers during the block
+		Goertzel* g_high = &ads.fm_goertzel[FM_HIGH];
+		Goertzel* g_low = &ads.fm_goertzel[FM_LOW];
+		Goertzel* g_ctr = &ads.fm_goertzel[FM_CTR];
+		float32_t gh1 = g_high->buf[1], gh2 = g_high->buf[2];
+		float32_t gl1 = g_low->buf[1], gl2 = g_low->buf[2];
+		float32_t gc1 = g_ctr->buf[1], gc2 = g_ctr->buf[2];
+
+		float32_t squelch_sample = 0.0;
+
+		// discriminator, de-emphasis, squelch noise high pass, tone detection and audio high pass in one pass over the block
 		for (uint16_t i = 0; i < blockSize; i++)
 		{
 			// first, calculate "x" and "y" for the arctan2, comparing the vectors of present data with previous data
 
-			y = (i_prev * adb.q_buffer[i]) - (adb.i_buffer[i] * q_prev);
-			x = (i_prev * adb.i_buffer[i]) + (adb.q_buffer[i] * q_prev);
-
-			/*        //
-			  we do not use this approximation any more, because it does not contribute significantly to saving processor cycles,
-			  and does not deliver as clean audio as we would expect.
-			  with atan2f the audio (and especially the hissing noise!) is much cleaner, DD4WH
-
-			 // What follows is adapted from "Fixed-Point Atan2 With Self Normalization", public domain code by "Jim Shima".
-			 // The result is "approximate" - but plenty good enough for speech-grade communications!
-			 //
-			 // Do calculation of arc-tangent (with quadrant preservation) of of I and Q channels, comparing with previous sample.
-			 // Because the result is absolute (we are using ratios!) there is no need to apply any sort of amplitude limiting
-			 //
-			 abs_y = fabs(y) + 2e-16;		// prevent us from taking "zero divided by zero" (indeterminate value) by setting this to be ALWAYS at least slightly higher than zero
-			 //
-			 if(x >= 0)	 					// Quadrant 1 or 4
-			 {
-			 r = (x - abs_y) / (x + abs_y);
-			 angle = FM_DEMOD_COEFF1 - FM_DEMOD_COEFF1 * r;
-			 }
-			 else	 						// Quadrant 2 or 3
-			 {
-			 r = (x + abs_y) / abs_y - x;
-			 angle = FM_DEMOD_COEFF2 - FM_DEMOD_COEFF1 * r;
-			 }
-			 //
-			 if (y < 0)						// Quadrant 3 or 4 - flip sign
-			 {
-			 angle = -angle;
-			 }
-
-			 */
-			angle = atan2f(y, x);
+			const float32_t y = (i_prev * adb.q_buffer[i]) - (adb.i_buffer[i] * q_prev);
+			const float32_t x = (i_prev * adb.i_buffer[i]) + (adb.q_buffer[i] * q_prev);
+
+			// the polynomial approximation is some 100dB below full deviation, which keeps the audio (and the hiss!) as clean as with atan2f
+			const float32_t angle = AudioDriver_FastAtan2(y, x);
 
 			// we now have our audio in "angle"
-			squelch_buf[i] = angle;	// save audio in "d" buffer for squelch noise filtering/detection - done later
+			// high-pass it for squelch noise detection, we need look at only one representative sample per block
+			const float32_t hp = AudioDriver_SquelchHpf(angle);
+			if (i == 0)
+			{
+				squelch_sample = hp;
+			}
 
 			// Now do integrating low-pass filter to do FM de-emphasis
-			a = lpf_prev + (FM_RX_LPF_ALPHA * (angle - lpf_prev));	//
+			const float32_t a = lpf_prev + (FM_RX_LPF_ALPHA * (angle - lpf_prev));	//
 			lpf_prev = a;			// save "[n-1]" sample for next iteration
 
-			goertzel_buf[i] = a;	// save in "c" for subaudible tone detection
-
-			if (((!ads.fm_squelched) && (!tone_det_enabled))
-					|| ((ads.fm_subaudible_tone_detected) && (tone_det_enabled))
-					|| ((!ts.fm_sql_threshold)))// high-pass audio only if we are un-squelched (to save processor time)
+			if (tone_det_enabled)
 			{
+				// subaudible tone detection runs on the de-emphasized audio, see below
+				float32_t g0;
+				g0 = g_high->r * gh1 - gh2 + a;
+				gh2 = gh1;
+				gh1 = g0;
+				g0 = g_low->r * gl1 - gl2 + a;
+				gl2 = gl1;
+				gl1 = g0;
+				g0 = g_ctr->r * gc1 - gc2 + a;
+				gc2 = gc1;
+				gc1 = g0;
+			}
 
+			if (audio_open)
+			{
 				// Do differentiating high-pass filter to attenuate very low frequency audio components, namely subadible tones and other "speaker-rattling" components - and to remove any DC that might be present.
 				b = FM_RX_HPF_ALPHA * (hpf_prev_b + a - hpf_prev_a);// do differentiation
 				hpf_prev_a = a;		// save "[n-1]" samples for next iteration
@@ -2679,8 +2683,7 @@ static void AudioDriver_DemodFM(const int16_t blockSize)
 				//
 				adb.a_buffer[0][i] = b;// save demodulated and filtered audio in main audio processing buffer
 			}
-			else if ((ads.fm_squelched)
-					|| ((!ads.fm_subaudible_tone_detected) && (tone_det_enabled)))// were we squelched or tone NOT detected?
+			else
 			{
 				adb.a_buffer[0][i] = 0;// do not filter receive audio - fill buffer with zeroes to mute it
 			}
@@ -2688,53 +2691,18 @@ static void AudioDriver_DemodFM(const int16_t blockSize)
 			q_prev = adb.q_buffer[i];// save "previous" value of each channel to allow detection of the change of angle in next go-around
 			i_prev = adb.i_buffer[i];
 		}
-#if 0
-		if (!ts.agc_wdsp)
-		{
-			//
-			ads.am_fm_agc = sqrtf(
-					(q_prev * q_prev) + (i_prev * i_prev)) * FM_AGC_SCALING;// calculate amplitude of carrier to use for AGC indication only (we need it for nothing else!)
-			//
-			// Do "AGC" on FM signal:  Calculate/smooth signal level ONLY - no need for audio scaling
-			//
-			ads.agc_calc = ads.am_fm_agc * ads.agc_val;
-			//
-			if (ads.agc_calc < ads.agc_knee)// is audio below AGC "knee" value?
-			{
-				ads.agc_var = ads.agc_knee - ads.agc_calc;// calculate difference between agc value and "knee" value
-				ads.agc_var /= ads.agc_knee;// calculate ratio of difference between knee value and this value
-				ads.agc_val += ads.agc_val * AGC_DECAY_FM * ads.agc_var;// Yes - Increase gain for AGC DECAY (always fast in FM)
-			}
-			else
-			{
-				ads.agc_var = ads.agc_calc - ads.agc_knee;// calculate difference between agc value and "knee" value
-				ads.agc_var /= ads.agc_knee;// calculate ratio of difference between knee value and this value
-				ads.agc_val -= ads.agc_val * AGC_ATTACK_FM * ads.agc_var;// Fast attack to increase attenuation (do NOT scale w/decimation or else oscillation results)
-				if (ads.agc_val <= AGC_VAL_MIN)	// Prevent zero or "negative" gain values
-				{
-					ads.agc_val = AGC_VAL_MIN;
-				}
-			}
-			if (ads.agc_val >= ads.agc_rf_gain)	// limit AGC to reasonable values when low/no signals present
-			{
-				ads.agc_val = ads.agc_rf_gain;
-				if (ads.agc_val >= ads.agc_val_max)	// limit maximum gain under no-signal conditions
-				{
-					ads.agc_val = ads.agc_val_max;
-				}
-			}
-		}
-#endif
 
-		// *** Squelch Processing ***
-		arm_iir_lattice_f32(&IIR_Squelch_HPF, squelch_buf, squelch_buf,
-				blockSize);	// Do IIR high-pass filter on audio so we may detect squelch noise energy
+		g_high->buf[2] = gh2;
+		g_high->buf[1] = g_high->buf[0] = gh1;
+		g_low->buf[2] = gl2;
+		g_low->buf[1] = g_low->buf[0] = gl1;
+		g_ctr->buf[2] = gc2;
+		g_ctr->buf[1] = g_ctr->buf[0] = gc1;
 
+		// *** Squelch Processing ***
 		ads.fm_sql_avg = ((1 - FM_RX_SQL_SMOOTHING) * ads.fm_sql_avg)
-				+ (FM_RX_SQL_SMOOTHING * sqrtf(fabsf(squelch_buf[0])));// IIR filter squelch energy magnitude:  We need look at only one representative sample
+				+ (FM_RX_SQL_SMOOTHING * sqrtf(fabsf(squelch_sample)));// IIR filter squelch energy magnitude
 
-		//
-		// Squelch processing
 		//
 		// Determine if the (averaged) energy in "ads.fm_sql_avg" is above or below the squelch threshold
 		//
@@ -2808,21 +2776,12 @@ static void AudioDriver_DemodFM(const int16_t blockSize)
 			//
 			// (Yes, I know that below could be rewritten to be a bit more compact-looking, but it would not be much faster and it would be less-readable)
 			//
-			// Note that the "c" buffer contains audio that is somewhat low-pass filtered by the integrator, above
+			// Note that the detectors are fed with audio that is somewhat low-pass filtered by the integrator, above
 			//
 			gcount++;// this counter is used for the accumulation of data over multiple cycles
 			//
-			for (uint16_t i = 0; i < blockSize; i++)
-			{
-
-				// Detect above target frequency
-				AudioFilter_GoertzelInput(&ads.fm_goertzel[FM_HIGH],goertzel_buf[i]);
-				// Detect energy below target frequency
-				AudioFilter_GoertzelInput(&ads.fm_goertzel[FM_LOW],goertzel_buf[i]);
-				// Detect on-frequency energy
-				AudioFilter_GoertzelInput(&ads.fm_goertzel[FM_CTR],goertzel_buf[i]);
-			}
-
+			// the Goertzel inputs of this block were processed together with the demodulation
+			//
 			if (gcount >= FM_SUBAUDIBLE_GOERTZEL_WINDOW)// have we accumulated enough samples to do the final energy calculation?
 			{
 				s = AudioFilter_GoertzelEnergy(&ads.fm_goertzel[FM_HIGH]) + AudioFilter_GoertzelEnergy(&ads.fm_goertzel[FM_LOW]);
@@ -2976,37 +2935,52 @@ static void AudioDriver_IQPhaseAdjust(uint16_t txrx_mode, float32_t* i_buffer, f
 }
 
 
+/**
+ * @brief appends I/Q samples to the spectrum frame being filled, see SpectrumDisplay for the frame queue
+ * the FFT buffers are filled with Q & I, not I & Q
+ */
+static void AudioDriver_SpectrumCollectSamples(const float32_t* i_buffer, const float32_t* q_buffer, const uint16_t blockSize)
+{
+    for(int i = 0; i < blockSize; i++)
+    {
+        if (sd.frames_filled - sd.frames_consumed >= 2)
+        {
+            // both frames wait for the spectrum, drop samples until it releases one
+            break;
+        }
+
+        float32_t* frame = sd.FFT_Frame[sd.frames_filled & 1];
+        frame[sd.samp_ptr++] = q_buffer[i];    // get floating point data for FFT for spectrum scope/waterfall display
+        frame[sd.samp_ptr++] = i_buffer[i];
+
+        // On obtaining enough samples for spectrum scope/waterfall, hand the frame over and start the next one
+        if(sd.samp_ptr >= sd.fft_iq_len)
+        {
+            sd.samp_ptr = 0;
+            __DMB(); // the frame content has to be complete before the spectrum sees the new count
+            sd.frames_filled++;
+        }
+    }
+}
+
 static void AudioDriver_SpectrumNoZoomProcessSamples(const uint16_t blockSize)
 {
 
-    if(sd.reading_ringbuffer == false && sd.fft_iq_len > 0)
+    if(sd.fft_iq_len > 0)
     {
         if(sd.magnify == 0)        //
         {
-            for(int i = 0; i < blockSize; i++)
-            {
-                // Collect I/Q samples // why are the I & Q buffers filled with I & Q, the FFT buffers are filled with Q & I?
-                sd.FFT_RingBuffer[sd.samp_ptr] = adb.q_buffer[i];    // get floating point data for FFT for spectrum scope/waterfall display
-                sd.samp_ptr++;
-                sd.FFT_RingBuffer[sd.samp_ptr] = adb.i_buffer[i];
-                sd.samp_ptr++;
-
-                // On obtaining enough samples for spectrum scope/waterfall, update state machine, reset pointer and wait until we process what we have
-                if(sd.samp_ptr >= sd.fft_iq_len-1) //*2)
-                {
-                    sd.samp_ptr = 0;
-                }
-            }
+            AudioDriver_SpectrumCollectSamples(adb.i_buffer, adb.q_buffer, blockSize);
             sd.FFT_frequency = (ts.tune_freq / TUNE_MULT); // spectrum shows all, LO is center frequency;
         }
     }
 }
 static void AudioDriver_SpectrumZoomProcessSamples(const uint16_t blockSize)
 {
-    if(sd.reading_ringbuffer == false && sd.fft_iq_len > 0)
+    if(sd.fft_iq_len > 0)
     {
         if(sd.magnify != 0)        //
-            // magnify 2, 4, 8, 16, or 32
+            // magnify 2, 4, 8, 16, 32, 64 or 128
         {
             // ZOOM FFT
             // is used here to have a very close look at a small part
@@ -3014,51 +2988,25 @@ static void AudioDriver_SpectrumZoomProcessSamples(const uint16_t blockSize)
             // The ZOOM FFT is based on the principles described in Lyons (2011)
             // 1. take the I & Q samples
             // 2. complex conversion to baseband (at this place has already been done in audio_rx_freq_conv!)
-            // 3. lowpass I and lowpass Q separately (48kHz sample rate)
-            // 4. decimate I and Q separately
-            // 5. apply 256-point-FFT to decimated I&Q samples
+            // 3. lowpass and decimate I and Q by 2 with a half band filter, sd.magnify times
+            // 4. apply 256-point-FFT to decimated I&Q samples
             //
             // frequency resolution: spectrum bandwidth / 256
             // example: decimate by 8 --> 48kHz / 8 = 6kHz spectrum display bandwidth
             // frequency resolution of the display --> 6kHz / 256 = 23.44Hz
-            // in 32x Mag-mode the resolution is 5.9Hz, not bad for such a small processor . . .
+            // in 128x Mag-mode the resolution is 1.5Hz, not bad for such a small processor . . .
             //
+            // Each stage runs at half the rate of the previous one, so the load is below
+            // twice that of the first stage, whatever the magnification.
+            // With high magnification a block may yield no sample at all (128x: one per 4 blocks).
 
             float32_t x_buffer[IQ_BLOCK_SIZE];
             float32_t y_buffer[IQ_BLOCK_SIZE];
 
-            // lowpass Filtering
-            // Mag 2x - 12k lowpass --> 24k bandwidth
-            // Mag 4x - 6k lowpass --> 12k bandwidth
-            // Mag 8x - 3k lowpass --> 6k bandwidth
-            // Mag 16x - 1k5 lowpass --> 3k bandwidth
-            // Mag 32x - 750Hz lowpass --> 1k5 bandwidth
-
-            // 1st attempt - use low processor power biquad lowpass filters with 4 stages each
-            arm_biquad_cascade_df1_f32 (&IIR_biquad_Zoom_FFT_I, adb.i_buffer,x_buffer, blockSize);
-            arm_biquad_cascade_df1_f32 (&IIR_biquad_Zoom_FFT_Q, adb.q_buffer,y_buffer, blockSize);
+            const uint32_t blockSizeDecim = AudioPolyphase_HalfbandCascade(&DECIMATE_ZOOM_FFT, adb.i_buffer, adb.q_buffer, x_buffer, y_buffer, blockSize);
 
-            // arm_iir_lattice_f32(&IIR_TXFilter, adb.i_buffer, adb.x_buffer, blockSize);
-            // arm_iir_lattice_f32(&IIR_TXFilter, adb.q_buffer, adb.y_buffer, blockSize);
-
-            // decimation
-            arm_fir_decimate_f32(&DECIMATE_ZOOM_FFT_I, x_buffer, x_buffer, blockSize);
-            arm_fir_decimate_f32(&DECIMATE_ZOOM_FFT_Q, y_buffer, y_buffer, blockSize);
             // collect samples for spectrum display 256-point-FFT
-
-            int16_t blockSizeDecim = blockSize/ (1<<sd.magnify);
-            for(int16_t i = 0; i < blockSizeDecim; i++)
-            {
-                sd.FFT_RingBuffer[sd.samp_ptr] = y_buffer[i];   // get floating point data for FFT for spectrum scope/waterfall display
-                sd.samp_ptr++;
-                sd.FFT_RingBuffer[sd.samp_ptr] = x_buffer[i]; //
-                sd.samp_ptr++;
-                // On obtaining enough samples for spectrum scope/waterfall, update state machine, reset pointer and wait until we process what we have
-                if(sd.samp_ptr >= sd.fft_iq_len-1) //*2)
-                {
-                    sd.samp_ptr = 0;
-                }
-            } // end for
+            AudioDriver_SpectrumCollectSamples(x_buffer, y_buffer, blockSizeDecim);
             sd.FFT_frequency = (ts.tune_freq / TUNE_MULT) + AudioDriver_GetTranslateFreq(); // spectrum shows center at translate frequency, LO + Translate Freq  is center frequency;
 
 
@@ -3101,18 +3049,147 @@ static bool AudioDriver_RxProcessorDigital(AudioSample_t * const src, float32_t
 #endif
 
 
-static float32_t AudioDriver_FadeLeveler(int chan, float32_t audio, float32_t corr)
+/**
+ * @brief sine and cosine of phs from the NCO table
+ * @param phs phase in the range 0 ... 2 * PI
+ */
+static inline void AudioDriver_SamNco(float32_t phs, float32_t* Sin, float32_t* Cos)
+{
+    const float32_t idx = phs * (SAM_NCO_TABLE_SIZE / (2.0 * PI));
+    const uint32_t k = ((uint32_t)idx) & (SAM_NCO_TABLE_SIZE - 1);
+    const float32_t frac = idx - (float32_t)k;
+    const float32_t* s = &sam_nco_table[k];
+    const float32_t* c = &sam_nco_table[k + SAM_NCO_TABLE_SIZE / 4];
+
+    *Sin = s[0] + frac * (s[1] - s[0]);
+    *Cos = c[0] + frac * (c[1] - c[0]);
+}
+
+/**
+ * @brief one of the four allpass chains of the SAM sideband separation, stage by stage over the whole block
+ * y[n] = c * (x[n] - y[n-2]) + x[n-2]
+ */
+static void AudioDriver_SamAllpass(float32_t* buffer, uint16_t blockSize, const float32_t* coeffs, float32_t state[SAM_PLL_HILBERT_STAGES][4])
+{
+    for (int j = 0; j < SAM_PLL_HILBERT_STAGES; j++)
+    {
+        const float32_t c = coeffs[j];
+        float32_t x1 = state[j][0], x2 = state[j][1], y1 = state[j][2], y2 = state[j][3];
+
+        for (int i = 0; i < blockSize; i++)
+        {
+            const float32_t x = buffer[i];
+            const float32_t y = c * (x - y2) + x2;
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            buffer[i] = y;
+        }
+
+        state[j][0] = x1;
+        state[j][1] = x2;
+        state[j][2] = y1;
+        state[j][3] = y2;
+    }
+}
+
+/**
+ * @brief "fade leveler", taken from Warren Pratts WDSP / HPSDR, 2016
+ * http://svn.tapr.org/repos_sdr_hpsdr/trunk/W5WC/PowerSDR_HPSDR_mRX_PS/Source/wdsp/
+ * @param corr carrier level to insert, NULL for none
+ */
+static void AudioDriver_FadeLeveler(int chan, float32_t* audio, const float32_t* corr, uint16_t blockSize)
 {
     assert (chan < NUM_AUDIO_CHANNELS);
 
     static float32_t dc27[NUM_AUDIO_CHANNELS]; // static will be initialized with 0
     static float32_t dc_insert[NUM_AUDIO_CHANNELS];
 
-    dc27[chan] = adb.mtauR * dc27[chan] + adb.onem_mtauR * audio;
-    dc_insert[chan] = adb.mtauI * dc_insert[chan] + adb.onem_mtauI * corr;
-    audio = audio + dc_insert[chan] - dc27[chan];
+    float32_t dc = dc27[chan];
+    float32_t ins = dc_insert[chan];
+
+    for (int i = 0; i < blockSize; i++)
+    {
+        dc = adb.mtauR * dc + adb.onem_mtauR * audio[i];
+        ins = adb.mtauI * ins + adb.onem_mtauI * (corr != NULL ? corr[i] : 0.0);
+        audio[i] = audio[i] + ins - dc;
+    }
 
-    return audio;
+    dc27[chan] = dc;
+    dc_insert[chan] = ins;
+}
+
+/**
+ * @brief the sample by sample part of the SAM demodulator: NCO, mixer, phase detector and loop filter
+ * Stores the mixer products the sideband separation needs and the in-phase correlation into the block buffers.
+ */
+static void AudioDriver_SamPllLoop(const float32_t* i_buffer, const float32_t* q_buffer, uint16_t blockSize, bool sideband)
+{
+    SamPllState* pll = &sam_pll;
+
+    float32_t phs = pll->phs;
+    float32_t omega2 = pll->omega2;
+    float32_t fil_out = pll->fil_out;
+    float32_t dsI = pll->dsI;
+    float32_t dsQ = pll->dsQ;
+
+    const float32_t g1 = adb.g1, g2 = adb.g2;
+    const float32_t omega_min = adb.omega_min, omega_max = adb.omega_max;
+
+    for (int i = 0; i < blockSize; i++)
+    {
+        float32_t Sin, Cos;
+
+        AudioDriver_SamNco(phs, &Sin, &Cos);
+
+        const float32_t ai = Cos * i_buffer[i];
+        const float32_t bi = Sin * i_buffer[i];
+        const float32_t aq = Cos * q_buffer[i];
+        const float32_t bq = Sin * q_buffer[i];
+
+        const float32_t corr0 = ai + bq;
+        const float32_t corr1 = -bi + aq;
+
+        sam_corr_buffer[i] = corr0;
+        if (sideband)
+        {
+            sam_sb_buffer[0][i] = dsI;
+            sam_sb_buffer[1][i] = bi;
+            sam_sb_buffer[2][i] = dsQ;
+            sam_sb_buffer[3][i] = aq;
+            dsI = ai;
+            dsQ = bq;
+        }
+
+        // determine phase error
+        const float32_t phzerror = AudioDriver_FastAtan2(corr1, corr0);
+
+        const float32_t del_out = fil_out;
+        // correct frequency 1st step
+        omega2 = omega2 + g2 * phzerror;
+        if (omega2 < omega_min)
+        {
+            omega2 = omega_min;
+        }
+        else if (omega2 > omega_max)
+        {
+            omega2 = omega_max;
+        }
+        // correct frequency 2nd step
+        fil_out = g1 * phzerror + omega2;
+        phs = phs + del_out;
+
+        // wrap round 2PI, modulus
+        while (phs >= 2.0 * PI) phs -= (2.0 * PI);
+        while (phs < 0.0) phs += (2.0 * PI);
+    }
+
+    pll->phs = phs;
+    pll->omega2 = omega2;
+    pll->fil_out = fil_out;
+    pll->dsI = dsI;
+    pll->dsQ = dsQ;
 }
 
 //*----------------------------------------------------------------------------
@@ -3125,8 +3202,6 @@ static float32_t AudioDriver_FadeLeveler(int chan, float32_t audio, float32_t co
 //*----------------------------------------------------------------------------
 static void AudioDriver_DemodSAM(int16_t blockSize)
 {
-    //#define STAGES    7
-
     // new synchronous AM PLL & PHASE detector
     // wdsp Warren Pratt, 2016
     //*****************************
@@ -3135,181 +3210,98 @@ static void AudioDriver_DemodSAM(int16_t blockSize)
     arm_fir_decimate_f32(&FirDecim_RxSam_I, adb.i_buffer, adb.i_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
     arm_fir_decimate_f32(&FirDecim_RxSam_Q, adb.q_buffer, adb.q_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
 
+    const uint16_t blockSizeDecim = blockSize / adb.DF;
+    const float32_t* corr = NULL;
+
     switch(ts.dmod_mode)
     {
     case DEMOD_AM:
-        for(int i = 0; i < blockSize / adb.DF; i++)
+        for(int i = 0; i < blockSizeDecim; i++)
         {
-            float32_t audio;
-
-            arm_sqrt_f32 (adb.i_buffer[i] * adb.i_buffer[i] + adb.q_buffer[i] * adb.q_buffer[i], &audio);
-            if(ads.fade_leveler)
-            {
-                audio = AudioDriver_FadeLeveler(0,audio,0);
-            }
-            adb.a_buffer[0][i] = audio;
+            arm_sqrt_f32 (adb.i_buffer[i] * adb.i_buffer[i] + adb.q_buffer[i] * adb.q_buffer[i], &adb.a_buffer[0][i]);
         }
         break;
 
     case DEMOD_SAM:
     {
-
-        static uint16_t  count = 0;
-
-        static float32_t fil_out = 0.0;
-        static float32_t lowpass = 0.0;
-        static float32_t omega2 = 0.0;
-        static float32_t phs = 0.0;
-
         // Wheatley 2011 cuteSDR & Warren Pratts WDSP, 2016
-        for(int i = 0; i < blockSize / adb.DF; i++)
-        {   // NCO
-
-            float32_t ai, bi, aq, bq;
-            float32_t ai_ps, bi_ps, aq_ps, bq_ps;
-            float32_t Sin, Cos;
-
-            static float32_t dsI;             // delayed sample, I path
-            static float32_t dsQ;             // delayed sample, Q path
-
-
-            sincosf(phs,&Sin,&Cos);
-            ai = Cos * adb.i_buffer[i];
-            bi = Sin * adb.i_buffer[i];
-            aq = Cos * adb.q_buffer[i];
-            bq = Sin * adb.q_buffer[i];
-
-            if (ads.sam_sideband != SAM_SIDEBAND_BOTH)
-            {
-
-#define OUT_IDX   (3 * SAM_PLL_HILBERT_STAGES)
-
-                static float32_t a[3 * SAM_PLL_HILBERT_STAGES + 3];     // Filter a variables
-                static float32_t b[3 * SAM_PLL_HILBERT_STAGES + 3];     // Filter b variables
-                static float32_t c[3 * SAM_PLL_HILBERT_STAGES + 3];     // Filter c variables
-                static float32_t d[3 * SAM_PLL_HILBERT_STAGES + 3];     // Filter d variables
+        const bool sideband = ads.sam_sideband != SAM_SIDEBAND_BOTH;
 
-                a[0] = dsI;
-                b[0] = bi;
-                c[0] = dsQ;
-                d[0] = aq;
-                dsI = ai;
-                dsQ = bq;
+        AudioDriver_SamPllLoop(adb.i_buffer, adb.q_buffer, blockSizeDecim, sideband);
+        corr = sam_corr_buffer;
 
-                for (int j = 0; j < SAM_PLL_HILBERT_STAGES; j++)
-                {
-                    int k = 3 * j;
-                    a[k + 3] = adb.c0[j] * (a[k] - a[k + 5]) + a[k + 2];
-                    b[k + 3] = adb.c1[j] * (b[k] - b[k + 5]) + b[k + 2];
-                    c[k + 3] = adb.c0[j] * (c[k] - c[k + 5]) + c[k + 2];
-                    d[k + 3] = adb.c1[j] * (d[k] - d[k + 5]) + d[k + 2];
-                }
-
-                ai_ps = a[OUT_IDX];
-                bi_ps = b[OUT_IDX];
-                bq_ps = c[OUT_IDX];
-                aq_ps = d[OUT_IDX];
-
-                // make room for next sample
-                for (int j = OUT_IDX + 2; j > 0; j--)
-                {
-                    a[j] = a[j - 1];
-                    b[j] = b[j - 1];
-                    c[j] = c[j - 1];
-                    d[j] = d[j - 1];
-                }
-            }
-
-            float32_t audio[NUM_AUDIO_CHANNELS];
-
-            float32_t corr[2] = { ai + bq, -bi + aq };
-
-            switch(ads.sam_sideband)
-            {
-            case SAM_SIDEBAND_BOTH:
-            {
-                audio[0] = corr[0];
-                break;
-            }
-            case SAM_SIDEBAND_USB:
-            {
-                audio[0] = (ai_ps - bi_ps) + (aq_ps + bq_ps);
-                break;
-            }
-            case SAM_SIDEBAND_LSB:
-            {
-                audio[0] = (ai_ps + bi_ps) - (aq_ps - bq_ps);
-                break;
-            }
+        if (sideband)
+        {
+            float32_t* A = sam_sb_buffer[0]; // ai_ps
+            float32_t* B = sam_sb_buffer[1]; // bi_ps
+            float32_t* C = sam_sb_buffer[2]; // bq_ps
+            float32_t* D = sam_sb_buffer[3]; // aq_ps
+
+            AudioDriver_SamAllpass(A, blockSizeDecim, adb.c0, sam_pll.allpass[0]);
+            AudioDriver_SamAllpass(B, blockSizeDecim, adb.c1, sam_pll.allpass[1]);
+            AudioDriver_SamAllpass(C, blockSizeDecim, adb.c0, sam_pll.allpass[2]);
+            AudioDriver_SamAllpass(D, blockSizeDecim, adb.c1, sam_pll.allpass[3]);
+
+            // LSB: (ai_ps + bi_ps) - (aq_ps - bq_ps), USB: (ai_ps - bi_ps) + (aq_ps + bq_ps)
+            const bool lsb = ads.sam_sideband != SAM_SIDEBAND_USB;
+            const bool usb = ads.sam_sideband != SAM_SIDEBAND_LSB;
+            float32_t* lsb_out = adb.a_buffer[0];
+            float32_t* usb_out = adb.a_buffer[0];
 #ifdef USE_TWO_CHANNEL_AUDIO
-            case SAM_SIDEBAND_STEREO:
+            if (ads.sam_sideband == SAM_SIDEBAND_STEREO)
             {
-                audio[0] = (ai_ps + bi_ps) - (aq_ps - bq_ps);
-                audio[1] = (ai_ps - bi_ps) + (aq_ps + bq_ps);
-                break;
+                usb_out = adb.a_buffer[1];
             }
 #endif
-
-            }
-
-            // "fade leveler", taken from Warren Pratts WDSP / HPSDR, 2016
-            // http://svn.tapr.org/repos_sdr_hpsdr/trunk/W5WC/PowerSDR_HPSDR_mRX_PS/Source/wdsp/
-            if(ads.fade_leveler)
-            {
-                for (int chan = 0; chan < NUM_AUDIO_CHANNELS; chan++)
-                {
-                    audio[chan] = AudioDriver_FadeLeveler(chan, audio[chan], corr[0]);
-                }
-            }
-
- /*
-            a->dc = a->mtauR * a->dc + a->onem_mtauR * audio;
-            							a->dc_insert = a->mtauI * a->dc_insert + a->onem_mtauI * corr[0];
-            audio += a->dc_insert - a->dc;
-   */
-
-            for (int chan = 0; chan < NUM_AUDIO_CHANNELS; chan++)
-            {
-                adb.a_buffer[chan][i] = audio[chan];
-            }
-
-            // determine phase error
-            float32_t phzerror = atan2f(corr[1], corr[0]);
-
-            float32_t del_out = fil_out;
-            // correct frequency 1st step
-            omega2 = omega2 + adb.g2 * phzerror;
-            if (omega2 < adb.omega_min)
+            if (lsb) { arm_add_f32(A, B, lsb_out, blockSizeDecim); }
+            if (usb) { arm_add_f32(D, C, usb_out, blockSizeDecim); }
+            // A and D are not needed anymore and take the differences
+            if (lsb)
             {
-                omega2 = adb.omega_min;
+                arm_sub_f32(D, C, D, blockSizeDecim);
+                arm_sub_f32(lsb_out, D, lsb_out, blockSizeDecim);
             }
-            else if (omega2 > adb.omega_max)
+            if (usb)
             {
-                omega2 = adb.omega_max;
+                arm_sub_f32(A, B, A, blockSizeDecim);
+                arm_add_f32(A, usb_out, usb_out, blockSizeDecim);
             }
-            // correct frequency 2nd step
-            fil_out = adb.g1 * phzerror + omega2;
-            phs = phs + del_out;
-
-            // wrap round 2PI, modulus
-            while (phs >= 2.0 * PI) phs -= (2.0 * PI);
-            while (phs < 0.0) phs += (2.0 * PI);
         }
-        count++;
-        if(count > 50) // to display the exact carrier frequency that the PLL is tuned to
+        else
+        {
+            arm_copy_f32(sam_corr_buffer, adb.a_buffer[0], blockSizeDecim);
+        }
+
+        sam_pll.count++;
+        if(sam_pll.count > 50) // to display the exact carrier frequency that the PLL is tuned to
             // in the small frequency display
             // we calculate carrier offset here and the display function is
             // then called in UiDriver_MainHandler approx. every 40-80ms
         { // to make this smoother, a simple lowpass/exponential averager here . . .
-            float32_t carrier = 0.1 * (omega2 * IQ_SAMPLE_RATE) / (adb.DF * 2.0 * PI);
-            carrier = carrier + 0.9 * lowpass;
+            float32_t carrier = 0.1 * (sam_pll.omega2 * IQ_SAMPLE_RATE) / (adb.DF * 2.0 * PI);
+            carrier = carrier + 0.9 * sam_pll.lowpass;
             ads.carrier_freq_offset =  (int)carrier;
-            count = 0;
-            lowpass = carrier;
+            sam_pll.count = 0;
+            sam_pll.lowpass = carrier;
         }
     }
     break;
     }
+
+#ifdef USE_TWO_CHANNEL_AUDIO
+    if (ts.dmod_mode != DEMOD_SAM || ads.sam_sideband != SAM_SIDEBAND_STEREO)
+    {
+        arm_copy_f32(adb.a_buffer[0], adb.a_buffer[1], blockSizeDecim);
+    }
+#endif
+
+    if(ads.fade_leveler)
+    {
+        for (int chan = 0; chan < NUM_AUDIO_CHANNELS; chan++)
+        {
+            AudioDriver_FadeLeveler(chan, adb.a_buffer[chan], corr, blockSizeDecim);
+        }
+    }
 }
 
 
@@ -3511,6 +3503,9 @@ void AudioDriver_RxProcessorNoiseReduction(uint16_t blockSizeDecim, float32_t* i
     static int outbuff_count=0;
     static int NR_fill_in_pt=0;
     static NR_Buffer* out_buffer = NULL;
+    // the frame length may be changed from the menu at any time, which is why the buffer
+    // counters below are compared with >=, so a change costs not more than one garbled frame
+    const int NR_hop_comp = ts.NR_FFT_L / 4; // new samples per NR frame, counted in COMP pairs
     // this would be the right place for another decimation-by-2 to get down to 6ksps
     // in order to further improve the spectral noise reduction
     // TEST!
@@ -3544,15 +3539,25 @@ void AudioDriver_RxProcessorNoiseReduction(uint16_t blockSizeDecim, float32_t* i
         trans_count_in++; // count the samples towards FFT-size  -  2 samples per loop
     }
 
-    if (trans_count_in >= (NR_FFT_SIZE/2))
-        //NR_FFT_SIZE has to be an integer mult. of blockSizeDecim!!!
+    if (trans_count_in >= NR_hop_comp)
+        //ts.NR_FFT_L/2 has to be an integer mult. of blockSizeDecim!!!
     {
-        NR_in_buffer_add(&mmb.nr_audio_buff[NR_fill_in_pt]); // save pointer to full buffer
         trans_count_in=0;                              // set counter to 0
-        NR_fill_in_pt++;                               // increase pointer index
-        NR_fill_in_pt %= NR_BUFFER_NUM;            // make sure, that index stays in range
 
-        //at this point we have transfered one complete block of 128 (?) samples to one buffer
+        // the buffer after this one must be free, i.e. neither queued nor in processing nor still being played
+        if (NR_frames_in_use() < NR_BUFFER_NUM - 1)
+        {
+            NR_in_buffer_add(&mmb.nr_audio_buff[NR_fill_in_pt]); // save pointer to full buffer
+            NR_fill_in_pt++;                               // increase pointer index
+            NR_fill_in_pt %= NR_BUFFER_NUM;            // make sure, that index stays in range
+        }
+        else
+        {
+            // the NR worker is too far behind, drop the frame and fill the same buffer again
+            profileEvent(NrOverrun);
+        }
+
+        //at this point we have transfered one complete block of ts.NR_FFT_L/2 samples to one buffer
     }
 
     //**********************************************************************************
@@ -3572,19 +3577,28 @@ void AudioDriver_RxProcessorNoiseReduction(uint16_t blockSizeDecim, float32_t* i
         for (int j=0; j < no_dec_samples; j=j+2) // transfer noise reduced data back to our buffer
             //                            for (int j=0; j < blockSizeDecim; j=j+2) // transfer noise reduced data back to our buffer
         {
-            NR_dec_buffer[j]   = out_buffer->samples[outbuff_count+NR_FFT_SIZE].real; //here add the offset in the buffer
-            NR_dec_buffer[j+1] = out_buffer->samples[outbuff_count+NR_FFT_SIZE].imag; //here add the offset in the buffer
+            NR_dec_buffer[j]   = out_buffer->samples[outbuff_count+NR_FFT_SIZE/2].real; //here add the offset in the buffer
+            NR_dec_buffer[j+1] = out_buffer->samples[outbuff_count+NR_FFT_SIZE/2].imag; //here add the offset in the buffer
             outbuff_count++;
         }
 
-        if (outbuff_count >= (NR_FFT_SIZE/2)) // we reached the end of the buffer coming from NR
+        if (outbuff_count >= NR_hop_comp) // we reached the end of the buffer coming from NR
         {
             outbuff_count = 0;
             NR_out_buffer_remove(&out_buffer);
             out_buffer = NULL;
-            NR_out_buffer_peek(&out_buffer);
+            if (NR_out_buffer_peek(&out_buffer) == 0)
+            {
+                // the next frame is not ready, we wait until two are available again
+                profileEvent(NrUnderrun);
+            }
         }
     }
+    else
+    {
+        // no processed samples, play the audio as it is instead of leaving a gap
+        arm_copy_f32(inout_buffer, NR_dec_buffer, no_dec_samples);
+    }
 
 
     // interpolation of a_buffer from 6ksps to 12ksps!
@@ -3670,11 +3684,15 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
         //    arm_scale_f32 (adb.i_buffer, 0.6, adb.i_buffer, blockSize);
 
 
+        profileStageStart(ProfileIqCorrection);
         AudioDriver_RxHandleIqCorrection(blockSize);
+        profileStageStop(ProfileIqCorrection);
 
 
         // Spectrum display sample collect for magnify == 0
+        profileStageStart(ProfileSpectrumCollect);
         AudioDriver_SpectrumNoZoomProcessSamples(blockSize);
+        profileStageStop(ProfileSpectrumCollect);
 
         if(iq_freq_mode)            // is receive frequency conversion to be done?
         {
@@ -3682,7 +3700,9 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
         }
 
         // Spectrum display sample collect for magnify != 0
+        profileStageStart(ProfileSpectrumCollect);
         AudioDriver_SpectrumZoomProcessSamples(blockSize);
+        profileStageStop(ProfileSpectrumCollect);
 
         //  Demodulation, optimized using fast ARM math functions as much as possible
 
@@ -3702,7 +3722,14 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                     && dmod_mode != DEMOD_FM
                     && dmod_mode != DEMOD_SAM
                     && dmod_mode != DEMOD_AM;
-            volatile const uint16_t blockSizeIQ = use_decimatedIQ? blockSizeDecim: blockSize;
+            // wide SSB/CW filters: Hilbert filter and decimation in one go, the demodulation below is linear and
+            // gives the same result on the decimated I/Q as the decimation after the demodulation did
+            const bool use_hilbert_decimate =
+                    rx_hilbert_decimate
+                    && dmod_mode != DEMOD_FM
+                    && dmod_mode != DEMOD_SAM
+                    && dmod_mode != DEMOD_AM;
+            volatile const uint16_t blockSizeIQ = (use_decimatedIQ || use_hilbert_decimate)? blockSizeDecim: blockSize;
 
             // ------------------------
             // In SSB and CW - Do 0-90 degree Phase-added Hilbert Transform
@@ -3713,18 +3740,26 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
             // we need this "if" although Danilo introduced "use_decimated_IQ"
             if(dmod_mode != DEMOD_SAM && dmod_mode != DEMOD_AM) // || ads.sam_sideband == 0) // for SAM & one sideband, leave out this processor-intense filter
             {
-                if(use_decimatedIQ)
+                profileStageStart(ProfileDecimation);
+                if (use_hilbert_decimate)
                 {
-                    // TODO HILBERT
-                    arm_fir_decimate_f32(&DECIMATE_RX_I, adb.i_buffer, adb.i_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
-                    arm_fir_decimate_f32(&DECIMATE_RX_Q, adb.q_buffer, adb.q_buffer, blockSize);      // LPF built into decimation (Yes, you can decimate-in-place!)
+                    AudioPolyphase_DecimateHilbert(&DECIMATE_RX_HILBERT, adb.i_buffer, adb.q_buffer, adb.i_buffer, adb.q_buffer, blockSize);
                 }
+                else
+                {
+                    if(use_decimatedIQ)
+                    {
+                        // the narrow filters run the Hilbert filter after the decimation, which is cheaper than fusing both
+                        AudioDriver_RxDecimateIQ(adb.i_buffer, adb.q_buffer, blockSize);
+                    }
 
-                arm_fir_f32(&Fir_Rx_Hilbert_I,adb.i_buffer, adb.i_buffer, blockSizeIQ);   // in AM: lowpass filter, in other modes: Hilbert lowpass 0 degrees
-                arm_fir_f32(&Fir_Rx_Hilbert_Q,adb.q_buffer, adb.q_buffer, blockSizeIQ);   // in AM: lowpass filter, in other modes: Hilbert lowpass -90 degrees
-
+                    arm_fir_f32(&Fir_Rx_Hilbert_I,adb.i_buffer, adb.i_buffer, blockSizeIQ);   // in AM: lowpass filter, in other modes: Hilbert lowpass 0 degrees
+                    arm_fir_f32(&Fir_Rx_Hilbert_Q,adb.q_buffer, adb.q_buffer, blockSizeIQ);   // in AM: lowpass filter, in other modes: Hilbert lowpass -90 degrees
+                }
+                profileStageStop(ProfileDecimation);
             }
 
+            profileStageStart(ProfileDemod);
             switch(dmod_mode)
             {
             case DEMOD_LSB:
@@ -3782,29 +3817,43 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                 arm_add_f32(adb.i_buffer, adb.q_buffer, adb.a_buffer[0], blockSizeIQ);   // sum of I and Q - USB
                 break;
             }
+            profileStageStop(ProfileDemod);
 
             if(dmod_mode != DEMOD_FM)       // are we NOT in FM mode?  If we are not, do decimation, filtering, DSP notch/noise reduction, etc.
             {
                 // Do decimation down to lower rate to reduce processor load
                 if (    DECIMATE_RX_I.numTaps > 0
                         && use_decimatedIQ == false // we did not already decimate the input earlier
+                        && use_hilbert_decimate == false
                         && dmod_mode != DEMOD_SAM
                         && dmod_mode != DEMOD_AM) // in AM/SAM mode, the decimation has been done in both I & Q path --> AudioDriver_Demod_SAM
                 {
-                    // TODO HILBERT
-                    arm_fir_decimate_f32(&DECIMATE_RX_I, adb.a_buffer[0], adb.a_buffer[0], blockSizeIQ);      // LPF built into decimation (Yes, you can decimate-in-place!)
+                    profileStageStart(ProfileDecimation);
 #ifdef USE_TWO_CHANNEL_AUDIO
                     if(use_stereo)
                     {
-                        arm_fir_decimate_f32(&DECIMATE_RX_Q, adb.a_buffer[1], adb.a_buffer[1], blockSizeIQ);      // LPF built into decimation (Yes, you can decimate-in-place!)
+                        AudioDriver_RxDecimateIQ(adb.a_buffer[0], adb.a_buffer[1], blockSizeIQ);
                     }
+                    else
 #endif
+                    {
+                        arm_fir_decimate_f32(&DECIMATE_RX_I, adb.a_buffer[0], adb.a_buffer[0], blockSizeIQ);      // LPF built into decimation (Yes, you can decimate-in-place!)
+                    }
+                    profileStageStop(ProfileDecimation);
                 }
 
+#ifdef STM32F4
+                // the F4 does not have the cycles for notch and NR on top of SAM at 24 kHz
+                const bool sam_24k = dmod_mode == DEMOD_SAM && FilterPathInfo[ts.filter_path].sample_rate_dec == RX_DECIMATION_RATE_24KHZ;
+#else
+                const bool sam_24k = false;
+#endif
+
                 if (ts.dsp_inhibit == false)
                 {
-                    if((dsp_active & DSP_NOTCH_ENABLE) && (dmod_mode != DEMOD_CW) && !(dmod_mode == DEMOD_SAM && (FilterPathInfo[ts.filter_path].sample_rate_dec) == RX_DECIMATION_RATE_24KHZ))       // No notch in CW
+                    if((dsp_active & DSP_NOTCH_ENABLE) && (dmod_mode != DEMOD_CW) && !sam_24k)       // No notch in CW
                     {
+                        profileStageStart(ProfileNotch);
 #ifdef USE_LEAKY_LMS
                     	if(ts.enable_leaky_LMS)
                     	{
@@ -3818,12 +3867,14 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                         	AudioDriver_NotchFilter(blockSizeDecim, adb.a_buffer[0]);     // Do notch filter
 #endif
                         }
+                        profileStageStop(ProfileNotch);
                     }
 
                     // DSP noise reduction using LMS (Least Mean Squared) algorithm
                     // This is the pre-filter/AGC instance
-                    if((dsp_active & DSP_NR_ENABLE) && (!(dsp_active & DSP_NR_POSTAGC_ENABLE)) && !(dmod_mode == DEMOD_SAM && (FilterPathInfo[ts.filter_path].sample_rate_dec) == RX_DECIMATION_RATE_24KHZ))      // Do this if enabled and "Pre-AGC" DSP NR enabled
+                    if((dsp_active & DSP_NR_ENABLE) && (!(dsp_active & DSP_NR_POSTAGC_ENABLE)) && !sam_24k)      // Do this if enabled and "Pre-AGC" DSP NR enabled
                     {
+                        profileStageStart(ProfileNoiseReduction);
 #ifdef USE_LEAKY_LMS
                     	if(ts.enable_leaky_LMS)
                     	{
@@ -3836,6 +3887,7 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                         	AudioDriver_NoiseReduction(blockSizeDecim, adb.a_buffer[0]);     //
 #endif
                         }
+                        profileStageStop(ProfileNoiseReduction);
                     }
 
                 }
@@ -3853,18 +3905,21 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                 }
 
                 // now process the samples and perform the receiver AGC function
+                profileStageStart(ProfileAgc);
 #ifdef USE_TWO_CHANNEL_AUDIO
                     AudioDriver_RxAgcWdsp(blockSizeDecim, adb.a_buffer[0], adb.a_buffer[1]);
 #else
                     AudioDriver_RxAgcWdsp(blockSizeDecim, adb.a_buffer[0]);
 #endif
+                profileStageStop(ProfileAgc);
 
 
                 // DSP noise reduction using LMS (Least Mean Squared) algorithm
                 // This is the post-filter, post-AGC instance
                 //
-                if((dsp_active & DSP_NR_ENABLE) && (dsp_active & DSP_NR_POSTAGC_ENABLE) && (!ts.dsp_inhibit) && !(dmod_mode == DEMOD_SAM && (FilterPathInfo[ts.filter_path].sample_rate_dec) == RX_DECIMATION_RATE_24KHZ))     // Do DSP NR if enabled and if post-DSP NR enabled
+                if((dsp_active & DSP_NR_ENABLE) && (dsp_active & DSP_NR_POSTAGC_ENABLE) && (!ts.dsp_inhibit) && !sam_24k)     // Do DSP NR if enabled and if post-DSP NR enabled
                 {
+                    profileStageStart(ProfileNoiseReduction);
 #ifdef USE_LEAKY_LMS
                 	if(ts.enable_leaky_LMS)
                 	{
@@ -3877,6 +3932,7 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                     	AudioDriver_NoiseReduction(blockSizeDecim, adb.a_buffer[0]);     //
 #endif
                     }
+                    profileStageStop(ProfileNoiseReduction);
                 }
                 //
                 //                if (ts.new_nb==true || ts.nr_enable == true) //start of new nb
@@ -3891,8 +3947,9 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
 
                     if (ads.decimation_rate == 4)   //  to make sure, that we are at 12Ksamples
                     {
+                        profileStageStart(ProfileNoiseReduction);
                         AudioDriver_RxProcessorNoiseReduction(blockSizeDecim, adb.a_buffer[0]);
-
+                        profileStageStop(ProfileNoiseReduction);
                     }
                 } // end of new nb
 
@@ -3939,33 +3996,52 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
 #endif
                 if (is_demod_psk() && blockSizeDecim == 8) // only works when decimation rate is 4 --> sample rate == 12ksps
                 {
-                    AudioDriver_RxProcessor_Bpsk(adb.a_buffer[0], blockSizeDecim);
+                    BpskDecoder_ProcessBlock(adb.a_buffer[0], blockSizeDecim);
+                    if (psk_ctrl_config.skimmer != PSK_SKIM_OFF)
+                    {
+                        PskSkimmer_ProcessBlock(adb.a_buffer[0], blockSizeDecim);
+                    }
                 }
 //                if(blockSizeDecim ==8 && dmod_mode == DEMOD_CW)
 //                if(ts.cw_decoder_enable && blockSizeDecim ==8 && (dmod_mode == DEMOD_CW || dmod_mode == DEMOD_AM || dmod_mode == DEMOD_SAM))
                 if(blockSizeDecim ==8 && (dmod_mode == DEMOD_CW || dmod_mode == DEMOD_AM || dmod_mode == DEMOD_SAM))
 // switch to use TUNE HELPER in AM/SAM
                 {
-                	CwDecode_RxProcessor(adb.a_buffer[0], blockSizeDecim);
+                    if (ts.cw_decoder_enable && dmod_mode == DEMOD_CW && cw_decoder_config.bank_mode != CW_BANK_OFF)
+                    {
+                        CwBank_ProcessBlock(adb.a_buffer[0], blockSizeDecim);
+                    }
+                    else
+                    {
+                        CwDecode_RxProcessor(adb.a_buffer[0], blockSizeDecim);
+                    }
                 }
 
                 // resample back to original sample rate while doing low-pass filtering to minimize audible aliasing effects
+                profileStageStart(ProfileInterpolation);
                 if (INTERPOLATE_RX[0].phaseLength > 0)
                 {
 #ifdef USE_TWO_CHANNEL_AUDIO
-                    float32_t temp_buffer[IQ_BLOCK_SIZE];
-                    if(use_stereo)
+                    if(use_stereo && rx_resampler_polyphase)
                     {
-                        arm_fir_interpolate_f32(&INTERPOLATE_RX[1], adb.a_buffer[1], temp_buffer, blockSizeDecim);
+                        // both channels in one pass, the output swaps the buffers as the code below does
+                        AudioPolyphase_InterpolateIQ(&INTERPOLATE_RX_STEREO, adb.a_buffer[0], adb.a_buffer[1], adb.a_buffer[1], adb.a_buffer[0], blockSizeDecim);
                     }
-#endif
-                    arm_fir_interpolate_f32(&INTERPOLATE_RX[0], adb.a_buffer[0], adb.a_buffer[1], blockSizeDecim);
-
-#ifdef USE_TWO_CHANNEL_AUDIO
-                    if(use_stereo)
+                    else
                     {
-                        arm_copy_f32(temp_buffer,adb.a_buffer[0],blockSize);
+                        float32_t temp_buffer[IQ_BLOCK_SIZE];
+                        if(use_stereo)
+                        {
+                            arm_fir_interpolate_f32(&INTERPOLATE_RX[1], adb.a_buffer[1], temp_buffer, blockSizeDecim);
+                        }
+                        arm_fir_interpolate_f32(&INTERPOLATE_RX[0], adb.a_buffer[0], adb.a_buffer[1], blockSizeDecim);
+                        if(use_stereo)
+                        {
+                            arm_copy_f32(temp_buffer,adb.a_buffer[0],blockSize);
+                        }
                     }
+#else
+                    arm_fir_interpolate_f32(&INTERPOLATE_RX[0], adb.a_buffer[0], adb.a_buffer[1], blockSizeDecim);
 #endif
 
                 }
@@ -3981,6 +4057,7 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                     }
 #endif
                 }
+                profileStageStop(ProfileInterpolation);
 
             } // end NOT in FM mode
             else if(dmod_mode == DEMOD_FM)           // it is FM - we don't do any decimation, interpolation, filtering or any other processing - just rescale audio amplitude
@@ -3990,11 +4067,13 @@ static void AudioDriver_RxProcessor(AudioSample_t * const src, AudioSample_t * c
                         RadioManagement_FmDevIs5khz() ? FM_RX_SCALING_5K : FM_RX_SCALING_2K5,
                                 adb.a_buffer[1],
                                 blockSizeDecim);  // apply fixed amount of audio gain scaling to make the audio levels correct along with AGC
+                profileStageStart(ProfileAgc);
 #ifdef USE_TWO_CHANNEL_AUDIO
                     AudioDriver_RxAgcWdsp(blockSizeDecim, adb.a_buffer[0], adb.a_buffer[1]);
 #else
                     AudioDriver_RxAgcWdsp(blockSizeDecim, adb.a_buffer[0]);
 #endif
+                profileStageStop(ProfileAgc);
             }
 
             // this is the biquad filter, a highshelf filter
@@ -4119,6 +4198,8 @@ static void AudioDriver_TxCompressor(float32_t* buffer, int16_t blockSize, float
 {
     static uint32_t	alc_delay_inbuf = 0, alc_delay_outbuf;
 
+    profileStageStart(ProfileAgc); // the TX ALC
+
     if (ts.tx_comp_level > -1)
     {
         if(!ts.tune)        // do post-filter gain calculations if we are NOT in TUNE mode
@@ -4193,6 +4274,7 @@ static void AudioDriver_TxCompressor(float32_t* buffer, int16_t blockSize, float
 
         arm_mult_f32(buffer, adb.agc_valbuf, buffer, blockSize);		// Apply ALC gain corrections to TX audio channels
     }
+    profileStageStop(ProfileAgc);
 }
 
 /**
@@ -4221,6 +4303,8 @@ static void AudioDriver_TxIqProcessingFinal(float32_t scaling, bool swap, AudioS
 
     float32_t *final_i_buffer, *final_q_buffer;
 
+    profileStageStart(ProfileIqCorrection);
+
     float32_t final_i_gain = ts.tx_power_factor * ts.tx_adj_gain_var[trans_idx].i * scaling;
     float32_t final_q_gain = ts.tx_power_factor * ts.tx_adj_gain_var[trans_idx].q * scaling;
 
@@ -4248,6 +4332,7 @@ static void AudioDriver_TxIqProcessingFinal(float32_t scaling, bool swap, AudioS
         dst[i].l = final_i_buffer[i]; // save left channel
         dst[i].r = final_q_buffer[i]; // save right channel
     }
+    profileStageStop(ProfileIqCorrection);
 
 }
 
@@ -4372,6 +4457,7 @@ static void AudioDriver_TxProcessorAMSideband(float32_t* i_buffer, float32_t* q_
 
 static inline void AudioDriver_TxFilterAudio(bool do_bandpass, bool do_bass_treble, float32_t* inBlock, float32_t* outBlock, const uint16_t blockSize)
 {
+    profileStageStart(ProfileTxAudioFilter);
     if (do_bandpass)
     {
         arm_iir_lattice_f32(&IIR_TXFilter, inBlock, outBlock, blockSize);
@@ -4381,6 +4467,7 @@ static inline void AudioDriver_TxFilterAudio(bool do_bandpass, bool do_bass_treb
         // biquad filter for bass & treble --> NOT enabled when using USB Audio (eg. for Digimodes)
         arm_biquad_cascade_df1_f32 (&IIR_TX_biquad, outBlock,outBlock, blockSize);
     }
+    profileStageStop(ProfileTxAudioFilter);
 }
 
 static void AudioDriver_TxProcessorFM(AudioSample_t * const src, AudioSample_t * const dst, uint16_t blockSize)
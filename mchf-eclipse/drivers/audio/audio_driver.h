@@ -221,6 +221,7 @@ typedef struct SMeter
     int		curr_max;
     float32_t dbm;
     float32_t dbmhz;
+    float32_t dbm_noise;    // noise floor within the filter bandwidth, from the spectrum display
 
 } SMeter;
 
@@ -593,6 +594,7 @@ void AudioDriver_TxFilterInit(uint8_t dmod_mode);
 int32_t AudioDriver_GetTranslateFreq();
 void AudioDriver_SetSamPllParameters (void);
 void AudioDriver_SetupAgcWdsp(void);
+void AudioDriver_AgcWdspSetNoiseLevel(float32_t noise_rms);
 float log10f_fast(float X);
 
 void RttyDecoder_Init();
@@ -148,7 +148,8 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
 {
 // id, mode name (for display), filter_select_ID, FIR_numTaps, FIR_I_coeff_file, FIR_Q_coeff_file, &decimation filter,
 //		sample_rate_dec, &IIR_PreFilter,
-//		&FIR_interpolaton filter, &IIR_interpolation filter, centre frequency of the filterpath (for graphical bandwidth display)
+//		&FIR_interpolaton filter, &IIR_interpolation filter, centre frequency of the filterpath (for graphical bandwidth display),
+//		use CMSIS resampler instead of polyphase I/Q bank, fuse Hilbert filter and decimation
 //
     // SPECIAL AUDIO_OFF Entry
     {
@@ -465,110 +466,110 @@ const FilterPathDescriptor FilterPathInfo[AUDIO_FILTER_PATH_NUM] =
     {
         AUDIO_3P8KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
         RX_DECIMATION_RATE_12KHZ, &IIR_3k8_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1900
+        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1900, false, true
     },
 
     {
         AUDIO_3P8KHZ, "BPF", FILTER_MASK_SSB, 2, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
         RX_DECIMATION_RATE_12KHZ, &IIR_3k8_BPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1975
+        &FirRxInterpolate_4_5k, &IIR_aa_5k, 1975, false, true
     },
 //50
     {
         AUDIO_4P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
         RX_DECIMATION_RATE_12KHZ, &IIR_4k_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2000
+        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2000, false, true
     },
 
     {
         AUDIO_4P2KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
         RX_DECIMATION_RATE_12KHZ, &IIR_4k2_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2100
+        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2100, false, true
     },
 
     {
         AUDIO_4P4KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
         RX_DECIMATION_RATE_12KHZ, &IIR_4k4_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2200
+        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2200, false, true
     },
 
     {
         AUDIO_4P6KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
         RX_DECIMATION_RATE_12KHZ, &IIR_4k6_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2300
+        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2300, false, true
     },
 
     {
         AUDIO_4P8KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_4k5_coeffs, q_rx_4k5_coeffs, &FirRxDecimate,
         RX_DECIMATION_RATE_12KHZ, &IIR_4k8_LPF,
-        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2400
+        &FirRxInterpolate_4_5k, &IIR_aa_5k, 2400, false, true
     },
 
 //55		// new decimation rate, new decimation filter, new interpolation filter, no IIR Prefilter, no IIR interpolation filter
     {
         AUDIO_5P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_5k_coeffs, q_rx_5k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ, NULL, 0, false, true
     },
 
     {
         AUDIO_5P5KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_5k_coeffs, q_rx_5k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ, NULL, 0, false, true
     },
 
     {
         AUDIO_6P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_6k_coeffs, q_rx_6k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ, NULL, 0, false, true
     },
 
     {
         AUDIO_6P5KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_6k_coeffs, q_rx_6k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ, NULL, 0, false, true
     },
 
     {
         AUDIO_7P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_6k_coeffs, q_rx_6k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ, NULL, 0, false, true
     },
 //60
     {
         AUDIO_7P5KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_7k5_coeffs, q_rx_7k5_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate10KHZ, NULL
+        &FirRxInterpolate10KHZ, NULL, 0, false, true
     },
     // additional IIR interpolation filter
     {
         AUDIO_8P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_10k_coeffs, q_rx_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_8k
+        &FirRxInterpolate_4_10k, &IIR_aa_8k, 0, false, true
     },
 
     {
         AUDIO_8P5KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_10k_coeffs, q_rx_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_8k5
+        &FirRxInterpolate_4_10k, &IIR_aa_8k5, 0, false, true
     },
 
     {
         AUDIO_9P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_10k_coeffs, q_rx_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_9k
+        &FirRxInterpolate_4_10k, &IIR_aa_9k, 0, false, true
     },
 
     {
         AUDIO_9P5KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_10k_coeffs, q_rx_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_9k5
+        &FirRxInterpolate_4_10k, &IIR_aa_9k5, 0, false, true
     },
 
     {
         AUDIO_10P0KHZ, "LPF", FILTER_MASK_SSB, 1, IQ_RX_NUM_TAPS, i_rx_10k_coeffs, q_rx_10k_coeffs, &FirRxDecimateMinLPF,
         RX_DECIMATION_RATE_24KHZ, NULL,
-        &FirRxInterpolate_4_10k, &IIR_aa_10k
+        &FirRxInterpolate_4_10k, &IIR_aa_10k, 0, false, true
     },
 
     //###################################################################################################################################
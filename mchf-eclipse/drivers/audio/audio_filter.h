@@ -132,6 +132,11 @@ typedef struct FilterPathDescriptor_s
     // remark: this IS in fact IDENTICAL to the CENTRE FREQUENCY of the filter
     // For most non-CW filters 0 is okay,
     // in this case bandwidth/2 is being used here.
+
+    const bool cmsis_resampler; // true: decimate/interpolate I and Q with two separate CMSIS filter instances
+    // false (default): use the polyphase I/Q filter bank (audio_polyphase.c), which runs both channels in one pass
+    const bool hilbert_decimate; // true: SSB/CW paths with the Hilbert filter at 48ksps run Hilbert filter and decimation
+    // as one fused filter on I and Q, which computes only the decimated output, see AudioPolyphase_DecimateHilbert()
 } FilterPathDescriptor;
 
 
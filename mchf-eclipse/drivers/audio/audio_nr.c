@@ -28,6 +28,9 @@ __IO int32_t NR_out_tail = 0;
 NR_Buffer* NR_in_buffers[NR_BUFFER_FIFO_SIZE];
 NR_Buffer* NR_out_buffers[NR_BUFFER_FIFO_SIZE];
 
+static __IO bool NR_worker_busy = false; // alternateNR_handle() holds a buffer taken from the in queue
+static __IO bool nr_fft_size_pending = false; // AudioNr_ChangeFftSize() was called, the worker applies ts.nr_fft_size
+
 /*const float32_t SQRT_van_hann[128]= {0.000000000, 0.024734427, 0.04945372, 0.074142753, 0.098786418, 0.123369638, 0.14787737, 0.172294617,
 	      0.196606441, 0.220797963, 0.244854382, 0.268760979, 0.292503125, 0.316066292, 0.339436063, 0.362598137,
 	      0.385538344, 0.408242645, 0.430697148, 0.452888114, 0.474801964, 0.49642529, 0.51774486, 0.53874763,
@@ -45,8 +48,6 @@ NR_Buffer* NR_out_buffers[NR_BUFFER_FIFO_SIZE];
 	      0.362598137, 0.339436063, 0.316066292, 0.292503125, 0.268760979, 0.244854382, 0.220797963, 0.196606441,
 	      0.172294617, 0.14787737, 0.123369638, 0.098786418, 0.074142753, 0.04945372, 0.024734427, 0.00000000};
 */
-const float32_t SQRT_von_Hann_256[256] = {0,0.01231966,0.024637449,0.036951499,0.049259941,0.061560906,0.073852527,0.086132939,0.098400278,0.110652682,0.122888291,0.135105247,0.147301698,0.159475791,0.171625679,0.183749518,0.195845467,0.207911691,0.219946358,0.231947641,0.24391372,0.255842778,0.267733003,0.279582593,0.291389747,0.303152674,0.314869589,0.326538713,0.338158275,0.349726511,0.361241666,0.372701992,0.384105749,0.395451207,0.406736643,0.417960345,0.429120609,0.440215741,0.451244057,0.462203884,0.473093557,0.483911424,0.494655843,0.505325184,0.515917826,0.526432163,0.536866598,0.547219547,0.557489439,0.567674716,0.577773831,0.587785252,0.597707459,0.607538946,0.617278221,0.626923806,0.636474236,0.645928062,0.65528385,0.664540179,0.673695644,0.682748855,0.691698439,0.700543038,0.709281308,0.717911923,0.726433574,0.734844967,0.743144825,0.75133189,0.759404917,0.767362681,0.775203976,0.78292761,0.790532412,0.798017227,0.805380919,0.812622371,0.819740483,0.826734175,0.833602385,0.840344072,0.846958211,0.853443799,0.859799851,0.866025404,0.872119511,0.878081248,0.88390971,0.889604013,0.895163291,0.900586702,0.905873422,0.911022649,0.916033601,0.920905518,0.92563766,0.930229309,0.934679767,0.938988361,0.943154434,0.947177357,0.951056516,0.954791325,0.958381215,0.961825643,0.965124085,0.968276041,0.971281032,0.974138602,0.976848318,0.979409768,0.981822563,0.984086337,0.986200747,0.988165472,0.989980213,0.991644696,0.993158666,0.994521895,0.995734176,0.996795325,0.99770518,0.998463604,0.999070481,0.99952572,0.99982925,0.999981027,0.999981027,0.99982925,0.99952572,0.999070481,0.998463604,0.99770518,0.996795325,0.995734176,0.994521895,0.993158666,0.991644696,0.989980213,0.988165472,0.986200747,0.984086337,0.981822563,0.979409768,0.976848318,0.974138602,0.971281032,0.968276041,0.965124085,0.961825643,0.958381215,0.954791325,0.951056516,0.947177357,0.943154434,0.938988361,0.934679767,0.930229309,0.92563766,0.920905518,0.916033601,0.911022649,0.905873422,0.900586702,0.895163291,0.889604013,0.88390971,0.878081248,0.872119511,0.866025404,0.859799851,0.853443799,0.846958211,0.840344072,0.833602385,0.826734175,0.819740483,0.812622371,0.805380919,0.798017227,0.790532412,0.78292761,0.775203976,0.767362681,0.759404917,0.75133189,0.743144825,0.734844967,0.726433574,0.717911923,0.709281308,0.700543038,0.691698439,0.682748855,0.673695644,0.664540179,0.65528385,0.645928062,0.636474236,0.626923806,0.617278221,0.607538946,0.597707459,0.587785252,0.577773831,0.567674716,0.557489439,0.547219547,0.536866598,0.526432163,0.515917826,0.505325184,0.494655843,0.483911424,0.473093557,0.462203884,0.451244057,0.440215741,0.429120609,0.417960345,0.406736643,0.395451207,0.384105749,0.372701992,0.361241666,0.349726511,0.338158275,0.326538713,0.314869589,0.303152674,0.291389747,0.279582593,0.267733003,0.255842778,0.24391372,0.231947641,0.219946358,0.207911691,0.195845467,0.183749518,0.171625679,0.159475791,0.147301698,0.135105247,0.122888291,0.110652682,0.098400278,0.086132939,0.073852527,0.061560906,0.049259941,0.036951499,0.024637449,0.01231966,0};
-
 
 #if 0
 // biquad IIR filter with a maximum of four notch filters
@@ -244,46 +245,80 @@ int32_t NR_out_has_room()
     return NR_BUFFER_FIFO_SIZE - 1 - NR_out_has_data();
 }
 
+/**
+ * @brief number of NR buffers waiting for or in processing or holding output not yet played
+ *
+ * The buffers are used strictly in turn, so the audio interrupt may fill the next one
+ * only if this leaves one of the NR_BUFFER_NUM buffers free.
+ * Called from the audio interrupt, which cannot be interrupted by alternateNR_handle().
+ */
+int32_t NR_frames_in_use()
+{
+    return NR_in_has_data() + NR_out_has_data() + (NR_worker_busy ? 1 : 0);
+}
+
 
 
+/**
+ * The noise reduction worker, called from UiDriver_TaskHandler_HighPrioTasks() in the PendSV interrupt
+ * which the audio interrupt triggers after every block. It owns the buffers between NR_in_buffer_remove()
+ * and NR_out_buffer_add() and processes one frame per call.
+ *
+ * A frame has to be finished before the audio interrupt has collected the next one. If the worker
+ * was held up for longer (e.g. by higher priority interrupts) and finds the next frame already waiting,
+ * it passes the current frame through unprocessed in order to catch up, instead of letting the audio
+ * interrupt run out of processed samples. The counters NrLate and NrSkipped in the event profile
+ * tell how often this happens, NrOverrun and NrUnderrun are counted by the audio interrupt.
+ *
+ * Lowering the frame length would not help here: short frames need more cycles per sample.
+ */
 void alternateNR_handle()
 {
-    static uint16_t NR_current_buffer_idx = 0;
-    static bool NR_was_here = false;
-
-    if (NR_was_here == false)
+    if (nr_fft_size_pending)
     {
-        NR_was_here = true;
-        NR_current_buffer_idx = 0;
-        NR_in_buffer_reset();
-        NR_out_buffer_reset();
+        // we are between two frames here
+        AudioNr_SetFftSize(ts.nr_fft_size);
     }
 
     if ( NR_in_has_data() && NR_out_has_room())
     {   // audio data is ready to be processed
 
-        NR_current_buffer_idx %= NR_BUFFER_NUM;
+        NR_worker_busy = true;
 
         NR_Buffer* input_buf = NULL;
         NR_in_buffer_remove(&input_buf); //&input_buffer points to the current valid audio data
 
-        // inside here do all the necessary noise reduction stuff!!!!!
         // here are the current input samples:  input_buf->samples
-        // NR_output samples have to be placed here: fdv_iq_buff[NR_current_buffer_idx].samples
-        // but starting at an offset of NR_FFT_SIZE as we are using the same buffer for in and out
-        // here is the only place where we are referring to fdv_iq... as this is the name of the used freedv buffer
+        // the output samples are placed into the same buffer
+        // but starting at an offset of NR_FFT_SIZE floats as we are using the same buffer for in and out
+        float32_t* inputsamples = &input_buf->samples[0].real;
+        float32_t* outputsamples = &input_buf->samples[NR_FFT_SIZE/2].real;
 
-        //profileTimedEventStart(ProfileTP8);
-
-        do_alternate_NR(&input_buf->samples[0].real,&mmb.nr_audio_buff[NR_current_buffer_idx].samples[NR_FFT_SIZE].real);
+        if (NR_in_has_data())
+        {
+            // we are more than a frame behind the audio interrupt
+            profileEvent(NrSkipped);
+            if (ts.dsp_active & DSP_NR_ENABLE)
+            {
+                spectral_noise_reduction_3_skip(inputsamples);
+            }
+            arm_copy_f32(inputsamples, outputsamples, ts.NR_FFT_L / 2);
+        }
+        else
+        {
+            do_alternate_NR(inputsamples, outputsamples);
 
-        //profileTimedEventStop(ProfileTP8);
+            if (NR_in_has_data())
+            {
+                // the next frame arrived while we were working on this one
+                profileEvent(NrLate);
+            }
+        }
 
-        NR_out_buffer_add(&mmb.nr_audio_buff[NR_current_buffer_idx]);
-        NR_current_buffer_idx++;
+        NR_out_buffer_add(input_buf);
 
+        NR_worker_busy = false;
     }
-
 }
 
 
@@ -291,16 +326,17 @@ void do_alternate_NR(float32_t* inputsamples, float32_t* outputsamples )
 {
 
     float32_t* Energy=0;
+    const int NR_hop = ts.NR_FFT_L / 2; // new samples per frame
 
     if(ts.nb_setting > 0)
     {
-        alt_noise_blanking(inputsamples,NR_FFT_SIZE,Energy);
+        alt_noise_blanking(inputsamples,NR_hop,Energy);
     }
 
     //    if((ts.dsp_active & DSP_NR_ENABLE) || (ts.dsp_active & DSP_NOTCH_ENABLE))
     if(ts.dsp_active & DSP_NR_ENABLE)
     {
-		profileTimedEventStart(ProfileTP8);
+		profileTimedEventStart(ProfileNoiseReductionTask);
 
 		/*	// spectral_noise_reduction_2(inputsamples);
 		if (ts.nr_mode == 0)
@@ -313,20 +349,53 @@ void do_alternate_NR(float32_t* inputsamples, float32_t* outputsamples )
 
 		spectral_noise_reduction_3(inputsamples);
 
-		profileTimedEventStop(ProfileTP8);
+		profileTimedEventStop(ProfileNoiseReductionTask);
     }
 
-    for (int k=0; k < NR_FFT_SIZE;  k++)
+    for (int k=0; k < NR_hop;  k++)
     {
         outputsamples[k] = inputsamples[k];
     }
 
 }
 
+/**
+ * @brief selects the frame length of the spectral noise reduction, the NR restarts with the next frame
+ * Only for the initialization, while the audio interrupt and the NR worker do not run yet, see AudioNr_ChangeFftSize()
+ * @param fft_size one of NR_FFT_SIZE_SEL_128 ... NR_FFT_SIZE_SEL_MAX, larger values are limited to the latter
+ */
+void AudioNr_SetFftSize(uint8_t fft_size)
+{
+    if (fft_size > NR_FFT_SIZE_SEL_MAX)
+    {
+        fft_size = NR_FFT_SIZE_SEL_MAX;
+    }
+    ts.nr_fft_size = fft_size;
+    ts.NR_FFT_L = NR_FFT_L_MIN << fft_size;
+    ts.NR_FFT_LOOP_NO = 1;
+    ts.nr_first_time = 1;
+    nr_fft_size_pending = false;
+}
+
+/**
+ * @brief changes the frame length while the audio is running
+ * The NR worker applies it between two frames, so that it never works on buffers which change size under its feet.
+ * The audio interrupt picks up the new length with the next buffer it fills, which may cause a single frame of garbled audio.
+ * @param fft_size one of NR_FFT_SIZE_SEL_128 ... NR_FFT_SIZE_SEL_MAX, larger values are limited to the latter
+ */
+void AudioNr_ChangeFftSize(uint8_t fft_size)
+{
+    if (fft_size > NR_FFT_SIZE_SEL_MAX)
+    {
+        fft_size = NR_FFT_SIZE_SEL_MAX;
+    }
+    ts.nr_fft_size = fft_size;
+    nr_fft_size_pending = true;
+}
+
 // debugging switches
 //#define OLD_LONG_TONE_DETECTION
 //#define NR_NOTCHTEST
-//#define NR_FFT_256 // if you change this, also changts.NR_FFT_LFFT_L in audio_nr.h
 
 
 
@@ -1771,6 +1840,27 @@ float32_t uf_freq = (offset + width/2) / (NR_sample_rate / ts.NR_FFT_L);
 }
 #endif
 
+/**
+ * @brief prepares the real FFT and the sqrt Hann window of spectral_noise_reduction_3() for the frame size ts.NR_FFT_L
+ *
+ * The window is used for analysis and synthesis, with half-overlapping frames the product
+ * of both adds up to exactly 1.0, so the signal passes unchanged when all gains are 1.0
+ */
+static void AudioNr_FftInit(void)
+{
+    arm_rfft_fast_init_f32(&NR.rfft, ts.NR_FFT_L);
+
+    for (int idx = 0; idx < ts.NR_FFT_L; idx++)
+    {
+        NR.window[idx] = sinf(PI * idx / ts.NR_FFT_L);
+    }
+
+    // the smoothing coefficients are tuned for FFT256 (one frame every 10.67ms at 12ksps),
+    // scale them so that the time constants stay the same for other frame lengths
+    NR2.ax = powf(0.7405, ts.NR_FFT_L / 256.0);
+    NR2.ap = powf(0.8691, ts.NR_FFT_L / 256.0);
+}
+
 void spectral_noise_reduction_3 (float* in_buffer)
 {
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -1783,8 +1873,8 @@ void spectral_noise_reduction_3 (float* in_buffer)
 // https://github.com/df8oe/UHSDR/wiki/Noise-reduction
 //
 // half-overlapping input buffers (= overlap 50%)
-// Hann window on 128 or 256 samples
-// FFT128 - inverse FFT128 or FFT256 / iFFT256
+// sqrt Hann window on ts.NR_FFT_L (128, 256 or 512) samples, for analysis and synthesis
+// real FFT / real iFFT
 // overlap-add
 
 
@@ -1796,8 +1886,8 @@ if(ts.NR_decimation_enable && (FilterInfo[FilterPathInfo[ts.filter_path].id].wid
 }
 
 static uint8_t NR_init_counter = 0;
-uint8_t VAD_low=0;
-uint8_t VAD_high=63;
+int VAD_low=0;
+int VAD_high=63;
 
 float32_t width = FilterInfo[FilterPathInfo[ts.filter_path].id].width;
 float32_t offset = FilterPathInfo[ts.filter_path].offset;
@@ -1817,19 +1907,19 @@ const float32_t pspri=0.5;	// prior speech probability [0.5]
 //NR2.ax = 0.9276; 		//expf(-tinc / tax);
 //NR2.ap = 0.9655; 		//expf(-tinc / tap);
 
-// for 6ksps and FFT256
-NR2.ax = 0.7405;
-NR2.ap = 0.8691;
+// for FFT256, set by AudioNr_FftInit() for other frame lengths
+//NR2.ax = 0.7405;
+//NR2.ap = 0.8691;
 //NR2.xih1 = 31.62; 		//powf(10, (float32_t)NR2.asnr / 10.0);
 NR2.xih1 = powf(10, (float32_t)NR2.asnr / 10.0);
 NR2.xih1r = 1.0 / (1.0 + NR2.xih1) - 1.0;
 NR2.pfac= (1.0 / pspri - 1.0) * (1.0 + NR2.xih1);
 NR2.snr_prio_min = 0.001; 			//powf(10, - (float32_t)NR2.snr_prio_min_int / 10.0);  //range should be down to -30dB min
 NR2.power_threshold = (float32_t)(NR2.power_threshold_int)/100.0;
-static float32_t pslp[NR_FFT_SIZE];
-static float32_t xt[NR_FFT_SIZE];
+static float32_t pslp[NR_FFT_L_MAX / 2];
+static float32_t xt[NR_FFT_L_MAX / 2];
 float32_t xtr;
-float32_t ph1y[NR_FFT_SIZE];
+float32_t ph1y[NR_FFT_L_MAX / 2];
 
 //ax and ap adjustment according to FFT-size and decimation
 // for 12KS and 128'er FFT we are doing well with the above values
@@ -1860,9 +1950,12 @@ Board_RedLed(LED_STATE_OFF);
     if(ts.nr_first_time == 1)
     { // TODO: properly initialize all the variables
 
+		AudioNr_FftInit();
+
 		for(int bindx = 0; bindx < ts.NR_FFT_L / 2; bindx++)
 			{
 				  NR.last_sample_buffer_L[bindx] = 0.0;
+				  NR.last_iFFT_result[bindx] = 0.0;
 				  NR.Hk[bindx] = 1.0;
 				//xu[bindx] = 1.0;  //has to be replaced by other variable
 				  NR.Hk_old[bindx] = 1.0; // old gain or xu in development mode
@@ -1874,61 +1967,36 @@ Board_RedLed(LED_STATE_OFF);
         ts.nr_first_time = 2; // we need to do some more a bit later down
     }
 
+    // the first half of FFT_buffer holds the real time domain frame, the second half the spectrum
+    // in the packed format of arm_rfft_fast_f32: DC, Nyquist, then re/im of bins 1 ... NR_FFT_L/2 - 1
+    float32_t* const NR_frame = &NR.FFT_buffer[0];
+    float32_t* const NR_spectrum = &NR.FFT_buffer[ts.NR_FFT_L];
+    const int NR_half = ts.NR_FFT_L / 2;
+
     for(int k = 0; k < ts.NR_FFT_LOOP_NO; k++)
     {
-    // NR_FFT_buffer is 256 floats big
-    // interleaved r, i, r, i . . .
-    // fill first half of FFT_buffer with last events audio samples
-          for(int i = 0; i < ts.NR_FFT_L / 2; i++)
-          {
-            NR.FFT_buffer[i * 2] = NR.last_sample_buffer_L[i]; // real
-            NR.FFT_buffer[i * 2 + 1] = 0.0; // imaginary
-          }
-    // copy recent samples to last_sample_buffer for next time!
-          for(int i = 0; i < ts.NR_FFT_L  / 2; i++)
-          {
-             NR.last_sample_buffer_L [i] = in_buffer[i + k * (ts.NR_FFT_L / 2)];
-          }
-    // now fill recent audio samples into second half of FFT_buffer
-          for(int i = 0; i < ts.NR_FFT_L / 2; i++)
-          {
-              NR.FFT_buffer[ts.NR_FFT_L + i * 2] = in_buffer[i+ k * (ts.NR_FFT_L / 2)]; // real
-              NR.FFT_buffer[ts.NR_FFT_L + i * 2 + 1] = 0.0;
-          }
-    /////////////////////////////////7
-    // WINDOWING
+          float32_t* const in_frame = &in_buffer[k * NR_half];
 
-//          if(ts.nr_fft_256_enable)
+          // half-overlapping frames: last events audio samples followed by the recent ones, analysis window applied on the way
+          for(int i = 0; i < NR_half; i++)
           {
-        	  for (int idx = 0; idx < ts.NR_FFT_L; idx++)
-              {
-        	  	  NR.FFT_buffer[idx * 2] *= SQRT_von_Hann_256[idx];
-              }
-              arm_cfft_f32(&arm_cfft_sR_f32_len256, NR.FFT_buffer, 0, 1);
+              NR_frame[i] = NR.last_sample_buffer_L[i] * NR.window[i];
+              NR_frame[NR_half + i] = in_frame[i] * NR.window[NR_half + i];
+              NR.last_sample_buffer_L[i] = in_frame[i];
           }
-          /*else
-          {
-              for (int idx = 0; idx < ts.NR_FFT_L; idx++)
-              {
-            	  NR.FFT_buffer[idx * 2] *= SQRT_van_hann[idx];
-              }
-              arm_cfft_f32(&arm_cfft_sR_f32_len128, NR.FFT_buffer, 0, 1);
-          }*/
-
-    // NR_FFT
-    // calculation is performed in-place the FFT_buffer [re, im, re, im, re, im . . .]
 
+          arm_rfft_fast_f32(&NR.rfft, NR_frame, NR_spectrum, 0);
 
-
-	  for(int bindx = 0; bindx < ts.NR_FFT_L / 2; bindx++)
+	  //here we need squared magnitude, there are no users of the magnitude itself
+	  NR2.X[0][0] = NR_spectrum[0] * NR_spectrum[0];
+	  for(int bindx = 1; bindx < NR_half; bindx++)
 		{
-		  //here we need squared magnitude
-			NR2.X[bindx][0] = (NR.FFT_buffer[bindx * 2] * NR.FFT_buffer[bindx * 2] + NR.FFT_buffer[bindx * 2 + 1] * NR.FFT_buffer[bindx * 2 + 1]);
+			NR2.X[bindx][0] = NR_spectrum[bindx * 2] * NR_spectrum[bindx * 2] + NR_spectrum[bindx * 2 + 1] * NR_spectrum[bindx * 2 + 1];
 		}
 
       if(ts.nr_first_time == 2)
       {
- 		  for(int bindx = 0; bindx < ts.NR_FFT_L / 2; bindx++)
+ 		  for(int bindx = 0; bindx < NR_half; bindx++)
 		  {
 			  NR.Nest[bindx][0] = NR.Nest[bindx][0] + 0.05* NR2.X[bindx][0];// we do it 20 times to average over 20 frames for app. 100ms only on NR_on/bandswitch/modeswitch,...
 			  xt[bindx] = psini * NR.Nest[bindx][0];
@@ -1945,7 +2013,7 @@ Board_RedLed(LED_STATE_OFF);
 
  //new noise estimate MMSE based!!!
 
-		for(int bindx = 0; bindx < ts.NR_FFT_L / 2; bindx++)// 1. Step of NR - calculate the SNR's
+		for(int bindx = 0; bindx < NR_half; bindx++)// 1. Step of NR - calculate the SNR's
     	{
 		      ph1y[bindx] = 1.0 / (1.0 + NR2.pfac * expf(NR2.xih1r * NR2.X[bindx][0]/xt[bindx]));
 		      pslp[bindx] = NR2.ap * pslp[bindx] + (1.0 - NR2.ap) * ph1y[bindx];
@@ -1964,7 +2032,7 @@ Board_RedLed(LED_STATE_OFF);
         }
 
 
-	  	  for(int bindx = 0; bindx < ts.NR_FFT_L / 2; bindx++)// 1. Step of NR - calculate the SNR's
+	  	  for(int bindx = 0; bindx < NR_half; bindx++)// 1. Step of NR - calculate the SNR's
 			 {
 			   NR.SNR_post[bindx] = fmax(fmin(NR2.X[bindx][0] / xt[bindx],1000.0), NR2.snr_prio_min); // limited to +30 /-15 dB, might be still too much of reduction, let's try it?
 
@@ -1984,45 +2052,40 @@ Board_RedLed(LED_STATE_OFF);
                 	  VAD_low = 1;
                   }
                   else
-				  if(VAD_low > ts.NR_FFT_L / 2 - 2)
+				  if(VAD_low > NR_half - 2)
 				  {
-					  VAD_low = ts.NR_FFT_L / 2 - 2;
+					  VAD_low = NR_half - 2;
 				  }
                   if(VAD_high < 1)
                   {
                 	  VAD_high = 1;
                   }
                   else
-				  if(VAD_high > ts.NR_FFT_L / 2)
+				  if(VAD_high > NR_half)
 				  {
-					  VAD_high = ts.NR_FFT_L / 2;
+					  VAD_high = NR_half;
 				  }
 
 
   	  // 4    calculate v = SNRprio(n, bin[i]) / (SNRprio(n, bin[i]) + 1) * SNRpost(n, bin[i]) (eq. 12 of Schmitt et al. 2002, eq. 9 of Romanin et al. 2009)
      //		   and calculate the HK's
-
+		// the gain is calculated as power gain Hk^2, this is what Hk_old and the musical noise reduction need,
+		// only the spectral weighting needs the amplitude gain and takes the square root
+		NR2.pre_power = 0.0;
+		NR2.post_power = 0.0;
 		for(int bindx = VAD_low; bindx < VAD_high; bindx++)// maybe we should limit this to the signal containing bins (filtering!!)
 		{
-			  float32_t v = NR.SNR_prio[bindx] * NR.SNR_post[bindx] / (1.0 + NR.SNR_prio[bindx]);
-
-			  NR.Hk[bindx] = fmax(1.0 / NR.SNR_post[bindx] * sqrtf((0.7212 * v + v * v)),0.001); //limit HK's to 0.001'
+			  const float32_t v = NR.SNR_prio[bindx] * NR.SNR_post[bindx] / (1.0 + NR.SNR_prio[bindx]);
 
-			  NR.Hk_old[bindx] = NR.SNR_post[bindx] * NR.Hk[bindx] * NR.Hk[bindx]; //
+			  // Hk = sqrt(0.7212 * v + v * v) / SNR_post, limited to 0.001
+			  const float32_t Hk2 = fmax((0.7212 * v + v * v) / (NR.SNR_post[bindx] * NR.SNR_post[bindx]), 0.001 * 0.001);
 
+			  arm_sqrt_f32(Hk2, &NR.Hk[bindx]);
+			  NR.Hk_old[bindx] = NR.SNR_post[bindx] * Hk2;
 
-			  /*if(!(ts.dsp_active & DSP_NR_ENABLE)) // if NR is not enabled (but notch is enabled !)
-			  {
-				  NR.Hk[bindx] = 1.0;
-			  } */
-		}
-		// musical noise "artefact" reduction by dynamic averaging - depending on SNR ratio
-		NR2.pre_power = 0.0;
-		NR2.post_power = 0.0;
-		for(int bindx = VAD_low; bindx < VAD_high; bindx++)
-		{
-		    NR2.pre_power += NR2.X[bindx][0];
-		    NR2.post_power += NR.Hk[bindx] * NR.Hk[bindx]  * NR2.X[bindx][0];
+			  // musical noise "artefact" reduction by dynamic averaging - depending on SNR ratio
+			  NR2.pre_power += NR2.X[bindx][0];
+			  NR2.post_power += Hk2 * NR2.X[bindx][0];
 		}
 
 		NR2.power_ratio = NR2.post_power / NR2.pre_power;
@@ -2079,54 +2142,28 @@ Board_RedLed(LED_STATE_OFF);
 	}	//end of "if ts.nr_first_time == 3"
 
 
-        // FINAL SPECTRAL WEIGHTING: Multiply current FFT results with NR_FFT_buffer for 64 bins with the 64 bin-specific gain factors
-              // only do this for the bins inside the filter passband
-              // if you do this for all the bins, you will get distorted audio: plopping !
-              //              for(int bindx = 0; bindx < ts.NR_FFT_L / 2; bindx++) // plopping !!!!
-                for(int bindx = VAD_low; bindx < VAD_high; bindx++) // no plopping
-              {
-                  NR.FFT_buffer[bindx * 2] = 						NR.FFT_buffer [bindx * 2] * NR.Hk[bindx]; // real part
-                  NR.FFT_buffer[bindx * 2 + 1] = 					NR.FFT_buffer [bindx * 2 + 1] * NR.Hk[bindx]; // imag part
-                  NR.FFT_buffer[ts.NR_FFT_L * 2 - bindx * 2 - 2] = 	NR.FFT_buffer[ts.NR_FFT_L * 2 - bindx * 2 - 2] * NR.Hk[bindx]; // real part conjugate symmetric
-                  NR.FFT_buffer[ts.NR_FFT_L * 2 - bindx * 2 - 1] = 	NR.FFT_buffer[ts.NR_FFT_L * 2 - bindx * 2 - 1] * NR.Hk[bindx]; // imag part conjugate symmetric
-//                  NR.FFT_buffer[bindx * 2] = NR.FFT_buffer [bindx * 2] * NR.Hk[bindx] * NR2.long_tone_gain[bindx]; // real part
-//                  NR.FFT_buffer[bindx * 2 + 1] = NR.FFT_buffer [bindx * 2 + 1] * NR.Hk[bindx] * NR2.long_tone_gain[bindx]; // imag part
-//                  NR.FFT_buffer[ts.NR_FFT_L * 2 - bindx * 2 - 2] = NR.FFT_buffer[ts.NR_FFT_L * 2 - bindx * 2 - 2] * NR.Hk[bindx] * NR2.long_tone_gain[bindx]; // real part conjugate symmetric
-//                  NR.FFT_buffer[ts.NR_FFT_L * 2 - bindx * 2 - 1] = NR.FFT_buffer[ts.NR_FFT_L * 2 - bindx * 2 - 1] * NR.Hk[bindx] * NR2.long_tone_gain[bindx]; // imag part conjugate symmetric
-              }
+        // FINAL SPECTRAL WEIGHTING: Multiply current FFT results with the bin-specific gain factors
+        // only do this for the bins inside the filter passband
+        // if you do this for all the bins, you will get distorted audio: plopping !
+        // the real FFT has no negative frequencies, so there is no conjugate symmetric half to take care of
+        for(int bindx = VAD_low; bindx < VAD_high; bindx++) // no plopping
+        {
+            NR_spectrum[bindx * 2] *= NR.Hk[bindx]; // real part
+            NR_spectrum[bindx * 2 + 1] *= NR.Hk[bindx]; // imag part
+        }
 
          /*****************************************************************
          * NOISE REDUCTION CODE ENDS HERE
          *****************************************************************/
-// NR_iFFT
-// & Window on exit!
-//      if(ts.nr_fft_256_enable)
-      {
-          arm_cfft_f32(&arm_cfft_sR_f32_len256, NR.FFT_buffer, 1, 1);
-    	  for (int idx = 0; idx < ts.NR_FFT_L; idx++)
-          {
-    	  	  NR.FFT_buffer[idx * 2] *= SQRT_von_Hann_256[idx];
-          }
-      }
-      /*else
-      {
-          arm_cfft_f32(&arm_cfft_sR_f32_len128, NR.FFT_buffer, 1, 1);
-          for (int idx = 0; idx < ts.NR_FFT_L; idx++)
-          {
-        	  NR.FFT_buffer[idx * 2] *= SQRT_van_hann[idx];
-          }
-      }*/
+        arm_rfft_fast_f32(&NR.rfft, NR_spectrum, NR_frame, 1);
 
-    // do the overlap & add
-          for(int i = 0; i < ts.NR_FFT_L / 2; i++)
-          { // take real part of first half of current iFFT result and add to 2nd half of last iFFT_result
-        	  //              NR_output_audio_buffer[i + k * (ts.NR_FFT_L / 2)] = NR_FFT_buffer[i * 2] + NR_last_iFFT_result[i];
-        	  in_buffer[i + k * (ts.NR_FFT_L / 2)] = NR.FFT_buffer[i * 2] + NR.last_iFFT_result[i];
-          }
-          for(int i = 0; i < ts.NR_FFT_L / 2; i++)
-          {
-              NR.last_iFFT_result[i] = NR.FFT_buffer[ts.NR_FFT_L + i * 2];
-          }
+        // synthesis window and overlap & add:
+        // first half of current iFFT result is added to 2nd half of last iFFT_result
+        for(int i = 0; i < NR_half; i++)
+        {
+            in_frame[i] = NR_frame[i] * NR.window[i] + NR.last_iFFT_result[i];
+            NR.last_iFFT_result[i] = NR_frame[NR_half + i] * NR.window[NR_half + i];
+        }
        // end of "for" loop which repeats the FFT_iFFT_chain two times !!!
     }
 
@@ -2134,6 +2171,33 @@ Board_RedLed(LED_STATE_OFF);
   //  arm_biquad_cascade_df1_f32 (&NR_notch_biquad, in_buffer, in_buffer, ts.NR_FFT_L);
 }
 
+/**
+ * @brief replaces spectral_noise_reduction_3() for a frame which has to be passed through without the FFTs,
+ * the result is what the frame would give with all gains at 1: the overlap-add of the windows is 1, so the
+ * output is the input of the previous frame, with the same one frame delay as a processed frame. The overlap
+ * state is filled from the new samples, the next frame continues without a gap or a repeated frame.
+ * @param in_buffer the new samples of the frame, replaced by the output samples
+ */
+void spectral_noise_reduction_3_skip(float* in_buffer)
+{
+    if (ts.nr_first_time != 1)
+    {
+        const int NR_half = ts.NR_FFT_L / 2;
+        for(int k = 0; k < ts.NR_FFT_LOOP_NO; k++)
+        {
+            float32_t* const in_frame = &in_buffer[k * NR_half];
+            for(int i = 0; i < NR_half; i++)
+            {
+                const float32_t in_sample = in_frame[i];
+                // second half of the last frame's synthesis plus the first half of this one at a gain of 1
+                in_frame[i] = NR.last_iFFT_result[i] + NR.last_sample_buffer_L[i] * NR.window[i] * NR.window[i];
+                NR.last_sample_buffer_L[i] = in_sample;
+                NR.last_iFFT_result[i] = in_sample * NR.window[NR_half + i] * NR.window[NR_half + i];
+            }
+        }
+    }
+}
+
 //alt noise blanking is trying to localize some impulse noise within the samples and after that
 //trying to replace corrupted samples by linear predicted samples.
 //therefore, first we calculate the lpc coefficients which represent the actual status of the
@@ -2147,7 +2211,7 @@ Board_RedLed(LED_STATE_OFF);
 //backward prediction)
 //hopefully we have enough processor power left....
 
-void alt_noise_blanking(float* insamp,int Nsam, int order, float* E )  //Nsam = 128
+void alt_noise_blanking(float* insamp,int Nsam, int order, float* E )  //Nsam = ts.NR_FFT_L / 2, at most NR_FFT_SIZE
 {
 
 #ifdef debug_alternate_NR
@@ -2305,7 +2369,7 @@ const float32_t NR_test_sinus_samp[128] = {
 
     //*****************************end of debug impulse generation
 
-    memcpy(&working_buffer[2*PL + 2*order],insamp,NR_FFT_SIZE * sizeof(float32_t));// copy incomming samples to the end of our working bufer
+    memcpy(&working_buffer[2*PL + 2*order],insamp,Nsam * sizeof(float32_t));// copy incomming samples to the end of our working bufer
 
 
     //  start of test timing zone
@@ -2360,17 +2424,17 @@ const float32_t NR_test_sinus_samp[128] = {
     for (int o = 0; o < order+1; o++ )             //store the reverse order coefficients separately
         reverse_lpcs[order-o]=lpcs[o];        // for the matched impulse filter
 
-    arm_fir_init_f32(&LPC,order+1,&reverse_lpcs[0],&firStateF32[0],NR_FFT_SIZE);                                         // we are using the same function as used in freedv
+    arm_fir_init_f32(&LPC,order+1,&reverse_lpcs[0],&firStateF32[0],Nsam);                                         // we are using the same function as used in freedv
 
     //arm_fir_f32(&LPC,insamp,tempsamp,Nsam); //do the inverse filtering to eliminate voice and enhance the impulses
     arm_fir_f32(&LPC,&working_buffer[order+PL],tempsamp,Nsam); //do the inverse filtering to eliminate voice and enhance the impulses
 
-    arm_fir_init_f32(&LPC,order+1,&lpcs[0],&firStateF32[0],NR_FFT_SIZE);                                         // we are using the same function as used in freedv
+    arm_fir_init_f32(&LPC,order+1,&lpcs[0],&firStateF32[0],Nsam);                                         // we are using the same function as used in freedv
 
     arm_fir_f32(&LPC,tempsamp,tempsamp,Nsam); // do a matched filtering to detect an impulse in our now voiceless signal
 
 
-    arm_var_f32(tempsamp,NR_FFT_SIZE,&sigma2); //calculate sigma2 of the original signal ? or tempsignal
+    arm_var_f32(tempsamp,Nsam,&sigma2); //calculate sigma2 of the original signal ? or tempsignal
 
     arm_power_f32(lpcs,order,&lpc_power);  // calculate the sum of the squares (the "power") of the lpc's
 
@@ -2397,7 +2461,7 @@ const float32_t NR_test_sinus_samp[128] = {
         search_pos++;
 
     //} while ((search_pos < NR_FFT_SIZE-boundary_blank) && (impulse_count < 5));// avoid upper boundary
-    } while ((search_pos < NR_FFT_SIZE) && (impulse_count < 5));
+    } while ((search_pos < Nsam) && (impulse_count < 5));
 
 
     // from here: reconstruction of the impulse-distorted audio part:
@@ -2470,8 +2534,8 @@ const float32_t NR_test_sinus_samp[128] = {
     //    last_frame_end[p]=insamp[NR_FFT_SIZE-1-order-PL+p];// store 13 samples from the current frame to use at the next frame
     //}
     //end of test timing zone
-memcpy(insamp,&working_buffer[order+PL],NR_FFT_SIZE * sizeof(float32_t));// copy the samples of the current frame back to the insamp-buffer for output
-memcpy(working_buffer,&working_buffer[NR_FFT_SIZE],(2*order + 2*PL) * sizeof(float32_t)); // copy
+memcpy(insamp,&working_buffer[order+PL],Nsam * sizeof(float32_t));// copy the samples of the current frame back to the insamp-buffer for output
+memcpy(working_buffer,&working_buffer[Nsam],(2*order + 2*PL) * sizeof(float32_t)); // copy
 }
 
 
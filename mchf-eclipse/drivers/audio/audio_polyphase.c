@@ -0,0 +1,398 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     audio_polyphase.c                                               **
+ **  Description:   polyphase FIR decimator / interpolator for I/Q sample pairs     **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+#include "audio_polyphase.h"
+
+/**
+ * @brief writes a block of I and Q into the state buffer, interleaved
+ */
+static inline void AudioPolyphase_StateWrite(float32_t* pState, const float32_t* pSrcI, const float32_t* pSrcQ, uint32_t blockSize)
+{
+    for (uint32_t i = 0; i < blockSize; i++)
+    {
+        pState[2 * i]     = pSrcI[i];
+        pState[2 * i + 1] = pSrcQ[i];
+    }
+}
+
+/**
+ * @brief moves the history needed by the next block to the start of the state buffer
+ * source and destination may overlap if the filter is longer than the block, hence the copy loop
+ */
+static inline void AudioPolyphase_StateShift(float32_t* pState, const float32_t* pHistory, uint32_t pairs)
+{
+    for (uint32_t i = 0; i < 2 * pairs; i++)
+    {
+        pState[i] = pHistory[i];
+    }
+}
+
+/**
+ * @brief one FIR output for I and Q, the summation order is that of the CMSIS filters
+ * @param pState oldest I/Q pair of the filter window
+ * @param pCoeffs coefficients matching the state order
+ */
+static inline void AudioPolyphase_MacIQ(const float32_t* pState, const float32_t* pCoeffs, uint32_t numTaps, float32_t* accI, float32_t* accQ)
+{
+    float32_t sumI = 0.0, sumQ = 0.0;
+    uint32_t tapCnt = numTaps >> 2;
+
+    while (tapCnt > 0)
+    {
+        float32_t c;
+        c = pCoeffs[0];
+        sumI += pState[0] * c;
+        sumQ += pState[1] * c;
+        c = pCoeffs[1];
+        sumI += pState[2] * c;
+        sumQ += pState[3] * c;
+        c = pCoeffs[2];
+        sumI += pState[4] * c;
+        sumQ += pState[5] * c;
+        c = pCoeffs[3];
+        sumI += pState[6] * c;
+        sumQ += pState[7] * c;
+
+        pState += 8;
+        pCoeffs += 4;
+        tapCnt--;
+    }
+
+    tapCnt = numTaps & 3;
+    while (tapCnt > 0)
+    {
+        const float32_t c = *pCoeffs;
+        sumI += pState[0] * c;
+        sumQ += pState[1] * c;
+
+        pState += 2;
+        pCoeffs++;
+        tapCnt--;
+    }
+
+    *accI = sumI;
+    *accQ = sumQ;
+}
+
+/**
+ * @brief same parameters as arm_fir_decimate_init_f32, but one state buffer of twice the size for I and Q
+ */
+void AudioPolyphase_DecimateIQInit(PolyphaseDecimateIQ* S, uint16_t numTaps, uint8_t M, const float32_t* pCoeffs, float32_t* pState, uint32_t blockSize)
+{
+    S->M = M;
+    S->numTaps = numTaps;
+    S->pCoeffs = pCoeffs;
+    S->pState = pState;
+
+    arm_fill_f32(0.0, pState, 2 * (numTaps + blockSize - 1));
+}
+
+/**
+ * @brief decimates I and Q by S->M, only the samples which are kept are calculated
+ * Works in place, i.e. pDstI == pSrcI and pDstQ == pSrcQ is permitted.
+ * @param blockSize number of input samples per channel, a multiple of S->M
+ */
+void AudioPolyphase_DecimateIQ(const PolyphaseDecimateIQ* S, const float32_t* pSrcI, const float32_t* pSrcQ, float32_t* pDstI, float32_t* pDstQ, uint32_t blockSize)
+{
+    const uint32_t history = S->numTaps - 1;
+    const uint32_t outBlockSize = blockSize / S->M;
+
+    AudioPolyphase_StateWrite(S->pState + 2 * history, pSrcI, pSrcQ, blockSize);
+
+    const float32_t* pWindow = S->pState;
+    for (uint32_t i = 0; i < outBlockSize; i++)
+    {
+        AudioPolyphase_MacIQ(pWindow, S->pCoeffs, S->numTaps, &pDstI[i], &pDstQ[i]);
+        pWindow += 2 * S->M;
+    }
+
+    AudioPolyphase_StateShift(S->pState, pWindow, history);
+}
+
+/**
+ * @brief one FIR output for I and Q with separate coefficients but a common walk over the state
+ */
+static inline void AudioPolyphase_MacComplex(const float32_t* pState, const float32_t* pCoeffsI, const float32_t* pCoeffsQ, uint32_t numTaps, float32_t* accI, float32_t* accQ)
+{
+    float32_t sumI = 0.0, sumQ = 0.0;
+    uint32_t tapCnt = numTaps >> 2;
+
+    while (tapCnt > 0)
+    {
+        sumI += pState[0] * pCoeffsI[0];
+        sumQ += pState[1] * pCoeffsQ[0];
+        sumI += pState[2] * pCoeffsI[1];
+        sumQ += pState[3] * pCoeffsQ[1];
+        sumI += pState[4] * pCoeffsI[2];
+        sumQ += pState[5] * pCoeffsQ[2];
+        sumI += pState[6] * pCoeffsI[3];
+        sumQ += pState[7] * pCoeffsQ[3];
+
+        pState += 8;
+        pCoeffsI += 4;
+        pCoeffsQ += 4;
+        tapCnt--;
+    }
+
+    tapCnt = numTaps & 3;
+    while (tapCnt > 0)
+    {
+        sumI += pState[0] * *pCoeffsI++;
+        sumQ += pState[1] * *pCoeffsQ++;
+
+        pState += 2;
+        tapCnt--;
+    }
+
+    *accI = sumI;
+    *accQ = sumQ;
+}
+
+/**
+ * @brief full convolution of two coefficient sets, pDst gets aLen + bLen - 1 values
+ * the CMSIS time reversed order is kept, as the convolution of the reversed sets is the reversed convolution
+ */
+static void AudioPolyphase_Convolve(const float32_t* pA, uint16_t aLen, const float32_t* pB, uint16_t bLen, float32_t* pDst)
+{
+    for (uint32_t n = 0; n < aLen + bLen - 1; n++)
+    {
+        float32_t sum = 0.0;
+        for (uint32_t k = 0; k < bLen; k++)
+        {
+            if (n >= k && n - k < aLen)
+            {
+                sum += pA[n - k] * pB[k];
+            }
+        }
+        pDst[n] = sum;
+    }
+}
+
+/**
+ * @brief prepares the fused Hilbert / decimation filter
+ * @param hilbertNumTaps, pHilbertI, pHilbertQ the arm_fir_f32 coefficients of the two Hilbert branches (iq_rx_filter.c)
+ * @param decNumTaps, M, pDecCoeffs the arm_fir_decimate_f32 filter which was applied after the demodulation
+ * @param pCoeffsI, pCoeffsQ hilbertNumTaps + decNumTaps - 1 floats each, filled here
+ * @param pState 2 * (hilbertNumTaps + decNumTaps - 2 + blockSize) floats
+ * @returns number of taps of the fused filter
+ */
+uint16_t AudioPolyphase_DecimateHilbertInit(PolyphaseDecimateHilbert* S, uint16_t hilbertNumTaps, const float32_t* pHilbertI, const float32_t* pHilbertQ,
+        uint16_t decNumTaps, uint8_t M, const float32_t* pDecCoeffs, float32_t* pCoeffsI, float32_t* pCoeffsQ, float32_t* pState, uint32_t blockSize)
+{
+    const uint16_t numTaps = hilbertNumTaps + decNumTaps - 1;
+
+    AudioPolyphase_Convolve(pHilbertI, hilbertNumTaps, pDecCoeffs, decNumTaps, pCoeffsI);
+    AudioPolyphase_Convolve(pHilbertQ, hilbertNumTaps, pDecCoeffs, decNumTaps, pCoeffsQ);
+
+    S->M = M;
+    S->numTaps = numTaps;
+    S->pCoeffsI = pCoeffsI;
+    S->pCoeffsQ = pCoeffsQ;
+    S->pState = pState;
+
+    arm_fill_f32(0.0, pState, 2 * (numTaps + blockSize - 1));
+
+    return numTaps;
+}
+
+/**
+ * @brief Hilbert transform and decimation by S->M of I and Q, only the samples which are kept are calculated
+ * Works in place, i.e. pDstI == pSrcI and pDstQ == pSrcQ is permitted.
+ * @param blockSize number of input samples per channel, a multiple of S->M
+ */
+void AudioPolyphase_DecimateHilbert(const PolyphaseDecimateHilbert* S, const float32_t* pSrcI, const float32_t* pSrcQ, float32_t* pDstI, float32_t* pDstQ, uint32_t blockSize)
+{
+    const uint32_t history = S->numTaps - 1;
+    const uint32_t outBlockSize = blockSize / S->M;
+
+    AudioPolyphase_StateWrite(S->pState + 2 * history, pSrcI, pSrcQ, blockSize);
+
+    const float32_t* pWindow = S->pState;
+    for (uint32_t i = 0; i < outBlockSize; i++)
+    {
+        AudioPolyphase_MacComplex(pWindow, S->pCoeffsI, S->pCoeffsQ, S->numTaps, &pDstI[i], &pDstQ[i]);
+        pWindow += 2 * S->M;
+    }
+
+    AudioPolyphase_StateShift(S->pState, pWindow, history);
+}
+
+/**
+ * @brief same parameters as arm_fir_interpolate_init_f32, plus the coefficient bank
+ * The CMSIS coefficients of output phase p are every L-th coefficient starting at L-1-p.
+ * They are copied into pCoeffsBank as L consecutive sub filters so that each output
+ * walks its coefficients linearly.
+ * @param numTaps a multiple of L, each output phase has numTaps / L taps
+ * @param pCoeffsBank numTaps floats, filled here
+ */
+void AudioPolyphase_InterpolateIQInit(PolyphaseInterpolateIQ* S, uint8_t L, uint16_t numTaps, const float32_t* pCoeffs, float32_t* pCoeffsBank, float32_t* pState, uint32_t blockSize)
+{
+    const uint16_t phaseLength = numTaps / L;
+
+    S->L = L;
+    S->phaseLength = phaseLength;
+    S->pCoeffs = pCoeffsBank;
+    S->pState = pState;
+
+    for (uint32_t phase = 0; phase < L; phase++)
+    {
+        for (uint32_t tap = 0; tap < phaseLength; tap++)
+        {
+            pCoeffsBank[phase * phaseLength + tap] = pCoeffs[(L - 1 - phase) + tap * L];
+        }
+    }
+
+    arm_fill_f32(0.0, pState, 2 * (phaseLength + blockSize - 1));
+}
+
+/**
+ * @brief interpolates I and Q by S->L
+ * The source block is taken into the state first, so the destination may overlap
+ * the source, e.g. pDstI == pSrcQ and pDstQ == pSrcI to swap the channels on the way.
+ * @param blockSize number of input samples per channel, the output has S->L times as many
+ */
+void AudioPolyphase_InterpolateIQ(const PolyphaseInterpolateIQ* S, const float32_t* pSrcI, const float32_t* pSrcQ, float32_t* pDstI, float32_t* pDstQ, uint32_t blockSize)
+{
+    const uint32_t history = S->phaseLength - 1;
+
+    AudioPolyphase_StateWrite(S->pState + 2 * history, pSrcI, pSrcQ, blockSize);
+
+    const float32_t* pWindow = S->pState;
+    for (uint32_t i = 0; i < blockSize; i++)
+    {
+        const float32_t* pPhaseCoeffs = S->pCoeffs;
+        for (uint32_t phase = 0; phase < S->L; phase++)
+        {
+            AudioPolyphase_MacIQ(pWindow, pPhaseCoeffs, S->phaseLength, pDstI++, pDstQ++);
+            pPhaseCoeffs += S->phaseLength;
+        }
+        pWindow += 2;
+    }
+
+    AudioPolyphase_StateShift(S->pState, pWindow, history);
+}
+
+/**
+ * @brief prepares a chain of half band decimators
+ * @param stages 0 ... POLYPHASE_HALFBAND_STAGES_MAX, the decimation factor is 2^stages
+ * @param numTaps, pCoeffs filter of all stages but the last one
+ * @param numTapsLast, pCoeffsLast filter of the last stage, which defines the final pass band
+ * @param pState 4 * ((stages - 1) * numTaps + numTapsLast) floats
+ */
+void AudioPolyphase_HalfbandCascadeInit(PolyphaseHalfbandCascade* S, uint8_t stages, uint16_t numTaps, const float32_t* pCoeffs,
+        uint16_t numTapsLast, const float32_t* pCoeffsLast, float32_t* pState)
+{
+    if (stages > POLYPHASE_HALFBAND_STAGES_MAX)
+    {
+        stages = POLYPHASE_HALFBAND_STAGES_MAX;
+    }
+
+    S->stages = stages;
+    S->phase = 0;
+
+    for (uint32_t stage = 0; stage < stages; stage++)
+    {
+        const bool last = stage == stages - 1;
+
+        S->numTaps[stage] = last ? numTapsLast : numTaps;
+        S->pCoeffs[stage] = last ? pCoeffsLast : pCoeffs;
+        S->pState[stage] = pState;
+        S->pos[stage] = 0;
+
+        arm_fill_f32(0.0, pState, 4 * S->numTaps[stage]);
+        pState += 4 * S->numTaps[stage];
+    }
+}
+
+/**
+ * @brief one half band output for I and Q
+ * Only the centre tap and the odd distances from it are non zero, and the filter is symmetric,
+ * so (numTaps + 1) / 4 + 1 multiplications per channel are enough.
+ * @param pWindow oldest I/Q pair of the filter window
+ */
+static inline void AudioPolyphase_HalfbandMacIQ(const float32_t* pWindow, const float32_t* pCoeffs, uint32_t numTaps, float32_t* accI, float32_t* accQ)
+{
+    const uint32_t centre = (numTaps - 1) / 2;
+    const float32_t* pLeft = pWindow + 2 * (centre - 1);
+    const float32_t* pRight = pWindow + 2 * (centre + 1);
+
+    float32_t sumI = pWindow[2 * centre] * pCoeffs[centre];
+    float32_t sumQ = pWindow[2 * centre + 1] * pCoeffs[centre];
+
+    const float32_t* pTap = pCoeffs + centre - 1;
+
+    for (uint32_t tapCnt = (centre + 1) / 2; tapCnt > 0; tapCnt--)
+    {
+        const float32_t c = *pTap;
+        sumI += (pLeft[0] + pRight[0]) * c;
+        sumQ += (pLeft[1] + pRight[1]) * c;
+
+        pLeft -= 4;
+        pRight += 4;
+        pTap -= 2;
+    }
+
+    *accI = sumI;
+    *accQ = sumQ;
+}
+
+/**
+ * @brief decimates I and Q by 2^S->stages
+ * Each sample runs through the stages as far as it produces outputs, so there is no block size
+ * restriction and no intermediate buffer. Works in place, i.e. pDstI == pSrcI and pDstQ == pSrcQ is permitted.
+ * @param blockSize number of input samples per channel
+ * @returns number of output samples per channel
+ */
+uint32_t AudioPolyphase_HalfbandCascade(PolyphaseHalfbandCascade* S, const float32_t* pSrcI, const float32_t* pSrcQ, float32_t* pDstI, float32_t* pDstQ, uint32_t blockSize)
+{
+    uint32_t outCnt = 0;
+
+    for (uint32_t i = 0; i < blockSize; i++)
+    {
+        float32_t sampleI = pSrcI[i];
+        float32_t sampleQ = pSrcQ[i];
+        bool output = true;
+
+        for (uint32_t stage = 0; stage < S->stages; stage++)
+        {
+            const uint32_t numTaps = S->numTaps[stage];
+            float32_t* pState = S->pState[stage];
+            uint32_t pos = S->pos[stage];
+
+            // the delay line is kept twice so that the window is always contiguous
+            pState[2 * pos] = pState[2 * (pos + numTaps)] = sampleI;
+            pState[2 * pos + 1] = pState[2 * (pos + numTaps) + 1] = sampleQ;
+            pos = pos + 1 < numTaps ? pos + 1 : 0;
+            S->pos[stage] = pos;
+
+            S->phase ^= 1 << stage;
+            if (S->phase & (1 << stage))
+            {
+                output = false;
+                break;
+            }
+
+            AudioPolyphase_HalfbandMacIQ(pState + 2 * pos, S->pCoeffs[stage], numTaps, &sampleI, &sampleQ);
+        }
+
+        if (output)
+        {
+            pDstI[outCnt] = sampleI;
+            pDstQ[outCnt] = sampleQ;
+            outCnt++;
+        }
+    }
+
+    return outCnt;
+}
@@ -0,0 +1,89 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     audio_polyphase.h                                               **
+ **  Description:   polyphase FIR decimator / interpolator for I/Q sample pairs     **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+#ifndef __AUDIO_POLYPHASE_H
+#define __AUDIO_POLYPHASE_H
+
+#include "uhsdr_types.h"
+#include "arm_math.h"
+
+/*
+ * Drop-in replacements for a pair of arm_fir_decimate_f32 / arm_fir_interpolate_f32 instances
+ * which run with the same coefficients on I and Q (or on the left and right audio channel).
+ * Both channels share one state buffer with I/Q interleaved, so each coefficient is loaded
+ * once for two multiply-accumulates and there is only one loop for both channels.
+ * The coefficients are those of the CMSIS instances, the results are identical to them.
+ *
+ * PolyphaseDecimateHilbert goes one step further for the SSB/CW paths which run the Hilbert
+ * filter at the full sample rate and decimate after the (linear) demodulation:
+ * it convolves both Hilbert branches with the decimation low pass and evaluates only the
+ * output samples which survive the decimation, producing phase shifted and decimated I/Q in one pass.
+ *
+ * PolyphaseHalfbandCascade decimates by 2^stages with a chain of half band filters, e.g. for the zoom FFT.
+ * Each stage only runs on every second output of the previous one and half of its coefficients are zero,
+ * so the total load stays below twice the load of the first stage for any number of stages.
+ */
+
+typedef struct
+{
+    uint8_t M;                  // decimation factor
+    uint16_t numTaps;
+    const float32_t* pCoeffs;   // time reversed as for arm_fir_decimate_f32
+    float32_t* pState;          // 2 * (numTaps + blockSize - 1) floats, I/Q interleaved
+} PolyphaseDecimateIQ;
+
+typedef struct
+{
+    uint8_t L;                  // interpolation factor
+    uint16_t phaseLength;
+    float32_t* pCoeffs;         // L * phaseLength floats, grouped by output phase, see AudioPolyphase_InterpolateIQInit
+    float32_t* pState;          // 2 * (phaseLength + blockSize - 1) floats, I/Q interleaved
+} PolyphaseInterpolateIQ;
+
+typedef struct
+{
+    uint8_t M;                  // decimation factor
+    uint16_t numTaps;
+    const float32_t* pCoeffsI;  // Hilbert 0 degree branch convolved with the decimation low pass, time reversed
+    const float32_t* pCoeffsQ;  // Hilbert 90 degree branch convolved with the decimation low pass, time reversed
+    float32_t* pState;          // 2 * (numTaps + blockSize - 1) floats, I/Q interleaved
+} PolyphaseDecimateHilbert;
+
+#define POLYPHASE_HALFBAND_STAGES_MAX 7
+
+typedef struct
+{
+    uint8_t stages;             // decimation by 2^stages, 0 passes the samples through
+    uint8_t phase;              // bit n set: stage n has taken the first sample of an output pair
+    uint16_t numTaps[POLYPHASE_HALFBAND_STAGES_MAX];
+    const float32_t* pCoeffs[POLYPHASE_HALFBAND_STAGES_MAX];   // symmetric, numTaps = 4k + 3
+    float32_t* pState[POLYPHASE_HALFBAND_STAGES_MAX];          // 4 * numTaps floats, I/Q interleaved and mirrored
+    uint16_t pos[POLYPHASE_HALFBAND_STAGES_MAX];
+} PolyphaseHalfbandCascade;
+
+void AudioPolyphase_DecimateIQInit(PolyphaseDecimateIQ* S, uint16_t numTaps, uint8_t M, const float32_t* pCoeffs, float32_t* pState, uint32_t blockSize);
+void AudioPolyphase_DecimateIQ(const PolyphaseDecimateIQ* S, const float32_t* pSrcI, const float32_t* pSrcQ, float32_t* pDstI, float32_t* pDstQ, uint32_t blockSize);
+
+uint16_t AudioPolyphase_DecimateHilbertInit(PolyphaseDecimateHilbert* S, uint16_t hilbertNumTaps, const float32_t* pHilbertI, const float32_t* pHilbertQ,
+        uint16_t decNumTaps, uint8_t M, const float32_t* pDecCoeffs, float32_t* pCoeffsI, float32_t* pCoeffsQ, float32_t* pState, uint32_t blockSize);
+void AudioPolyphase_DecimateHilbert(const PolyphaseDecimateHilbert* S, const float32_t* pSrcI, const float32_t* pSrcQ, float32_t* pDstI, float32_t* pDstQ, uint32_t blockSize);
+
+void AudioPolyphase_InterpolateIQInit(PolyphaseInterpolateIQ* S, uint8_t L, uint16_t numTaps, const float32_t* pCoeffs, float32_t* pCoeffsBank, float32_t* pState, uint32_t blockSize);
+void AudioPolyphase_InterpolateIQ(const PolyphaseInterpolateIQ* S, const float32_t* pSrcI, const float32_t* pSrcQ, float32_t* pDstI, float32_t* pDstQ, uint32_t blockSize);
+
+void AudioPolyphase_HalfbandCascadeInit(PolyphaseHalfbandCascade* S, uint8_t stages, uint16_t numTaps, const float32_t* pCoeffs,
+        uint16_t numTapsLast, const float32_t* pCoeffsLast, float32_t* pState);
+uint32_t AudioPolyphase_HalfbandCascade(PolyphaseHalfbandCascade* S, const float32_t* pSrcI, const float32_t* pSrcQ, float32_t* pDstI, float32_t* pDstQ, uint32_t blockSize);
+
+#endif
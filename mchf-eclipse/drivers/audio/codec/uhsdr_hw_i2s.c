@@ -103,6 +103,7 @@ static void MchfHw_Codec_HandleBlock(uint16_t which)
     // now we start again
     // profileCycleCount_start();
     profileTimedEventStop(ProfileAudioInterrupt);
+    profileStagesCommit();
 #endif
 }
 
@@ -0,0 +1,478 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                               UHSDR FIRMWARE                                    **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **  Licence:        GNU GPLv3, see LICENSE.md                                                      **
+ ************************************************************************************/
+
+/*
+ * CW filter bank: one spectrum over the passband of the CW filter feeds all CW decoders.
+ *
+ * The audio is mixed with an oscillator close to the centre of the passband and summed over
+ * CW_BANK_DECIMATION samples, which gives complex samples at CW_BANK_RATE. The summation is a crude low pass:
+ * the CW filter has removed everything outside the passband before, but the mirror image of the passband,
+ * which the mixing moves to CW_BANK_RATE minus the audio frequency, is only slightly attenuated.
+ * The searched bins therefore end below the image, which only matters for filters wider than about 1.5kHz.
+ * Every CW_BANK_HOP decimated samples the last CW_BANK_FFT_LEN of them are windowed and transformed, so each bin
+ * is a sliding DFT of CW_BANK_FFT_LEN * CW_BANK_DECIMATION audio samples, evaluated every 32 audio samples,
+ * which is the rate of the signal levels of the Goertzel decoder with the default block size.
+ *
+ * The logarithm of the power of a bin is the signal level of one CwDecoderChannel. The adaptive threshold of the decoder
+ * sits at 80% of the range between noise and signal, in dB that is close to the half amplitude points of the keying,
+ * so marks and spaces keep their length even though the window is a good part of a dot at high speed.
+ * N decoders cost one FFT plus N times the timing code, while N Goertzel decoders of the same selectivity
+ * would each need a window of 256 samples every 32 samples.
+ *
+ * The averaged bins are searched for carriers a few times per second: in CW_BANK_LOCK mode the decoder follows
+ * the strongest one, in CW_BANK_SKIM mode up to CW_SKIM_CHANNELS carriers get a decoder each.
+ */
+
+#include "uhsdr_board.h"
+#include "audio_driver.h"
+#include "cw_decoder.h"
+#include "cw_bank.h"
+#include "arm_const_structs.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CW_BANK_SAMPLE_RATE 12000
+#define CW_BANK_DECIMATION 4
+#define CW_BANK_RATE (CW_BANK_SAMPLE_RATE / CW_BANK_DECIMATION) // 3000 Hz, complex
+#define CW_BANK_FFT_LEN 64
+#define CW_BANK_BIN_HZ ((float32_t)CW_BANK_RATE / CW_BANK_FFT_LEN) // 46.875 Hz from bin to bin
+#define CW_BANK_HOP 8 // decimated samples from one spectrum to the next
+#define CW_BANK_LEVEL_RATE (CW_BANK_RATE / CW_BANK_HOP) // 375 signal levels per second
+#define CW_BANK_SPAN 12 // bins used on each side of the mixing frequency, the summation attenuates the outer ones by 0.5dB
+#define CW_BANK_NCO_LEN 64 // the mixing frequency is a multiple of CW_BANK_SAMPLE_RATE / CW_BANK_NCO_LEN = 187.5 Hz
+
+#define CW_BANK_AVG 0.01 // weight of a new spectrum in the average for the carrier search
+#define CW_BANK_SEARCH 32 // spectra from one carrier search to the next, about 12 searches per second
+#define CW_BANK_NOISE_MIN 1.0 // lower limit of the noise floor, keeps silence from looking like carriers
+#define CW_BANK_THRESHOLD 8.0 // skimmer: a carrier needs this average power over the noise floor to get a decoder
+#define CW_BANK_LOCK_THRESHOLD 4.0 // lock: the strongest carrier needs this
+#define CW_BANK_HOLD 2.0 // a carrier keeps its decoder as long as it is above this
+#define CW_BANK_MARK 8.0 // a bin below this power over the noise floor is never a mark, whatever the adaptive threshold says
+#define CW_BANK_TIMEOUT 48 // searches below CW_BANK_HOLD until the decoder is released, longer than the decoder timeout
+#define CW_BANK_DRIFT 1.5 // a neighbour bin this much stronger takes over the decoder of a drifting carrier
+#define CW_BANK_SWITCH_LEVEL 4.0 // lock: another carrier this much stronger ...
+#define CW_BANK_SWITCH 8 // ... for this many searches takes over the decoder
+#define CW_BANK_REPLAY (2 * CW_BANK_SEARCH) // spectra a new decoder gets replayed, the search finds a carrier only after its first elements
+
+#define CW_BANK_NONE (CW_BANK_SPAN + 1) // not a bin
+
+// the bins are numbered from the mixing frequency, negative ones are at the end of the FFT output
+#define CW_BANK_IDX(bin) ((bin) & (CW_BANK_FFT_LEN - 1))
+
+typedef struct
+{
+	CwDecoderChannel decoder;
+	int16_t bin;
+	bool active;
+	uint8_t timeout;
+	uint8_t switch_count;
+} CwBankChannel;
+
+typedef struct
+{
+	float32_t nco[2 * CW_BANK_NCO_LEN]; // cos and -sin of the mixing oscillator
+	uint16_t nco_idx;
+	uint16_t filter_path; // the passband the bank is set up for
+	uint8_t mode;
+	float32_t mix_freq;
+	int16_t bin_min; // searched bins, the passband of the CW filter
+	int16_t bin_max;
+	float32_t acc_i;
+	float32_t acc_q;
+	uint16_t acc_count;
+	float32_t history[4 * CW_BANK_FFT_LEN]; // complex, every sample is stored twice, the last CW_BANK_FFT_LEN are always contiguous
+	uint16_t history_idx;
+	uint16_t hop_count;
+	float32_t window[CW_BANK_FFT_LEN];
+	float32_t fft[2 * CW_BANK_FFT_LEN];
+	float32_t power[CW_BANK_FFT_LEN];
+	float32_t avg[CW_BANK_FFT_LEN]; // averaged power for the carrier search
+	float32_t noise; // noise floor of the last carrier search
+	uint16_t search_count;
+	float32_t replay[CW_BANK_REPLAY][2 * CW_BANK_SPAN + 1]; // power of the searched bins in the last spectra, indexed from -CW_BANK_SPAN
+	uint16_t replay_idx; // the oldest spectrum
+	CwBankChannel channels[CW_SKIM_CHANNELS];
+} CwBankState;
+
+static CwBankState __MCHF_SPECIALMEM cw_bank;
+
+SkimmerText cw_skimmer_text[CW_SKIM_CHANNELS];
+
+/**
+ * @brief puts the mixing frequency close to the centre of the CW filter and limits the search to its passband
+ */
+static void CwBank_SetupPassband(void)
+{
+	const FilterPathDescriptor* path_p = &FilterPathInfo[ts.filter_path];
+	const float32_t width = FilterInfo[path_p->id].width;
+	const float32_t centre = path_p->offset != 0 ? path_p->offset : width / 2;
+	const int32_t nco_k = lroundf(centre * CW_BANK_NCO_LEN / CW_BANK_SAMPLE_RATE);
+
+	for (uint16_t n = 0; n < CW_BANK_NCO_LEN; n++)
+	{
+		const float32_t phase = 2 * PI * ((nco_k * n) % CW_BANK_NCO_LEN) / CW_BANK_NCO_LEN;
+		cw_bank.nco[2 * n] = cosf(phase);
+		cw_bank.nco[2 * n + 1] = -sinf(phase);
+	}
+	cw_bank.mix_freq = (float32_t)nco_k * CW_BANK_SAMPLE_RATE / CW_BANK_NCO_LEN;
+
+	cw_bank.bin_min = ceilf((centre - width / 2 - cw_bank.mix_freq) / CW_BANK_BIN_HZ);
+	cw_bank.bin_max = floorf((centre + width / 2 - cw_bank.mix_freq) / CW_BANK_BIN_HZ);
+	if (cw_bank.bin_min < -CW_BANK_SPAN)
+	{
+		cw_bank.bin_min = -CW_BANK_SPAN;
+	}
+	if (cw_bank.bin_max > CW_BANK_SPAN)
+	{
+		cw_bank.bin_max = CW_BANK_SPAN;
+	}
+	// keep two bins away from the mirror image of the passband
+	const int16_t bin_image = floorf((CW_BANK_RATE - centre - width / 2 - cw_bank.mix_freq) / CW_BANK_BIN_HZ) - 2;
+	if (cw_bank.bin_max > bin_image)
+	{
+		cw_bank.bin_max = bin_image;
+	}
+	if (cw_bank.bin_min > cw_bank.bin_max)
+	{
+		// filter narrower than a bin
+		cw_bank.bin_min = cw_bank.bin_max = lroundf((centre - cw_bank.mix_freq) / CW_BANK_BIN_HZ);
+	}
+	cw_bank.filter_path = ts.filter_path;
+}
+
+void CwBank_Init(void)
+{
+	for (uint16_t n = 0; n < CW_BANK_FFT_LEN; n++)
+	{
+		cw_bank.window[n] = 0.5 - 0.5 * cosf(2 * PI * (n + 0.5) / CW_BANK_FFT_LEN);
+	}
+	CwBank_SetupPassband();
+
+	cw_bank.nco_idx = 0;
+	cw_bank.acc_i = 0;
+	cw_bank.acc_q = 0;
+	cw_bank.acc_count = 0;
+	memset(cw_bank.history, 0, sizeof(cw_bank.history));
+	cw_bank.history_idx = 0;
+	cw_bank.hop_count = 0;
+	memset(cw_bank.avg, 0, sizeof(cw_bank.avg));
+	cw_bank.noise = CW_BANK_NOISE_MIN;
+	cw_bank.search_count = 0;
+	memset(cw_bank.replay, 0, sizeof(cw_bank.replay));
+	cw_bank.replay_idx = 0;
+	cw_bank.mode = cw_decoder_config.bank_mode;
+
+	for (uint16_t c = 0; c < CW_SKIM_CHANNELS; c++)
+	{
+		cw_bank.channels[c].active = false;
+	}
+	SkimmerText_Reset(cw_skimmer_text, CW_SKIM_CHANNELS);
+}
+
+/**
+ * @returns the audio frequency of a bin in Hz
+ */
+static uint16_t CwBank_BinFreq(int16_t bin)
+{
+	return lroundf(cw_bank.mix_freq + bin * CW_BANK_BIN_HZ);
+}
+
+/**
+ * @returns the power below which a quarter of the searched bins are, a measure of the noise floor
+ */
+static float32_t CwBank_NoiseFloor(void)
+{
+	float32_t sorted[2 * CW_BANK_SPAN + 1];
+	const uint16_t bins = cw_bank.bin_max - cw_bank.bin_min + 1;
+
+	for (uint16_t i = 0; i < bins; i++)
+	{
+		const float32_t p = cw_bank.avg[CW_BANK_IDX(cw_bank.bin_min + i)];
+		uint16_t j = i;
+		for (; j > 0 && sorted[j - 1] > p; j--)
+		{
+			sorted[j] = sorted[j - 1];
+		}
+		sorted[j] = p;
+	}
+	return fmaxf(sorted[bins / 4], CW_BANK_NOISE_MIN);
+}
+
+/**
+ * @returns true if another channel than the given one decodes a carrier in the bin or next to it
+ */
+static bool CwBank_BinTaken(int16_t bin, int16_t except)
+{
+	bool retval = false;
+	for (int16_t c = 0; c < CW_SKIM_CHANNELS && retval == false; c++)
+	{
+		retval = c != except && cw_bank.channels[c].active && abs(cw_bank.channels[c].bin - bin) < 2;
+	}
+	return retval;
+}
+
+/**
+ * @returns the bin of the strongest carrier above the threshold, CW_BANK_NONE if there is none
+ * @param skip_taken ignore carriers which are already decoded
+ */
+static int16_t CwBank_Strongest(float32_t threshold, bool skip_taken)
+{
+	int16_t retval = CW_BANK_NONE;
+	float32_t best = threshold;
+
+	for (int16_t bin = cw_bank.bin_min; bin <= cw_bank.bin_max; bin++)
+	{
+		const float32_t p = cw_bank.avg[CW_BANK_IDX(bin)];
+		const float32_t p_lower = bin > cw_bank.bin_min ? cw_bank.avg[CW_BANK_IDX(bin - 1)] : 0;
+		const float32_t p_upper = bin < cw_bank.bin_max ? cw_bank.avg[CW_BANK_IDX(bin + 1)] : 0;
+		if (p > best && p >= p_lower && p > p_upper && (skip_taken == false || CwBank_BinTaken(bin, -1) == false))
+		{
+			best = p;
+			retval = bin;
+		}
+	}
+	return retval;
+}
+
+/**
+ * @brief the power of a bin as signal level for its decoder
+ */
+static void CwBank_Decode(CwDecoderChannel* decoder, float32_t power)
+{
+	float32_t level = log10f(power + 1);
+	if (power < cw_bank.noise * CW_BANK_MARK)
+	{
+		level = decoder->CW_noise;	// squelch, noise must not become text
+	}
+	CwDecoder_ChannelProcess(decoder, level, true);
+}
+
+/**
+ * @brief starts a decoder on a carrier, it gets the last CW_BANK_REPLAY spectra of the bin first
+ * so that the characters sent before the carrier search found it are decoded as well.
+ * The adaptive threshold starts between the noise floor and the strongest mark of the replay, from zero it would
+ * take the first elements to settle and decode key clicks of neighbour carriers as marks meanwhile.
+ */
+static void CwBank_Assign(uint16_t c, int16_t bin)
+{
+	CwBankChannel* channel = &cw_bank.channels[c];
+	const bool skim = cw_bank.mode == CW_BANK_SKIM;
+
+	float32_t peak = 0;
+	for (uint16_t n = 0; n < CW_BANK_REPLAY; n++)
+	{
+		peak = fmaxf(peak, cw_bank.replay[n][bin + CW_BANK_SPAN]);
+	}
+
+	CwDecoder_ChannelInit(&channel->decoder, CW_BANK_LEVEL_RATE, skim ? &cw_skimmer_text[c] : NULL);
+	channel->decoder.CW_noise = log10f(cw_bank.noise + 1);
+	channel->decoder.CW_env = log10f(peak + 1);
+	for (uint16_t n = 0; n < CW_BANK_REPLAY; n++)
+	{
+		CwBank_Decode(&channel->decoder, cw_bank.replay[(cw_bank.replay_idx + n) % CW_BANK_REPLAY][bin + CW_BANK_SPAN]);
+	}
+	channel->bin = bin;
+	channel->timeout = 0;
+	channel->switch_count = 0;
+	channel->active = true;
+	if (skim)
+	{
+		SkimmerText_Assign(&cw_skimmer_text[c], CwBank_BinFreq(bin));
+	}
+}
+
+/**
+ * @brief follows a drifting carrier and releases the decoder if the carrier is gone
+ */
+static void CwBank_Track(uint16_t c, float32_t noise)
+{
+	CwBankChannel* channel = &cw_bank.channels[c];
+	const float32_t p = cw_bank.avg[CW_BANK_IDX(channel->bin)];
+
+	int16_t next = channel->bin;
+	float32_t p_next = p * CW_BANK_DRIFT;
+	for (int16_t bin = channel->bin - 1; bin <= channel->bin + 1; bin += 2)
+	{
+		if (bin >= cw_bank.bin_min && bin <= cw_bank.bin_max && cw_bank.avg[CW_BANK_IDX(bin)] > p_next && CwBank_BinTaken(bin, c) == false)
+		{
+			next = bin;
+			p_next = cw_bank.avg[CW_BANK_IDX(bin)];
+		}
+	}
+	channel->bin = next;
+
+	if (p > noise * CW_BANK_HOLD)
+	{
+		channel->timeout = 0;
+	}
+	else if (++channel->timeout == CW_BANK_TIMEOUT)
+	{
+		channel->active = false;
+		// the text stays readable until the channel gets the next carrier
+		cw_skimmer_text[c].active = false;
+	}
+
+	if (cw_bank.mode == CW_BANK_SKIM)
+	{
+		cw_skimmer_text[c].freq = CwBank_BinFreq(channel->bin);
+	}
+}
+
+/**
+ * @brief lock: the decoder goes to the strongest carrier, and to another one only if that is clearly stronger for a while
+ */
+static void CwBank_SearchLock(float32_t noise)
+{
+	CwBankChannel* channel = &cw_bank.channels[0];
+	const int16_t best = CwBank_Strongest(noise * CW_BANK_LOCK_THRESHOLD, false);
+
+	if (channel->active == false)
+	{
+		if (best != CW_BANK_NONE)
+		{
+			CwBank_Assign(0, best);
+		}
+	}
+	else
+	{
+		CwBank_Track(0, noise);
+		if (channel->active && best != CW_BANK_NONE && abs(best - channel->bin) > 1
+				&& cw_bank.avg[CW_BANK_IDX(best)] > cw_bank.avg[CW_BANK_IDX(channel->bin)] * CW_BANK_SWITCH_LEVEL)
+		{
+			if (++channel->switch_count == CW_BANK_SWITCH)
+			{
+				CwBank_Assign(0, best);
+			}
+		}
+		else
+		{
+			channel->switch_count = 0;
+		}
+	}
+}
+
+/**
+ * @brief skimmer: releases the decoders of carriers which are gone and assigns free decoders to new carriers, strongest first
+ */
+static void CwBank_SearchSkim(float32_t noise)
+{
+	for (uint16_t c = 0; c < CW_SKIM_CHANNELS; c++)
+	{
+		if (cw_bank.channels[c].active)
+		{
+			CwBank_Track(c, noise);
+		}
+	}
+
+	for (uint16_t c = 0; c < CW_SKIM_CHANNELS; c++)
+	{
+		if (cw_bank.channels[c].active == false)
+		{
+			const int16_t best = CwBank_Strongest(noise * CW_BANK_THRESHOLD, true);
+			if (best == CW_BANK_NONE)
+			{
+				break;
+			}
+			CwBank_Assign(c, best);
+		}
+	}
+}
+
+/**
+ * @brief one spectrum: the signal levels for all decoders
+ */
+static void CwBank_Spectrum(void)
+{
+	const float32_t* x = &cw_bank.history[2 * cw_bank.history_idx];
+	for (uint16_t n = 0; n < CW_BANK_FFT_LEN; n++)
+	{
+		cw_bank.fft[2 * n] = cw_bank.window[n] * x[2 * n];
+		cw_bank.fft[2 * n + 1] = cw_bank.window[n] * x[2 * n + 1];
+	}
+	arm_cfft_f32(&arm_cfft_sR_f32_len64, cw_bank.fft, 0, 1);
+	arm_cmplx_mag_squared_f32(cw_bank.fft, cw_bank.power, CW_BANK_FFT_LEN);
+
+	for (int16_t bin = cw_bank.bin_min; bin <= cw_bank.bin_max; bin++)
+	{
+		float32_t* avg = &cw_bank.avg[CW_BANK_IDX(bin)];
+		*avg += CW_BANK_AVG * (cw_bank.power[CW_BANK_IDX(bin)] - *avg);
+		cw_bank.replay[cw_bank.replay_idx][bin + CW_BANK_SPAN] = cw_bank.power[CW_BANK_IDX(bin)];
+	}
+	cw_bank.replay_idx = (cw_bank.replay_idx + 1) % CW_BANK_REPLAY;
+
+	// the strongest decoded carrier drives the LED and the speed display
+	CwDecoderChannel* shown = NULL;
+	float32_t shown_power = 0;
+	for (uint16_t c = 0; c < CW_SKIM_CHANNELS; c++)
+	{
+		CwBankChannel* channel = &cw_bank.channels[c];
+		if (channel->active)
+		{
+			CwBank_Decode(&channel->decoder, cw_bank.power[CW_BANK_IDX(channel->bin)]);
+			if (cw_bank.avg[CW_BANK_IDX(channel->bin)] > shown_power)
+			{
+				shown = &channel->decoder;
+				shown_power = cw_bank.avg[CW_BANK_IDX(channel->bin)];
+			}
+		}
+	}
+	CwDecoder_ChannelShow(shown);
+
+	if (++cw_bank.search_count == CW_BANK_SEARCH)
+	{
+		cw_bank.search_count = 0;
+		const float32_t noise = CwBank_NoiseFloor();
+		cw_bank.noise = noise;
+		if (cw_bank.mode == CW_BANK_SKIM)
+		{
+			CwBank_SearchSkim(noise);
+		}
+		else
+		{
+			CwBank_SearchLock(noise);
+		}
+	}
+}
+
+/**
+ * @brief decodes the CW signals in the passband, replaces CwDecode_RxProcessor if cw_decoder_config.bank_mode is not CW_BANK_OFF
+ * @param src audio at 12 ksps
+ */
+void CwBank_ProcessBlock(const float32_t* src, int16_t blockSize)
+{
+	if (cw_bank.filter_path != ts.filter_path || cw_bank.mode != cw_decoder_config.bank_mode)
+	{
+		CwBank_Init();
+	}
+
+	for (int16_t i = 0; i < blockSize; i++)
+	{
+		const float32_t* nco = &cw_bank.nco[2 * cw_bank.nco_idx];
+		cw_bank.acc_i += src[i] * nco[0];
+		cw_bank.acc_q += src[i] * nco[1];
+		cw_bank.nco_idx = (cw_bank.nco_idx + 1) & (CW_BANK_NCO_LEN - 1);
+
+		if (++cw_bank.acc_count == CW_BANK_DECIMATION)
+		{
+			float32_t* h = &cw_bank.history[2 * cw_bank.history_idx];
+			h[0] = h[2 * CW_BANK_FFT_LEN] = cw_bank.acc_i;
+			h[1] = h[2 * CW_BANK_FFT_LEN + 1] = cw_bank.acc_q;
+			cw_bank.history_idx = (cw_bank.history_idx + 1) & (CW_BANK_FFT_LEN - 1);
+			cw_bank.acc_i = 0;
+			cw_bank.acc_q = 0;
+			cw_bank.acc_count = 0;
+
+			if (++cw_bank.hop_count == CW_BANK_HOP)
+			{
+				cw_bank.hop_count = 0;
+				CwBank_Spectrum();
+			}
+		}
+	}
+}
@@ -0,0 +1,24 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+**                                                                                 **
+**                               UHSDR FIRMWARE                                    **
+**                                                                                 **
+**---------------------------------------------------------------------------------**
+**  Licence:		GNU GPLv3, see LICENSE.md                                                      **
+************************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CW_BANK_H
+#define __CW_BANK_H
+
+#include "uhsdr_types.h"
+#include "skimmer_text.h"
+
+#define CW_SKIM_CHANNELS 4 // carriers decoded at the same time in CW_BANK_SKIM mode
+
+extern SkimmerText cw_skimmer_text[CW_SKIM_CHANNELS];
+
+void CwBank_Init(void);
+void CwBank_ProcessBlock(const float32_t* src, int16_t blockSize);
+
+#endif
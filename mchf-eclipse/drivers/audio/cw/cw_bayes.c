@@ -0,0 +1,246 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                               UHSDR FIRMWARE                                    **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **  Licence:        GNU GPLv3, see LICENSE.md                                                      **
+ ************************************************************************************/
+
+/*
+ * Timing model of the Bayesian CW decoder core.
+ *
+ * The length of an element is modelled in the logarithmic domain, where a change of speed shifts
+ * all elements by the same amount and the timing errors of a fist are about the same for all elements:
+ * log(length) = log(dot) + offset[element] + gaussian noise, a bit more for spaces than for marks.
+ * The offsets start at the standard 1:3 for marks and 1:3:7 for spaces and slowly learn the fist of the sender.
+ *
+ * The dot length is tracked by a one dimensional Kalman filter, which gives each element the weight it deserves:
+ * a lot while the speed is unknown, little once it is known, always enough to follow QSB and a drifting fist.
+ * One filter alone could mistake the dahs for dits of a three times slower signal, so CW_BAYES_HYPOTHESES
+ * filters run side by side, each classifies the elements on its own and collects the likelihood of what it sees.
+ * The best one decides. A filter which has ended up at the same dot length as the best one is restarted
+ * a factor of CW_BAYES_SPREAD away, so a new speed is always being tried.
+ *
+ * All of this is a handful of multiplications per mark or space, independent of the history.
+ */
+
+#include "uhsdr_board.h"
+#include "cw_bayes.h"
+
+#define CW_BAYES_JITTER 0.22 // standard deviation of the logarithm of a mark length, 25% timing error
+#define CW_BAYES_JITTER_SPACE 0.35 // spaces are less regular, keyer weighting and Farnsworth spacing change them
+#define CW_BAYES_DRIFT 0.03 // standard deviation of the speed change from one element to the next, logarithm
+#define CW_BAYES_VAR_INIT 0.5 // variance of the dot length of a new hypothesis, a factor 2 either way
+#define CW_BAYES_SPREAD 0.92 // log(2.5), distance of a restarted hypothesis from the best one
+#define CW_BAYES_MERGE 0.34 // log(1.4), hypotheses closer than this track the same speed
+#define CW_BAYES_MEMORY 0.9 // forgetting factor of the scores, about the last 10 elements count
+#define CW_BAYES_PENALTY 2.0 // a restarted hypothesis has to be this much more likely than the best one to take over
+#define CW_BAYES_LEARN 0.05 // weight of an element in the learned offsets
+#define CW_BAYES_OUTLIER 9.0 // an element this many variances off suggests a change of speed
+
+static const float32_t cw_bayes_offset_default[CW_ELEMENT_NUM] =
+{
+	0.0,        // log(1)
+	1.0986,     // log(3)
+	0.0,
+	1.0986,
+	1.9459,     // log(7)
+};
+
+// logarithms of how often the elements are in plain text, marks and spaces separately
+static const float32_t cw_bayes_log_prior[CW_ELEMENT_NUM] =
+{
+	-0.598,     // log(0.55)
+	-0.799,     // log(0.45)
+	-0.598,     // log(0.55)
+	-1.109,     // log(0.33)
+	-2.120,     // log(0.12)
+};
+
+/**
+ * @returns the variance of the log length of an element for a given variance of the dot length
+ */
+static inline float32_t CwBayes_Variance(float32_t var, bool mark)
+{
+	return var + (mark ? CW_BAYES_JITTER * CW_BAYES_JITTER : CW_BAYES_JITTER_SPACE * CW_BAYES_JITTER_SPACE);
+}
+
+/**
+ * @returns the log length of the element predicted by a hypothesis
+ */
+static inline float32_t CwBayes_Predict(const CwBayesModel* model, const CwBayesHypothesis* hyp, CwElement element)
+{
+	return hyp->log_dot + model->offset[element];
+}
+
+/**
+ * @brief finds the most probable element for a hypothesis
+ * @param x log length of the element
+ * @param var variance of x as predicted by the hypothesis
+ * @param cost_p negative log likelihood of the element, without the part which is the same for all elements
+ */
+static CwElement CwBayes_Classify(const CwBayesModel* model, const CwBayesHypothesis* hyp, bool mark, float32_t x, float32_t var, float32_t* cost_p)
+{
+	const CwElement first = mark ? CW_ELEMENT_DIT : CW_ELEMENT_GAP;
+	const CwElement last = mark ? CW_ELEMENT_DAH : CW_ELEMENT_WORD_GAP;
+	CwElement retval = first;
+	float32_t best_cost = INFINITY;
+
+	for (CwElement element = first; element <= last; element++)
+	{
+		float32_t e = x - CwBayes_Predict(model, hyp, element);
+		if (element == CW_ELEMENT_WORD_GAP && e > 0)
+		{
+			e = 0;      // word gaps have no upper limit, pauses are nothing unusual
+		}
+		const float32_t cost = e * e / (2 * var) - cw_bayes_log_prior[element];
+		if (cost < best_cost)
+		{
+			best_cost = cost;
+			retval = element;
+		}
+	}
+	*cost_p = best_cost;
+	return retval;
+}
+
+/**
+ * @returns the length in signal levels above which the best hypothesis prefers the longer of two neighbouring elements
+ */
+static float32_t CwBayes_Boundary(const CwBayesModel* model, CwElement shorter)
+{
+	const CwBayesHypothesis* hyp = &model->hyp[model->best];
+	const float32_t var = CwBayes_Variance(hyp->var, shorter == CW_ELEMENT_DIT);
+	const float32_t m1 = CwBayes_Predict(model, hyp, shorter);
+	const float32_t m2 = CwBayes_Predict(model, hyp, shorter + 1);
+
+	return expf((m1 + m2) / 2 + var * (cw_bayes_log_prior[shorter] - cw_bayes_log_prior[shorter + 1]) / (m2 - m1));
+}
+
+/**
+ * @brief keeps the learned element lengths in the order they have to be in, whatever the fist
+ */
+static void CwBayes_LimitOffsets(CwBayesModel* model)
+{
+	float32_t* offset = model->offset;
+
+	offset[CW_ELEMENT_DAH] = fmaxf(offset[CW_ELEMENT_DAH], offset[CW_ELEMENT_DIT] + 0.69);              // at least 1:2
+	offset[CW_ELEMENT_CHAR_GAP] = fmaxf(offset[CW_ELEMENT_CHAR_GAP], offset[CW_ELEMENT_GAP] + 0.69);
+	offset[CW_ELEMENT_WORD_GAP] = fmaxf(offset[CW_ELEMENT_WORD_GAP], offset[CW_ELEMENT_CHAR_GAP] + 0.47); // at least 1:1.6
+}
+
+static void CwBayes_UpdateBoundaries(CwBayesModel* model)
+{
+	model->dot = expf(CwBayes_Predict(model, &model->hyp[model->best], CW_ELEMENT_DIT));
+	model->dah_min = CwBayes_Boundary(model, CW_ELEMENT_DIT);
+	model->char_gap_min = CwBayes_Boundary(model, CW_ELEMENT_GAP);
+	model->word_gap_min = CwBayes_Boundary(model, CW_ELEMENT_CHAR_GAP);
+}
+
+/**
+ * @brief starts with no knowledge but a guess of the dot length
+ * @param dot dot length in signal levels
+ */
+void CwBayes_Init(CwBayesModel* model, float32_t dot)
+{
+	const float32_t start[CW_BAYES_HYPOTHESES] = { 0, CW_BAYES_SPREAD, -CW_BAYES_SPREAD };
+
+	for (uint16_t h = 0; h < CW_BAYES_HYPOTHESES; h++)
+	{
+		model->hyp[h].log_dot = logf(dot) + start[h % 3];
+		model->hyp[h].var = CW_BAYES_VAR_INIT;
+		model->hyp[h].score = h == 0 ? 0 : -CW_BAYES_PENALTY / 2;  // the guess is the most likely speed
+	}
+	for (uint16_t element = 0; element < CW_ELEMENT_NUM; element++)
+	{
+		model->offset[element] = cw_bayes_offset_default[element];
+	}
+	model->best = 0;
+	model->respawn = 0;
+	model->observed = 0;
+	CwBayes_UpdateBoundaries(model);
+}
+
+/**
+ * @brief classifies a mark or space and learns from it
+ * @param duration length in signal levels
+ * @returns what the element most probably is
+ */
+CwElement CwBayes_Observe(CwBayesModel* model, bool mark, float32_t duration)
+{
+	const float32_t x = logf(fmaxf(duration, 1.0));
+	CwElement element[CW_BAYES_HYPOTHESES];
+
+	for (uint16_t h = 0; h < CW_BAYES_HYPOTHESES; h++)
+	{
+		CwBayesHypothesis* hyp = &model->hyp[h];
+		const float32_t var = CwBayes_Variance(hyp->var, mark);
+		float32_t cost;
+
+		element[h] = CwBayes_Classify(model, hyp, mark, x, var, &cost);
+		hyp->score = CW_BAYES_MEMORY * hyp->score - cost - 0.5 * logf(var);
+
+		// a word gap says nothing about the speed, it just needs to be long enough
+		if (element[h] != CW_ELEMENT_WORD_GAP)
+		{
+			const float32_t e = x - CwBayes_Predict(model, hyp, element[h]);
+
+			if (e * e > CW_BAYES_OUTLIER * var)
+			{
+				// a stuck key, a misread element or a new speed, let the next elements tell
+				hyp->var += CW_BAYES_VAR_INIT / 4;
+			}
+			else
+			{
+				const float32_t gain = hyp->var / var;
+				hyp->log_dot += gain * e;
+				hyp->var = (1 - gain) * hyp->var + CW_BAYES_DRIFT * CW_BAYES_DRIFT;
+			}
+		}
+	}
+
+	uint8_t best = 0;
+	for (uint16_t h = 1; h < CW_BAYES_HYPOTHESES; h++)
+	{
+		if (model->hyp[h].score > model->hyp[best].score)
+		{
+			best = h;
+		}
+	}
+	model->best = best;
+	const CwBayesHypothesis* best_hyp = &model->hyp[best];
+
+	// the fist: what is left over after the dot length has been adjusted
+	if (element[best] != CW_ELEMENT_WORD_GAP)
+	{
+		float32_t* offset = &model->offset[element[best]];
+		const float32_t e = x - best_hyp->log_dot - *offset;
+		if (e * e < CW_BAYES_OUTLIER * CwBayes_Variance(0, mark))
+		{
+			// quickly at first, then slowly
+			*offset += fmaxf(CW_BAYES_LEARN, 1.0 / (2 + model->observed)) * e;
+			CwBayes_LimitOffsets(model);
+		}
+	}
+
+	for (uint16_t h = 0; h < CW_BAYES_HYPOTHESES; h++)
+	{
+		CwBayesHypothesis* hyp = &model->hyp[h];
+		if (h != best && fabsf(hyp->log_dot - best_hyp->log_dot) < CW_BAYES_MERGE)
+		{
+			model->respawn = !model->respawn;
+			hyp->log_dot = best_hyp->log_dot + (model->respawn ? CW_BAYES_SPREAD : -CW_BAYES_SPREAD);
+			hyp->var = CW_BAYES_VAR_INIT;
+			hyp->score = best_hyp->score - CW_BAYES_PENALTY;
+		}
+	}
+
+	if (model->observed < UINT16_MAX)
+	{
+		model->observed++;
+	}
+	CwBayes_UpdateBoundaries(model);
+
+	return element[best];
+}
@@ -0,0 +1,54 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+**                                                                                 **
+**                               UHSDR FIRMWARE                                    **
+**                                                                                 **
+**---------------------------------------------------------------------------------**
+**  Licence:		GNU GPLv3, see LICENSE.md                                                      **
+************************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CW_BAYES_H
+#define __CW_BAYES_H
+
+#include "uhsdr_types.h"
+
+#define CW_BAYES_HYPOTHESES 3 // dot lengths which are tracked at the same time
+
+// what a mark or a space of the keying is
+typedef enum
+{
+	CW_ELEMENT_DIT = 0,
+	CW_ELEMENT_DAH,
+	CW_ELEMENT_GAP,         // between the dits and dahs of a character
+	CW_ELEMENT_CHAR_GAP,
+	CW_ELEMENT_WORD_GAP,
+	CW_ELEMENT_NUM
+} CwElement;
+
+typedef struct
+{
+	float32_t log_dot;      // estimated dot length, natural logarithm of signal levels
+	float32_t var;          // variance of the estimate
+	float32_t score;        // log likelihood of the recent elements, old ones are forgotten
+} CwBayesHypothesis;
+
+// timing model of one CW signal
+typedef struct
+{
+	CwBayesHypothesis hyp[CW_BAYES_HYPOTHESES];
+	float32_t offset[CW_ELEMENT_NUM]; // logarithm of the element lengths in dots, learned from the fist of the sender
+	uint8_t best;           // the hypothesis which explains the keying best
+	uint8_t respawn;        // side of the next hypothesis which is restarted
+	uint16_t observed;      // elements seen, saturates
+	// decision boundaries of the best hypothesis in signal levels, updated with each element
+	float32_t dot;
+	float32_t dah_min;
+	float32_t char_gap_min;
+	float32_t word_gap_min;
+} CwBayesModel;
+
+void CwBayes_Init(CwBayesModel* model, float32_t dot);
+CwElement CwBayes_Observe(CwBayesModel* model, bool mark, float32_t duration);
+
+#endif
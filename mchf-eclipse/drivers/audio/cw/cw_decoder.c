@@ -60,17 +60,13 @@ cw_config_t cw_decoder_config =
 		.spikecancel = 0,
 		.use_3_goertzels = false,
 		.snap_enable = true,
-		.show_CW_LED = true // menu choice whether the user wants the CW LED indicator to be working or not
+		.show_CW_LED = true, // menu choice whether the user wants the CW LED indicator to be working or not
+		.bank_mode = CW_BANK_OFF,
+		.timing = CW_TIMING_CLASSIC,
 };
 
-static void CW_Decode(void);
-
-void CwDecode_FilterInit()
-{
-	// set Goertzel parameters for CW decoding
-	AudioFilter_CalcGoertzel(&cw_goertzel, ts.cw_sidetone_freq , // cw_decoder_config.target_freq,
-			cw_decoder_config.blocksize, 1.0, cw_decoder_config.sampling_freq);
-}
+static void CW_Decode(CwDecoderChannel* ch);
+static void CW_DecodeBayes(CwDecoderChannel* ch);
 
 //#define SIGNAL_TAU			0.01
 #define SIGNAL_TAU			0.1
@@ -88,42 +84,20 @@ void CwDecode_FilterInit()
 													// 14bits * 25words per min / (60 sec/min) = 5.83 bits/sec bitrate
 													// (sample_rate / blocksize) / bitrate = samples per bit !
 
+#define CW_BAYES_DOT_INIT      0.048 // Bayesian timing: dot length in seconds to start with, 25 WPM
+#define CW_BAYES_GLITCH        0.3   // states shorter than this fraction of a dot are glitches ...
+#define CW_BAYES_GLITCH_MAX    0.012 // ... but never longer than this in seconds
+#define CW_BAYES_LOCKED        16    // elements until the speed is shown
+
 #define CW_SPIKECANCEL_MAX_DURATION        8  // Cancel transients/spikes/drops that have max duration of number chosen.
 // Typically 4 or 8 to select at time periods of 4 or 8 times 2.9ms.
 // 0 to deselect.
 
 
-#define CW_SIG_BUFSIZE      256  // Size of a circular buffer of decoded input levels and durations
-#define CW_DATA_BUFSIZE      40  // Size of a buffer of accumulated dot/dash information. Max is DATA_BUFSIZE-2
-// Needs to be significantly longer than longest symbol 'sos'= ~30.
-
 // FIXME: replace with true/false (since already defined elsewhere)
 #define  TRUE  1
 #define  FALSE 0
 
-typedef struct
-{
-	unsigned state :1; // Pulse or space (sample buffer) OR Dot or Dash (data buffer)
-	unsigned time :31; // Time duration
-} sigbuf;
-
-typedef struct
-{
-	unsigned initialized :1; // Do we have valid time duration measurements?
-	unsigned dash :1; // Dash flag
-	unsigned wspace :1; // Word Space flag
-	unsigned timeout :1; // Timeout flag
-	unsigned overload :1; // Overload flag
-} bflags;
-
-static bool cw_state;                   // Current decoded signal state
-static sigbuf sig[CW_SIG_BUFSIZE]; // A circular buffer of decoded input levels and durations, input from
-
-static int32_t sig_lastrx = 0; // Circular buffer in pointer, updated by SignalSampler
-static int32_t sig_incount = 0; // Circular buffer in pointer, copy of sig_lastrx, used by CW Decode functions
-static int32_t sig_outcount = 0; // Circular buffer out pointer, used by CW Decode functions
-static int32_t sig_timer = 0; // Elapsed time of current signal state, dependent
-
 // on sample rate, decimation factor and CW_DECODE_BLOCK_SIZE
 // 48ksps & decimation-by-4 equals 12ksps
 // if CW_DECODE_BLOCK_SIZE == 32, then we have 12000/32 = 375 blocks per second, which means
@@ -131,29 +105,9 @@ static int32_t sig_timer = 0; // Elapsed time of current signal state, dependent
 // this is very similar to the original 2.9ms (when using FFT256 in the Teensy 3 original sketch)
 // DD4WH 2017_09_08
 static int32_t timer_stepsize = 1; // equivalent to 2.67ms, see above
-static int32_t cur_time;                     // copy of sig_timer
-static int32_t cur_outcount = 0; // Basically same as sig_outcount, for Error Correction functionality
-static int32_t last_outcount = 0; // sig_outcount for previous character, used for Error Correction func
 
-sigbuf data[CW_DATA_BUFSIZE]; // Buffer containing decoded dot/dash and time information
-// for assembly into a character
-static uint8_t data_len = 0;             // Length of incoming character data
-
-static uint32_t code; // Decoded dot/dash info in pairs of bits, - is encoded as 11, and . is encoded as 10
-
-static bflags b;                            // Various Operational state flags
-
-typedef struct
-{
-	float32_t pulse_avg; // CW timing variables - pulse_avg is a composite value
-	float32_t dot_avg;
-	float32_t dash_avg;            // Dot and Dash Space averages
-	float32_t symspace_avg;
-	float32_t cwspace_avg; // Intra symbol Space and Character-Word Space
-	int32_t w_space;                      // Last word space time
-} cw_times_t;
-
-static cw_times_t cw_times;
+// the decoder of the fixed frequency Goertzel, which is also the one for the tune helper
+static CwDecoderChannel cw_channel = { .old_siglevel = 0.001 };
 
 // audio signal buffer
 static float32_t raw_signal_buffer[CW_DECODER_BLOCKSIZE_MAX];  //cw_decoder_config.blocksize];
@@ -178,108 +132,70 @@ static float32_t raw_signal_buffer[CW_DECODER_BLOCKSIZE_MAX];  //cw_decoder_conf
 
 // RINGBUFFER HELPER MACROS END
 
-static void CW_Decode_exe(void)
+void CwDecode_FilterInit()
+{
+	// set Goertzel parameters for CW decoding
+	AudioFilter_CalcGoertzel(&cw_goertzel, ts.cw_sidetone_freq , // cw_decoder_config.target_freq,
+			cw_decoder_config.blocksize, 1.0, cw_decoder_config.sampling_freq);
+	// the timing of the decoder is in blocks, start again
+	CwDecoder_ChannelInit(&cw_channel, ONE_SECOND, NULL);
+	cw_channel.level_rate = cw_decoder_config.sampling_freq / (float32_t)cw_decoder_config.blocksize;
+}
+
+/**
+ * @brief resets the decoder of one signal
+ * @param one_second number of signal levels per second
+ * @param text where the decoded characters go, NULL for the text message line
+ */
+void CwDecoder_ChannelInit(CwDecoderChannel* ch, int32_t one_second, SkimmerText* text)
+{
+	memset(ch, 0, sizeof(*ch));
+	ch->old_siglevel = 0.001;
+	ch->one_second = one_second;
+	ch->level_rate = one_second;
+	ch->text = text;
+}
+
+/**
+ * @brief decides mark or space from the next signal level, records the state changes and decodes them
+ * @param level signal level, squared magnitude or its logarithm, one value per 1/ch->one_second seconds
+ * @param adaptive if true the threshold follows signal and noise, otherwise cw_decoder_config.thresh is used
+ * @returns true if the signal is a mark
+ */
+bool CwDecoder_ChannelProcess(CwDecoderChannel* ch, float32_t level, bool adaptive)
 {
 	bool newstate;
-	static float32_t CW_env = 0.0;
-	static float32_t CW_mag = 0.0;
-	static float32_t CW_noise = 0.0;
 	float32_t CW_clipped = 0.0;
-
-	static float32_t old_siglevel = 0.001;
-	static float32_t speed_wpm_avg = 0.0;
 	float32_t siglevel;                	// signal level from Goertzel calculation
-	static bool prevstate; 				// Last recorded state of signal input (mark or space)
-
-	//    1.) get samples
-	// these are already in raw_signal_buffer
-
-	//    2.) calculate Goertzel
-	for (uint16_t index = 0; index < cw_decoder_config.blocksize; index++)
-	{
-		AudioFilter_GoertzelInput(&cw_goertzel, raw_signal_buffer[index]);
-	}
-
-	float32_t magnitudeSquared = AudioFilter_GoertzelEnergy(&cw_goertzel);
 
 	// I am not sure whether we would need an AGC here, because the audio chain already has an AGC
 	// Now I am sure, we do not need it
-	//    3.) AGC
-
-#if 0
-
-	float32_t pklvl;                   	// Used for AGC calculations
-	if (cw_decoder_config.AGC_enable)
-	{
-		pklvl = CW_agcvol * CW_vol * magnitudeSquared; // Get level at Goertzel frequency
-		if (pklvl > AGC_MAX_PEAK)
-			CW_agcvol = CW_agcvol * CW_AGC_ATTACK; // Decrease volume if above this level.
-		if (pklvl < AGC_MIN_PEAK)
-			CW_agcvol = CW_agcvol * CW_AGC_DECAY; // Increase volume if below this level.
-		if (CW_agcvol > 1.0)
-			CW_agcvol = 1.0;                 // Cap max at 1.0
-		siglevel = CW_agcvol * CW_vol * pklvl;
-	}
-	else
-#endif
-	{
-		siglevel = magnitudeSquared;
-	}
-	//    4.) signal averaging/smoothing
-
-#if 0
-
-	static float32_t avg_win[20]; // Sliding window buffer for signal averaging, if used
-	static uint8_t avg_cnt = 0;                        // Sliding window counter
-
-	avg_win[avg_cnt] = siglevel;     // Add value onto "sliding window" buffer
-	avg_cnt = ring_idx_increment(avg_cnt, cw_decoder_config.average);
-
-	float32_t lvl = 0;                 	// Multiuse variable
-	for (uint8_t x = 0; x < cw_decoder_config.average; x++) // Average up all values within sliding window
-	{
-		lvl = lvl + avg_win[x];
-	}
-	siglevel = lvl / cw_decoder_config.average;
-
-#else
-	// better use exponential averager for averaging/smoothing here !? Let�s try!
-//	siglevel = siglevel * SIGNAL_TAU + ONEM_SIGNAL_TAU * old_siglevel;
-//	old_siglevel = magnitudeSquared;
-#endif
-
+	siglevel = level;
 
 	// 4b.) automatic threshold correction
-	if(cw_decoder_config.use_3_goertzels)
+	if(adaptive)
 	{
-	CW_mag = siglevel;
-	CW_env = decayavg(CW_env, CW_mag, (CW_mag > CW_env)?
+	float32_t CW_mag = siglevel;
+	ch->CW_env = decayavg(ch->CW_env, CW_mag, (CW_mag > ch->CW_env)?
 			//				(CW_ONE_BIT_SAMPLE_COUNT / 4) : (CW_ONE_BIT_SAMPLE_COUNT * 16));
 				(cw_decoder_config.thresh /1000 / 4) : (cw_decoder_config.thresh /1000 * 16));
 
-	CW_noise = decayavg(CW_noise, CW_mag, (CW_mag < CW_noise)?
+	ch->CW_noise = decayavg(ch->CW_noise, CW_mag, (CW_mag < ch->CW_noise)?
 			//(CW_ONE_BIT_SAMPLE_COUNT / 4) : (CW_ONE_BIT_SAMPLE_COUNT * 48));
 			(cw_decoder_config.thresh /1000 / 4) : (cw_decoder_config.thresh /1000 * 48));
 
-	CW_clipped = CW_mag > CW_env? CW_env: CW_mag;
+	CW_clipped = CW_mag > ch->CW_env? ch->CW_env: CW_mag;
 
-	if (CW_clipped < CW_noise)
+	if (CW_clipped < ch->CW_noise)
 	{
-		CW_clipped = CW_noise;
+		CW_clipped = ch->CW_noise;
 	}
 
-	float32_t v1 = (CW_clipped - CW_noise) * (CW_env - CW_noise) -
-					0.8 * ((CW_env - CW_noise) * (CW_env - CW_noise));
-	//				0.85 * ((CW_env - CW_noise) * (CW_env - CW_noise));
-//				 ((CW_env - CW_noise) * (CW_env - CW_noise));
-//	0.25 * ((CW_env - CW_noise) * (CW_env - CW_noise));
-
-	//lowpass
+	float32_t v1 = (CW_clipped - ch->CW_noise) * (ch->CW_env - ch->CW_noise) -
+					0.8 * ((ch->CW_env - ch->CW_noise) * (ch->CW_env - ch->CW_noise));
 
-//	v1 = RttyDecoder_lowPass(v1, rttyDecoderData.lpfConfig, &rttyDecoderData.lpfData);
-		siglevel = v1 * SIGNAL_TAU + ONEM_SIGNAL_TAU * old_siglevel;
-		old_siglevel = v1;
-//	bool newstate = (siglevel > 0)? false:true;
+		siglevel = v1 * SIGNAL_TAU + ONEM_SIGNAL_TAU * ch->old_siglevel;
+		ch->old_siglevel = v1;
 	newstate = (siglevel < 0)? false:true;
 	}
 	//    5.) signal state determination
@@ -290,88 +206,122 @@ static void CW_Decode_exe(void)
 	// of same (changed state) to accept change (i.e. a single sample change is ignored).
 	else
 	{
-		siglevel = siglevel * SIGNAL_TAU + ONEM_SIGNAL_TAU * old_siglevel;
-		old_siglevel = magnitudeSquared;
+		siglevel = siglevel * SIGNAL_TAU + ONEM_SIGNAL_TAU * ch->old_siglevel;
+		ch->old_siglevel = level;
 		newstate = (siglevel >= cw_decoder_config.thresh);
 	}
 
 	if(cw_decoder_config.noisecancel_enable)
 	{
-		static bool change; // reads to be the same to confirm a true change
-
-		if (change == TRUE)
+		if (ch->change == TRUE)
 		{
-			cw_state = newstate;
-			change = FALSE;
+			ch->cw_state = newstate;
+			ch->change = FALSE;
 		}
-		else if (newstate != cw_state)
+		else if (newstate != ch->cw_state)
 		{
-			change = TRUE;
+			ch->change = TRUE;
 		}
 
 	}
 	else
 	{// No noise canceling
-		cw_state = newstate;
+		ch->cw_state = newstate;
 	}
 
-	ads.CW_signal = cw_state;
-//	if(ts.dmod_mode == DEMOD_CW)
-	if(cw_decoder_config.show_CW_LED == true && ts.cw_decoder_enable)
-		{
-			Board_RedLed(cw_state == true? LED_STATE_ON : LED_STATE_OFF);
-		}
-
 	//    6.) fill into circular buffer
 	//----------------
 	// Record state changes and durations onto circular buffer
-	if (cw_state != prevstate)
+	if (ch->cw_state != ch->prevstate)
 	{
 		// Enter the type and duration of the state change into the circular buffer
-		sig[sig_lastrx].state = prevstate;
-		sig[sig_lastrx].time = sig_timer;
+		ch->sig[ch->sig_lastrx].state = ch->prevstate;
+		ch->sig[ch->sig_lastrx].time = ch->sig_timer;
 
 		// Zero circular buffer when at max
-		sig_lastrx = ring_idx_increment(sig_lastrx, CW_SIG_BUFSIZE);
+		ch->sig_lastrx = ring_idx_increment(ch->sig_lastrx, CW_SIG_BUFSIZE);
 
-		sig_timer = 0;                                // Zero the signal timer.
-		prevstate = cw_state;                            // Update state
+		ch->sig_timer = 0;                                // Zero the signal timer.
+		ch->prevstate = ch->cw_state;                            // Update state
 	}
 
 	//----------------
 	// Count signal state timer upwards based on which sampling rate is in effect
-	sig_timer = sig_timer + timer_stepsize;
+	ch->sig_timer = ch->sig_timer + timer_stepsize;
 
-	if (sig_timer > ONE_SECOND * CW_TIMEOUT)
+	if (ch->sig_timer > ch->one_second * CW_TIMEOUT)
 	{
-		sig_timer = ONE_SECOND * CW_TIMEOUT; // Impose a MAXTIME second boundary for overflow time
+		ch->sig_timer = ch->one_second * CW_TIMEOUT; // Impose a MAXTIME second boundary for overflow time
 	}
 
-	sig_incount = sig_lastrx;                         // Current Incount pointer
-	cur_time = sig_timer;
+	ch->sig_incount = ch->sig_lastrx;                         // Current Incount pointer
+	ch->cur_time = ch->sig_timer;
 
 	//    7.) CW Decode
 	if(ts.cw_decoder_enable && ts.dmod_mode == DEMOD_CW)
 	{
-	  CW_Decode();                                     // Do all the heavy lifting
+		if (cw_decoder_config.timing == CW_TIMING_BAYES)
+		{
+			CW_DecodeBayes(ch);
+		}
+		else
+		{
+			ch->timing = CW_TIMING_CLASSIC;
+			CW_Decode(ch);                                     // Do all the heavy lifting
+		}
 	}
-	// calculation of speed of the received morse signal on basis of the standard "PARIS"
-	float32_t spdcalc =  10.0 * cw_times.dot_avg + 4.0 * cw_times.dash_avg + 9.0 * cw_times.symspace_avg + 5.0 * cw_times.cwspace_avg;
 
-	// update only if initialized and prevent division  by zero
-	if(b.initialized == true && spdcalc > 0)
+	if (ch->timing == CW_TIMING_BAYES)
 	{
-		// Convert to Milliseconds per Word
-		float32_t speed_ms_per_word = spdcalc * 1000.0 / (cw_decoder_config.sampling_freq / (float32_t)cw_decoder_config.blocksize);
-		float32_t speed_wpm_raw = (0.5 + 60000.0 / speed_ms_per_word); // calculate words per minute
-		speed_wpm_avg = speed_wpm_raw * 0.3 + 0.7 * speed_wpm_avg; // a little lowpass filtering
+		// the model knows the dot length, PARIS has 50 dots
+		if (ch->bayes.observed >= CW_BAYES_LOCKED)
+		{
+			float32_t speed_wpm_raw = 0.5 + 1.2 * ch->level_rate / ch->bayes.dot;
+			ch->speed_wpm_avg = speed_wpm_raw * 0.3 + 0.7 * ch->speed_wpm_avg;
+		}
+		else
+		{
+			ch->speed_wpm_avg = 0;
+		}
 	}
 	else
 	{
-		speed_wpm_avg = 0; // we have no calculated speed, i.e. not synchronized to signal
+		// calculation of speed of the received morse signal on basis of the standard "PARIS"
+		float32_t spdcalc =  10.0 * ch->cw_times.dot_avg + 4.0 * ch->cw_times.dash_avg + 9.0 * ch->cw_times.symspace_avg + 5.0 * ch->cw_times.cwspace_avg;
+
+		// update only if initialized and prevent division  by zero
+		if(ch->b.initialized == true && spdcalc > 0)
+		{
+			// Convert to Milliseconds per Word
+			float32_t speed_ms_per_word = spdcalc * 1000.0 / ch->level_rate;
+			float32_t speed_wpm_raw = (0.5 + 60000.0 / speed_ms_per_word); // calculate words per minute
+			ch->speed_wpm_avg = speed_wpm_raw * 0.3 + 0.7 * ch->speed_wpm_avg; // a little lowpass filtering
+		}
+		else
+		{
+			ch->speed_wpm_avg = 0; // we have no calculated speed, i.e. not synchronized to signal
+		}
 	}
 
-	cw_decoder_config.speed = speed_wpm_avg; // for external use, 0 indicates no signal condition
+	return ch->cw_state;
+}
+
+/**
+ * @brief shows the state and the speed of the decoder which is listened to
+ * @param ch the decoder, NULL if there is no signal
+ */
+void CwDecoder_ChannelShow(CwDecoderChannel* ch)
+{
+	const bool cw_state = ch != NULL && ch->cw_state;
+
+	ads.CW_signal = cw_state;
+//	if(ts.dmod_mode == DEMOD_CW)
+	if(cw_decoder_config.show_CW_LED == true && ts.cw_decoder_enable)
+		{
+			Board_RedLed(cw_state == true? LED_STATE_ON : LED_STATE_OFF);
+		}
+
+	cw_decoder_config.speed = ch != NULL ? ch->speed_wpm_avg : 0; // for external use, 0 indicates no signal condition
 
 	if(ts.txrx_mode == TRX_MODE_TX)
 	{	// just to ensure that during RX/TX switching the red LED remains lit in TX_mode
@@ -379,6 +329,23 @@ static void CW_Decode_exe(void)
 	}
 }
 
+static void CW_Decode_exe(void)
+{
+	//    1.) get samples
+	// these are already in raw_signal_buffer
+
+	//    2.) calculate Goertzel
+	for (uint16_t index = 0; index < cw_decoder_config.blocksize; index++)
+	{
+		AudioFilter_GoertzelInput(&cw_goertzel, raw_signal_buffer[index]);
+	}
+
+	float32_t magnitudeSquared = AudioFilter_GoertzelEnergy(&cw_goertzel);
+
+	CwDecoder_ChannelProcess(&cw_channel, magnitudeSquared, cw_decoder_config.use_3_goertzels);
+	CwDecoder_ChannelShow(&cw_channel);
+}
+
 void CwDecode_RxProcessor(float32_t * const src, int16_t blockSize)
 {
 	static uint16_t sample_counter = 0;
@@ -405,85 +372,83 @@ void CwDecode_RxProcessor(float32_t * const src, int16_t blockSize)
 // Output is variables containing dot dash and space averages
 //
 //------------------------------------------------------------------
-static void InitializationFunc(void)
+static void InitializationFunc(CwDecoderChannel* ch)
 {
-	static int16_t startpos, progress;   // Progress counter, size = SIG_BUFSIZE
-	static bool initializing = FALSE; // Bool for first time init of progress counter
 	int16_t processed;              // Number of states that have been processed
 	float32_t t;                     // We do timing calculations in floating point
 	// to gain a little bit of precision when low
 	// sampling rate
 	// Set up progress counter at beginning of initialize
-	if (initializing == FALSE)
+	if (ch->initializing == FALSE)
 	{
-		startpos = sig_outcount;        // We start at last processed mark/space
-		progress = sig_outcount;
-		initializing = TRUE;
-		cw_times.pulse_avg = 0;                         // Reset CW timing variables to 0
-		cw_times.dot_avg = 0;
-		cw_times.dash_avg = 0;
-		cw_times.symspace_avg = 0;
-		cw_times.cwspace_avg = 0;
-		cw_times.w_space = 0;
+		ch->init_startpos = ch->sig_outcount;        // We start at last processed mark/space
+		ch->init_progress = ch->sig_outcount;
+		ch->initializing = TRUE;
+		ch->cw_times.pulse_avg = 0;                         // Reset CW timing variables to 0
+		ch->cw_times.dot_avg = 0;
+		ch->cw_times.dash_avg = 0;
+		ch->cw_times.symspace_avg = 0;
+		ch->cw_times.cwspace_avg = 0;
+		ch->cw_times.w_space = 0;
 	}
 	//    Board_RedLed(LED_STATE_ON);
 
 	// Determine number of states waiting to be processed
-	processed = ring_distanceFromTo(startpos,progress);
+	processed = ring_distanceFromTo(ch->init_startpos,ch->init_progress);
 
 	if (processed >= 98)
 	{
-		b.initialized = TRUE;                  // Indicate we're done and return
-		initializing = FALSE;          // Allow for correct setup of progress if
+		ch->b.initialized = TRUE;                  // Indicate we're done and return
+		ch->initializing = FALSE;          // Allow for correct setup of progress if
 		// InitializaitonFunc is invoked a second time
 		// Board_RedLed(LED_STATE_OFF);
 	}
-	if (progress != sig_incount)                      // Do we have a new state?
+	if (ch->init_progress != ch->sig_incount)                      // Do we have a new state?
 	{
-		t = sig[progress].time;
+		t = ch->sig[ch->init_progress].time;
 
-		if (sig[progress].state)                               // Is it a pulse?
+		if (ch->sig[ch->init_progress].state)                               // Is it a pulse?
 		{
 			if (processed > 32)                  // More than 32, getting stable
 			{
-				if (t > cw_times.pulse_avg)
+				if (t > ch->cw_times.pulse_avg)
 				{
-					cw_times.dash_avg = cw_times.dash_avg + (t - cw_times.dash_avg) / 4.0;    // (e.q. 4.5)
+					ch->cw_times.dash_avg = ch->cw_times.dash_avg + (t - ch->cw_times.dash_avg) / 4.0;    // (e.q. 4.5)
 				}
 				else
 				{
-					cw_times.dot_avg = cw_times.dot_avg + (t - cw_times.dot_avg) / 4.0;       // (e.q. 4.4)
+					ch->cw_times.dot_avg = ch->cw_times.dot_avg + (t - ch->cw_times.dot_avg) / 4.0;       // (e.q. 4.4)
 				}
 			}
 			else                           // Less than 32, still quite unstable
 			{
-				if (t > cw_times.pulse_avg)
+				if (t > ch->cw_times.pulse_avg)
 				{
-					cw_times.dash_avg = (t + cw_times.dash_avg) / 2.0;               // (e.q. 4.2)
+					ch->cw_times.dash_avg = (t + ch->cw_times.dash_avg) / 2.0;               // (e.q. 4.2)
 				}
 				else
 				{
-					cw_times.dot_avg = (t + cw_times.dot_avg) / 2.0;                 // (e.q. 4.1)
+					ch->cw_times.dot_avg = (t + ch->cw_times.dot_avg) / 2.0;                 // (e.q. 4.1)
 				}
 			}
-			cw_times.pulse_avg = (cw_times.dot_avg / 4 + cw_times.dash_avg) / 2.0; // Update pulse_avg (e.q. 4.3)
+			ch->cw_times.pulse_avg = (ch->cw_times.dot_avg / 4 + ch->cw_times.dash_avg) / 2.0; // Update pulse_avg (e.q. 4.3)
 		}
 		else          // Not a pulse - determine character_word space avg
 		{
 			if (processed > 32)
 			{
-				if (t > cw_times.pulse_avg)                              // Symbol space?
+				if (t > ch->cw_times.pulse_avg)                              // Symbol space?
 				{
-					cw_times.cwspace_avg = cw_times.cwspace_avg + (t - cw_times.cwspace_avg) / 4.0; // (e.q. 4.8)
+					ch->cw_times.cwspace_avg = ch->cw_times.cwspace_avg + (t - ch->cw_times.cwspace_avg) / 4.0; // (e.q. 4.8)
 				}
 				else
 				{
-					cw_times.symspace_avg = cw_times.symspace_avg + (t - cw_times.symspace_avg) / 4.0; // New EQ, to assist calculating Rate
+					ch->cw_times.symspace_avg = ch->cw_times.symspace_avg + (t - ch->cw_times.symspace_avg) / 4.0; // New EQ, to assist calculating Rate
 				}
 			}
 		}
 
-		progress = ring_idx_increment(progress,CW_SIG_BUFSIZE);                                // Increment progress counter
+		ch->init_progress = ring_idx_increment(ch->init_progress,CW_SIG_BUFSIZE);                                // Increment progress counter
 	}
 }
 
@@ -496,7 +461,7 @@ static void InitializationFunc(void)
 //
 //------------------------------------------------------------------
 
-bool CwDecoder_IsSpike(uint32_t t)
+static bool CwDecoder_IsSpike(CwDecoderChannel* ch, uint32_t t)
 {
 	bool retval = false;
 
@@ -506,31 +471,29 @@ bool CwDecoder_IsSpike(uint32_t t)
 	}
 	else if (cw_decoder_config.spikecancel == CW_SPIKECANCEL_MODE_SHORT) // SHORT CANCEL // Squash spikes shorter than 1/3rd dot duration
 	{
-		retval = (3 * t < cw_times.dot_avg) && (b.initialized == TRUE); // Only do this if we are not initializing dot/dash periods
+		retval = (3 * t < ch->cw_times.dot_avg) && (ch->b.initialized == TRUE); // Only do this if we are not initializing dot/dash periods
 	}
 	return retval;
 }
 
 
-float32_t spikeCancel(float32_t t)
+static float32_t spikeCancel(CwDecoderChannel* ch, float32_t t)
 {
-	static bool spike;
-
 	if (cw_decoder_config.spikecancel != CW_SPIKECANCEL_MODE_OFF)
 	{
-		if (CwDecoder_IsSpike(t) == true)
+		if (CwDecoder_IsSpike(ch, t) == true)
 		{
-			spike = TRUE;
-			sig_outcount = ring_idx_increment(sig_outcount, CW_SIG_BUFSIZE); // If short, then do nothing
+			ch->spike = TRUE;
+			ch->sig_outcount = ring_idx_increment(ch->sig_outcount, CW_SIG_BUFSIZE); // If short, then do nothing
 			t = 0.0;
 		}
-		else if (spike == TRUE) // Check if last state was a short Spike or Drop
+		else if (ch->spike == TRUE) // Check if last state was a short Spike or Drop
 		{
-			spike = FALSE;
+			ch->spike = FALSE;
 			// Add time of last three states together.
 			t =		t
-					+ sig[ring_idx_change(sig_outcount, -1, CW_SIG_BUFSIZE)].time
-					+ sig[ring_idx_change(sig_outcount, -2, CW_SIG_BUFSIZE)].time;
+					+ ch->sig[ring_idx_change(ch->sig_outcount, -1, CW_SIG_BUFSIZE)].time
+					+ ch->sig[ring_idx_change(ch->sig_outcount, -2, CW_SIG_BUFSIZE)].time;
 		}
 	}
 
@@ -552,57 +515,56 @@ float32_t spikeCancel(float32_t t)
 // In addition, b.wspace flag indicates whether long (word) space after char
 //
 //------------------------------------------------------------------
-bool DataRecognitionFunc(bool* new_char_p)
+static bool DataRecognitionFunc(CwDecoderChannel* ch, bool* new_char_p)
 {
 	bool not_done = FALSE;                  // Return value
-	static bool processed;
 
 	*new_char_p = FALSE;
 
 	//-----------------------------------
 	// Do we have a new state to process?
-	if (sig_outcount != sig_incount)
+	if (ch->sig_outcount != ch->sig_incount)
 	{
 		not_done = true;
-		b.timeout = FALSE;           // Mainly used by Error Correction Function
+		ch->b.timeout = FALSE;           // Mainly used by Error Correction Function
 
-		const float32_t t = spikeCancel(sig[sig_outcount].time); // Get time of the new state
+		const float32_t t = spikeCancel(ch, ch->sig[ch->sig_outcount].time); // Get time of the new state
 		// Squash spikes/transients if enabled
 		// Attention: Side Effect -> sig_outcount has been be incremented inside spikeCancel if result == 0, because of this we increment only if not 0
 
 		if (t > 0) // not a spike (or spike processing not enabled)
 		{
-			const bool is_markstate = sig[sig_outcount].state;
+			const bool is_markstate = ch->sig[ch->sig_outcount].state;
 
-			sig_outcount = ring_idx_increment(sig_outcount, CW_SIG_BUFSIZE); // Update process counter
+			ch->sig_outcount = ring_idx_increment(ch->sig_outcount, CW_SIG_BUFSIZE); // Update process counter
 			//-----------------------------------
 			// Is it a Mark (keydown)?
 			if (is_markstate == true)
 			{
-				processed = FALSE; // Indicate that incoming character is not processed
+				ch->processed = FALSE; // Indicate that incoming character is not processed
 
 				// Determine if Dot or Dash (e.q. 4.10)
-				if ((cw_times.pulse_avg - t) >= 0)                         // It is a Dot
+				if ((ch->cw_times.pulse_avg - t) >= 0)                         // It is a Dot
 				{
-					b.dash = FALSE;                           // Clear Dash flag
-					data[data_len].state = 0;                   // Store as Dot
-					cw_times.dot_avg = cw_times.dot_avg + (t - cw_times.dot_avg) / 8.0; // Update cw_times.dot_avg (e.q. 4.6)
+					ch->b.dash = FALSE;                           // Clear Dash flag
+					ch->data[ch->data_len].state = 0;                   // Store as Dot
+					ch->cw_times.dot_avg = ch->cw_times.dot_avg + (t - ch->cw_times.dot_avg) / 8.0; // Update cw_times.dot_avg (e.q. 4.6)
 				}
 				//-----------------------------------
 				// Is it a Dash?
 				else
 				{
-					b.dash = TRUE;                              // Set Dash flag
-					data[data_len].state = 1;                   // Store as Dash
-					if (t <= 5 * cw_times.dash_avg)        // Store time if not stuck key
+					ch->b.dash = TRUE;                              // Set Dash flag
+					ch->data[ch->data_len].state = 1;                   // Store as Dash
+					if (t <= 5 * ch->cw_times.dash_avg)        // Store time if not stuck key
 					{
-						cw_times.dash_avg = cw_times.dash_avg + (t - cw_times.dash_avg) / 8.0; // Update dash_avg (e.q. 4.7)
+						ch->cw_times.dash_avg = ch->cw_times.dash_avg + (t - ch->cw_times.dash_avg) / 8.0; // Update dash_avg (e.q. 4.7)
 					}
 				}
 
-				data[data_len].time = (uint32_t) t;     // Store associated time
-				data_len++;                         // Increment by one dot/dash
-				cw_times.pulse_avg = (cw_times.dot_avg / 4 + cw_times.dash_avg) / 2.0; // Update pulse_avg (e.q. 4.3)
+				ch->data[ch->data_len].time = (uint32_t) t;     // Store associated time
+				ch->data_len++;                         // Increment by one dot/dash
+				ch->cw_times.pulse_avg = (ch->cw_times.dot_avg / 4 + ch->cw_times.dash_avg) / 2.0; // Update pulse_avg (e.q. 4.3)
 			}
 
 			//-----------------------------------
@@ -610,53 +572,53 @@ bool DataRecognitionFunc(bool* new_char_p)
 			else
 			{
 				bool full_char_detected = true;
-				if (b.dash == TRUE)                // Last character was a dash
+				if (ch->b.dash == TRUE)                // Last character was a dash
 				{
-				    b.dash = false;
+				    ch->b.dash = false;
 				    float32_t eq4_12 = t
-				            - (cw_times.pulse_avg
-				                    - ((uint32_t) data[data_len - 1].time
-				                            - cw_times.pulse_avg) / 4.0); // (e.q. 4.12, corrected)
+				            - (ch->cw_times.pulse_avg
+				                    - ((uint32_t) ch->data[ch->data_len - 1].time
+				                            - ch->cw_times.pulse_avg) / 4.0); // (e.q. 4.12, corrected)
 				    if (eq4_12 < 0) // Return on symbol space - not a full char yet
 				    {
-				        cw_times.symspace_avg = cw_times.symspace_avg + (t - cw_times.symspace_avg) / 8.0; // New EQ, to assist calculating Rat
+				        ch->cw_times.symspace_avg = ch->cw_times.symspace_avg + (t - ch->cw_times.symspace_avg) / 8.0; // New EQ, to assist calculating Rat
 				        full_char_detected = false;
 				    }
-				    else if (t <= 10 * cw_times.dash_avg) // Current space is not a timeout
+				    else if (t <= 10 * ch->cw_times.dash_avg) // Current space is not a timeout
 				    {
 				        float32_t eq4_14 = t
-				                - (cw_times.cwspace_avg
-				                        - ((uint32_t) data[data_len - 1].time
-				                                - cw_times.pulse_avg) / 4.0); // (e.q. 4.14)
+				                - (ch->cw_times.cwspace_avg
+				                        - ((uint32_t) ch->data[ch->data_len - 1].time
+				                                - ch->cw_times.pulse_avg) / 4.0); // (e.q. 4.14)
 				        if (eq4_14 >= 0)                   // It is a Word space
 				        {
-				            cw_times.w_space = t;
-				            b.wspace = TRUE;
+				            ch->cw_times.w_space = t;
+				            ch->b.wspace = TRUE;
 				        }
 				    }
 				}
 				else                                 // Last character was a dot
 				{
 					// (e.q. 4.11)
-					if ((t - cw_times.pulse_avg) < 0) // Return on symbol space - not a full char yet
+					if ((t - ch->cw_times.pulse_avg) < 0) // Return on symbol space - not a full char yet
 					{
-						cw_times.symspace_avg = cw_times.symspace_avg + (t - cw_times.symspace_avg) / 8.0; // New EQ, to assist calculating Rate
+						ch->cw_times.symspace_avg = ch->cw_times.symspace_avg + (t - ch->cw_times.symspace_avg) / 8.0; // New EQ, to assist calculating Rate
 						full_char_detected = false;
 					}
-					else if (t <= 10 * cw_times.dash_avg) // Current space is not a timeout
+					else if (t <= 10 * ch->cw_times.dash_avg) // Current space is not a timeout
 					{
-						cw_times.cwspace_avg = cw_times.cwspace_avg + (t - cw_times.cwspace_avg) / 8.0; // (e.q. 4.9)
+						ch->cw_times.cwspace_avg = ch->cw_times.cwspace_avg + (t - ch->cw_times.cwspace_avg) / 8.0; // (e.q. 4.9)
 
 						// (e.q. 4.13)
-						if ((t - cw_times.cwspace_avg) >= 0)        // It is a Word space
+						if ((t - ch->cw_times.cwspace_avg) >= 0)        // It is a Word space
 						{
-							cw_times.w_space = t;
-							b.wspace = TRUE;
+							ch->cw_times.w_space = t;
+							ch->b.wspace = TRUE;
 						}
 					}
 				}
 				// Process the character
-				if (full_char_detected == true && processed == FALSE)
+				if (full_char_detected == true && ch->processed == FALSE)
 				{
 					*new_char_p = TRUE; // Indicate there is a new char to be processed
 				}
@@ -665,27 +627,27 @@ bool DataRecognitionFunc(bool* new_char_p)
 	}
 	//-----------------------------------
 	// Long key down or key up
-	else if (cur_time > (10 * cw_times.dash_avg))
+	else if (ch->cur_time > (10 * ch->cw_times.dash_avg))
 	{
 		// If current state is Key up and Long key up then  Char finalized
-		if (sig[sig_incount].state == false && processed == false)
+		if (ch->sig[ch->sig_incount].state == false && ch->processed == false)
 		{
-			processed = TRUE;
-			b.wspace = TRUE;
-			b.timeout = TRUE;
+			ch->processed = TRUE;
+			ch->b.wspace = TRUE;
+			ch->b.timeout = TRUE;
 			*new_char_p = TRUE;                         // Process the character
 		}
 	}
 
-	if (data_len > CW_DATA_BUFSIZE - 2)
+	if (ch->data_len > CW_DATA_BUFSIZE - 2)
 	{
-		data_len = CW_DATA_BUFSIZE - 2; // We're receiving garble, throw away
+		ch->data_len = CW_DATA_BUFSIZE - 2; // We're receiving garble, throw away
 	}
 
 	if (*new_char_p)       // Update circular buffer pointers for Error function
 	{
-		last_outcount = cur_outcount;
-		cur_outcount = sig_outcount;
+		ch->last_outcount = ch->cur_outcount;
+		ch->cur_outcount = ch->sig_outcount;
 	}
 	return not_done;  // FALSE if all data processed or new character, else TRUE
 }
@@ -696,30 +658,37 @@ bool DataRecognitionFunc(bool* new_char_p)
 // character to a string code[] of dots and dashes
 //
 //------------------------------------------------------------------
-void CodeGenFunc()
+static void CodeGenFunc(CwDecoderChannel* ch)
 {
 	uint8_t a;
-	code = 0;
+	ch->code = 0;
 
-	for (a = 0; a < data_len; a++)
+	for (a = 0; a < ch->data_len; a++)
 	{
-		code *= 4;
-		if (data[a].state)
+		ch->code *= 4;
+		if (ch->data[a].state)
 		{
-			code += 3; // Dash
+			ch->code += 3; // Dash
 		}
 		else
 		{
-			code += 2; // Dit
+			ch->code += 2; // Dit
 		}
 	}
-	data_len = 0;                               // And make ready for a new Char
+	ch->data_len = 0;                               // And make ready for a new Char
 }
 
 
-void lcdLineScrollPrint(char c)
+static void lcdLineScrollPrint(CwDecoderChannel* ch, char c)
 {
-	UiDriver_TextMsgPutChar(c);
+	if (ch->text != NULL)
+	{
+		SkimmerText_PutChar(ch->text, c);
+	}
+	else
+	{
+		UiDriver_TextMsgPutChar(c);
+	}
 }
 
 //------------------------------------------------------------------
@@ -727,7 +696,7 @@ void lcdLineScrollPrint(char c)
 // The Print Character Function prints to LCD and Serial (USB)
 //
 //------------------------------------------------------------------
-void PrintCharFunc(uint8_t c)
+static void PrintCharFunc(CwDecoderChannel* ch, uint8_t c)
 {
 	//--------------------------------------
 
@@ -738,66 +707,66 @@ void PrintCharFunc(uint8_t c)
 	// Prosigns
 	if (c == '}')
 	{
-		lcdLineScrollPrint('c');
-		lcdLineScrollPrint('t');
+		lcdLineScrollPrint(ch, 'c');
+		lcdLineScrollPrint(ch, 't');
 	}
 	else if (c == '(')
 	{
-		lcdLineScrollPrint('k');
-		lcdLineScrollPrint('n');
+		lcdLineScrollPrint(ch, 'k');
+		lcdLineScrollPrint(ch, 'n');
 	}
 	else if (c == '&')
 	{
-		lcdLineScrollPrint('a');
-		lcdLineScrollPrint('s');
+		lcdLineScrollPrint(ch, 'a');
+		lcdLineScrollPrint(ch, 's');
 	}
 	else if (c == '~')
 	{
-		lcdLineScrollPrint('s');
-		lcdLineScrollPrint('n');
+		lcdLineScrollPrint(ch, 's');
+		lcdLineScrollPrint(ch, 'n');
 	}
 	else if (c == '>')
 	{
-		lcdLineScrollPrint('s');
-		lcdLineScrollPrint('k');
+		lcdLineScrollPrint(ch, 's');
+		lcdLineScrollPrint(ch, 'k');
 	}
 	else if (c == '+')
 	{
-		lcdLineScrollPrint('a');
-		lcdLineScrollPrint('r');
+		lcdLineScrollPrint(ch, 'a');
+		lcdLineScrollPrint(ch, 'r');
 	}
 	else if (c == '^')
 	{
-		lcdLineScrollPrint('b');
-		lcdLineScrollPrint('k');
+		lcdLineScrollPrint(ch, 'b');
+		lcdLineScrollPrint(ch, 'k');
 	}
 	else if (c == '{')
 	{
-		lcdLineScrollPrint('c');
-		lcdLineScrollPrint('l');
+		lcdLineScrollPrint(ch, 'c');
+		lcdLineScrollPrint(ch, 'l');
 	}
 	else if (c == '^')
 	{
-		lcdLineScrollPrint('a');
-		lcdLineScrollPrint('a');
+		lcdLineScrollPrint(ch, 'a');
+		lcdLineScrollPrint(ch, 'a');
 	}
 	else if (c == '%')
 	{
-		lcdLineScrollPrint('n');
-		lcdLineScrollPrint('j');
+		lcdLineScrollPrint(ch, 'n');
+		lcdLineScrollPrint(ch, 'j');
 	}
 	else if (c == 0x7f)
 	{
-		lcdLineScrollPrint('e');
-		lcdLineScrollPrint('r');
-		lcdLineScrollPrint('r');
+		lcdLineScrollPrint(ch, 'e');
+		lcdLineScrollPrint(ch, 'r');
+		lcdLineScrollPrint(ch, 'r');
 	}
 
 	//--------------------------------------
 	// # is our designated ERROR Symbol
 	else if (c == 0xff)
 	{
-		lcdLineScrollPrint('#');
+		lcdLineScrollPrint(ch, '#');
 	}
 
 	//--------------------------------------
@@ -806,12 +775,12 @@ void PrintCharFunc(uint8_t c)
 
 	/*	if (c == 0xfe || c == 0xff)
 	{
-		lcdLineScrollPrint('#');
+		lcdLineScrollPrint(ch, '#');
 	}
 	 */
 	else
 	{
-		lcdLineScrollPrint(c);
+		lcdLineScrollPrint(ch, c);
 	}
 }
 
@@ -824,25 +793,25 @@ void PrintCharFunc(uint8_t c)
 // The characters tested are applicable to the English language
 //
 //------------------------------------------------------------------
-void WordSpaceFunc(uint8_t c)
+static void WordSpaceFunc(CwDecoderChannel* ch, uint8_t c)
 {
-	if (b.wspace == TRUE)                             // Print word space
+	if (ch->b.wspace == TRUE)                             // Print word space
 	{
-		b.wspace = FALSE;
+		ch->b.wspace = FALSE;
 
 		// Word space correction routine - longer space required if certain characters
 		if ((c == 'I') || (c == 'J') || (c == 'Q') || (c == 'U') || (c == 'V')
 				|| (c == 'Z'))
 		{
-			int16_t x = (cw_times.cwspace_avg + cw_times.pulse_avg) - cw_times.w_space;      // (e.q. 4.15)
+			int16_t x = (ch->cw_times.cwspace_avg + ch->cw_times.pulse_avg) - ch->cw_times.w_space;      // (e.q. 4.15)
 			if (x < 0)
 			{
-				lcdLineScrollPrint(' ');
+				lcdLineScrollPrint(ch, ' ');
 			}
 		}
 		else
 		{
-			lcdLineScrollPrint(' ');
+			lcdLineScrollPrint(ch, ' ');
 		}
 	}
 
@@ -863,43 +832,43 @@ void WordSpaceFunc(uint8_t c)
 // Return TRUE if something was resolved.
 //
 //------------------------------------------------------------------
-bool ErrorCorrectionFunc(void)
+static bool ErrorCorrectionFunc(CwDecoderChannel* ch)
 {
 	bool result = FALSE; // Result of Error resolution - FALSE if nothing resolved
 
-	if (data_len >= CW_DATA_BUFSIZE - 2)     // Too long char received
+	if (ch->data_len >= CW_DATA_BUFSIZE - 2)     // Too long char received
 	{
-		PrintCharFunc(0xff);              // Print Error to LCD and Serial (USB)
-		WordSpaceFunc(0xff); // Print Word Space to LCD and Serial when required
+		PrintCharFunc(ch, 0xff);              // Print Error to LCD and Serial (USB)
+		WordSpaceFunc(ch, 0xff); // Print Word Space to LCD and Serial when required
 	}
 
 	else
 	{
-		b.wspace = FALSE;
+		ch->b.wspace = FALSE;
 		//-----------------------------------------------------
 		// Find the location of pulse with shortest duration
 		// and the location of symbol space of longest duration
-		int32_t temp_outcount = last_outcount; // Grab a copy of endpos for last successful decode
-		int32_t slocation = last_outcount; // Long symbol space duration and location
-		int32_t plocation = last_outcount; // Short pulse duration and location
+		int32_t temp_outcount = ch->last_outcount; // Grab a copy of endpos for last successful decode
+		int32_t slocation = ch->last_outcount; // Long symbol space duration and location
+		int32_t plocation = ch->last_outcount; // Short pulse duration and location
 		uint32_t pduration = UINT32_MAX; // Very high number to decrement for min pulse duration
 		uint32_t sduration = 0; // and a zero to increment for max symbol space duration
 
 		// if cur_outcount is < CW_SIG_BUFSIZE, loop must terminate after CW_SIG_BUFSIZE -1 steps
-		while (temp_outcount != cur_outcount)
+		while (temp_outcount != ch->cur_outcount)
 		{
 			//-----------------------------------------------------
 			// Find shortest pulse duration. Only test key-down states
-			if (sig[temp_outcount].state)
+			if (ch->sig[temp_outcount].state)
 			{
-				bool is_shortest_pulse = sig[temp_outcount].time < pduration;
+				bool is_shortest_pulse = ch->sig[temp_outcount].time < pduration;
 				// basic test -> shorter than all previously seen ones
 
-				bool is_not_spike = CwDecoder_IsSpike(sig[temp_outcount].time) == false;
+				bool is_not_spike = CwDecoder_IsSpike(ch, ch->sig[temp_outcount].time) == false;
 
 				if (is_shortest_pulse == true && is_not_spike == true)
 				{
-					pduration = sig[temp_outcount].time;
+					pduration = ch->sig[temp_outcount].time;
 					plocation = temp_outcount;
 				}
 			}
@@ -907,13 +876,13 @@ bool ErrorCorrectionFunc(void)
 			//-----------------------------------------------------
 			// Find longest symbol space duration. Do not test first state
 			// or last state and only test key-up states
-			if ((temp_outcount != last_outcount)
-					&& (temp_outcount != (cur_outcount - 1))
-					&& (!sig[temp_outcount].state))
+			if ((temp_outcount != ch->last_outcount)
+					&& (temp_outcount != (ch->cur_outcount - 1))
+					&& (!ch->sig[temp_outcount].state))
 			{
-				if (sig[temp_outcount].time > sduration)
+				if (ch->sig[temp_outcount].time > sduration)
 				{
-					sduration = sig[temp_outcount].time;
+					sduration = ch->sig[temp_outcount].time;
 					slocation = temp_outcount;
 				}
 			}
@@ -927,53 +896,53 @@ bool ErrorCorrectionFunc(void)
 		// Take corrective action by dropping shortest pulse
 		// if shorter than half of cw_times.dot_avg
 		// This can result in one or more valid characters - or Error
-		if ((pduration < cw_times.dot_avg / 2) && (plocation != temp_outcount))
+		if ((pduration < ch->cw_times.dot_avg / 2) && (plocation != temp_outcount))
 		{
 			// Add up duration of short pulse and the two spaces on either side,
 			// as space at pulse location + 1
-			sig[ring_idx_change(plocation, +1, CW_SIG_BUFSIZE)].time =
-					sig[ring_idx_change(plocation, -1, CW_SIG_BUFSIZE)].time
-					+ sig[plocation].time
-					+ sig[ring_idx_change(plocation, +1, CW_SIG_BUFSIZE)].time;
+			ch->sig[ring_idx_change(plocation, +1, CW_SIG_BUFSIZE)].time =
+					ch->sig[ring_idx_change(plocation, -1, CW_SIG_BUFSIZE)].time
+					+ ch->sig[plocation].time
+					+ ch->sig[ring_idx_change(plocation, +1, CW_SIG_BUFSIZE)].time;
 
 			// Shift the preceding data forward accordingly
 			temp_outcount = ring_idx_change(plocation, -2 ,CW_SIG_BUFSIZE);
 
 			// if last_outcount is < CW_SIG_BUFSIZE, loop must terminate after CW_SIG_BUFSIZE -1 steps
-			while (temp_outcount != last_outcount)
+			while (temp_outcount != ch->last_outcount)
 			{
-				sig[ring_idx_change(temp_outcount, +2, CW_SIG_BUFSIZE)].time =
-						sig[temp_outcount].time;
+				ch->sig[ring_idx_change(temp_outcount, +2, CW_SIG_BUFSIZE)].time =
+						ch->sig[temp_outcount].time;
 
-				sig[ring_idx_change(temp_outcount, +2, CW_SIG_BUFSIZE)].state =
-						sig[temp_outcount].state;
+				ch->sig[ring_idx_change(temp_outcount, +2, CW_SIG_BUFSIZE)].state =
+						ch->sig[temp_outcount].state;
 
 
 				temp_outcount = ring_idx_decrement(temp_outcount,CW_SIG_BUFSIZE);
 			}
 			// And finally shift the startup pointer similarly
-			sig_outcount = ring_idx_change(last_outcount, +2,CW_SIG_BUFSIZE);
+			ch->sig_outcount = ring_idx_change(ch->last_outcount, +2,CW_SIG_BUFSIZE);
 			//
 			// Now we reprocess
 			//
 			// Pull out a character, using the adjusted sig[] buffer
 			// Process character delimited by character or word space
 			bool dummy;
-			while (DataRecognitionFunc(&dummy))
+			while (DataRecognitionFunc(ch, &dummy))
 			{
 				// nothing
 			}
 
-			CodeGenFunc();                 // Generate a dot/dash pattern string
-			decoded[0] = CwGen_CharacterIdFunc(code); // Convert dot/dash data into a character
+			CodeGenFunc(ch);                 // Generate a dot/dash pattern string
+			decoded[0] = CwGen_CharacterIdFunc(ch->code); // Convert dot/dash data into a character
 			if (decoded[0] != 0xff)
 			{
-				PrintCharFunc(decoded[0]);
+				PrintCharFunc(ch, decoded[0]);
 				result = TRUE;                // Error correction had success.
 			}
 			else
 			{
-				PrintCharFunc(0xff);
+				PrintCharFunc(ch, 0xff);
 			}
 		}
 		//-----------------------------------------------------
@@ -982,9 +951,9 @@ bool ErrorCorrectionFunc(void)
 		else
 		{
 			// Split char in two by adjusting time of longest sym space to a char space
-			sig[slocation].time =
-					((cw_times.cwspace_avg - 1) >= 1 ? cw_times.cwspace_avg - 1 : 1); // Make sure it is always larger than 0
-			sig_outcount = last_outcount; // Set circ buffer reference to the start of previous failed decode
+			ch->sig[slocation].time =
+					((ch->cw_times.cwspace_avg - 1) >= 1 ? ch->cw_times.cwspace_avg - 1 : 1); // Make sure it is always larger than 0
+			ch->sig_outcount = ch->last_outcount; // Set circ buffer reference to the start of previous failed decode
 			//
 			// Now we reprocess
 			//
@@ -994,31 +963,31 @@ bool ErrorCorrectionFunc(void)
 
 			// Process first character delimited by character or word space
 			bool dummy;
-			while (DataRecognitionFunc(&dummy))
+			while (DataRecognitionFunc(ch, &dummy))
 			{
 				// nothing
 			}
 
-			CodeGenFunc();                 // Generate a dot/dash pattern string
-			decoded[0] = CwGen_CharacterIdFunc(code); // Convert dot/dash pattern into a character
+			CodeGenFunc(ch);                 // Generate a dot/dash pattern string
+			decoded[0] = CwGen_CharacterIdFunc(ch->code); // Convert dot/dash pattern into a character
 			// Process second character delimited by character or word space
 
-			while (DataRecognitionFunc(&dummy))
+			while (DataRecognitionFunc(ch, &dummy))
 			{
 				// nothing
 			}
-			CodeGenFunc();                 // Generate a dot/dash pattern string
-			decoded[1] = CwGen_CharacterIdFunc(code); // Convert dot/dash pattern into a character
+			CodeGenFunc(ch);                 // Generate a dot/dash pattern string
+			decoded[1] = CwGen_CharacterIdFunc(ch->code); // Convert dot/dash pattern into a character
 
 			if ((decoded[0] != 0xff) && (decoded[1] != 0xff)) // If successful error resolution
 			{
-				PrintCharFunc(decoded[0]);
-				PrintCharFunc(decoded[1]);
+				PrintCharFunc(ch, decoded[0]);
+				PrintCharFunc(ch, decoded[1]);
 				result = TRUE;                // Error correction had success.
 			}
 			else
 			{
-				PrintCharFunc(0xff);
+				PrintCharFunc(ch, 0xff);
 			}
 		}
 	}
@@ -1036,46 +1005,171 @@ bool ErrorCorrectionFunc(void)
 // Initialization is re-performed.
 //
 //------------------------------------------------------------------
-void CW_Decode(void)
+static void CW_Decode(CwDecoderChannel* ch)
 {
 	//-----------------------------------
 	// Initialize pulse_avg, dot_avg, cw_times.dash_avg, cw_times.symspace_avg, cwspace_avg
-	if (b.initialized == FALSE)
+	if (ch->b.initialized == FALSE)
 	{
-		InitializationFunc();
+		InitializationFunc(ch);
 	}
 
 	//-----------------------------------
 	// Process the works once initialized - or if timeout
-	if ((b.initialized == TRUE) || (cur_time >= ONE_SECOND * CW_TIMEOUT)) //
+	if ((ch->b.initialized == TRUE) || (ch->cur_time >= ch->one_second * CW_TIMEOUT)) //
 	{
 		bool received;                       // True on a symbol received
-		DataRecognitionFunc(&received);      // True if new character received
-		if (received && (data_len > 0))      // also make sure it is not a spike
+		DataRecognitionFunc(ch, &received);      // True if new character received
+		if (received && (ch->data_len > 0))      // also make sure it is not a spike
 		{
-			CodeGenFunc();                 	// Generate a dot/dash pattern string
+			CodeGenFunc(ch);                 	// Generate a dot/dash pattern string
 
-			uint8_t decoded = CwGen_CharacterIdFunc(code);
+			uint8_t decoded = CwGen_CharacterIdFunc(ch->code);
 			// Identify the Character
 			// 0xff if char not recognized
 
 			if (decoded < 0xfe)        // 0xfe = spike suppression, 0xff = error
 			{
-				PrintCharFunc(decoded);         // Print to LCD and Serial (USB)
-				WordSpaceFunc(decoded); 		// Print Word Space to LCD and Serial when required
+				PrintCharFunc(ch, decoded);         // Print to LCD and Serial (USB)
+				WordSpaceFunc(ch, decoded); 		// Print Word Space to LCD and Serial when required
 			}
 			else if (decoded == 0xff)                // Attempt Error Correction
 			{
 				// If Error Correction function cannot resolve, then reinitialize speed
-				if (ErrorCorrectionFunc() == FALSE)
+				if (ErrorCorrectionFunc(ch) == FALSE)
 				{
-					b.initialized = FALSE;
+					ch->b.initialized = FALSE;
 				}
 			}
 		}
 	}
 }
 
+//------------------------------------------------------------------
+//
+// Bayesian timing: the marks and spaces are classified by the timing model
+// of cw_bayes.c one at a time, as soon as the next state has lasted longer
+// than a glitch. Glitches, i.e. states shorter than a fraction of a dot,
+// are added to the element they interrupt. The dots and dashes are collected
+// in data[] and turned into characters by the same functions as above.
+//
+//------------------------------------------------------------------
+static void CW_DecodeBayesInit(CwDecoderChannel* ch)
+{
+	CwBayes_Init(&ch->bayes, CW_BAYES_DOT_INIT * ch->level_rate);
+	ch->run_state = false;
+	ch->run_time = 0;
+	ch->word_done = true;
+	ch->data_len = 0;
+	ch->sig_outcount = ch->sig_incount;         // forget what the other timing has left
+	ch->timing = CW_TIMING_BAYES;
+}
+
+static void CW_DecodeBayesChar(CwDecoderChannel* ch)
+{
+	if (ch->data_len > 0)
+	{
+		// the model knows more at the end of the character than at each of its elements
+		for (uint16_t i = 0; i < ch->data_len; i++)
+		{
+			ch->data[i].state = ch->data[i].time > ch->bayes.dah_min;
+		}
+		CodeGenFunc(ch);
+		const uint8_t decoded = CwGen_CharacterIdFunc(ch->code);
+		if (decoded != 0xfe)
+		{
+			PrintCharFunc(ch, decoded);       // 0xff is printed as error symbol
+		}
+		ch->word_done = false;
+	}
+}
+
+static void CW_DecodeBayesSpace(CwDecoderChannel* ch)
+{
+	if (ch->word_done == false)
+	{
+		lcdLineScrollPrint(ch, ' ');
+		ch->word_done = true;
+	}
+}
+
+static void CW_DecodeBayesElement(CwDecoderChannel* ch, bool mark, int32_t t)
+{
+	if (mark)
+	{
+		const CwElement element = CwBayes_Observe(&ch->bayes, true, t);
+		if (ch->data_len < CW_DATA_BUFSIZE - 2)
+		{
+			ch->data[ch->data_len].state = element == CW_ELEMENT_DAH;
+			ch->data[ch->data_len].time = t;
+			ch->data_len++;
+		}
+	}
+	// the silence before the first character and the pause after a word tell nothing
+	else if (ch->data_len > 0 || ch->word_done == false)
+	{
+		const CwElement element = CwBayes_Observe(&ch->bayes, false, t);
+		if (element >= CW_ELEMENT_CHAR_GAP)
+		{
+			CW_DecodeBayesChar(ch);
+		}
+		if (element == CW_ELEMENT_WORD_GAP)
+		{
+			CW_DecodeBayesSpace(ch);
+		}
+	}
+}
+
+static void CW_DecodeBayes(CwDecoderChannel* ch)
+{
+	if (ch->timing != CW_TIMING_BAYES)
+	{
+		CW_DecodeBayesInit(ch);
+	}
+
+	const float32_t glitch = fminf(CW_BAYES_GLITCH * ch->bayes.dot, CW_BAYES_GLITCH_MAX * ch->level_rate);
+
+	while (ch->sig_outcount != ch->sig_incount)
+	{
+		const bool state = ch->sig[ch->sig_outcount].state;
+		const int32_t t = ch->sig[ch->sig_outcount].time;
+		ch->sig_outcount = ring_idx_increment(ch->sig_outcount, CW_SIG_BUFSIZE);
+
+		if (state == ch->run_state || t < glitch)
+		{
+			ch->run_time += t;
+		}
+		else
+		{
+			CW_DecodeBayesElement(ch, ch->run_state, ch->run_time);
+			ch->run_state = state;
+			ch->run_time = t;
+		}
+	}
+
+	// the current state is no glitch, the element before it is complete
+	if (ch->prevstate != ch->run_state && ch->cur_time >= glitch)
+	{
+		CW_DecodeBayesElement(ch, ch->run_state, ch->run_time);
+		ch->run_state = ch->prevstate;
+		ch->run_time = 0;
+	}
+
+	// a long space ends the character and the word without waiting for the next mark
+	if (ch->run_state == false)
+	{
+		const int32_t space = ch->run_time + ch->cur_time;
+		if (space > ch->bayes.char_gap_min)
+		{
+			CW_DecodeBayesChar(ch);
+		}
+		if (space > ch->bayes.word_gap_min)
+		{
+			CW_DecodeBayesSpace(ch);
+		}
+	}
+}
+
 void CwDecoder_WpmDisplayClearOrPrepare(bool prepare)
 {
     uint16_t color1 = prepare?White:Black;
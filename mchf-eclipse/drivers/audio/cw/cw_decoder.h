@@ -8,7 +8,8 @@
 #ifndef AUDIO_CW_CW_DECODER_H_
 #define AUDIO_CW_CW_DECODER_H_
 
-
+#include "skimmer_text.h"
+#include "cw_bayes.h"
 
 
 typedef struct
@@ -33,13 +34,101 @@ typedef struct
 	bool use_3_goertzels;
 	bool snap_enable;
     bool show_CW_LED; // menu choice whether the user wants the CW LED indicator to be working or not
+	uint8_t bank_mode;
+#define CW_BANK_OFF 0 // one Goertzel at the sidetone frequency
+#define CW_BANK_LOCK 1 // filter bank over the passband, decodes the strongest carrier
+#define CW_BANK_SKIM 2 // filter bank over the passband, decodes several carriers, see cw_bank.h
+#define CW_BANK_NUM 3
+	uint8_t timing;
+#define CW_TIMING_CLASSIC 0 // running averages of the dot, dash and space lengths
+#define CW_TIMING_BAYES 1 // probabilistic model of the element lengths, see cw_bayes.c
+#define CW_TIMING_NUM 2
 } cw_config_t;
 
 extern cw_config_t cw_decoder_config;
 
 
+#define CW_SIG_BUFSIZE      256  // Size of a circular buffer of decoded input levels and durations
+#define CW_DATA_BUFSIZE      40  // Size of a buffer of accumulated dot/dash information. Max is DATA_BUFSIZE-2
+// Needs to be significantly longer than longest symbol 'sos'= ~30.
+
+typedef struct
+{
+	unsigned state :1; // Pulse or space (sample buffer) OR Dot or Dash (data buffer)
+	unsigned time :31; // Time duration
+} sigbuf;
+
+typedef struct
+{
+	unsigned initialized :1; // Do we have valid time duration measurements?
+	unsigned dash :1; // Dash flag
+	unsigned wspace :1; // Word Space flag
+	unsigned timeout :1; // Timeout flag
+	unsigned overload :1; // Overload flag
+} bflags;
+
+typedef struct
+{
+	float32_t pulse_avg; // CW timing variables - pulse_avg is a composite value
+	float32_t dot_avg;
+	float32_t dash_avg;            // Dot and Dash Space averages
+	float32_t symspace_avg;
+	float32_t cwspace_avg; // Intra symbol Space and Character-Word Space
+	int32_t w_space;                      // Last word space time
+} cw_times_t;
+
+// the complete state of one decoded CW signal, from the signal level to the decoded characters
+typedef struct
+{
+	int32_t one_second;         // signal levels per second, as integer for the timeouts
+	float32_t level_rate;       // signal levels per second, for the speed calculation
+	SkimmerText* text;          // decoded characters go here, if NULL to the text message line
+
+	// signal state detection
+	float32_t CW_env;
+	float32_t CW_noise;
+	float32_t old_siglevel;
+	bool change;                // noise cancel: the next level has to confirm the state change
+	bool cw_state;              // Current decoded signal state
+	bool prevstate;             // Last recorded state of signal input (mark or space)
+	float32_t speed_wpm_avg;
+
+	sigbuf sig[CW_SIG_BUFSIZE]; // A circular buffer of decoded input levels and durations
+	int32_t sig_lastrx;         // Circular buffer in pointer, updated by SignalSampler
+	int32_t sig_incount;        // Circular buffer in pointer, copy of sig_lastrx, used by CW Decode functions
+	int32_t sig_outcount;       // Circular buffer out pointer, used by CW Decode functions
+	int32_t sig_timer;          // Elapsed time of current signal state, in signal levels
+	int32_t cur_time;           // copy of sig_timer
+	int32_t cur_outcount;       // Basically same as sig_outcount, for Error Correction functionality
+	int32_t last_outcount;      // sig_outcount for previous character, used for Error Correction func
+
+	sigbuf data[CW_DATA_BUFSIZE]; // Buffer containing decoded dot/dash and time information for assembly into a character
+	uint8_t data_len;           // Length of incoming character data
+	uint32_t code;              // Decoded dot/dash info in pairs of bits, - is encoded as 11, and . is encoded as 10
+
+	bflags b;                   // Various Operational state flags
+	cw_times_t cw_times;
+
+	int16_t init_startpos;      // Initialization progress
+	int16_t init_progress;
+	bool initializing;
+	bool spike;                 // last state was a spike
+	bool processed;             // the current character has been processed
+
+	// Bayesian timing
+	uint8_t timing;             // the cw_decoder_config.timing the channel is set up for
+	CwBayesModel bayes;
+	bool run_state;             // state of the element which is not classified yet
+	int32_t run_time;           // its length, including glitches of the other state
+	bool word_done;             // no character since the last word space
+} CwDecoderChannel;
+
+
 void CwDecode_RxProcessor(float32_t * const src, int16_t blockSize);
 void CwDecode_FilterInit();
+void CwDecoder_ChannelInit(CwDecoderChannel* ch, int32_t one_second, SkimmerText* text);
+bool CwDecoder_ChannelProcess(CwDecoderChannel* ch, float32_t level, bool adaptive);
+void CwDecoder_ChannelShow(CwDecoderChannel* ch);
 //void CW_Decoder_WPM_display_erase();
 void CwDecoder_WpmDisplayUpdate(bool force_update);
 void CwDecoder_WpmDisplayClearOrPrepare(bool prepare);
@@ -20,7 +20,10 @@ typedef struct {
 
 extern const arm_fir_decimate_instance_f32 FirRxDecimate;
 extern const arm_fir_decimate_instance_f32 FirRxDecimate_sideband_supp;
-extern const arm_fir_decimate_instance_f32 FirZoomFFTDecimate[6];
+#define FIR_ZOOM_HALFBAND_NUM_TAPS 15
+#define FIR_ZOOM_HALFBAND_LAST_NUM_TAPS 39
+extern const float32_t FirZoomFFTHalfband[FIR_ZOOM_HALFBAND_NUM_TAPS];
+extern const float32_t FirZoomFFTHalfbandLast[FIR_ZOOM_HALFBAND_LAST_NUM_TAPS];
 extern const arm_fir_decimate_instance_f32 FirRxDecimateMinLPF;
 extern const arm_fir_interpolate_instance_f32 FirRxInterpolate;
 extern const arm_fir_interpolate_instance_f32 FirRxInterpolate_4_5k;
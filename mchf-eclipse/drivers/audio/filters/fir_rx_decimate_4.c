@@ -71,73 +71,74 @@ const arm_fir_decimate_instance_f32 FirRxDecimate_sideband_supp =
 };
 
 
-const arm_fir_decimate_instance_f32 FirZoomFFTDecimate[] =
+// Zoom FFT decimation by 2^magnify, a cascade of half band filters decimating by 2 each
+// see AudioPolyphase_HalfbandCascade. Every second coefficient is zero, the DC gain is 1.
+
+// all stages but the last: they only have to keep the aliases away from the final band,
+// which is at most 1/8 of their input sample rate
+// 15 taps, Kaiser Beta 5.0, flat (-0.02dB) to 0.125 fs, >= 54dB from 0.375 fs
+const float32_t FirZoomFFTHalfband[FIR_ZOOM_HALFBAND_NUM_TAPS] =
+{
+    -0.00166775857731089666,
+    0.0,
+    0.017216528203693255,
+    0.0,
+    -0.0690857104726787519,
+    0.0,
+    0.303775055531306071,
+    0.499523770629980546,
+    0.303775055531306071,
+    0.0,
+    -0.0690857104726787519,
+    0.0,
+    0.017216528203693255,
+    0.0,
+    -0.00166775857731089666
+};
+
+// last stage: its transition band is at the edges of the displayed band
+// 39 taps, Kaiser Beta 6.0, flat (-0.01dB) to 0.2 fs, >= 60dB from 0.3 fs
+const float32_t FirZoomFFTHalfbandLast[FIR_ZOOM_HALFBAND_LAST_NUM_TAPS] =
 {
-        {
-                .numTaps = 4,
-                .pCoeffs = (float*) (const float[])
-                {
-                    -0.3105711170561,
-                    -0.2100034101786,
-                    -0.2099936469089,
-                    -0.3105557871709
-                }
-        },
-        // 48ksps, 12kHz lowpass
-        {
-                .numTaps = 4,
-                .pCoeffs = (float*) (const float[])
-                {
-                    475.1179397144384210E-6,
-                    0.503905202786044337,
-                    0.503905202786044337,
-                    475.1179397144384210E-6
-                }
-        },
-        // 48ksps, 6kHz lowpass
-        {
-                .numTaps = 4,
-                .pCoeffs = (float*) (const float[])
-                {
-                    0.198273254218889416,
-                    0.298085149879260325,
-                    0.298085149879260325,
-                    0.198273254218889416
-                }
-        },
-        // 48ksps, 3kHz lowpass
-        {
-                .numTaps = 4,
-                .pCoeffs = (float*) (const float[])
-                {
-                    0.199820836596682871,
-                    0.272777397353925699,
-                    0.272777397353925699,
-                    0.199820836596682871
-                }
-        },
-        // 48ksps, 1.5kHz lowpass
-        {
-                .numTaps = 4,
-                .pCoeffs = (float*) (const float[])
-                {
-                    0.199820836596682871,
-                    0.272777397353925699,
-                    0.272777397353925699,
-                    0.199820836596682871
-                }
-        },
-        // 48ksps, 750Hz lowpass
-        {
-                .numTaps = 4,
-                .pCoeffs = (float*) (const float[])
-                {
-                    0.199820836596682871,
-                    0.272777397353925699,
-                    0.272777397353925699,
-                    0.199820836596682871
-                }
-        }
+    -0.000249178383205093056,
+    0.0,
+    0.00105286550937427675,
+    0.0,
+    -0.00271786393287783493,
+    0.0,
+    0.00570784125187775299,
+    0.0,
+    -0.010648937467091741,
+    0.0,
+    0.0184872250589805456,
+    0.0,
+    -0.0309857982070851495,
+    0.0,
+    0.0525102187799278142,
+    0.0,
+    -0.0990675466111970576,
+    0.0,
+    0.315908056353000621,
+    0.500006235296591606,
+    0.315908056353000621,
+    0.0,
+    -0.0990675466111970576,
+    0.0,
+    0.0525102187799278142,
+    0.0,
+    -0.0309857982070851495,
+    0.0,
+    0.018487225058980556,
+    0.0,
+    -0.010648937467091741,
+    0.0,
+    0.00570784125187775299,
+    0.0,
+    -0.00271786393287783493,
+    0.0,
+    0.0010528655093742774,
+    0.0,
+    -0.000249178383205093056
 };
 
 
@@ -24,8 +24,18 @@
 #define FDV_BUFFER_AUDIO_NUM   3
 #define FDV_BUFFER_IQ_NUM  3 // 3*320*8 = 7680
 
+// frame length limits of the spectral noise reduction, the length in use is ts.NR_FFT_L (see audio_nr.h)
+// 512 samples are too much for the RAM of the 192k STM32F4 machines
+#define NR_FFT_L_MIN    128
+#if defined(STM32F7) || defined(STM32H7)
+#define NR_FFT_L_MAX    512
+#else
+#define NR_FFT_L_MAX    256
+#endif
+
 #define NR_BUFFER_NUM  4
-#define NR_BUFFER_SIZE     256 // 4*256*8 -> 8192
+// the NR_FFT_L/2 new input samples, followed by the same number of output samples
+#define NR_BUFFER_SIZE     (NR_FFT_L_MAX / 2) // 4*128*8 -> 4096 on the mcHF
 
 typedef struct {
     int16_t samples[FDV_BUFFER_SIZE]; // this is kind of variable unfortunately, see freedv_api.h/.c for FREEDV1600 it is 360
@@ -112,113 +112,40 @@ uint16_t psk_varicode[] = {
 };
 
 
-float32_t PskBndPassB_31[] = {
-		6.6165543533213894e-05,
-		0.0,
-		-0.00013233108706642779,
-		0.0,
-		6.6165543533213894e-05
+// 4th order band pass filters around PSK_OFFSET, factored into two biquads each: b0, b1, b2, a1, a2 with
+// the CMSIS sign convention for a1, a2, the gain is in the first stage
+static const float32_t PskBndPass_31[PSK_BPF_STAGES * 5] = {
+		6.6165543533213894e-05, 0.0, -6.6165543533213894e-05, 1.9175246329071425, -0.98824964179470198,
+		1.0, 0.0, -1.0, 1.9239566734176987, -0.98874375498425482
 };
 
-float32_t PskBndPassA_31[] = {
-		1.0,
-		-3.8414813063247664,
-		5.6662277107033248,
-		-3.7972899991488904,
-		0.9771256616899302
+static const float32_t PskBndPass_63[PSK_BPF_STAGES * 5] = {
+		0.0002616526950658905, 0.0, -0.0002616526950658905, 1.9028933660088052, -0.97614769590963291,
+		1.0, 0.0, -1.0, 1.9166258590150869, -0.97810460847453184
 };
 
-float32_t PskBndPassB_63[] = {
-		0.0002616526950658905,
-		0.0,
-		-0.000523305390131781,
-		0.0,
-		0.0002616526950658905
+static const float32_t PskBndPass_125[PSK_BPF_STAGES * 5] = {
+		0.0010232176384709002, 0.0, -0.0010232176384709002, 1.8727588251952454, -0.95093288131551823,
+		1.0, 0.0, -1.0, 1.9036198320962865, -0.95863179674558008
 };
 
-float32_t PskBndPassA_63[] = {
-		1.0,
-		-3.8195192250239174,
-		5.6013869366249818,
-		-3.7321386869273105,
-		0.95477455992103932
-};
-
-float32_t PskBndPassB_125[] = {
-		0.0010232176384709002,
-		0.0,
-		-0.0020464352769418003,
-		0.0,
-		0.0010232176384709002
-};
-
-float32_t PskBndPassA_125[] = {
-		1.0,
-		-3.7763786572915334,
-		5.4745855184361272,
-		-3.6055008493327723,
-		0.91159449659996006
-};
-
-float32_t PskCosDDS[] = { 6.123233995736766e-17, -0.09801714032956066, -0.1950903220161282,
-		-0.2902846772544622, -0.3826834323650897, -0.4713967368259977, -0.555570233019602,
-		-0.6343932841636453, -0.7071067811865475, -0.773010453362737, -0.8314696123025453,
-		-0.8819212643483549, -0.9238795325112867, -0.9569403357322088, -0.9807852804032304,
-		-0.9951847266721968, -1.0, -0.9951847266721969, -0.9807852804032304, -0.9569403357322089,
-		-0.9238795325112867, -0.881921264348355, -0.8314696123025455, -0.7730104533627371,
-		-0.7071067811865477, -0.6343932841636453, -0.5555702330196022, -0.47139673682599786,
-		-0.38268343236509034, -0.2902846772544624, -0.19509032201612866, -0.09801714032956045,
-		-1.8369701987210297e-16, 0.09801714032956009, 0.19509032201612828, 0.2902846772544621,
-		0.38268343236509, 0.4713967368259976, 0.5555702330196018, 0.6343932841636448, 0.7071067811865475,
-		0.7730104533627367, 0.8314696123025452, 0.8819212643483549, 0.9238795325112865, 0.9569403357322088,
-		0.9807852804032303, 0.9951847266721969, 1.0, 0.9951847266721969, 0.9807852804032304, 0.9569403357322089,
-		0.9238795325112867, 0.881921264348355, 0.8314696123025456, 0.7730104533627369, 0.7071067811865477,
-		0.634393284163646, 0.5555702330196023, 0.47139673682599803, 0.3826834323650905, 0.29028467725446255,
-		0.19509032201612878, 0.09801714032956058 }; // TODO to replace with soft_dds
-
 soft_dds_t psk_dds;
 soft_dds_t psk_bit_dds;
 
-void PskBufAdd(int len, float32_t buf[], float32_t v)
-{
-	for (int i = len - 1; i > 0; i--)
-	{
-		buf[i] = buf[i-1];
-	}
-	buf[0] = v;
-}
-
-float32_t Psk_IirNext(float32_t b[], float32_t a[], float32_t x[], float32_t y[], int idx, int taps)
-{
-	float32_t resp = 0;
-	int iidx; 
-
-	for (int i = 0; i < taps; i++)
-	{
-		iidx = (idx - i + taps) % taps;
-		resp += b[i] * x[iidx];
-		if (i>0)
-		{
-			resp -= a[i] * y[iidx];
-		}
-	}
-	return resp / a[0];
-}
-
-
 #define PSK_VARICODE_NUM (sizeof(psk_varicode)/sizeof(*psk_varicode))
 
 
 const psk_speed_item_t psk_speeds[PSK_SPEED_NUM] =
 {
-		{ .id =PSK_SPEED_31, .value = 31.25, .zeros = 50, .bpf_b = PskBndPassB_31, .bpf_a = PskBndPassA_31, .rate = 384, .label = " 31" },
-		{ .id =PSK_SPEED_63, .value = 62.5, .zeros = 100, .bpf_b = PskBndPassB_63, .bpf_a = PskBndPassA_63, .rate = 192, .label = " 63"  },
-		{ .id =PSK_SPEED_125, .value = 125.0, .zeros = 200, .bpf_b = PskBndPassB_125, .bpf_a = PskBndPassA_125, .rate = 96, .label = "125" }
+		{ .id =PSK_SPEED_31, .value = 31.25, .zeros = 50, .bpf_coeffs = PskBndPass_31, .rate = 384, .label = " 31" },
+		{ .id =PSK_SPEED_63, .value = 62.5, .zeros = 100, .bpf_coeffs = PskBndPass_63, .rate = 192, .label = " 63"  },
+		{ .id =PSK_SPEED_125, .value = 125.0, .zeros = 200, .bpf_coeffs = PskBndPass_125, .rate = 96, .label = "125" }
 };
 
 psk_ctrl_t psk_ctrl_config =
 {
-		.speed_idx = PSK_SPEED_31
+		.speed_idx = PSK_SPEED_31,
+		.skimmer = PSK_SKIM_OFF
 };
 
 PskState  psk_state;
@@ -237,41 +164,64 @@ void Bpsk_ModulatorInit(void)
 	psk_state.tx_wave_prev = 1;
 	psk_state.tx_bit_phase = 0;
 	psk_state.tx_ending = false;
-	Bpsk_ResetWin();
+	// the bit window starts with the first bit, not where the last transmission ended
+	softdds_setFreqDDS(&psk_bit_dds, psk_speeds[psk_ctrl_config.speed_idx].value / 2, ts.samp_rate, false);
 }
 
-void Bpsk_DemodulatorInit(void)
+/**
+ * @brief resets the receiver of a single carrier
+ * @param symbol_len decimated samples per symbol, at most PSK_RX_SYMBOL_MAX
+ * @param freq_range how far the AFC may move the carrier, in radians per decimated sample
+ * @param acquire symbols used to estimate the carrier offset before decoding starts, 0 if the carrier is expected at 0 Hz
+ */
+void Bpsk_RxChannelInit(PskRxChannel* ch, uint16_t symbol_len, float32_t freq_range, uint16_t acquire)
 {
-	psk_state.rx_phase = 0;
-	psk_state.rx_bnd_idx = 0;
-	
-	for (int i = 0; i < PSK_BND_FLT_LEN; i++)
-	{
-		psk_state.rx_samples_in[i] = 0;
-		psk_state.rx_samples[i] = 0;
-	}
-	
-	for (int i = 0; i < PSK_BUF_LEN; i++)
+	for (int i = 0; i < PSK_RX_SYMBOL_MAX; i++)
 	{
-		psk_state.rx_vco[i] = 0;
-		psk_state.rx_sin_prod[i] = 0;
-		psk_state.rx_cos_prod[i] = 0;
-		psk_state.rx_scmix[i] = 0;
+		ch->sym_i[i] = 0;
+		ch->sym_q[i] = 0;
+		ch->sync[i] = 0;
 	}
+	ch->sum_i = 0;
+	ch->sum_q = 0;
+	ch->sym_idx = 0;
+	ch->symbol_len = symbol_len;
+	ch->bitclk = 0;
+
+	ch->nco_i = 1;
+	ch->nco_q = 0;
+	ch->nco_step_i = 1;
+	ch->nco_step_q = 0;
+	ch->freq_err = 0;
+	ch->freq_centre = 0;
+	ch->freq_range = freq_range;
+
+	ch->acquire = acquire * symbol_len;
+	ch->acq_i = 0;
+	ch->acq_q = 0;
+	ch->acq_prev_i = 0;
+	ch->acq_prev_q = 0;
+
+	ch->last_i = 0;
+	ch->last_q = 0;
+	ch->last_bit = 0;
+	ch->word = 0;
+}
 
-	psk_state.rx_idx = 0;
-	psk_state.rx_last_bit = 0;
-	psk_state.rx_err = 0;
-	psk_state.rx_last_symbol = 0;
-	psk_state.rx_symbol_len = psk_state.rate / PSK_BUF_LEN;
-	psk_state.rx_symbol_idx = 0;
-	
-	// for (int i = 0; i < psk_state.rx_symbol_len; i ++)
-	// {
-	// 	psk_state.rx_symbol_buf[i];
-	// }
-
-	psk_state.rx_word = 0;
+void Bpsk_DemodulatorInit(void)
+{
+	// the coefficients are not modified by CMSIS, the instance just has no const pointer
+	arm_biquad_cascade_df1_init_f32(&psk_state.rx_bpf, PSK_BPF_STAGES, (float32_t*)psk_speeds[psk_ctrl_config.speed_idx].bpf_coeffs,
+			psk_state.rx_bpf_state);
+	softdds_setFreqDDS(&psk_state.rx_dds, PSK_OFFSET, PSK_SAMPLE_RATE, false);
+
+	psk_state.rx_acc_i = 0;
+	psk_state.rx_acc_q = 0;
+	psk_state.rx_acc_count = 0;
+
+	// the carrier is tuned to PSK_OFFSET, the AFC follows it within half the baud rate
+	Bpsk_RxChannelInit(&psk_state.rx, psk_state.rate / PSK_RX_DECIMATION,
+			2 * PI * psk_speeds[psk_ctrl_config.speed_idx].value / 2 / (PSK_SAMPLE_RATE / PSK_RX_DECIMATION), 0);
 	UiDriver_TextMsgPutChar('>');
 }
 
@@ -281,7 +231,7 @@ void PskDecoder_Init(void)
 
 	psk_state.tx_idx = 0;
 
-	softdds_setFreqDDS(&psk_dds, PSK_OFFSET, ts.samp_rate, true);
+	softdds_setFreqDDS(&psk_dds, PSK_OFFSET, ts.samp_rate, false);
 	psk_state.tx_bit_len = lround(ts.samp_rate / psk_speeds[psk_ctrl_config.speed_idx].value * 2);
 	psk_state.tx_zeros = - psk_speeds[psk_ctrl_config.speed_idx].zeros;
 	psk_state.rate = psk_speeds[psk_ctrl_config.speed_idx].rate;
@@ -324,104 +274,208 @@ uint16_t Bpsk_FindCharReversed(uint8_t c)
 	return retval;
 }
 
-void BpskDecoder_ProcessSample(float32_t sample)
+#define PSK_RX_AFC_GAIN 0.1 // fraction of the measured carrier rotation corrected per symbol
+#define PSK_RX_SYNC_GAIN 0.2 // fraction of the measured timing error corrected per symbol
+#define PSK_RX_CHUNK 8 // samples processed at once, the audio driver delivers blocks of 8 samples at 12ksps
+
+/**
+ * @brief decides one symbol from the matched filter output, corrects the carrier offset and decodes the varicode
+ * @returns the decoded character, '\0' if the symbol did not complete one
+ */
+static char Bpsk_RxChannelSymbol(PskRxChannel* ch, float32_t sym_i, float32_t sym_q)
 {
-	float32_t fsample, sum_sin = 0, sum_cos = 0, symbol_out, smax = 0;
-	int8_t bit;
+	char retval = '\0';
 
-	psk_state.rx_samples_in[psk_state.rx_bnd_idx] = sample;
-	fsample = Psk_IirNext(psk_speeds[psk_ctrl_config.speed_idx].bpf_b, psk_speeds[psk_ctrl_config.speed_idx].bpf_a, psk_state.rx_samples_in,
-		psk_state.rx_samples, psk_state.rx_bnd_idx, PSK_BND_FLT_LEN);
-	psk_state.rx_samples[psk_state.rx_bnd_idx] = fsample;
-	psk_state.rx_bnd_idx++;
-	psk_state.rx_bnd_idx %= PSK_BND_FLT_LEN;
+	// the phase change to the previous symbol carries the bit: a reversal is a 0
+	const float32_t diff_i = sym_i * ch->last_i + sym_q * ch->last_q;
+	const float32_t diff_q = sym_q * ch->last_i - sym_i * ch->last_q;
+	const int8_t bit = diff_i < 0 ? 0 : 1;
 
-	psk_state.rx_vco[psk_state.rx_idx] = PskCosDDS[(int)(psk_state.rx_phase * PSK_COS_DDS_LEN)]; // TODO This shall be replaced with soft_dds
-	psk_state.rx_sin_prod[psk_state.rx_idx] = psk_state.rx_vco[(psk_state.rx_idx - PSK_SHIFT_90 + PSK_BUF_LEN) % PSK_BUF_LEN] * fsample;
-	psk_state.rx_cos_prod[psk_state.rx_idx] = psk_state.rx_vco[psk_state.rx_idx] * fsample;
+	ch->last_i = sym_i;
+	ch->last_q = sym_q;
 
-	for (int i = 0; i < PSK_BUF_LEN; i++)
+	// the angle of the difference modulo 180 degrees (the modulation) is the carrier rotation during one symbol
+	if (diff_i != 0 || diff_q != 0)
 	{
-		sum_sin += psk_state.rx_sin_prod[i]; // Could be optimized keeping the sum in memory
-		sum_cos += psk_state.rx_cos_prod[i]; //
-	}
+		float32_t rotation = atan2f(diff_q, diff_i);
+		if (rotation > PI / 2)
+		{
+			rotation -= PI;
+		}
+		else if (rotation < -PI / 2)
+		{
+			rotation += PI;
+		}
 
-	symbol_out = sum_sin / PSK_BUF_LEN;
-	psk_state.rx_scmix[psk_state.rx_idx] = symbol_out * sum_cos / PSK_BUF_LEN;
+		ch->freq_err += PSK_RX_AFC_GAIN * rotation / ch->symbol_len;
+		if (ch->freq_err > ch->freq_centre + ch->freq_range)
+		{
+			ch->freq_err = ch->freq_centre + ch->freq_range;
+		}
+		else if (ch->freq_err < ch->freq_centre - ch->freq_range)
+		{
+			ch->freq_err = ch->freq_centre - ch->freq_range;
+		}
+		ch->nco_step_i = arm_cos_f32(ch->freq_err);
+		ch->nco_step_q = arm_sin_f32(ch->freq_err);
+	}
 
-	psk_state.rx_err = 0;
-	smax = 0;
-	for (int i = 0; i < PSK_BUF_LEN; i++)
+	// bit synchronisation: the magnitude of the matched filter output peaks at the end of the symbol,
+	// the clock is moved so that the energy before and after the decision point is balanced
 	{
-		psk_state.rx_err += psk_state.rx_scmix[i]; // Could be optimized keeping the sum in memory
-		if (fabsf(psk_state.rx_sin_prod[i]) > smax)
+		const uint16_t half = ch->symbol_len / 2;
+		float32_t sum = 0, ampsum = 0;
+		for (uint16_t i = 0; i < half; i++)
 		{
-			smax = fabsf(psk_state.rx_sin_prod[i]);
+			sum += ch->sync[i] - ch->sync[i + half];
+			ampsum += ch->sync[i] + ch->sync[i + half];
 		}
-		if (fabsf(psk_state.rx_cos_prod[i]) > smax)
+		if (ampsum != 0)
 		{
-			smax = fabsf(psk_state.rx_cos_prod[i]);
+			ch->bitclk -= PSK_RX_SYNC_GAIN * half * sum / ampsum;
 		}
 	}
 
-	if (smax != 0)
+	if (ch->last_bit == 0 && bit == 0 && ch->word != 0)
 	{
-		psk_state.rx_err /= PSK_BUF_LEN * smax * 4;
+		retval = Bpsk_DecodeVaricode(ch->word / 2);
+		ch->word = 0;
 	}
 	else
 	{
-		psk_state.rx_err /= PSK_BUF_LEN;
+		ch->word = 2 * ch->word + bit;
 	}
 
-	if(fabsf(psk_state.rx_err) > 0.1)
+	ch->last_bit = bit;
+	return retval;
+}
+
+/**
+ * @brief estimates the carrier offset: squaring removes the modulation, the rotation of the squared signal
+ * from sample to sample is twice the offset. The range is a quarter of the decimated sample rate.
+ */
+static void Bpsk_RxChannelAcquire(PskRxChannel* ch, float32_t in_i, float32_t in_q)
+{
+	const float32_t sq_i = in_i * in_i - in_q * in_q;
+	const float32_t sq_q = 2 * in_i * in_q;
+	ch->acq_i += sq_i * ch->acq_prev_i + sq_q * ch->acq_prev_q;
+	ch->acq_q += sq_q * ch->acq_prev_i - sq_i * ch->acq_prev_q;
+	ch->acq_prev_i = sq_i;
+	ch->acq_prev_q = sq_q;
+
+	ch->acquire--;
+	if (ch->acquire == 0)
 	{
-		psk_state.rx_err = 0.1 * ((psk_state.rx_err > 0) ? 1 : -1 );
+		if (ch->acq_i != 0 || ch->acq_q != 0)
+		{
+			ch->freq_centre = atan2f(ch->acq_q, ch->acq_i) / 2;
+			ch->freq_err = ch->freq_centre;
+			ch->nco_step_i = arm_cos_f32(ch->freq_err);
+			ch->nco_step_q = arm_sin_f32(ch->freq_err);
+		}
+		ch->word = 0;
 	}
+}
 
-	psk_state.rx_idx += 1;
-	psk_state.rx_idx %= PSK_BUF_LEN;
+/**
+ * @brief processes one decimated baseband sample: AFC, matched filter and symbol clock
+ * @returns the decoded character, '\0' if there is none
+ */
+char Bpsk_RxChannelProcess(PskRxChannel* ch, float32_t in_i, float32_t in_q)
+{
+	char retval = '\0';
 
-	psk_state.rx_phase += PSK_SHIFT_DIFF + psk_state.rx_err * PSK_SHIFT_DIFF;
-	
-	if (psk_state.rx_phase > 1)
+	if (ch->acquire > 0)
 	{
-		psk_state.rx_phase -= 1;
-		psk_state.rx_symbol_idx += 1;
-		if (psk_state.rx_symbol_idx >= psk_state.rx_symbol_len)
-		{
-			psk_state.rx_symbol_idx = 0;
-			// TODO here should come additional part to check if timing of sampling should be moved
-			if (psk_state.rx_last_symbol * symbol_out < 0)
-			{
-				bit = 0;
-			} 
-			else
-			{
-				bit = 1;
-			}
-
-			psk_state.rx_last_symbol = symbol_out;
+		Bpsk_RxChannelAcquire(ch, in_i, in_q);
+	}
 
-			if (psk_state.rx_last_bit == 0 && bit == 0 && psk_state.rx_word != 0)
-			{
-				UiDriver_TextMsgPutChar(Bpsk_DecodeVaricode(psk_state.rx_word / 2));
-				psk_state.rx_word = 0;
-			}
-			else
-			{
-				psk_state.rx_word = 2 * psk_state.rx_word + bit;
-			}
+	// remove the remaining carrier offset
+	const float32_t smp_i = in_i * ch->nco_i + in_q * ch->nco_q;
+	const float32_t smp_q = in_q * ch->nco_i - in_i * ch->nco_q;
+	const float32_t nco_i = ch->nco_i * ch->nco_step_i - ch->nco_q * ch->nco_step_q;
+	ch->nco_q = ch->nco_q * ch->nco_step_i + ch->nco_i * ch->nco_step_q;
+	ch->nco_i = nco_i;
+
+	// matched filter: running sum over one symbol
+	const uint16_t idx = ch->sym_idx;
+	ch->sum_i += smp_i - ch->sym_i[idx];
+	ch->sum_q += smp_q - ch->sym_q[idx];
+	ch->sym_i[idx] = smp_i;
+	ch->sym_q[idx] = smp_q;
+
+	ch->sym_idx++;
+	if (ch->sym_idx == ch->symbol_len)
+	{
+		ch->sym_idx = 0;
+		// once per symbol the sums are recalculated, so that rounding errors cannot accumulate,
+		// and the AFC phasor is brought back to unit length
+		arm_mean_f32(ch->sym_i, ch->symbol_len, &ch->sum_i);
+		arm_mean_f32(ch->sym_q, ch->symbol_len, &ch->sum_q);
+		ch->sum_i *= ch->symbol_len;
+		ch->sum_q *= ch->symbol_len;
+
+		const float32_t nco_mag = sqrtf(ch->nco_i * ch->nco_i + ch->nco_q * ch->nco_q);
+		ch->nco_i /= nco_mag;
+		ch->nco_q /= nco_mag;
+	}
 
-			psk_state.rx_last_bit = bit;
+	// symbol clock, it is negative if the last correction delayed the next decision
+	const uint16_t pos = ch->bitclk < 0 ? ch->bitclk + ch->symbol_len : ch->bitclk;
+	const float32_t mag = sqrtf(ch->sum_i * ch->sum_i + ch->sum_q * ch->sum_q);
+	ch->sync[pos] = 0.8 * ch->sync[pos] + 0.2 * mag;
 
+	ch->bitclk += 1;
+	if (ch->bitclk >= ch->symbol_len)
+	{
+		ch->bitclk -= ch->symbol_len;
+		retval = Bpsk_RxChannelSymbol(ch, ch->sum_i, ch->sum_q);
+		if (ch->acquire > 0)
+		{
+			// the carrier is not known yet, the decisions are random
+			retval = '\0';
 		}
 	}
+	return retval;
+}
+
+/**
+ * @brief BPSK receiver, filters and mixes a block of audio at PSK_SAMPLE_RATE down to the decimated baseband
+ * @param src audio samples, not modified
+ * @param blockSize number of samples
+ */
+void BpskDecoder_ProcessBlock(const float32_t* src, int16_t blockSize)
+{
+	float32_t filtered[PSK_RX_CHUNK], mix_i[PSK_RX_CHUNK], mix_q[PSK_RX_CHUNK];
 
-	if (psk_state.rx_phase < 0)
+	for (int16_t offset = 0; offset < blockSize; offset += PSK_RX_CHUNK)
 	{
-		psk_state.rx_phase += 1;
-	}
+		const uint16_t len = blockSize - offset < PSK_RX_CHUNK ? blockSize - offset : PSK_RX_CHUNK;
+
+		arm_biquad_cascade_df1_f32(&psk_state.rx_bpf, (float32_t*)&src[offset], filtered, len);
+		softdds_genIQSingleTone(&psk_state.rx_dds, mix_q, mix_i, len);
+		arm_mult_f32(filtered, mix_i, mix_i, len);
+		arm_mult_f32(filtered, mix_q, mix_q, len);
 
+		for (uint16_t i = 0; i < len; i++)
+		{
+			psk_state.rx_acc_i += mix_i[i];
+			psk_state.rx_acc_q += mix_q[i];
+			psk_state.rx_acc_count++;
+			if (psk_state.rx_acc_count == PSK_RX_DECIMATION)
+			{
+				// remove the DDS amplitude
+				const char ch = Bpsk_RxChannelProcess(&psk_state.rx, psk_state.rx_acc_i / 32768, psk_state.rx_acc_q / 32768);
+				if (ch != '\0')
+				{
+					UiDriver_TextMsgPutChar(ch);
+				}
+				psk_state.rx_acc_i = 0;
+				psk_state.rx_acc_q = 0;
+				psk_state.rx_acc_count = 0;
+			}
+		}
+	}
 }
 
 
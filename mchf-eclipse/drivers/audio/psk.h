@@ -12,18 +12,19 @@
 #define __PSK_H
 
 #include "uhsdr_types.h"
+#include "arm_math.h"
 #include "softdds.h"
 
 #define PSK_OFFSET 500
 #define PSK_SNAP_RANGE 100 // defines the range within which the SNAP algorithm in spectrum.c searches for the PSK carrier
 #define PSK_SAMPLE_RATE 12000 // TODO This should come from elsewhere, to be fixed
-#define PSK_BND_FLT_LEN 5
-#define PSK_BUF_LEN (PSK_SAMPLE_RATE / PSK_OFFSET)
-#define PSK_SHIFT_DIFF (1.0 * PSK_OFFSET / PSK_SAMPLE_RATE)
-#define PSK_SHIFT_90 (PSK_BUF_LEN / 4)
+#define PSK_BPF_STAGES 2 // the band pass filter is a cascade of biquads
 #define SAMPLE_MAX 32766
-#define PSK_COS_DDS_LEN 64
-#define PSK_MAX_SYMBOL_BUF 384 // Maximum for 12000 sample rate and 31.25; for higher sample rate should value be increased
+
+// the receiver mixes the carrier to 0 Hz and integrates over PSK_RX_DECIMATION samples,
+// the nulls of this integrator are at multiples of 1000 Hz and suppress the mixing product at 2 * PSK_OFFSET
+#define PSK_RX_DECIMATION 12
+#define PSK_RX_SYMBOL_MAX (384 / PSK_RX_DECIMATION) // decimated samples per symbol for the slowest speed
 
 typedef enum {
     PSK_SPEED_31,
@@ -37,12 +38,34 @@ typedef struct
     psk_speed_t id;
     float32_t value;
     uint16_t zeros;
-    float32_t* bpf_b;
-    float32_t* bpf_a;
-    uint16_t rate;
+    const float32_t* bpf_coeffs; // PSK_BPF_STAGES biquads in CMSIS order
+    uint16_t rate; // samples per symbol at PSK_SAMPLE_RATE
     char* label;
 } psk_speed_item_t;
 
+// receiver of a single carrier in the decimated baseband: matched filter, AFC, bit synchronisation and varicode,
+// used by the decoder of the tuned carrier and by every channel of the skimmer
+typedef struct
+{
+	float32_t sym_i[PSK_RX_SYMBOL_MAX], sym_q[PSK_RX_SYMBOL_MAX]; // decimated samples of the last symbol
+	float32_t sum_i, sum_q;         // running sum of sym_i/q, the matched filter output
+	uint16_t sym_idx;
+	uint16_t symbol_len;            // decimated samples per symbol
+	float32_t sync[PSK_RX_SYMBOL_MAX]; // averaged magnitude at each position within the symbol
+	float32_t bitclk;               // position within the symbol, the symbol is decided when it wraps
+	float32_t nco_i, nco_q;         // AFC phasor, removes the remaining carrier offset
+	float32_t nco_step_i, nco_step_q;
+	float32_t freq_err;             // carrier offset in radians per decimated sample
+	float32_t freq_centre;          // the AFC keeps freq_err within freq_range around freq_centre
+	float32_t freq_range;
+	uint16_t acquire;               // decimated samples left until the carrier offset is estimated, 0 if done
+	float32_t acq_i, acq_q;         // sum of the squared input times its conjugated predecessor
+	float32_t acq_prev_i, acq_prev_q;
+	float32_t last_i, last_q;       // previous symbol
+	int8_t last_bit;
+	uint32_t word;
+} PskRxChannel;
+
 typedef struct
 {
 	uint16_t rate;
@@ -59,38 +82,41 @@ typedef struct
 	bool tx_ending;
 	bool tx_win;
 
-	float32_t rx_phase;
-	float32_t rx_samples_in[PSK_BND_FLT_LEN];
-	float32_t rx_samples[PSK_BND_FLT_LEN];
-	int16_t rx_bnd_idx;
-	float32_t rx_vco[PSK_BUF_LEN];
-	float32_t rx_sin_prod[PSK_BUF_LEN];
-	float32_t rx_cos_prod[PSK_BUF_LEN];
-	float32_t rx_scmix[PSK_BUF_LEN];
-	int32_t rx_idx;
-	int8_t rx_last_bit;
-	float32_t rx_err;
-	float32_t rx_last_symbol;
-	int16_t rx_symbol_len;
-	int16_t rx_symbol_idx;
-	// float32_t rx_symbol_buf[PSK_MAX_SYMBOL_BUF];
-	uint32_t rx_word;
+	// receiver, runs on blocks: band pass, mixer and integrator at PSK_SAMPLE_RATE,
+	// matched filter, AFC and bit synchronisation at the decimated rate
+	arm_biquad_casd_df1_inst_f32 rx_bpf;
+	float32_t rx_bpf_state[PSK_BPF_STAGES * 4];
+	soft_dds_t rx_dds;
+	float32_t rx_acc_i, rx_acc_q;   // integrator of the decimation
+	uint16_t rx_acc_count;
+	PskRxChannel rx;
 
 } PskState;
 
 extern const psk_speed_item_t psk_speeds[PSK_SPEED_NUM];
 extern PskState psk_state;
 
+typedef enum {
+    PSK_SKIM_OFF,
+    PSK_SKIM_LCD, // decoded text of all carriers on the display
+    PSK_SKIM_LCD_USB, // and over the virtual serial port
+    PSK_SKIM_NUM
+} psk_skim_mode_t;
+
 typedef struct
 {
     psk_speed_t speed_idx;
+    uint8_t skimmer; // psk_skim_mode_t
 }  psk_ctrl_t;
 
 extern psk_ctrl_t psk_ctrl_config;
 
 void PskDecoder_Init(void);
 void Bpsk_ModulatorInit(void);
-void BpskDecoder_ProcessSample(float32_t sample);
+void BpskDecoder_ProcessBlock(const float32_t* src, int16_t blockSize);
+void Bpsk_RxChannelInit(PskRxChannel* ch, uint16_t symbol_len, float32_t freq_range, uint16_t acquire);
+char Bpsk_RxChannelProcess(PskRxChannel* ch, float32_t in_i, float32_t in_q);
+uint16_t Bpsk_FindCharReversed(uint8_t c);
 int16_t Psk_Modulator_GenSample();
 
 #endif
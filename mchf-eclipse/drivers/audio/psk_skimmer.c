@@ -0,0 +1,314 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                               UHSDR FIRMWARE                                    **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **  Licence:        GNU GPLv3, see LICENSE.md                                                      **
+ ************************************************************************************/
+
+/*
+ * PSK31 skimmer: decodes all PSK31 carriers in the audio passband at the same time.
+ *
+ * The audio at PSK_SAMPLE_RATE is split into channels PSK_SAMPLE_RATE / PSK_SKIM_FFT_LEN apart
+ * by a polyphase FFT filter bank: every PSK_SKIM_DECIMATION samples the last PSK_SKIM_TAPS samples
+ * are weighted with the prototype low pass, folded to PSK_SKIM_FFT_LEN and transformed.
+ * Each bin is then the complex baseband of its channel at PSK_SKIM_RATE, mixed with a phase
+ * which is referenced to the sample counter so that it is continuous from one output to the next.
+ *
+ * The channels overlap, their pass band is flat over more than the channel spacing, so that a carrier
+ * anywhere between two bins is received undistorted. This makes them too wide to tell two stations
+ * 100 Hz apart, so the carriers are searched in a separate spectrum with twice the resolution:
+ * every PSK_SKIM_DETECT outputs the last PSK_SKIM_TAPS samples are transformed and averaged.
+ * A few times per second the peaks of this spectrum get one of the PSK_SKIM_CHANNELS receivers of psk.c
+ * in the channel closest to them, which estimates the exact offset within the channel first
+ * and then decodes like the receiver of the tuned carrier.
+ */
+
+#include "uhsdr_board.h"
+#include "psk_skimmer.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define PSK_SKIM_FFT_LEN 256 // channels 46.875 Hz apart
+#define PSK_SKIM_TAPS (2 * PSK_SKIM_FFT_LEN)
+#define PSK_SKIM_DECIMATION 24
+#define PSK_SKIM_RATE (PSK_SAMPLE_RATE / PSK_SKIM_DECIMATION) // 500 Hz per channel, 16 samples per PSK31 symbol
+#define PSK_SKIM_CUTOFF 70.0 // -6dB of the prototype low pass, flat up to 40Hz, -45dB at 120Hz
+
+#define PSK_SKIM_DETECT 4 // filter bank outputs from one spectrum for the carrier search to the next
+#define PSK_SKIM_DETECT_BIN_MIN (200 * PSK_SKIM_TAPS / PSK_SAMPLE_RATE) // searched range, 200Hz ...
+#define PSK_SKIM_DETECT_BIN_MAX (3000 * PSK_SKIM_TAPS / PSK_SAMPLE_RATE) // ... 3000Hz
+#define PSK_SKIM_DETECT_BINS (PSK_SKIM_DETECT_BIN_MAX - PSK_SKIM_DETECT_BIN_MIN + 1)
+
+#define PSK_SKIM_AVG 0.02 // weight of a new spectrum in the average
+#define PSK_SKIM_SEARCH 32 // spectra from one carrier search to the next, 4 searches per second
+#define PSK_SKIM_SPACING 50 // Hz, a peak closer than this to a decoded carrier belongs to it
+#define PSK_SKIM_NOISE_MIN 1.0 // lower limit of the noise floor, keeps silence from looking like carriers
+#define PSK_SKIM_THRESHOLD 8.0 // a carrier needs this power over the noise floor to get a channel
+#define PSK_SKIM_HOLD 2.0 // and keeps it as long as it is above this
+#define PSK_SKIM_TIMEOUT 12 // searches below PSK_SKIM_HOLD until the channel is released again
+#define PSK_SKIM_ACQUIRE 8 // symbols for the estimation of the carrier offset
+
+typedef struct
+{
+	PskRxChannel rx;
+	uint16_t bin;
+	float32_t detect_freq; // where the carrier was found, until the receiver has its own estimate
+	uint8_t timeout;
+} PskSkimmerChannel;
+
+typedef struct
+{
+	float32_t coeffs[PSK_SKIM_TAPS]; // prototype low pass of the filter bank
+	float32_t history[2 * PSK_SKIM_TAPS]; // every sample is stored twice, the last PSK_SKIM_TAPS are always contiguous
+	uint16_t history_idx;
+	uint16_t sample_count; // samples since the last filter bank output
+	uint16_t time; // samples modulo PSK_SKIM_FFT_LEN, the phase reference of the bins
+	arm_rfft_fast_instance_f32 rfft;
+	arm_rfft_fast_instance_f32 detect_rfft;
+	float32_t fft_in[PSK_SKIM_TAPS]; // shared by the filter bank and the spectrum for the carrier search
+	float32_t fft_out[PSK_SKIM_TAPS];
+	float32_t power[PSK_SKIM_DETECT_BIN_MAX + 2]; // averaged spectrum for the carrier search
+	uint16_t detect_count;
+	uint16_t search_count;
+	PskSkimmerChannel channels[PSK_SKIM_CHANNELS];
+} PskSkimmerState;
+
+static PskSkimmerState __MCHF_SPECIALMEM psk_skimmer;
+
+SkimmerText psk_skimmer_text[PSK_SKIM_CHANNELS];
+
+void PskSkimmer_Init(void)
+{
+	// windowed sinc, normalized to a gain of 1
+	float32_t sum = 0;
+	for (uint16_t n = 0; n < PSK_SKIM_TAPS; n++)
+	{
+		const float32_t t = n - (PSK_SKIM_TAPS - 1) / 2.0;
+		const float32_t x = 2 * PI * PSK_SKIM_CUTOFF / PSK_SAMPLE_RATE * t;
+		const float32_t window = 0.5 - 0.5 * cosf(2 * PI * (n + 0.5) / PSK_SKIM_TAPS);
+		psk_skimmer.coeffs[n] = window * sinf(x) / x;
+		sum += psk_skimmer.coeffs[n];
+	}
+	arm_scale_f32(psk_skimmer.coeffs, 1 / sum, psk_skimmer.coeffs, PSK_SKIM_TAPS);
+
+	memset(psk_skimmer.history, 0, sizeof(psk_skimmer.history));
+	psk_skimmer.history_idx = 0;
+	psk_skimmer.sample_count = 0;
+	psk_skimmer.time = 0;
+	arm_rfft_fast_init_f32(&psk_skimmer.rfft, PSK_SKIM_FFT_LEN);
+	arm_rfft_fast_init_f32(&psk_skimmer.detect_rfft, PSK_SKIM_TAPS);
+	memset(psk_skimmer.power, 0, sizeof(psk_skimmer.power));
+	psk_skimmer.detect_count = 0;
+	psk_skimmer.search_count = 0;
+
+	SkimmerText_Reset(psk_skimmer_text, PSK_SKIM_CHANNELS);
+}
+
+/**
+ * @returns the power below which a quarter of the bins are, a measure of the noise floor
+ */
+static float32_t PskSkimmer_NoiseFloor(void)
+{
+	float32_t sorted[PSK_SKIM_DETECT_BINS];
+
+	for (uint16_t i = 0; i < PSK_SKIM_DETECT_BINS; i++)
+	{
+		const float32_t p = psk_skimmer.power[PSK_SKIM_DETECT_BIN_MIN + i];
+		uint16_t j = i;
+		for (; j > 0 && sorted[j - 1] > p; j--)
+		{
+			sorted[j] = sorted[j - 1];
+		}
+		sorted[j] = p;
+	}
+	return fmaxf(sorted[PSK_SKIM_DETECT_BINS / 4], PSK_SKIM_NOISE_MIN);
+}
+
+/**
+ * @returns the frequency of the carrier in Hz as estimated by the channel
+ */
+static float32_t PskSkimmer_ChannelFreq(const PskSkimmerChannel* channel)
+{
+	float32_t retval = channel->detect_freq;
+	if (channel->rx.acquire == 0)
+	{
+		retval = (float32_t)channel->bin * PSK_SAMPLE_RATE / PSK_SKIM_FFT_LEN + channel->rx.freq_err * PSK_SKIM_RATE / (2 * PI);
+	}
+	return retval;
+}
+
+/**
+ * @returns true if a channel decodes a carrier close to the frequency
+ */
+static bool PskSkimmer_FreqTaken(float32_t freq)
+{
+	bool retval = false;
+	for (uint16_t c = 0; c < PSK_SKIM_CHANNELS && retval == false; c++)
+	{
+		retval = psk_skimmer_text[c].active && fabsf(PskSkimmer_ChannelFreq(&psk_skimmer.channels[c]) - freq) < PSK_SKIM_SPACING;
+	}
+	return retval;
+}
+
+/**
+ * @brief releases the channels of carriers which are gone and assigns free channels to new carriers, strongest first
+ */
+static void PskSkimmer_Search(void)
+{
+	const float32_t noise = PskSkimmer_NoiseFloor();
+	int16_t free_channel = -1;
+
+	for (uint16_t c = 0; c < PSK_SKIM_CHANNELS; c++)
+	{
+		PskSkimmerChannel* channel = &psk_skimmer.channels[c];
+		if (psk_skimmer_text[c].active)
+		{
+			const uint16_t bin = lroundf(PskSkimmer_ChannelFreq(channel) * PSK_SKIM_TAPS / PSK_SAMPLE_RATE);
+			if (psk_skimmer.power[bin] > noise * PSK_SKIM_HOLD)
+			{
+				channel->timeout = 0;
+			}
+			else if (++channel->timeout == PSK_SKIM_TIMEOUT)
+			{
+				// the text stays readable until the channel gets the next carrier
+				psk_skimmer_text[c].active = false;
+			}
+			psk_skimmer_text[c].freq = lroundf(PskSkimmer_ChannelFreq(channel));
+		}
+
+		if (psk_skimmer_text[c].active == false && free_channel < 0)
+		{
+			free_channel = c;
+		}
+	}
+
+	while (free_channel >= 0)
+	{
+		float32_t best_freq = 0;
+		float32_t best_power = noise * PSK_SKIM_THRESHOLD;
+
+		for (uint16_t bin = PSK_SKIM_DETECT_BIN_MIN + 1; bin < PSK_SKIM_DETECT_BIN_MAX; bin++)
+		{
+			const float32_t p = psk_skimmer.power[bin];
+			const float32_t p_lower = psk_skimmer.power[bin - 1], p_upper = psk_skimmer.power[bin + 1];
+			if (p > best_power && p >= p_lower && p > p_upper)
+			{
+				// the vertex of the parabola through the peak and its neighbours
+				const float32_t freq = (bin + 0.5 * (p_lower - p_upper) / (p_lower - 2 * p + p_upper)) * PSK_SAMPLE_RATE / PSK_SKIM_TAPS;
+				if (PskSkimmer_FreqTaken(freq) == false)
+				{
+					best_freq = freq;
+					best_power = p;
+				}
+			}
+		}
+		if (best_freq == 0)
+		{
+			break;
+		}
+
+		PskSkimmerChannel* channel = &psk_skimmer.channels[free_channel];
+		channel->bin = lroundf(best_freq * PSK_SKIM_FFT_LEN / PSK_SAMPLE_RATE);
+		channel->detect_freq = best_freq;
+		channel->timeout = 0;
+		// the offset within the channel is estimated first, from there the AFC follows within half the baud rate
+		Bpsk_RxChannelInit(&channel->rx, psk_speeds[PSK_SPEED_31].rate / PSK_SKIM_DECIMATION,
+				2 * PI * psk_speeds[PSK_SPEED_31].value / 2 / PSK_SKIM_RATE, PSK_SKIM_ACQUIRE);
+
+		SkimmerText_Assign(&psk_skimmer_text[free_channel], lroundf(best_freq));
+
+		free_channel = -1;
+		for (uint16_t c = 0; c < PSK_SKIM_CHANNELS && free_channel < 0; c++)
+		{
+			if (psk_skimmer_text[c].active == false)
+			{
+				free_channel = c;
+			}
+		}
+	}
+}
+
+/**
+ * @brief adds the spectrum of the last PSK_SKIM_TAPS samples to the average for the carrier search
+ */
+static void PskSkimmer_Detect(void)
+{
+	arm_copy_f32(&psk_skimmer.history[psk_skimmer.history_idx], psk_skimmer.fft_in, PSK_SKIM_TAPS);
+	arm_rfft_fast_f32(&psk_skimmer.detect_rfft, psk_skimmer.fft_in, psk_skimmer.fft_out, 0);
+
+	for (uint16_t bin = PSK_SKIM_DETECT_BIN_MIN; bin <= PSK_SKIM_DETECT_BIN_MAX; bin++)
+	{
+		// Hann window, applied as convolution of the bins
+		const float32_t* x = &psk_skimmer.fft_out[2 * bin];
+		const float32_t re = 0.5 * x[0] - 0.25 * (x[-2] + x[2]);
+		const float32_t im = 0.5 * x[1] - 0.25 * (x[-1] + x[3]);
+		psk_skimmer.power[bin] += PSK_SKIM_AVG * (re * re + im * im - psk_skimmer.power[bin]);
+	}
+
+	if (++psk_skimmer.search_count == PSK_SKIM_SEARCH)
+	{
+		psk_skimmer.search_count = 0;
+		PskSkimmer_Search();
+	}
+}
+
+/**
+ * @brief one output of the filter bank: the bins of all channels at PSK_SKIM_RATE
+ */
+static void PskSkimmer_FilterBank(void)
+{
+	const float32_t* window = &psk_skimmer.history[psk_skimmer.history_idx];
+
+	// folding with a rotation by the sample counter: bin k gets the phase -2*PI*k*time/PSK_SKIM_FFT_LEN,
+	// which is what mixing with a free running oscillator at the bin frequency would give
+	for (uint16_t n = 0; n < PSK_SKIM_FFT_LEN; n++)
+	{
+		psk_skimmer.fft_in[(n + psk_skimmer.time) & (PSK_SKIM_FFT_LEN - 1)] =
+				psk_skimmer.coeffs[n] * window[n] + psk_skimmer.coeffs[n + PSK_SKIM_FFT_LEN] * window[n + PSK_SKIM_FFT_LEN];
+	}
+	// packed format: DC, Nyquist, then re/im of bins 1 ... PSK_SKIM_FFT_LEN/2 - 1
+	arm_rfft_fast_f32(&psk_skimmer.rfft, psk_skimmer.fft_in, psk_skimmer.fft_out, 0);
+
+	for (uint16_t c = 0; c < PSK_SKIM_CHANNELS; c++)
+	{
+		if (psk_skimmer_text[c].active)
+		{
+			const uint16_t bin = psk_skimmer.channels[c].bin;
+			const char ch = Bpsk_RxChannelProcess(&psk_skimmer.channels[c].rx, psk_skimmer.fft_out[2 * bin], psk_skimmer.fft_out[2 * bin + 1]);
+			if (ch != '\0')
+			{
+				SkimmerText_PutChar(&psk_skimmer_text[c], ch);
+			}
+		}
+	}
+
+	if (++psk_skimmer.detect_count == PSK_SKIM_DETECT)
+	{
+		psk_skimmer.detect_count = 0;
+		PskSkimmer_Detect();
+	}
+}
+
+/**
+ * @brief PSK31 skimmer, runs on the same audio as BpskDecoder_ProcessBlock
+ * @param src audio samples at PSK_SAMPLE_RATE, not modified
+ * @param blockSize number of samples
+ */
+void PskSkimmer_ProcessBlock(const float32_t* src, int16_t blockSize)
+{
+	for (int16_t i = 0; i < blockSize; i++)
+	{
+		psk_skimmer.history[psk_skimmer.history_idx] = src[i];
+		psk_skimmer.history[psk_skimmer.history_idx + PSK_SKIM_TAPS] = src[i];
+		psk_skimmer.history_idx = (psk_skimmer.history_idx + 1) % PSK_SKIM_TAPS;
+		psk_skimmer.time = (psk_skimmer.time + 1) & (PSK_SKIM_FFT_LEN - 1);
+
+		if (++psk_skimmer.sample_count == PSK_SKIM_DECIMATION)
+		{
+			psk_skimmer.sample_count = 0;
+			PskSkimmer_FilterBank();
+		}
+	}
+}
@@ -0,0 +1,25 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+**                                                                                 **
+**                               UHSDR FIRMWARE                                    **
+**                                                                                 **
+**---------------------------------------------------------------------------------**
+**  Licence:		GNU GPLv3, see LICENSE.md                                                      **
+************************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PSK_SKIMMER_H
+#define __PSK_SKIMMER_H
+
+#include "uhsdr_types.h"
+#include "psk.h"
+#include "skimmer_text.h"
+
+#define PSK_SKIM_CHANNELS 8 // carriers decoded at the same time
+
+extern SkimmerText psk_skimmer_text[PSK_SKIM_CHANNELS];
+
+void PskSkimmer_Init(void);
+void PskSkimmer_ProcessBlock(const float32_t* src, int16_t blockSize);
+
+#endif
@@ -171,8 +171,10 @@ const uint8_t Ascii2Baudot[128] =
 
 const rtty_speed_item_t rtty_speeds[RTTY_SPEED_NUM] =
 {
-		{ .id =RTTY_SPEED_45, .value = 45.45, .label = "45" },
-		{ .id =RTTY_SPEED_50, .value = 50, .label = "50"  },
+		{ .id =RTTY_SPEED_45, .value = 45.45, .label = " 45" },
+		{ .id =RTTY_SPEED_50, .value = 50, .label = " 50"  },
+		{ .id =RTTY_SPEED_75, .value = 75, .label = " 75"  },
+		{ .id =RTTY_SPEED_100, .value = 100, .label = "100"  },
 };
 
 const rtty_shift_item_t rtty_shifts[RTTY_SHIFT_NUM] =
@@ -194,52 +196,6 @@ rtty_ctrl_t rtty_ctrl_config =
 
 
 
-typedef struct
-{
-	float32_t gain;
-	float32_t coeffs[4];
-	uint16_t freq; // center freq
-} rtty_bpf_config_t;
-
-typedef struct
-{
-	float32_t gain;
-	float32_t coeffs[2];
-} rtty_lpf_config_t;
-
-typedef struct
-{
-	float32_t xv[5];
-	float32_t yv[5];
-} rtty_bpf_data_t;
-
-typedef struct
-{
-	float32_t xv[3];
-	float32_t yv[3];
-} rtty_lpf_data_t;
-
-
-
-static float32_t RttyDecoder_bandPassFreq(float32_t sampleIn, const rtty_bpf_config_t* coeffs, rtty_bpf_data_t* data) {
-	data->xv[0] = data->xv[1]; data->xv[1] = data->xv[2]; data->xv[2] = data->xv[3]; data->xv[3] = data->xv[4];
-	data->xv[4] = sampleIn / coeffs->gain; // gain at centre
-	data->yv[0] = data->yv[1]; data->yv[1] = data->yv[2]; data->yv[2] = data->yv[3]; data->yv[3] = data->yv[4];
-	data->yv[4] = (data->xv[0] + data->xv[4]) - 2 * data->xv[2]
-															 + (coeffs->coeffs[0] * data->yv[0]) + (coeffs->coeffs[1] * data->yv[1])
-															 + (coeffs->coeffs[2] * data->yv[2]) + (coeffs->coeffs[3] * data->yv[3]);
-	return data->yv[4];
-}
-
-static float32_t RttyDecoder_lowPass(float32_t sampleIn, const rtty_lpf_config_t* coeffs, rtty_lpf_data_t* data) {
-	data->xv[0] = data->xv[1]; data->xv[1] = data->xv[2];
-	data->xv[2] = sampleIn / coeffs->gain; // gain at DC
-	data->yv[0] = data->yv[1]; data->yv[1] = data->yv[2];
-	data->yv[2] = (data->xv[0] + data->xv[2]) + 2 * data->xv[1]
-															 + (coeffs->coeffs[0] * data->yv[0]) + (coeffs->coeffs[1] * data->yv[1]);
-	return data->yv[2];
-}
-
 typedef enum {
 	RTTY_RUN_STATE_WAIT_START = 0,
 	RTTY_RUN_STATE_BIT,
@@ -252,19 +208,45 @@ typedef enum {
 } rtty_charSetMode_t;
 
 
+// The receiver mixes the mark and the space tone to 0 Hz and decimates both to about RTTY_RX_BIT_SAMPLES
+// samples per bit by summing. Everything else runs at this low rate: a raised cosine matched filter of one bit
+// length, the envelope detection with ATC and the bit clock. So the work per audio sample is the same for all
+// speeds and shifts, and any of them can be received.
+#define RTTY_RX_BIT_SAMPLES 8 // decimated samples per bit
+#define RTTY_RX_TAPS_MAX 12 // matched filter taps, one bit at RTTY_RX_BIT_SAMPLES plus some margin for rounding
+#define RTTY_RX_CHUNK 8 // audio samples mixed at once
+#define RTTY_RX_TAPER 0.5 // depth of the raised cosine, 1 would be a Hann window, 0 the plain sum over a bit
 
+#define RTTY_SPACE 0
+#define RTTY_MARK 1
+
+typedef struct
+{
+	soft_dds_t dds;         // mixes the tone to 0 Hz
+	float32_t acc_i;
+	float32_t acc_q;
+	float32_t hist_i[2 * RTTY_RX_TAPS_MAX]; // decimated samples, stored twice so the filter needs no wrap around
+	float32_t hist_q[2 * RTTY_RX_TAPS_MAX];
+	float32_t env;          // envelope and noise level for the ATC
+	float32_t noise;
+} rtty_rx_tone_t;
 
 typedef struct {
-	rtty_bpf_data_t bpfSpaceData;
-	rtty_bpf_data_t bpfMarkData;
-	rtty_lpf_data_t lpfData;
-	rtty_bpf_config_t *bpfSpaceConfig;
-	rtty_bpf_config_t *bpfMarkConfig;
-	rtty_lpf_config_t *lpfConfig;
-
-	uint16_t oneBitSampleCount;
+	rtty_rx_tone_t tone[2];     // RTTY_SPACE, RTTY_MARK
+	uint16_t decimation;        // audio samples per decimated sample
+	uint16_t acc_count;
+	float32_t taps[RTTY_RX_TAPS_MAX];
+	uint16_t taps_len;
+	uint16_t hist_idx;
+
+	uint16_t oneBitSampleCount; // audio samples per bit, for the modulator
+	float32_t bitLen;           // decimated samples per bit
 	int32_t DPLLOldVal;
-	int32_t DPLLBitPhase;
+	float32_t DPLLBitPhase;
+	bool DPLLPhaseChanged;
+
+	int16_t waitForStartState;
+	int16_t waitForHalf;
 
 	uint8_t byteResult;
 	uint16_t byteResultp;
@@ -281,156 +263,80 @@ typedef struct {
 
 rtty_decoder_data_t rttyDecoderData;
 
-
-
-
-#if 0 // 48Khz filters, not needed
-// this is for 48ksps sample rate
-// for filter designing, see http://www-users.cs.york.ac.uk/~fisher/mkfilter/
-// order 2 Butterworth, freqs: 865-965 Hz
-rtty_bpf_config_t rtty_bp_48khz_915 =
-{
-		.gain = 2.356080041e+04,  // gain at centre
-		.coeffs = {-0.9816582826, 3.9166274264, -5.8882201843, 3.9530488323 },
-		.freq = 915
-};
-
-// order 2 Butterworth, freqs: 1035-1135 Hz
-rtty_bpf_config_t rtty_bp_48khz_1085 =
-{
-		.gain = 2.356080365e+04,
-		.coeffs = {-0.9816582826, 3.9051693660, -5.8653953990, 3.9414842213 },
-		.freq = 1085
-};
-#endif
-
-// order 2 Butterworth, freq: 50 Hz
-rtty_lpf_config_t rtty_lp_48khz_50 =
-{
-		.gain = 9.381008646e+04,
-		.coeffs = {-0.9907866988, 1.9907440595 }
-};
-
-// this is for 12ksps sample rate
-// for filter designing, see http://www-users.cs.york.ac.uk/~fisher/mkfilter/
-// order 2 Butterworth, freqs: 865-965 Hz, centre: 915 Hz
-static rtty_bpf_config_t rtty_bp_12khz_915 =
-{
-		.gain = 1.513364755e+03,
-		.coeffs = { -0.9286270861, 3.3584472566, -4.9635817596, 3.4851652468 },
-		.freq = 915
-};
-
-// order 2 Butterworth, freqs: 1315-1415 Hz, centre 1365Hz
-static rtty_bpf_config_t rtty_bp_12khz_1365 =
-{
-		.gain = 1.513365019e+03,
-		.coeffs = { -0.9286270861, 2.8583904591, -4.1263569881, 2.9662407442 },
-		.freq = 1365
-};
-// order 2 Butterworth, freqs: 1035-1135 Hz, centre: 1085Hz
-static rtty_bpf_config_t rtty_bp_12khz_1085 =
-{
-		.gain = 1.513364927e+03,
-		.coeffs = { -0.9286270861, 3.1900687350, -4.6666321298, 3.3104336142 },
-		.freq = 1085
-};
-// order 2 Butterworth, freqs: 1065-1165 Hz, centre: 1115Hz
-// for 200Hz shift
-static rtty_bpf_config_t rtty_bp_12khz_1115 =
-{
-		.gain = 1.513364944e+03,
-		.coeffs = { -0.9286270861, 3.1576917276, -4.6112830458, 3.2768349860 },
-		.freq = 1115
-};
-
-// for 85Hz shift --> 915 + 85Hz = space = 1000Hz
-// 3dB bandwidth 50Hz
-// order 2 Butterworth, freqs: 975-1025 Hz, centre: 1000Hz
-static rtty_bpf_config_t rtty_bp_12khz_1000 =
-{
-		.gain = 5.944465260e+03,
-		.coeffs = { -0.9636529842, 3.3693752166, -4.9084595657, 3.4323354886 },
-		.freq = 1000
-};
-
-// for 425Hz shift --> 915 + 425Hz = space = 1340Hz
-// 3dB bandwidth 100Hz
-// order 2 Butterworth, freqs: 1290 - 1390 Hz, centre: 1340Hz
-static rtty_bpf_config_t rtty_bp_12khz_1340 =
-{
-		.gain = 1.513365018e+03,
-		.coeffs = { -0.9286270862, 2.8906128091, -4.1762457780, 2.9996788796 },
-		.freq = 1340
-};
-
-// for 850Hz shift --> 915 + 850Hz = space = 1765Hz
-// 3dB bandwidth 100Hz
-// order 2 Butterworth, freqs: 1715 - 1815 Hz, centre: 1765Hz
-static rtty_bpf_config_t rtty_bp_12khz_1765 =
-{
-		.gain = 1.513365057e+03,
-		.coeffs = { -0.9286270862, 2.1190223173, -3.1352567157, 2.1989754113 },
-		.freq = 1765
-};
-
-
-static rtty_lpf_config_t rtty_lp_12khz_50 =
-{
-		.gain = 5.944465310e+03,
-		.coeffs = { -0.9636529842, 1.9629800894 }
-};
-
 static rtty_mode_config_t  rtty_mode_current_config;
 
 
-void RttyDecoder_Init()
+void RttyDecoder_InitMode(const rtty_mode_config_t* config)
 {
-
-	// TODO: pass config as parameter and make it changeable via menu
-	rtty_mode_current_config.samplerate = 12000;
-	rtty_mode_current_config.shift = rtty_shifts[rtty_ctrl_config.shift_idx].value;
-	rtty_mode_current_config.speed = rtty_speeds[rtty_ctrl_config.speed_idx].value;
-	rtty_mode_current_config.stopbits = rtty_ctrl_config.stopbits_idx;
-
+	rtty_mode_current_config = *config;
 	rttyDecoderData.config_p = &rtty_mode_current_config;
 
-	// common config to all supported modes
-	rttyDecoderData.oneBitSampleCount = (uint16_t)roundf(rttyDecoderData.config_p->samplerate/rttyDecoderData.config_p->speed);
+	rttyDecoderData.oneBitSampleCount = (uint16_t)roundf(config->samplerate/config->speed);
 	rttyDecoderData.charSetMode = RTTY_MODE_LETTERS;
 	rttyDecoderData.state = RTTY_RUN_STATE_WAIT_START;
+	rttyDecoderData.waitForStartState = 0;
+	rttyDecoderData.DPLLBitPhase = 0;
+	rttyDecoderData.DPLLOldVal = 0;
+	rttyDecoderData.DPLLPhaseChanged = false;
+
+	// the summing decimator has its first zero at the decimated rate, far enough from the tones to suppress
+	// the other tone and the mixing products well, the matched filter does the rest
+	rttyDecoderData.decimation = roundf(config->samplerate / (config->speed * RTTY_RX_BIT_SAMPLES));
+	if (rttyDecoderData.decimation < 1)
+	{
+		rttyDecoderData.decimation = 1;
+	}
+	rttyDecoderData.bitLen = config->samplerate / rttyDecoderData.decimation / config->speed;
+	rttyDecoderData.acc_count = 0;
+	rttyDecoderData.hist_idx = 0;
+
+	// raised cosine over one bit on a pedestal, the best copy of weak signals in the tests,
+	// normalized to unity gain for a tone at 0 Hz with the amplitude of the DDS table
+	rttyDecoderData.taps_len = roundf(rttyDecoderData.bitLen);
+	if (rttyDecoderData.taps_len > RTTY_RX_TAPS_MAX)
+	{
+		rttyDecoderData.taps_len = RTTY_RX_TAPS_MAX;
+	}
+	float32_t gain = 0;
+	for (uint16_t i = 0; i < rttyDecoderData.taps_len; i++)
+	{
+		rttyDecoderData.taps[i] = 1 - RTTY_RX_TAPER * arm_cos_f32(2 * PI * (i + 0.5) / rttyDecoderData.taps_len);
+		gain += rttyDecoderData.taps[i];
+	}
+	gain *= rttyDecoderData.decimation * 32768.0;
+	arm_scale_f32(rttyDecoderData.taps, 1 / gain, rttyDecoderData.taps, rttyDecoderData.taps_len);
 
-	rttyDecoderData.bpfMarkConfig = &rtty_bp_12khz_915; // this is mark, or '1'
-	rttyDecoderData.lpfConfig = &rtty_lp_12khz_50;
-
-	// now we handled the specifics
-	switch (rttyDecoderData.config_p->shift)
+	const float32_t freq[2] = { RTTY_MARK_FREQ + config->shift, RTTY_MARK_FREQ };
+	for (int t = RTTY_SPACE; t <= RTTY_MARK; t++)
 	{
-	case 85:
-		rttyDecoderData.bpfSpaceConfig = &rtty_bp_12khz_1000;
-		break;
-	case 200:
-		rttyDecoderData.bpfSpaceConfig = &rtty_bp_12khz_1115;
-		break;
-	case 425:
-		rttyDecoderData.bpfSpaceConfig = &rtty_bp_12khz_1340;
-		break;
-	case 450:
-		rttyDecoderData.bpfSpaceConfig = &rtty_bp_12khz_1365; // this is space or '0'
-		break;
-	case 850:
-		rttyDecoderData.bpfSpaceConfig = &rtty_bp_12khz_1765; // this is space or '0'
-		break;
-	case 170:
-	default:
-		// all unsupported shifts are mapped to 170
-		rttyDecoderData.bpfSpaceConfig = &rtty_bp_12khz_1085; // this is space or '0'
+		rtty_rx_tone_t* tone = &rttyDecoderData.tone[t];
+		softdds_setFreqDDS(&tone->dds, freq[t], config->samplerate, false);
+		tone->acc_i = 0;
+		tone->acc_q = 0;
+		for (int i = 0; i < 2 * RTTY_RX_TAPS_MAX; i++)
+		{
+			tone->hist_i[i] = 0;
+			tone->hist_q[i] = 0;
+		}
+		tone->env = 0;
+		tone->noise = 0;
+
+		// configure DDS for transmission
+		softdds_setFreqDDS(&rttyDecoderData.tx_dds[t], freq[t], ts.samp_rate, 0);
 	}
+}
 
-	// configure DDS for transmission
-	softdds_setFreqDDS(&rttyDecoderData.tx_dds[0], rttyDecoderData.bpfSpaceConfig->freq, ts.samp_rate, 0);
-	softdds_setFreqDDS(&rttyDecoderData.tx_dds[1], rttyDecoderData.bpfMarkConfig->freq, ts.samp_rate, 0);
+void RttyDecoder_Init()
+{
+	const rtty_mode_config_t config =
+	{
+			.samplerate = 12000,
+			.shift = rtty_shifts[rtty_ctrl_config.shift_idx].value,
+			.speed = rtty_speeds[rtty_ctrl_config.speed_idx].value,
+			.stopbits = rtty_ctrl_config.stopbits_idx,
+	};
 
+	RttyDecoder_InitMode(&config);
 }
 
 float32_t decayavg(float32_t average, float32_t input, int weight)
@@ -447,54 +353,65 @@ float32_t decayavg(float32_t average, float32_t input, int weight)
 	return retval;
 }
 
+/**
+ * @brief matched filter of one tone, runs for each decimated sample
+ * @returns the magnitude of the filter output
+ */
+static float32_t RttyDecoder_matchedFilter(rtty_rx_tone_t* tone)
+{
+	const uint16_t len = rttyDecoderData.taps_len;
+	const uint16_t idx = rttyDecoderData.hist_idx;
+	float32_t out_i, out_q;
+
+	tone->hist_i[idx] = tone->hist_i[idx + len] = tone->acc_i;
+	tone->hist_q[idx] = tone->hist_q[idx + len] = tone->acc_q;
+	tone->acc_i = 0;
+	tone->acc_q = 0;
 
-// this function returns the bit value of the current sample
-static int RttyDecoder_demodulator(float32_t sample)
+	// the taps are symmetric, the order of the samples does not matter
+	arm_dot_prod_f32(&tone->hist_i[idx + 1], rttyDecoderData.taps, len, &out_i);
+	arm_dot_prod_f32(&tone->hist_q[idx + 1], rttyDecoderData.taps, len, &out_q);
+
+	float32_t retval;
+	arm_sqrt_f32(out_i * out_i + out_q * out_q, &retval);
+	return retval;
+}
+
+// this function returns the bit value of the current decimated sample
+static int RttyDecoder_demodulator(void)
 {
+	float32_t space_mag = RttyDecoder_matchedFilter(&rttyDecoderData.tone[RTTY_SPACE]);
+	float32_t mark_mag = RttyDecoder_matchedFilter(&rttyDecoderData.tone[RTTY_MARK]);
 
-	float32_t space_mag = RttyDecoder_bandPassFreq(sample, rttyDecoderData.bpfSpaceConfig, &rttyDecoderData.bpfSpaceData);
-	float32_t mark_mag = RttyDecoder_bandPassFreq(sample, rttyDecoderData.bpfMarkConfig, &rttyDecoderData.bpfMarkData);
+	rttyDecoderData.hist_idx++;
+	if (rttyDecoderData.hist_idx == rttyDecoderData.taps_len)
+	{
+		rttyDecoderData.hist_idx = 0;
+	}
 
 	float32_t v1 = 0.0;
-	// calculating the RMS of the two lines (squaring them)
-	space_mag *= space_mag;
-	mark_mag *= mark_mag;
 
     if(ts.rtty_atc_enable)
 	{   // RTTY decoding with ATC = automatic threshold correction
-		// FIXME: space & mark seem to be swapped in the following code
-		// dirty fix
-		float32_t helper = space_mag;
-		space_mag = mark_mag;
-		mark_mag = helper;
-		static float32_t mark_env = 0.0;
-		static float32_t space_env = 0.0;
-		static float32_t mark_noise = 0.0;
-		static float32_t space_noise = 0.0;
+		rtty_rx_tone_t* mark = &rttyDecoderData.tone[RTTY_MARK];
+		rtty_rx_tone_t* space = &rttyDecoderData.tone[RTTY_SPACE];
+		const int bitLen = roundf(rttyDecoderData.bitLen);
 		// experiment to implement an ATC (Automatic threshold correction), DD4WH, 2017_08_24
 		// everything taken from FlDigi, licensed by GNU GPLv2 or later
 		// https://github.com/ukhas/dl-fldigi/blob/master/src/cw_rtty/rtty.cxx
 		// calculate envelope of the mark and space signals
 		// uses fast attack and slow decay
-		mark_env = decayavg (mark_env, mark_mag,
-				(mark_mag > mark_env) ? rttyDecoderData.oneBitSampleCount / 4 : rttyDecoderData.oneBitSampleCount * 16);
-		space_env = decayavg (space_env, space_mag,
-				(space_mag > space_env) ? rttyDecoderData.oneBitSampleCount / 4 : rttyDecoderData.oneBitSampleCount * 16);
+		mark->env = decayavg (mark->env, mark_mag, (mark_mag > mark->env) ? bitLen / 4 : bitLen * 16);
+		space->env = decayavg (space->env, space_mag, (space_mag > space->env) ? bitLen / 4 : bitLen * 16);
 		// calculate the noise on the mark and space signals
-		mark_noise = decayavg (mark_noise, mark_mag,
-				(mark_mag < mark_noise) ? rttyDecoderData.oneBitSampleCount / 4 : rttyDecoderData.oneBitSampleCount * 48);
-		space_noise = decayavg (space_noise, space_mag,
-				(space_mag < space_noise) ? rttyDecoderData.oneBitSampleCount / 4 : rttyDecoderData.oneBitSampleCount * 48);
+		mark->noise = decayavg (mark->noise, mark_mag, (mark_mag < mark->noise) ? bitLen / 4 : bitLen * 48);
+		space->noise = decayavg (space->noise, space_mag, (space_mag < space->noise) ? bitLen / 4 : bitLen * 48);
 		// the noise floor is the lower signal of space and mark noise
-		float32_t noise_floor = (space_noise < mark_noise) ? space_noise : mark_noise;
-
-		// Linear ATC, section 3 of www.w7ay.net/site/Technical/ATC
-		//		v1 = space_mag - mark_mag - 0.5 * (space_env - mark_env);
+		float32_t noise_floor = (space->noise < mark->noise) ? space->noise : mark->noise;
 
 		// Compensating for the noise floor by using clipping
-		float32_t mclipped = 0.0, sclipped = 0.0;
-		mclipped = mark_mag > mark_env ? mark_env : mark_mag;
-		sclipped = space_mag > space_env ? space_env : space_mag;
+		float32_t mclipped = mark_mag > mark->env ? mark->env : mark_mag;
+		float32_t sclipped = space_mag > space->env ? space->env : space_mag;
 		if (mclipped < noise_floor)
 		{
 			mclipped = noise_floor;
@@ -504,74 +421,48 @@ static int RttyDecoder_demodulator(float32_t sample)
 			sclipped = noise_floor;
 		}
 
-		// we could add options for mark-only or space-only decoding
-		// however, the current implementation with ATC already works quite well with mark-only/space-only
-		/*					switch (progdefaults.rtty_cwi) {
-						case 1 : // mark only decode
-							space_env = sclipped = noise_floor;
-							break;
-						case 2: // space only decode
-							mark_env = mclipped = noise_floor;
-						default : ;
-		}
-		 */
-
 		// Optimal ATC (Section 6 of of www.w7ay.net/site/Technical/ATC)
-		v1  = (mclipped - noise_floor) * (mark_env - noise_floor) -
-				(sclipped - noise_floor) * (space_env - noise_floor) -
-				0.25 *  ((mark_env - noise_floor) * (mark_env - noise_floor) -
-						(space_env - noise_floor) * (space_env - noise_floor));
-
-		v1 = RttyDecoder_lowPass(v1, rttyDecoderData.lpfConfig, &rttyDecoderData.lpfData);
-
-		// MchfBoard_GreenLed((line0 > 0)? LED_STATE_OFF:LED_STATE_ON);
+		v1  = (mclipped - noise_floor) * (mark->env - noise_floor) -
+				(sclipped - noise_floor) * (space->env - noise_floor) -
+				0.25 *  ((mark->env - noise_floor) * (mark->env - noise_floor) -
+						(space->env - noise_floor) * (space->env - noise_floor));
 	}
 	else
 	{   // RTTY without ATC, which works very well too!
-		// inverting line 1
-		mark_mag *= -1;
-
-		// summing the two lines
-		v1 = mark_mag + space_mag;
-
-		// lowpass filtering the summed line
-		v1 = RttyDecoder_lowPass(v1, rttyDecoderData.lpfConfig, &rttyDecoderData.lpfData);
-		// MchfBoard_GreenLed((line0 > 0)? LED_STATE_OFF:LED_STATE_ON);
+		v1 = mark_mag - space_mag;
 	}
 
-	return (v1 > 0)?0:1;
+	return (v1 > 0)?RTTY_MARK:RTTY_SPACE;
 }
 
 // this function returns true once at the half of a bit with the bit's value
-static bool RttyDecoder_getBitDPLL(float32_t sample, bool* val_p) {
-	static bool phaseChanged = false;
+static bool RttyDecoder_getBitDPLL(int bit, bool* val_p) {
 	bool retval = false;
 
-
-	if (rttyDecoderData.DPLLBitPhase < rttyDecoderData.oneBitSampleCount)
+	if (rttyDecoderData.DPLLBitPhase < rttyDecoderData.bitLen)
 	{
-		*val_p = RttyDecoder_demodulator(sample);
+		*val_p = bit;
 
-		if (!phaseChanged && *val_p != rttyDecoderData.DPLLOldVal) {
-			if (rttyDecoderData.DPLLBitPhase < rttyDecoderData.oneBitSampleCount/2)
+		if (!rttyDecoderData.DPLLPhaseChanged && *val_p != rttyDecoderData.DPLLOldVal) {
+			if (rttyDecoderData.DPLLBitPhase < rttyDecoderData.bitLen/2)
 			{
-				// rttyDecoderData.DPLLBitPhase += rttyDecoderData.oneBitSampleCount/8; // early
-				rttyDecoderData.DPLLBitPhase += rttyDecoderData.oneBitSampleCount/32; // early
+				rttyDecoderData.DPLLBitPhase += rttyDecoderData.bitLen/32; // early
 			}
 			else
 			{
-				//rttyDecoderData.DPLLBitPhase -= rttyDecoderData.oneBitSampleCount/8; // late
-				rttyDecoderData.DPLLBitPhase -= rttyDecoderData.oneBitSampleCount/32; // late
+				rttyDecoderData.DPLLBitPhase -= rttyDecoderData.bitLen/32; // late
 			}
-			phaseChanged = true;
+			rttyDecoderData.DPLLPhaseChanged = true;
 		}
 		rttyDecoderData.DPLLOldVal = *val_p;
 		rttyDecoderData.DPLLBitPhase++;
 	}
 
-	if (rttyDecoderData.DPLLBitPhase >= rttyDecoderData.oneBitSampleCount)
+	if (rttyDecoderData.DPLLBitPhase >= rttyDecoderData.bitLen)
 	{
-		rttyDecoderData.DPLLBitPhase -= rttyDecoderData.oneBitSampleCount;
+		rttyDecoderData.DPLLBitPhase -= rttyDecoderData.bitLen;
+		// one correction per bit
+		rttyDecoderData.DPLLPhaseChanged = false;
 		retval = true;
 	}
 
@@ -579,38 +470,38 @@ static bool RttyDecoder_getBitDPLL(float32_t sample, bool* val_p) {
 }
 
 // this function returns only true when the start bit is successfully received
-static bool RttyDecoder_waitForStartBit(float32_t sample) {
+static bool RttyDecoder_waitForStartBit(int bitResult) {
 	bool retval = false;
-	int bitResult;
-	static int16_t wait_for_start_state = 0;
-	static int16_t wait_for_half = 0;
 
-	bitResult = RttyDecoder_demodulator(sample);
-	switch (wait_for_start_state)
+	switch (rttyDecoderData.waitForStartState)
 	{
 	case 0:
 		// waiting for a falling edge
 		if (bitResult != 0)
 		{
-			wait_for_start_state++;
+			rttyDecoderData.waitForStartState++;
 		}
 		break;
 	case 1:
 		if (bitResult != 1)
 		{
-			wait_for_start_state++;
+			rttyDecoderData.waitForStartState++;
 		}
 		break;
 	case 2:
-		wait_for_half = rttyDecoderData.oneBitSampleCount/2;
-		wait_for_start_state ++;
+		rttyDecoderData.waitForHalf = roundf(rttyDecoderData.bitLen/2);
+		rttyDecoderData.waitForStartState ++;
 		/* no break */
 	case 3:
-		wait_for_half--;
-		if (wait_for_half == 0)
+		rttyDecoderData.waitForHalf--;
+		if (rttyDecoderData.waitForHalf <= 0)
 		{
 			retval = (bitResult == 0);
-			wait_for_start_state = 0;
+			rttyDecoderData.waitForStartState = 0;
+			// the bit clock starts in the middle of the start bit
+			rttyDecoderData.DPLLBitPhase = 0;
+			rttyDecoderData.DPLLOldVal = bitResult;
+			rttyDecoderData.DPLLPhaseChanged = false;
 		}
 		break;
 	}
@@ -623,13 +514,14 @@ static const char RTTYLetters[] = "<E\nA SIU\nDRJNFCKTZLWHYPQOBG^MXV^";
 static const char RTTYSymbols[] = "<3\n- ,87\n$4#,.:(5+)2.60197.^./=^";
 
 
-void RttyDecoder_ProcessSample(float32_t sample)
+static void RttyDecoder_ProcessDecimated(void)
 {
+	const int bit = RttyDecoder_demodulator();
 
 	switch(rttyDecoderData.state)
 	{
 	case RTTY_RUN_STATE_WAIT_START: // not synchronized, need to wait for start bit
-		if (RttyDecoder_waitForStartBit(sample))
+		if (RttyDecoder_waitForStartBit(bit))
 		{
 			rttyDecoderData.state = RTTY_RUN_STATE_BIT;
 			rttyDecoderData.byteResultp = 1;
@@ -641,7 +533,7 @@ void RttyDecoder_ProcessSample(float32_t sample)
 		if (rttyDecoderData.byteResultp < 8)
 		{
 			bool bitResult;
-			if (RttyDecoder_getBitDPLL(sample, &bitResult))
+			if (RttyDecoder_getBitDPLL(bit, &bitResult))
 			{
 				switch (rttyDecoderData.byteResultp)
 				{
@@ -700,6 +592,39 @@ void RttyDecoder_ProcessSample(float32_t sample)
 	}
 }
 
+void RttyDecoder_ProcessBlock(const float32_t* src, int16_t blockSize)
+{
+	float32_t osc_i[RTTY_RX_CHUNK], osc_q[RTTY_RX_CHUNK];
+
+	for (int16_t offset = 0; offset < blockSize; offset += RTTY_RX_CHUNK)
+	{
+		const int16_t len = blockSize - offset < RTTY_RX_CHUNK ? blockSize - offset : RTTY_RX_CHUNK;
+		float32_t mix_i[2][RTTY_RX_CHUNK], mix_q[2][RTTY_RX_CHUNK];
+
+		for (int t = RTTY_SPACE; t <= RTTY_MARK; t++)
+		{
+			softdds_genIQSingleTone(&rttyDecoderData.tone[t].dds, osc_i, osc_q, len);
+			arm_mult_f32((float32_t*)&src[offset], osc_i, mix_i[t], len);
+			arm_mult_f32((float32_t*)&src[offset], osc_q, mix_q[t], len);
+		}
+
+		for (int16_t idx = 0; idx < len; idx++)
+		{
+			for (int t = RTTY_SPACE; t <= RTTY_MARK; t++)
+			{
+				rttyDecoderData.tone[t].acc_i += mix_i[t][idx];
+				rttyDecoderData.tone[t].acc_q += mix_q[t][idx];
+			}
+			rttyDecoderData.acc_count++;
+			if (rttyDecoderData.acc_count == rttyDecoderData.decimation)
+			{
+				rttyDecoderData.acc_count = 0;
+				RttyDecoder_ProcessDecimated();
+			}
+		}
+	}
+}
+
 typedef enum
 {
 	MSK_IDLE = 0,
@@ -13,6 +13,8 @@
 
 #include "uhsdr_types.h"
 
+#define RTTY_MARK_FREQ 915 // audio frequency of the mark tone, the space tone is the shift above it
+
 typedef enum {
     RTTY_STOP_1 = 0,
     RTTY_STOP_1_5,
@@ -20,6 +22,7 @@ typedef enum {
 } rtty_stop_t;
 
 
+// any speed and shift can be decoded, the menu offers the common ones of rtty_speeds[] and rtty_shifts[]
 typedef struct
 {
     float32_t speed;
@@ -33,6 +36,8 @@ typedef struct
 typedef enum {
     RTTY_SPEED_45,
     RTTY_SPEED_50,
+    RTTY_SPEED_75,
+    RTTY_SPEED_100,
     RTTY_SPEED_NUM
 } rtty_speed_t;
 
@@ -77,7 +82,9 @@ typedef struct
 
 extern rtty_ctrl_t rtty_ctrl_config;
 void RttyDecoder_Init();
-void RttyDecoder_ProcessSample(float32_t sample);
+void RttyDecoder_InitMode(const rtty_mode_config_t* config);
+void RttyDecoder_ProcessBlock(const float32_t* src, int16_t blockSize);
+void Rtty_Modulator_StartTX();
 int16_t Rtty_Modulator_GenSample();
 
 int DigiModes_TxBufferPutChar(uint8_t c);
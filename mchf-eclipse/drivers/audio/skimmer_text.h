@@ -0,0 +1,64 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+**                                                                                 **
+**                               UHSDR FIRMWARE                                    **
+**                                                                                 **
+**---------------------------------------------------------------------------------**
+**  Licence:		GNU GPLv3, see LICENSE.md                                                      **
+************************************************************************************/
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SKIMMER_TEXT_H
+#define __SKIMMER_TEXT_H
+
+#include "uhsdr_types.h"
+#include "uhsdr_mcu.h"
+
+#define SKIMMER_TEXT_LEN 128 // characters kept per carrier, must be a power of 2
+
+// decoded text of one skimmer channel, written by the audio interrupt, read by the UI
+typedef struct
+{
+	bool active;            // a carrier is assigned to the channel
+	uint16_t freq;          // audio frequency of the carrier in Hz
+	uint16_t generation;    // incremented whenever the channel gets a new carrier
+	uint32_t text_count;    // characters decoded since then, the last SKIMMER_TEXT_LEN are in text
+	char text[SKIMMER_TEXT_LEN];
+} SkimmerText;
+
+/**
+ * @brief starts the text of a new carrier, the UI sees the reset text before the channel becomes active
+ */
+static inline void SkimmerText_Assign(SkimmerText* text, uint16_t freq)
+{
+	text->text_count = 0;
+	text->freq = freq;
+	text->generation++;
+	__DMB();
+	text->active = true;
+}
+
+/**
+ * @brief adds a decoded character, the character is stored before the count which announces it
+ */
+static inline void SkimmerText_PutChar(SkimmerText* text, char ch)
+{
+	text->text[text->text_count & (SKIMMER_TEXT_LEN - 1)] = ch;
+	__DMB();
+	text->text_count++;
+}
+
+/**
+ * @brief forgets the text of all channels
+ */
+static inline void SkimmerText_Reset(SkimmerText* text, uint16_t channels)
+{
+	for (uint16_t c = 0; c < channels; c++)
+	{
+		text[c].active = false;
+		text[c].text_count = 0;
+		text[c].generation++;
+	}
+}
+
+#endif
@@ -19,8 +19,10 @@
 #include "usbd_cdc_if.h"
 
 #include <stdio.h>
+#include <string.h>
 #include "audio_driver.h"
 #include "radio_management.h"
+#include "profiling.h"
 
 uint8_t limit_4bits(uint32_t in)
 {
@@ -206,6 +208,15 @@ static uint8_t CatDriver_InterfaceBufferPutData(uint8_t* Buf,uint32_t Len)
 }
 
 
+/**
+ * @brief sends text which is not a CAT response over the virtual serial port, e.g. the output of a decoder
+ * @returns true if the text was queued for transmission
+ */
+bool CatDriver_SendText(const char* text)
+{
+    return CatDriver_InterfaceBufferPutData((uint8_t*)text, strlen(text)) != 0;
+}
+
 /*
 
     DUPLEX = ["", "-", "+", "split"]
@@ -718,7 +729,9 @@ typedef enum
     FT817_READ_TX_STATE = 0xbd,
     FT817_READ_RX_STATE = 0xe7,
     FT817_PTT_STATE     = 0xf7,
-    FT817_NOOP          = 0xff
+    FT817_NOOP          = 0xff,
+    // UHSDR extensions, not known to a real FT-817
+    UHSDR_PROFILE_GET   = 0x9f,
 } Ft817_CatCmd_t;
 
 struct FT817 ft817;
@@ -992,10 +1005,89 @@ bool CatDriver_CloneInStart()
 }
 
 
+static void CatDriver_PutUint32(uint8_t* buf, uint32_t value)
+{
+    buf[0] = value;
+    buf[1] = value >> 8;
+    buf[2] = value >> 16;
+    buf[3] = value >> 24;
+}
+
+/**
+ * @brief UHSDR_PROFILE_GET: reads the cycle statistics of the profiler, see profiling.h
+ *
+ * P1 is the event index, P2 selects what is returned, all numbers are little endian:
+ * - P1 = 0xff: 7 bytes, number of events, number of histogram bins, histogram shift (uint8 each),
+ *   core clock in kHz (uint32), the H7 runs at more than 255 MHz
+ * - P2 = 0: 16 bytes, count, min, max and mean cycles of the event (uint32 each)
+ * - P2 = 1: 4 bytes per histogram bin (uint32), bin n > 0 counts durations of 2^(shift+n-1) up to 2^(shift+n)-1 cycles
+ * - P2 = 2: 20 bytes, name of the event, zero padded
+ * - P2 = 3: resets the event, all events if P1 = 0xfe, returns a single 0
+ * Invalid requests are not answered, as it is done for unknown commands
+ *
+ * @param resp has to have room for 4 * PROFILE_HIST_BINS bytes
+ * @returns number of bytes in resp
+ */
+static uint8_t CatDriver_HandleProfileGet(uint8_t event_idx, uint8_t what, uint8_t* resp)
+{
+    uint8_t bc = 0;
+
+    if (event_idx == 0xff)
+    {
+        resp[0] = EventProfileMax;
+        resp[1] = PROFILE_HIST_BINS;
+        resp[2] = PROFILE_HIST_SHIFT;
+        CatDriver_PutUint32(&resp[3], SystemCoreClock / 1000);
+        bc = 7;
+    }
+    else if (event_idx == 0xfe && what == 3)
+    {
+        for (ProfiledEventNames pe = 0; pe < EventProfileMax; pe++)
+        {
+            profileTimedEventReset(pe);
+        }
+        resp[0] = 0;
+        bc = 1;
+    }
+    else if (event_idx < EventProfileMax)
+    {
+        // we copy the data, the audio interrupt may update the event while we are sending it
+        const ProfilingTimedEvent ev = *profileTimedEventGet(event_idx);
+
+        switch(what)
+        {
+        case 0:
+            CatDriver_PutUint32(&resp[0], ev.count);
+            CatDriver_PutUint32(&resp[4], ev.min);
+            CatDriver_PutUint32(&resp[8], ev.max);
+            CatDriver_PutUint32(&resp[12], ev.count != 0 ? ev.duration / ev.count : 0);
+            bc = 16;
+            break;
+        case 1:
+            for (int bin = 0; bin < PROFILE_HIST_BINS; bin++)
+            {
+                CatDriver_PutUint32(&resp[bin * 4], ev.hist[bin]);
+            }
+            bc = PROFILE_HIST_BINS * 4;
+            break;
+        case 2:
+            strncpy((char*)resp, profileTimedEventName(event_idx), 20);
+            bc = 20;
+            break;
+        case 3:
+            profileTimedEventReset(event_idx);
+            resp[0] = 0;
+            bc = 1;
+            break;
+        }
+    }
+    return bc;
+}
+
 static void CatDriver_HandleCommands()
 {
     uint8_t bc = 0;
-    uint8_t resp[32];
+    uint8_t resp[4 * PROFILE_HIST_BINS > 32 ? 4 * PROFILE_HIST_BINS : 32];
 
     cat_driver_sync_data();
 
@@ -1265,6 +1357,9 @@ static void CatDriver_HandleCommands()
             }
             bc = 1;
             break;
+        case UHSDR_PROFILE_GET:
+            bc = CatDriver_HandleProfileGet(ft817.req[0], ft817.req[1], resp);
+            break;
         case 255: /* FF sent out by HRD */
             break;
             // default:
@@ -42,6 +42,7 @@ bool CatDriver_CloneOutStart();
 bool CatDriver_CloneInStart();
 
 bool CatDriver_CWKeyPressed();
+bool CatDriver_SendText(const char* text);
 bool CatDriver_CatPttActive();
 
 #endif
@@ -61,6 +61,20 @@
     #define LCD_RAM      (*((volatile unsigned short *) 0x60004000))
     #endif
     #endif
+
+    #ifdef HOST_BUILD
+    // the parallel bus ends in the display emulator of the host build, see support/host-dsp/host_lcd.c
+    #include "host_lcd.h"
+    #define UiLcdHy28_BusWriteReg(reg)      HostLcd_BusWriteReg(reg)
+    #define UiLcdHy28_BusWriteRam(data)     HostLcd_BusWriteRam(data)
+    #define UiLcdHy28_BusReadReg()          HostLcd_BusReadReg()
+    #define UiLcdHy28_BusReadRam()          HostLcd_BusReadRam()
+    #else
+    #define UiLcdHy28_BusWriteReg(reg)      (LCD_REG = (reg))
+    #define UiLcdHy28_BusWriteRam(data)     (LCD_RAM = (data))
+    #define UiLcdHy28_BusReadReg()          (LCD_REG)
+    #define UiLcdHy28_BusReadRam()          (LCD_RAM)
+    #endif
 #endif
 
 
@@ -661,28 +675,76 @@ void UiLcdHy28_GpioInit(mchf_display_types_t display_type)
 DMA_HandleTypeDef DMA_Handle;
 
 
-static inline void UiLcdHy28_SpiDmaStop()
-{
-    while (DMA1_Stream4->CR & DMA_SxCR_EN) { asm(""); }
-}
+#define PIXELBUFFERSIZE 512
+#define PIXELBUFFERCOUNT 2
 
+#ifdef USE_SPI_DMA
+/*
+ * Display command queue for SPI displays: the drawing functions queue window setups, filled pixel buffers
+ * and color fills, which are sent to the display from the SPI DMA transfer complete interrupt.
+ * The main loop only waits if the queue is full or if it needs a pixel buffer which has not been sent yet,
+ * so it can prepare the next drawing while the previous one is still being transferred.
+ * Everything else using the SPI bus (register access, touchscreen) has to wait for the queue to run empty,
+ * see UiLcdHy28_SpiQueueWait().
+ * The window setups are polled register writes, up to about 0.1ms per interrupt, so the SPI DMA interrupt
+ * has to have a lower priority than the audio interrupts (DMA1_Stream4_IRQn, see dma.c).
+ */
+#define LCD_SPI_QUEUE_LEN   32
+#define LCD_SPI_FILL_LEN    64      // pixels per DMA transfer of a fill
 
+typedef enum
+{
+    LCD_SPI_CMD_WINDOW = 0,
+    LCD_SPI_CMD_PIXELS,
+    LCD_SPI_CMD_FILL,
+    LCD_SPI_CMD_CLOSE,
+} lcd_spi_cmd_type_t;
 
-void UiLcdHy28_SpiDmaStart(uint8_t* buffer, uint32_t size)
+typedef struct
 {
+    uint8_t type;
+    uint8_t buffer;                     // PIXELS: pixel buffer index, released when sent
+    uint16_t color;                     // FILL
+    uint32_t len;                       // PIXELS, FILL: number of pixels not yet sent
+    uint16_t* pixels;                   // PIXELS: byte swapped pixel data
+    lcd_bulk_transfer_header_t window;  // WINDOW
+} lcd_spi_cmd_t;
 
-    // do busy waiting here. This is just for testing if everything goes according to plan
-    // if this works okay, we can let SPI DMA running while doing something else
-    // and just check before next transfer if DMA is being done.
-    // and finally we can move that into an interrupt, of course.
-    if (size > 0)  {
-        UiLcdHy28_SpiDmaStop();
-        HAL_SPI_Transmit_DMA(&hspi2,buffer,size);
+typedef struct
+{
+    lcd_spi_cmd_t cmd[LCD_SPI_QUEUE_LEN];
+    volatile uint16_t head;             // next free entry, written by the main loop only
+    volatile uint16_t tail;             // command being executed
+    volatile bool busy;                 // commands are being executed or a DMA transfer is running
+    volatile bool in_run;               // we are executing commands, register writes go out directly
+    volatile bool buffer_queued[PIXELBUFFERCOUNT];
+} lcd_spi_queue_t;
+
+static lcd_spi_queue_t lcd_spi_queue;
+static uint16_t lcd_spi_fill[LCD_SPI_FILL_LEN];
+
+/**
+ * @brief waits until all queued display commands have been sent, does nothing if called while executing them
+ */
+static inline void UiLcdHy28_SpiQueueWait()
+{
+    if (lcd_spi_queue.in_run == false)
+    {
+        while (lcd_spi_queue.busy) { asm(""); }
     }
 }
 
+static inline void UiLcdHy28_SpiDmaStart(uint8_t* buffer, uint32_t size)
+{
+    HAL_SPI_Transmit_DMA(&hspi2,buffer,size);
+}
+#endif
+
 void UiLcdHy28_SpiDeInit()
 {
+#ifdef USE_SPI_DMA
+    UiLcdHy28_SpiQueueWait();
+#endif
 
     // __HAL_SPI_DISABLE(&hspi2);
     // HAL_SPI_DeInit(&hspi2);
@@ -851,7 +913,7 @@ static inline void UiLcdHy28_WriteDataOnly( unsigned short data)
     }
     else
     {
-        LCD_RAM = data;
+        UiLcdHy28_BusWriteRam(data);
         __DMB();
 
     }
@@ -868,7 +930,7 @@ static inline void UiLcdHy28_WriteData( unsigned short data)
     }
     else
     {
-        LCD_RAM = data;
+        UiLcdHy28_BusWriteRam(data);
         __DMB();
 
     }
@@ -912,14 +974,17 @@ void UiLcdHy28_WriteReg(unsigned short LCD_Reg, unsigned short LCD_RegValue)
 
     if(UiLcdHy28_SpiDisplayUsed())
     {
+#ifdef USE_SPI_DMA
+        UiLcdHy28_SpiQueueWait();
+#endif
         UiLcdHy28_WriteIndexSpi(LCD_Reg);
         UiLcdHy28_WriteDataSpi(LCD_RegValue);
     }
     else
     {
-        LCD_REG = LCD_Reg;
+        UiLcdHy28_BusWriteReg(LCD_Reg);
         __DMB();
-        LCD_RAM = LCD_RegValue;
+        UiLcdHy28_BusWriteRam(LCD_RegValue);
         __DMB();
     }
 }
@@ -929,6 +994,9 @@ unsigned short UiLcdHy28_ReadReg( unsigned short LCD_Reg)
     uint16_t retval;
     if(UiLcdHy28_SpiDisplayUsed())
     {
+#ifdef USE_SPI_DMA
+        UiLcdHy28_SpiQueueWait();
+#endif
         // Write 16-bit Index (then Read Reg)
         UiLcdHy28_WriteIndexSpi(LCD_Reg);
         // Read 16-bit Reg
@@ -938,10 +1006,10 @@ unsigned short UiLcdHy28_ReadReg( unsigned short LCD_Reg)
     {
 
         // Write 16-bit Index (then Read Reg)
-        LCD_REG = LCD_Reg;
+        UiLcdHy28_BusWriteReg(LCD_Reg);
         // Read 16-bit Reg
         __DMB();
-        retval = LCD_RAM;
+        retval = UiLcdHy28_BusReadRam();
     }
     return retval;
 }
@@ -960,7 +1028,7 @@ static void UiLcdHy28_WriteRAM_Prepare_Index(uint16_t wr_prep_reg)
     }
     else
     {
-        LCD_REG = wr_prep_reg;
+        UiLcdHy28_BusWriteReg(wr_prep_reg);
         __DMB();
     }
 }
@@ -977,31 +1045,126 @@ void UiLcdHy28_SetActiveWindow(uint16_t XLeft, uint16_t XRight, uint16_t YTop,
     mchf_display.SetActiveWindow(XLeft, XRight, YTop, YBottom);
 }
 
-static void UiLcdHy28_BulkWrite(uint16_t* pixel, uint32_t len)
-{
+static void UiLcdHy28_CloseBulkWrite();
 
-// if we are not using SPI DMA, we send the data as it comes
-// if we are using SPI DMA, we do this only if we are NOT using SPI
 #ifdef USE_SPI_DMA
-    if(UiLcdHy28_SpiDisplayUsed() == false)
-#endif
+/**
+ * @brief executes queued display commands until a DMA transfer has been started or the queue is empty
+ * Called from the main loop if the queue is idle and from the DMA transfer complete interrupt.
+ */
+static void UiLcdHy28_SpiQueueRun()
+{
+    bool dma_started = false;
+
+    lcd_spi_queue.in_run = true;
+
+    while (dma_started == false && lcd_spi_queue.tail != lcd_spi_queue.head)
     {
-        for (uint32_t i = len; i; i--)
+        lcd_spi_cmd_t* cmd = &lcd_spi_queue.cmd[lcd_spi_queue.tail];
+
+        switch(cmd->type)
+        {
+        case LCD_SPI_CMD_WINDOW:
+            // the pixels of the previous window have left the SPI, end that transfer
+            UiLcdHy28_LcdSpiFinishTransfer();
+            UiLcdHy28_SetActiveWindow(cmd->window.x, cmd->window.x + cmd->window.width - 1, cmd->window.y, cmd->window.y + cmd->window.height - 1);
+            UiLcdHy28_SetCursorA(cmd->window.x, cmd->window.y);
+            UiLcdHy28_WriteRAM_Prepare();
+            break;
+        case LCD_SPI_CMD_CLOSE:
+            UiLcdHy28_LcdSpiFinishTransfer();
+            UiLcdHy28_CloseBulkWrite();
+            break;
+        case LCD_SPI_CMD_PIXELS:
+            dma_started = true;
+            UiLcdHy28_SpiDmaStart((uint8_t*)cmd->pixels, cmd->len * 2);
+            break;
+        case LCD_SPI_CMD_FILL:
         {
-            UiLcdHy28_WriteDataOnly(*(pixel++));
+            const uint32_t len = cmd->len < LCD_SPI_FILL_LEN ? cmd->len : LCD_SPI_FILL_LEN;
+            const uint16_t color = __REV16(cmd->color);
+            for (uint32_t idx = 0; idx < len; idx++)
+            {
+                lcd_spi_fill[idx] = color;
+            }
+            // the command must not be touched anymore once the transfer runs
+            cmd->len -= len;
+            dma_started = true;
+            UiLcdHy28_SpiDmaStart((uint8_t*)lcd_spi_fill, len * 2);
+            break;
         }
-    }
-#ifdef USE_SPI_DMA
-    else
-    {
-        for (uint32_t i = 0; i < len; i++)
+        }
+
+        if (dma_started == false)
         {
-            pixel[i] = __REV16(pixel[i]); // reverse byte order;
+            lcd_spi_queue.tail = (lcd_spi_queue.tail + 1) % LCD_SPI_QUEUE_LEN;
         }
-        UiLcdHy28_SpiDmaStart((uint8_t*)pixel,len*2);
     }
+
+    if (dma_started == false)
+    {
+        lcd_spi_queue.busy = false;
+    }
+    lcd_spi_queue.in_run = false;
+}
+
+/**
+ * @brief DMA transfer of the command at the queue tail is done, release it and continue with the queue
+ */
+static void UiLcdHy28_SpiQueueDmaDone()
+{
+    lcd_spi_cmd_t* cmd = &lcd_spi_queue.cmd[lcd_spi_queue.tail];
+
+    if (cmd->type == LCD_SPI_CMD_PIXELS)
+    {
+        lcd_spi_queue.buffer_queued[cmd->buffer] = false;
+        cmd->len = 0;
+    }
+    if (cmd->len == 0)
+    {
+        lcd_spi_queue.tail = (lcd_spi_queue.tail + 1) % LCD_SPI_QUEUE_LEN;
+    }
+    UiLcdHy28_SpiQueueRun();
+}
+
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi)
+{
+    if (hspi == &hspi2)
+    {
+        UiLcdHy28_SpiQueueDmaDone();
+    }
+}
+
+/**
+ * @brief appends a command to the display queue and starts executing the queue if it is idle
+ * waits if the queue is full
+ */
+static void UiLcdHy28_SpiQueuePush(const lcd_spi_cmd_t* cmd)
+{
+    const uint16_t next = (lcd_spi_queue.head + 1) % LCD_SPI_QUEUE_LEN;
+
+    // queue full, wait for the display to catch up
+    while (next == lcd_spi_queue.tail) { asm(""); }
+
+    lcd_spi_queue.cmd[lcd_spi_queue.head] = *cmd;
+    __DMB();
+    lcd_spi_queue.head = next;
+
+    // if busy, the running transfer will pick up the new command when done
+    if (lcd_spi_queue.busy == false)
+    {
+        lcd_spi_queue.busy = true;
+        UiLcdHy28_SpiQueueRun();
+    }
+}
 #endif
 
+static void UiLcdHy28_BulkWrite(const uint16_t* pixel, uint32_t len)
+{
+    for (uint32_t i = len; i; i--)
+    {
+        UiLcdHy28_WriteDataOnly(*(pixel++));
+    }
 }
 
 static void UiLcdHy28_FinishWaitBulkWrite()
@@ -1009,7 +1172,7 @@ static void UiLcdHy28_FinishWaitBulkWrite()
     if(UiLcdHy28_SpiDisplayUsed())         // SPI enabled?
     {
 #ifdef USE_SPI_DMA
-        UiLcdHy28_SpiDmaStop();
+        UiLcdHy28_SpiQueueWait();
 #endif
         UiLcdHy28_LcdSpiFinishTransfer();
     }
@@ -1017,26 +1180,118 @@ static void UiLcdHy28_FinishWaitBulkWrite()
 
 static void UiLcdHy28_OpenBulkWrite(ushort x, ushort width, ushort y, ushort height)
 {
-    UiLcdHy28_FinishWaitBulkWrite();
-    UiLcdHy28_SetActiveWindow(x, x + width - 1, y, y + height - 1);
-    UiLcdHy28_SetCursorA(x, y);
-    UiLcdHy28_WriteRAM_Prepare();
+#ifdef USE_SPI_DMA
+    if(UiLcdHy28_SpiDisplayUsed())
+    {
+        const lcd_spi_cmd_t cmd = { .type = LCD_SPI_CMD_WINDOW, .window = { .x = x, .width = width, .y = y, .height = height } };
+        UiLcdHy28_SpiQueuePush(&cmd);
+    }
+    else
+#endif
+    {
+        UiLcdHy28_FinishWaitBulkWrite();
+        UiLcdHy28_SetActiveWindow(x, x + width - 1, y, y + height - 1);
+        UiLcdHy28_SetCursorA(x, y);
+        UiLcdHy28_WriteRAM_Prepare();
+    }
 }
 
 static void UiLcdHy28_CloseBulkWrite()
 {
 #ifdef USE_GFX_RA8875
-	uint16_t MAX_X=mchf_display.MAX_X; uint16_t MAX_Y=mchf_display.MAX_Y;
-    UiLcdHy28_SetActiveWindow(0, MAX_X - 1, 0, MAX_Y - 1);
-    UiLcdHy28_WriteReg(0x40, 0);
+#ifdef USE_SPI_DMA
+    if(UiLcdHy28_SpiDisplayUsed() && lcd_spi_queue.in_run == false)
+    {
+        // done when the queue gets here
+        const lcd_spi_cmd_t cmd = { .type = LCD_SPI_CMD_CLOSE };
+        UiLcdHy28_SpiQueuePush(&cmd);
+    }
+    else
+#endif
+    {
+        uint16_t MAX_X=mchf_display.MAX_X; uint16_t MAX_Y=mchf_display.MAX_Y;
+        UiLcdHy28_SetActiveWindow(0, MAX_X - 1, 0, MAX_Y - 1);
+        UiLcdHy28_WriteReg(0x40, 0);
+    }
 #endif
 }
 
 
 
+/*
+ * Retained drawing: text and boxes of the UI widgets which are redrawn all the time with mostly the same content.
+ * For each item we remember what the screen shows, so that only changed characters are drawn and
+ * unchanged items not at all. Every other drawing function invalidates the items it paints over.
+ * Items are kept in creation order, later items are considered to be on top of earlier ones:
+ * redrawing an item invalidates only the overlapping items created after it.
+ */
+#define UI_LCD_RETAINED_NUM         64
+#define UI_LCD_RETAINED_TEXT_LEN    16
+#define UI_LCD_RETAINED_RUN_GAP     1   // unchanged characters between two changed ones which are redrawn to get a single run
+
+typedef enum
+{
+    RETAINED_TEXT_LEFT = 0,
+    RETAINED_TEXT_RIGHT,
+    RETAINED_TEXT_CENTERED,
+    RETAINED_FILL,
+    RETAINED_FRAME,
+} retained_kind_t;
+
+typedef struct
+{
+    uint16_t x, y, w, h;        // as given by the caller, for text w is the box width and h the character pitch
+    uint16_t dx, dw;            // horizontal extent of the drawn text
+    uint16_t clr_fg, clr_bg;
+    uint8_t kind;
+    uint8_t font;
+    uint8_t len;
+    bool valid;                 // the screen shows what is stored here
+    char text[UI_LCD_RETAINED_TEXT_LEN];
+} retained_item_t;
+
+static retained_item_t retained_items[UI_LCD_RETAINED_NUM];
+static uint16_t retained_num;
+
+static inline bool UiLcdHy28_AreaOverlap(uint16_t x1, uint16_t y1, uint16_t w1, uint16_t h1, uint16_t x2, uint16_t y2, uint16_t w2, uint16_t h2)
+{
+    return x1 < x2 + w2 && x2 < x1 + w1 && y1 < y2 + h2 && y2 < y1 + h1;
+}
+
+/**
+ * @brief marks all retained items from index first on as invalid which overlap the area
+ */
+static void UiLcdHy28_RetainedInvalidate(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t first)
+{
+    for (uint16_t idx = first; idx < retained_num; idx++)
+    {
+        retained_item_t* item = &retained_items[idx];
+        if (item->valid)
+        {
+            switch(item->kind)
+            {
+            case RETAINED_FILL:
+                item->valid = !UiLcdHy28_AreaOverlap(x, y, w, h, item->x, item->y, item->w, item->h);
+                break;
+            case RETAINED_FRAME:
+                item->valid = !UiLcdHy28_AreaOverlap(x, y, w, h, item->x, item->y, item->w + 1, item->h + 1);
+                break;
+            default:
+                item->valid = !UiLcdHy28_AreaOverlap(x, y, w, h, item->dx, item->y, item->dw, UiLcdHy28_TextHeight(item->font));
+                break;
+            }
+        }
+    }
+}
+
+/**
+ * @brief forgets all retained items, e.g. if the screen is cleared or the layout changes
+ */
+void UiLcdHy28_RetainedReset()
+{
+    retained_num = 0;
+}
 
-#define PIXELBUFFERSIZE 512
-#define PIXELBUFFERCOUNT 2
 static uint16_t   pixelbuffer[PIXELBUFFERCOUNT][PIXELBUFFERSIZE];
 static uint16_t pixelcount = 0;
 static uint16_t pixelbufidx = 0;
@@ -1044,13 +1299,37 @@ static uint16_t pixelbufidx = 0;
 static inline void UiLcdHy28_BulkPixel_BufferInit()
 {
     pixelbufidx= (pixelbufidx+1)%PIXELBUFFERCOUNT;
+#ifdef USE_SPI_DMA
+    // the buffer may still wait for its transfer
+    while (lcd_spi_queue.buffer_queued[pixelbufidx]) { asm(""); }
+#endif
     pixelcount = 0;
 }
 
 
 inline void UiLcdHy28_BulkPixel_BufferFlush()
 {
-    UiLcdHy28_BulkWrite(pixelbuffer[pixelbufidx],pixelcount);
+#ifdef USE_SPI_DMA
+    if(UiLcdHy28_SpiDisplayUsed())
+    {
+        if (pixelcount > 0)
+        {
+            uint16_t* pixel = pixelbuffer[pixelbufidx];
+            for (uint32_t i = 0; i < pixelcount; i++)
+            {
+                pixel[i] = __REV16(pixel[i]); // reverse byte order;
+            }
+            lcd_spi_queue.buffer_queued[pixelbufidx] = true;
+
+            const lcd_spi_cmd_t cmd = { .type = LCD_SPI_CMD_PIXELS, .buffer = pixelbufidx, .pixels = pixel, .len = pixelcount };
+            UiLcdHy28_SpiQueuePush(&cmd);
+        }
+    }
+    else
+#endif
+    {
+        UiLcdHy28_BulkWrite(pixelbuffer[pixelbufidx],pixelcount);
+    }
     UiLcdHy28_BulkPixel_BufferInit();
 }
 
@@ -1063,10 +1342,7 @@ inline void UiLcdHy28_BulkPixel_Put(uint16_t pixel)
     }
 }
 
-// TODO: Not most efficient way, we could use remaining buffer size to judge
-// if it will fit without flush and fill accordingly.
-
-inline void UiLcdHy28_BulkPixel_PutBuffer(uint16_t* pixel_buffer, uint32_t len)
+inline void UiLcdHy28_BulkPixel_PutBuffer(const uint16_t* pixel_buffer, uint32_t len)
 {
     // We bypass the buffering if in parallel mode
     // since as for now, it will not benefit from it.
@@ -1074,9 +1350,19 @@ inline void UiLcdHy28_BulkPixel_PutBuffer(uint16_t* pixel_buffer, uint32_t len)
     // interface (memory to memory DMA)
     if(UiLcdHy28_SpiDisplayUsed())         // SPI enabled?
     {
-        for (uint32_t idx = 0; idx < len; idx++)
+        while (len > 0)
         {
-            UiLcdHy28_BulkPixel_Put(pixel_buffer[idx]);
+            // copy as much as fits into the current buffer
+            const uint32_t count = len < (PIXELBUFFERSIZE - pixelcount) ? len : (PIXELBUFFERSIZE - pixelcount);
+            memcpy(&pixelbuffer[pixelbufidx][pixelcount], pixel_buffer, count * sizeof(uint16_t));
+            pixelcount += count;
+            pixel_buffer += count;
+            len -= count;
+
+            if (pixelcount == PIXELBUFFERSIZE)
+            {
+                UiLcdHy28_BulkPixel_BufferFlush();
+            }
         }
     }
     else
@@ -1087,6 +1373,7 @@ inline void UiLcdHy28_BulkPixel_PutBuffer(uint16_t* pixel_buffer, uint32_t len)
 
 inline void UiLcdHy28_BulkPixel_OpenWrite(ushort x, ushort width, ushort y, ushort height)
 {
+    UiLcdHy28_RetainedInvalidate(x, y, width, height, 0);
     UiLcdHy28_OpenBulkWrite(x, width,y,height);
     UiLcdHy28_BulkPixel_BufferInit();
 }
@@ -1100,26 +1387,10 @@ inline void UiLcdHy28_BulkPixel_CloseWrite()
 
 void UiLcdHy28_LcdClear(ushort Color)
 {
+    UiLcdHy28_RetainedReset();
 	uint32_t MAX_X=mchf_display.MAX_X; uint32_t MAX_Y=mchf_display.MAX_Y;
     UiLcdHy28_OpenBulkWrite(0,MAX_X,0,MAX_Y);
-#ifdef USE_SPI_DMA
-    if(UiLcdHy28_SpiDisplayUsed())
-    {
-        int idx;
-
-        UiLcdHy28_BulkPixel_BufferInit();
-
-        for (idx = 0; idx < MAX_X * MAX_Y; idx++)
-        {
-            UiLcdHy28_BulkPixel_Put(Color);
-        }
-        UiLcdHy28_BulkPixel_BufferFlush();
-    }
-    else
-#endif
-    {
-        UiLcdHy28_BulkWriteColor(Color,MAX_X * MAX_Y);
-    }
+    UiLcdHy28_BulkWriteColor(Color,MAX_X * MAX_Y);
     UiLcdHy28_CloseBulkWrite();
 }
 
@@ -1127,6 +1398,7 @@ void UiLcdHy28_LcdClear(ushort Color)
 
 void UiLcdHy28_DrawColorPoint( unsigned short Xpos, unsigned short Ypos, unsigned short point)
 {
+    UiLcdHy28_RetainedInvalidate(Xpos, Ypos, 1, 1, 0);
 	uint16_t MAX_X=mchf_display.MAX_X; uint16_t MAX_Y=mchf_display.MAX_Y;
 #ifdef USE_GFX_RA8875
     if( Xpos < MAX_X && Ypos < MAX_Y )
@@ -1138,7 +1410,7 @@ void UiLcdHy28_DrawColorPoint( unsigned short Xpos, unsigned short Ypos, unsigne
     if( Xpos < MAX_X && Ypos < MAX_Y )
     {
         UiLcdHy28_OpenBulkWrite(Xpos,1,Ypos,1);
-        UiLcdHy28_WriteDataOnly(point);
+        UiLcdHy28_BulkWriteColor(point,1);
         UiLcdHy28_CloseBulkWrite();
     }
 #endif
@@ -1146,7 +1418,7 @@ void UiLcdHy28_DrawColorPoint( unsigned short Xpos, unsigned short Ypos, unsigne
 #endif
 
 
-void UiLcdHy28_DrawFullRect(ushort Xpos, ushort Ypos, ushort Height, ushort Width ,ushort color)
+static void UiLcdHy28_FillRect(ushort Xpos, ushort Ypos, ushort Height, ushort Width ,ushort color)
 {
 #ifdef USE_GFX_RA8875
     UiLcdRA8875_SetForegroundColor(color);
@@ -1169,6 +1441,12 @@ void UiLcdHy28_DrawFullRect(ushort Xpos, ushort Ypos, ushort Height, ushort Widt
 
 }
 
+void UiLcdHy28_DrawFullRect(ushort Xpos, ushort Ypos, ushort Height, ushort Width ,ushort color)
+{
+    UiLcdHy28_RetainedInvalidate(Xpos, Ypos, Width, Height, 0);
+    UiLcdHy28_FillRect(Xpos, Ypos, Height, Width, color);
+}
+
 
 
 #ifdef  USE_DRIVER_RA8875
@@ -1177,7 +1455,7 @@ void UiLcdHy28_RA8875_WaitReady()
 {
     uint16_t temp;
     do {
-        temp = LCD_REG;
+        temp = UiLcdHy28_BusReadReg();
     } while ((temp & 0x80) == 0x80);
 }
 
@@ -1227,7 +1505,7 @@ void UiLcdRA8875_setScrollMode(uint8_t mode)
         default:
             return;             //do nothing
     }
-    LCD_RAM=temp;
+    UiLcdHy28_BusWriteRam(temp);
     __DMB();
 
 }
@@ -1281,6 +1559,45 @@ void UiLcdRA8875_scroll(int16_t x,int16_t y)
 
 #endif
 
+/**
+ * @brief sets up hardware vertical scrolling of a screen area, if the controller can do it
+ * With offset y the top row of the area shows the memory row y + offset, the rows wrap
+ * around inside the area. Drawing still uses the unscrolled memory coordinates.
+ * The ILI9486 scrolls only along its native vertical axis, which is horizontal in our landscape
+ * orientation, and always the full width, so it is not supported here.
+ * @returns true if the area can be scrolled with UiLcdHy28_ScrollWindowOffset, the offset is 0
+ */
+bool UiLcdHy28_ScrollWindowInit(ushort x, ushort width, ushort y, ushort height)
+{
+    bool retval = false;
+#ifdef USE_DRIVER_RA8875
+    if (mchf_display.display_type == DISPLAY_RA8875_SPI || mchf_display.display_type == DISPLAY_RA8875_PARALLEL)
+    {
+        UiLcdRA8875_setScrollWindow(x, x + width - 1, y, y + height - 1);
+        UiLcdRA8875_scroll(0, 0);
+        retval = true;
+    }
+#elif defined(HOST_BUILD)
+    // the display emulator can stand in for the scroll window of the RA8875
+    retval = HostLcd_ScrollWindowInit(x, width, y, height);
+#endif
+    return retval;
+}
+
+/**
+ * @brief vertical offset of the scroll window, only call if UiLcdHy28_ScrollWindowInit returned true
+ */
+void UiLcdHy28_ScrollWindowOffset(ushort y)
+{
+#ifdef USE_DRIVER_RA8875
+    UiLcdHy28_FinishWaitBulkWrite();
+    UiLcdRA8875_scroll(0, y);
+#elif defined(HOST_BUILD)
+    UiLcdHy28_FinishWaitBulkWrite();
+    HostLcd_ScrollWindowOffset(y);
+#endif
+}
+
 
 void UiLcdHy28_DrawStraightLineWidth(ushort x, ushort y, ushort Length, uint16_t Width, uchar Direction,ushort color)
 {
@@ -1310,6 +1627,7 @@ void UiLcdHy28_DrawStraightLine(ushort x, ushort y, ushort Length, uchar Directi
     #define LCD_DLVER1  (0x98)      /* Draw Line/Square Vertical End Address Register1 */
 
 
+    UiLcdHy28_RetainedInvalidate(x, y, Direction == LCD_DIR_VERTICAL ? 1 : Length + 1, Direction == LCD_DIR_VERTICAL ? Length + 1 : 1, 0);
     UiLcdRA8875_SetForegroundColor(color);
 
     uint16_t x_end, y_end;
@@ -1355,6 +1673,7 @@ void UiLcdHy28_DrawHorizLineWithGrad(ushort x, ushort y, ushort Length,ushort gr
     uint32_t i = 0,j = 0;
     ushort     k = gradient_start;
 
+    UiLcdHy28_RetainedInvalidate(x, y, Length, 1, 0);
     UiLcdHy28_OpenBulkWrite(x,Length,y,1);
     UiLcdHy28_BulkPixel_BufferInit();
     for(i = 0; i < Length; i++)
@@ -1399,15 +1718,11 @@ static void UiLcdHy28_BulkWriteColor(uint16_t Color, uint32_t len)
 #ifdef USE_SPI_DMA
     if(UiLcdHy28_SpiDisplayUsed())
     {
-        int idx;
-
-        UiLcdHy28_BulkPixel_BufferInit();
-
-        for (idx = 0; idx < len; idx++)
+        if (len > 0)
         {
-            UiLcdHy28_BulkPixel_Put(Color);
+            const lcd_spi_cmd_t cmd = { .type = LCD_SPI_CMD_FILL, .color = Color, .len = len };
+            UiLcdHy28_SpiQueuePush(&cmd);
         }
-        UiLcdHy28_BulkPixel_BufferFlush();
     }
     else
 #endif
@@ -1421,74 +1736,50 @@ static void UiLcdHy28_BulkWriteColor(uint16_t Color, uint32_t len)
 }
 
 
-#ifdef USE_8bit_FONT
-static void UiLcdHy28_DrawChar_8bit(ushort x, ushort y, char symb,ushort Color, ushort bkColor,const sFONT *cf)
+/**
+ * @returns width of the area written for a single character, the advance to the next one may be smaller
+ */
+static inline uint16_t UiLcdHy28_CharCellWidth(const sFONT *cf)
 {
-    uint8_t cntrX, cntrY;
-    uint8_t FontDefaultSize,Font_W,Font_H;
-    uint8_t *FontData;
-
-    FontDefaultSize=cf->Width;
-    if(symb==0x20)
-    {
-        Font_W=cf->Width;
-        Font_H=cf->Height;
-    }
-    else
+#ifdef USE_8bit_FONT
+    if (cf->BitCount == 8)
     {
-        Font_W=cf->widthTable[symb-cf->firstCode];
-        Font_H=cf->heightTable[symb-cf->firstCode];
-        FontData=(uint8_t*)cf->table;
-        FontData+=cf->offsetTable[symb-cf->firstCode];
+        return cf->Width + 1; // one column of spacing after the glyph
     }
+#endif
+    return cf->Width;
+}
 
-    const uint16_t charSpacing = 1;
-
-    //gray shaded font type
-    uint32_t pixel;
-    uint8_t FontD;
-    uint16_t ColBG_R=(bkColor>>11)&0x1f;
-    int32_t ColBG_G=(bkColor>>5)&0x3f;
-    int32_t ColBG_B=bkColor&0x1f;
+#ifdef USE_8bit_FONT
+/**
+ * @brief renders the first cols pixels of row cntrY of a character into dst
+ */
+static void UiLcdHy28_CharRow_8bit(char symb, uint8_t cntrY, uint16_t cols, ushort Color, ushort bkColor, const sFONT *cf, uint16_t* dst)
+{
+    uint16_t cntrX = 0;
 
-    int32_t ColFG_R=((Color>>11)&0x1f) - ColBG_R; //decomposition of 16 bit color data into channels
-    int32_t ColFG_G=((Color>>5)&0x3f)  - ColBG_G;
-    int32_t ColFG_B=(Color&0x1f) - ColBG_B;
+    if(symb != 0x20)
+    {
+        const uint8_t Font_W = cf->widthTable[symb-cf->firstCode];
+        const uint8_t Font_H = cf->heightTable[symb-cf->firstCode];
 
-    int32_t ColFG_Ro,ColFG_Go,ColFG_Bo;
+        if (cntrY < Font_H)
+        {
+            const uint8_t* FontData = (const uint8_t*)cf->table + cf->offsetTable[symb-cf->firstCode] + cntrY * Font_W;
 
-    UiLcdHy28_BulkPixel_OpenWrite(x, FontDefaultSize+charSpacing, y, Font_H);
+            //gray shaded font type
+            const int32_t ColBG_R=(bkColor>>11)&0x1f;
+            const int32_t ColBG_G=(bkColor>>5)&0x3f;
+            const int32_t ColBG_B=bkColor&0x1f;
 
-    if(symb==0x20)
-    {
-        Font_W=4;
-        for(cntrY=0;cntrY<Font_H;cntrY++)
-        {
-            //Cidx=0;
-            for(cntrX=0;cntrX<(FontDefaultSize+charSpacing);cntrX++)
-            {
-                UiLcdHy28_BulkPixel_Put(bkColor);
-            }
+            const int32_t ColFG_R=((Color>>11)&0x1f) - ColBG_R; //decomposition of 16 bit color data into channels
+            const int32_t ColFG_G=((Color>>5)&0x3f)  - ColBG_G;
+            const int32_t ColFG_B=(Color&0x1f) - ColBG_B;
 
-        }
-        UiLcdHy28_BulkPixel_BufferFlush();
-        // flush all not yet  transferred pixel to display.
-        UiLcdHy28_CloseBulkWrite();
-    }
-    else
-    {
-        for(cntrY=0;cntrY<Font_H;cntrY++)
-        {
-            for(cntrX=0;cntrX<Font_W;cntrX++)
+            for(; cntrX < Font_W && cntrX < cols; cntrX++)
             {
-                if(cntrY<Font_H)
-                {
-                    FontD=*FontData++;      //get one point from bitmap
-                }
-                else
-                {
-                    FontD=0;
-                }
+                const uint8_t FontD=*FontData++;      //get one point from bitmap
+                uint16_t pixel;
 
                 if(FontD==0)
                 {
@@ -1497,82 +1788,186 @@ static void UiLcdHy28_DrawChar_8bit(ushort x, ushort y, char symb,ushort Color,
                 else
                 {
                     //shading the foreground colour
-                    ColFG_Ro=(ColFG_R*FontD)>>8;
-                    ColFG_Go=(ColFG_G*FontD)>>8;
-                    ColFG_Bo=(ColFG_B*FontD)>>8;
-                    ColFG_Ro+=ColBG_R;
-                    ColFG_Go+=ColBG_G;
-                    ColFG_Bo+=ColBG_B;
+                    const int32_t ColFG_Ro=((ColFG_R*FontD)>>8) + ColBG_R;
+                    const int32_t ColFG_Go=((ColFG_G*FontD)>>8) + ColBG_G;
+                    const int32_t ColFG_Bo=((ColFG_B*FontD)>>8) + ColBG_B;
 
                     pixel=(ColFG_Ro<<11)|(ColFG_Go<<5)|ColFG_Bo;    //assembly of destination colour
                 }
-                UiLcdHy28_BulkPixel_Put(pixel);
-
+                dst[cntrX] = pixel;
             }
-            if(Font_W<FontDefaultSize)
-            {
-                for(int n=0;n<(FontDefaultSize-Font_W);n++)
-                {
-                    UiLcdHy28_BulkPixel_Put(bkColor);
-                }
-
-            }
-
-            //adding the spacing after the printed font
-            for(cntrX=0;cntrX<charSpacing;cntrX++)
-            {
-                UiLcdHy28_BulkPixel_Put(bkColor);
-            }
-
-
-
         }
-        UiLcdHy28_BulkPixel_BufferFlush();
-        // flush all not yet  transferred pixel to display.
-        UiLcdHy28_CloseBulkWrite();
+    }
+
+    // the rest of the glyph box and the spacing after the printed font
+    for(; cntrX < cols; cntrX++)
+    {
+        dst[cntrX] = bkColor;
     }
 }
 #endif
 
-static void UiLcdHy28_DrawChar_1bit(ushort x, ushort y, char symb,ushort Color, ushort bkColor,const sFONT *cf)
+/**
+ * @brief renders the first cols pixels of row i of a character into dst
+ */
+static void UiLcdHy28_CharRow_1bit(char symb, uint8_t i, uint16_t cols, ushort Color, ushort bkColor, const sFONT *cf, uint16_t* dst)
 {
-    ulong       i,j;
     ushort      a,b,d;
     const uchar      fw = cf->Width;
 
     uint8_t   *ch = (uint8_t *)cf->table;
     if(cf->Width>8)
+    {
         ch+=(symb - 32) * cf->Height*2;
+        d=ch[i*2+1]<<8;
+        d|=ch[i*2];
+    }
     else
+    {
         ch+=(symb - 32) * cf->Height;
+        d=ch[i];
+    }
+
+    uint16_t j = 0;
+    for(; j < fw && j < cols; j++)
+    {
+        a = (d & ((0x80 << ((fw / 12 ) * 8)) >> j));
+        b = (d &  (0x01 << j));
+        //
+        dst[j] = ((!a && (fw <= 12)) || (!b && (fw > 12)))?bkColor:Color;
+    }
+    for(; j < cols; j++)
+    {
+        dst[j] = bkColor;
+    }
+}
 
+/*
+ * Glyph cache: characters are rendered once for a given font and colors into RGB565 pixels,
+ * drawing them again is just copying rows into the bulk pixel buffer.
+ * The cache is filled in order of use, if it runs full it is emptied and filled again.
+ * It is accessed by the CPU only, so it can live in the CCM RAM.
+ */
+#define UI_LCD_GLYPH_CACHE_NUM      64
+#define UI_LCD_GLYPH_CACHE_PIXELS   6144    // 16 characters of the large frequency font, 64 of the 8x12 fonts
+#define UI_LCD_GLYPH_RUN_MAX        32      // characters resolved at once per bulk write window
 
-    UiLcdHy28_OpenBulkWrite(x,cf->Width,y,cf->Height);
-    UiLcdHy28_BulkPixel_BufferInit();
-    for(i = 0; i < cf->Height; i++)
+typedef struct
+{
+    const sFONT* cf;
+    uint16_t clr_fg, clr_bg;
+    uint16_t offset;                        // first pixel in glyph_cache_pixels
+    char symb;
+} glyph_cache_entry_t;
+
+static glyph_cache_entry_t glyph_cache[UI_LCD_GLYPH_CACHE_NUM];
+static uint16_t __MCHF_SPECIALMEM glyph_cache_pixels[UI_LCD_GLYPH_CACHE_PIXELS];
+static uint16_t glyph_cache_num;
+static uint16_t glyph_cache_used;
+
+/**
+ * @param may_flush the cache may be emptied to make room, which invalidates all pointers returned before
+ * @returns the pixels of the character, cell width times font height, rendered if not yet in the cache,
+ * NULL if there is no room and may_flush is false
+ */
+static const uint16_t* UiLcdHy28_GlyphGet(char symb, ushort Color, ushort bkColor, const sFONT *cf, bool may_flush)
+{
+    const uint16_t* retval = NULL;
+
+    for (uint16_t idx = 0; retval == NULL && idx < glyph_cache_num; idx++)
     {
-        if(cf->Width>8)
+        const glyph_cache_entry_t* entry = &glyph_cache[idx];
+        if (entry->symb == symb && entry->cf == cf && entry->clr_fg == Color && entry->clr_bg == bkColor)
         {
-            d=ch[i*2+1]<<8;
-            d|=ch[i*2];
+            retval = &glyph_cache_pixels[entry->offset];
         }
-        else
+    }
+
+    const uint16_t cell_w = UiLcdHy28_CharCellWidth(cf);
+    const uint16_t size = cell_w * cf->Height;
+
+    if (retval == NULL && (glyph_cache_num == UI_LCD_GLYPH_CACHE_NUM || glyph_cache_used + size > UI_LCD_GLYPH_CACHE_PIXELS) && may_flush)
+    {
+        glyph_cache_num = 0;
+        glyph_cache_used = 0;
+    }
+
+    if (retval == NULL && glyph_cache_num < UI_LCD_GLYPH_CACHE_NUM && glyph_cache_used + size <= UI_LCD_GLYPH_CACHE_PIXELS)
+    {
+        glyph_cache_entry_t* entry = &glyph_cache[glyph_cache_num++];
+        entry->cf = cf;
+        entry->symb = symb;
+        entry->clr_fg = Color;
+        entry->clr_bg = bkColor;
+        entry->offset = glyph_cache_used;
+        glyph_cache_used += size;
+
+        uint16_t* dst = &glyph_cache_pixels[entry->offset];
+        for(uint8_t row = 0; row < cf->Height; row++, dst += cell_w)
         {
-            d=ch[i];
+#ifdef USE_8bit_FONT
+            if (cf->BitCount == 8)
+            {
+                UiLcdHy28_CharRow_8bit(symb, row, cell_w, Color, bkColor, cf, dst);
+            }
+            else
+#endif
+            {
+                UiLcdHy28_CharRow_1bit(symb, row, cell_w, Color, bkColor, cf, dst);
+            }
         }
+        retval = &glyph_cache_pixels[entry->offset];
+    }
+    return retval;
+}
 
-        // Draw line
-        for(j = 0; j < cf->Width; j++)
+/**
+ * @brief draws a run of characters on one line through a single bulk write window
+ * Instead of one window per character the window covers the whole run and is filled row by row
+ * from the glyph cache, which saves the window setup per character and gives long transfers for the SPI DMA.
+ * Each character but the last one gets pitch columns, so the result is the same as drawing the
+ * characters one by one at a distance of pitch, each one overwriting the spacing of its predecessor.
+ * @param clip_last the last character gets only pitch columns as well, used if the character following the run must not be touched
+ */
+static void UiLcdHy28_DrawCharRun(ushort x, ushort y, const char* str, uint16_t len, uint16_t pitch, bool clip_last, ushort Color, ushort bkColor, const sFONT *cf)
+{
+    const uint16_t cell_w = UiLcdHy28_CharCellWidth(cf);
+
+    // long runs are split, as are runs whose glyphs do not fit into the cache together
+    while (len > 0)
+    {
+        const uint16_t* glyphs[UI_LCD_GLYPH_RUN_MAX];
+        uint16_t count = 0;
+
+        for (; count < len && count < UI_LCD_GLYPH_RUN_MAX; count++)
         {
-            a = (d & ((0x80 << ((fw / 12 ) * 8)) >> j));
-            b = (d &  (0x01 << j));
-            //
-            UiLcdHy28_BulkPixel_Put(((!a && (fw <= 12)) || (!b && (fw > 12)))?bkColor:Color);
+            // only the first glyph of a window may empty the cache, the others must stay valid
+            glyphs[count] = UiLcdHy28_GlyphGet(str[count], Color, bkColor, cf, count == 0);
+            if (glyphs[count] == NULL)
+            {
+                break;
+            }
         }
+
+        const uint16_t last_w = (clip_last || count < len) ? pitch : cell_w;
+
+        UiLcdHy28_OpenBulkWrite(x, (count - 1) * pitch + last_w, y, cf->Height);
+        UiLcdHy28_BulkPixel_BufferInit();
+
+        for(uint8_t row = 0; row < cf->Height; row++)
+        {
+            for (uint16_t idx = 0; idx < count; idx++)
+            {
+                UiLcdHy28_BulkPixel_PutBuffer(glyphs[idx] + row * cell_w, idx == count - 1 ? last_w : pitch);
+            }
+        }
+        // flush all not yet  transferred pixel to display.
+        UiLcdHy28_BulkPixel_CloseWrite();
+
+        x += count * pitch;
+        str += count;
+        len -= count;
     }
-    UiLcdHy28_BulkPixel_BufferFlush();
-    // flush all not yet  transferred pixel to display.
-    UiLcdHy28_CloseBulkWrite();
 }
 //volatile int debtxt=0;
 
@@ -1580,20 +1975,8 @@ void UiLcdHy28_DrawChar(ushort x, ushort y, char symb,ushort Color, ushort bkCol
 {
 //	if((x==0) && (y==302))		//this is only for catching the faulty new line drawing event for decoded text line.
 //		debtxt++;
-#ifdef USE_8bit_FONT
-	switch(cf->BitCount)
-	{
-	case 1:		//1 bit font (basic type)
-#endif
-	    UiLcdHy28_DrawChar_1bit(x, y, symb, Color, bkColor, cf);
-#ifdef USE_8bit_FONT
-		break;
-	case 8:	//8 bit grayscaled font
-        UiLcdHy28_DrawChar_8bit(x, y, symb, Color, bkColor, cf);
-	    break;
-	}
-#endif
-
+    UiLcdHy28_RetainedInvalidate(x, y, UiLcdHy28_CharCellWidth(cf), cf->Height, 0);
+    UiLcdHy28_DrawCharRun(x, y, &symb, 1, UiLcdHy28_CharCellWidth(cf), false, Color, bkColor, cf);
 }
 
 const sFONT   *UiLcdHy28_Font(uint8_t font)
@@ -1612,8 +1995,15 @@ static void UiLcdHy28_PrintTextLen(uint16_t XposStart, uint16_t YposStart, const
     uint16_t XposCurrent = XposStart;
     uint16_t YposCurrent = YposStart;
 
-    if (str != NULL)
+    if (str != NULL && len > 0 && XposStart + (len - 1) * Xshift + UiLcdHy28_CharCellWidth(cf) <= MAX_X)
     {
+        // the usual case, no line wrap
+        UiLcdHy28_RetainedInvalidate(XposStart, YposStart, (len - 1) * Xshift + UiLcdHy28_CharCellWidth(cf), cf->Height, 0);
+        UiLcdHy28_DrawCharRun(XposStart, YposStart, str, len, Xshift, false, clr_fg, clr_bg, cf);
+    }
+    else if (str != NULL)
+    {
+        UiLcdHy28_RetainedInvalidate(0, YposStart, MAX_X, MAX_Y - YposStart, 0);
         for (uint16_t idx = 0; idx < len; idx++)
         {
             uint8_t TempChar = *str++;
@@ -1832,6 +2222,247 @@ uint16_t UiLcdHy28_PrintTextCentered(const uint16_t XposStart,const uint16_t Ypo
 
 
 
+/**
+ * @returns the retained item with the given key, a new (invalid) one if there is none yet, or NULL if all are in use
+ */
+static retained_item_t* UiLcdHy28_RetainedGet(retained_kind_t kind, uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint8_t font, uint16_t* index)
+{
+    retained_item_t* retval = NULL;
+
+    for (uint16_t idx = 0; retval == NULL && idx < retained_num; idx++)
+    {
+        retained_item_t* item = &retained_items[idx];
+        if (item->kind == kind && item->x == x && item->y == y && item->w == w && item->h == h && item->font == font)
+        {
+            retval = item;
+            *index = idx;
+        }
+    }
+
+    if (retval == NULL && retained_num < UI_LCD_RETAINED_NUM)
+    {
+        retval = &retained_items[retained_num];
+        *index = retained_num;
+        retained_num++;
+
+        retval->kind = kind;
+        retval->x = x;
+        retval->y = y;
+        retval->w = w;
+        retval->h = h;
+        retval->font = font;
+        retval->valid = false;
+    }
+
+    return retval;
+}
+
+/**
+ * @brief draws a single line of text and remembers it. If the same text item is drawn again with the same colors
+ * and length, only the changed characters are sent to the display, in as few runs as possible.
+ * @param bbW box width for centered text
+ * @param pitch horizontal distance of the characters, 0 for the font default
+ * @returns next unused Y line, as UiLcdHy28_PrintText
+ */
+static uint16_t UiLcdHy28_PrintTextRetainedKind(retained_kind_t kind, uint16_t x, uint16_t y, uint16_t bbW, uint16_t pitch,
+        const char* str, uint32_t clr_fg, uint32_t clr_bg, uint8_t font)
+{
+    const sFONT   *cf = UiLcdHy28_Font(font);
+    const uint16_t len = str != NULL ? strlen(str) : 0;
+
+    if (pitch == 0)
+    {
+        pitch = cf->Width - ((cf->Width == 8 && cf->Height == 8)?1:0);
+    }
+
+    uint16_t idx = 0;
+    retained_item_t* item = NULL;
+    if (len <= UI_LCD_RETAINED_TEXT_LEN && (str == NULL || strchr(str, '\n') == NULL))
+    {
+        item = UiLcdHy28_RetainedGet(kind, x, y, bbW, pitch, font, &idx);
+    }
+
+    if (item == NULL)
+    {
+        // nothing to remember, draw it directly
+        switch(kind)
+        {
+        case RETAINED_TEXT_RIGHT:
+            return UiLcdHy28_PrintTextRight(x, y, str, clr_fg, clr_bg, font);
+        case RETAINED_TEXT_CENTERED:
+            return UiLcdHy28_PrintTextCentered(x, y, bbW, str, clr_fg, clr_bg, font);
+        default:
+            return UiLcdHy28_PrintText(x, y, str, clr_fg, clr_bg, font);
+        }
+    }
+
+    const uint16_t txtW = len * pitch;
+    const uint16_t drawW = len > 0 ? (len - 1) * pitch + UiLcdHy28_CharCellWidth(cf) : 0;
+    uint16_t txtX, dx, dw;
+
+    switch(kind)
+    {
+    case RETAINED_TEXT_RIGHT:
+        txtX = x < txtW ? 0 : x - txtW;
+        dx = txtX;
+        dw = drawW;
+        break;
+    case RETAINED_TEXT_CENTERED:
+        txtX = x + (txtW > bbW ? 0 : ((bbW - txtW) + 1) / 2);
+        dx = x;
+        dw = txtX - x + txtW > bbW ? txtX - x + drawW : bbW;
+        break;
+    default:
+        txtX = x;
+        dx = x;
+        dw = drawW;
+        break;
+    }
+
+    if (item->valid && item->len == len && item->clr_fg == (uint16_t)clr_fg && item->clr_bg == (uint16_t)clr_bg)
+    {
+        // same place, same colors: only the characters which differ
+        for (uint16_t start = 0; start < len; start++)
+        {
+            if (item->text[start] != str[start])
+            {
+                uint16_t end = start + 1;
+                for (uint16_t next = end; next < len && next <= end + UI_LCD_RETAINED_RUN_GAP; next++)
+                {
+                    if (item->text[next] != str[next])
+                    {
+                        end = next + 1;
+                    }
+                }
+
+                UiLcdHy28_DrawCharRun(txtX + start * pitch, y, &str[start], end - start, pitch, end < len, clr_fg, clr_bg, cf);
+                UiLcdHy28_RetainedInvalidate(txtX + start * pitch, y, end < len ? (end - start) * pitch : drawW - start * pitch, cf->Height, idx + 1);
+                start = end;
+            }
+        }
+    }
+    else
+    {
+        if (item->valid && item->clr_bg == (uint16_t)clr_bg)
+        {
+            // remove what is left of the previous text
+            if (item->dx < dx)
+            {
+                UiLcdHy28_FillRect(item->dx, y, cf->Height, dx - item->dx, clr_bg);
+            }
+            if (item->dx + item->dw > dx + dw)
+            {
+                UiLcdHy28_FillRect(dx + dw, y, cf->Height, item->dx + item->dw - (dx + dw), clr_bg);
+            }
+        }
+
+        if (kind == RETAINED_TEXT_CENTERED && txtX > x)
+        {
+            UiLcdHy28_FillRect(x, y, cf->Height, txtX - x, clr_bg);
+        }
+
+        UiLcdHy28_DrawCharRun(txtX, y, str, len, pitch, false, clr_fg, clr_bg, cf);
+
+        if (kind == RETAINED_TEXT_CENTERED && txtW < bbW)
+        {
+            UiLcdHy28_FillRect(txtX + txtW, y, cf->Height, x + bbW - (txtX + txtW), clr_bg);
+        }
+
+        UiLcdHy28_RetainedInvalidate(dx, y, dw, cf->Height, idx + 1);
+        item->dx = dx;
+        item->dw = dw;
+        item->len = len;
+        item->clr_fg = clr_fg;
+        item->clr_bg = clr_bg;
+        item->valid = true;
+    }
+
+    memcpy(item->text, str, len);
+
+    return y + cf->Height;
+}
+
+/**
+ * @brief as UiLcdHy28_PrintText for a single line, but only changes are drawn, see UiLcdHy28_PrintTextRetainedKind
+ */
+uint16_t UiLcdHy28_PrintTextRetained(uint16_t Xpos, uint16_t Ypos, const char *str, const uint32_t clr_fg, const uint32_t clr_bg, uchar font)
+{
+    return UiLcdHy28_PrintTextRetainedKind(RETAINED_TEXT_LEFT, Xpos, Ypos, 0, 0, str, clr_fg, clr_bg, font);
+}
+
+/**
+ * @brief as UiLcdHy28_PrintTextRetained, with characters pitch pixels apart instead of the font default
+ */
+uint16_t UiLcdHy28_PrintTextRetainedPitch(uint16_t Xpos, uint16_t Ypos, uint16_t pitch, const char *str, const uint32_t clr_fg, const uint32_t clr_bg, uchar font)
+{
+    return UiLcdHy28_PrintTextRetainedKind(RETAINED_TEXT_LEFT, Xpos, Ypos, 0, pitch, str, clr_fg, clr_bg, font);
+}
+
+uint16_t UiLcdHy28_PrintTextRightRetained(uint16_t Xpos, uint16_t Ypos, const char *str, const uint32_t clr_fg, const uint32_t clr_bg, uchar font)
+{
+    return UiLcdHy28_PrintTextRetainedKind(RETAINED_TEXT_RIGHT, Xpos, Ypos, 0, 0, str, clr_fg, clr_bg, font);
+}
+
+uint16_t UiLcdHy28_PrintTextCenteredRetained(const uint16_t bbX, const uint16_t bbY, const uint16_t bbW, const char* str, uint32_t clr_fg, uint32_t clr_bg, uint8_t font)
+{
+    return UiLcdHy28_PrintTextRetainedKind(RETAINED_TEXT_CENTERED, bbX, bbY, bbW, 0, str, clr_fg, clr_bg, font);
+}
+
+/**
+ * @brief as UiLcdHy28_DrawFullRect, but nothing is drawn if the screen already shows this rectangle
+ */
+void UiLcdHy28_DrawFullRectRetained(ushort Xpos, ushort Ypos, ushort Height, ushort Width, ushort color)
+{
+    uint16_t idx = 0;
+    retained_item_t* item = UiLcdHy28_RetainedGet(RETAINED_FILL, Xpos, Ypos, Width, Height, 0, &idx);
+
+    if (item == NULL || item->valid == false || item->clr_fg != color)
+    {
+        UiLcdHy28_FillRect(Xpos, Ypos, Height, Width, color);
+        if (item != NULL)
+        {
+            UiLcdHy28_RetainedInvalidate(Xpos, Ypos, Width, Height, idx + 1);
+            item->clr_fg = color;
+            item->valid = true;
+        }
+        else
+        {
+            UiLcdHy28_RetainedInvalidate(Xpos, Ypos, Width, Height, 0);
+        }
+    }
+}
+
+/**
+ * @brief as UiLcdHy28_DrawEmptyRect, but nothing is drawn if the screen already shows this frame
+ */
+void UiLcdHy28_DrawEmptyRectRetained(ushort Xpos, ushort Ypos, ushort Height, ushort Width, ushort color)
+{
+    uint16_t idx = 0;
+    retained_item_t* item = UiLcdHy28_RetainedGet(RETAINED_FRAME, Xpos, Ypos, Width, Height, 0, &idx);
+
+    if (item == NULL)
+    {
+        UiLcdHy28_DrawEmptyRect(Xpos, Ypos, Height, Width, color);
+    }
+    else if (item->valid == false || item->clr_fg != color)
+    {
+        // the lines of UiLcdHy28_DrawEmptyRect, only items on them are affected
+        UiLcdHy28_FillRect(Xpos, Ypos, 1, Width, color);
+        UiLcdHy28_FillRect(Xpos, Ypos, Height, 1, color);
+        UiLcdHy28_FillRect(Xpos + Width, Ypos, Height + 1, 1, color);
+        UiLcdHy28_FillRect(Xpos, Ypos + Height, 1, Width, color);
+
+        UiLcdHy28_RetainedInvalidate(Xpos, Ypos, Width, 1, idx + 1);
+        UiLcdHy28_RetainedInvalidate(Xpos, Ypos, 1, Height, idx + 1);
+        UiLcdHy28_RetainedInvalidate(Xpos + Width, Ypos, 1, Height + 1, idx + 1);
+        UiLcdHy28_RetainedInvalidate(Xpos, Ypos + Height, Width, 1, idx + 1);
+
+        item->clr_fg = color;
+        item->valid = true;
+    }
+}
+
+
 /*********************************************************************
  *
  * Controller Specific Functions Go Here (
@@ -2102,9 +2733,9 @@ static uint16_t UiLcdHy28_DetectController(const uhsdr_display_info_t* disp_info
         case DISPLAY_ILI9486_PARALLEL:
             retval = UiLcdHy28_ReadReg(0xd3);
 
-            retval = LCD_RAM;    //first dummy read
-            retval = (LCD_RAM&0xff)<<8;
-            retval |=LCD_RAM&0xff;
+            retval = UiLcdHy28_BusReadRam();    //first dummy read
+            retval = (UiLcdHy28_BusReadRam()&0xff)<<8;
+            retval |=UiLcdHy28_BusReadRam()&0xff;
             break;
         case DISPLAY_RPI_SPI:
             retval = 0x9486; // we cannot read from the RPI "SPI" display
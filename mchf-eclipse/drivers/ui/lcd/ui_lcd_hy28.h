@@ -129,6 +129,14 @@ uint16_t UiLcdHy28_PrintText(uint16_t Xpos, uint16_t Ypos, const char *str,const
 uint16_t UiLcdHy28_PrintTextRight(uint16_t Xpos, uint16_t Ypos, const char *str,const uint32_t Color, const uint32_t bkColor, uchar font);
 uint16_t UiLcdHy28_PrintTextCentered(const uint16_t bbX,const uint16_t bbY,const uint16_t bbW,const char* txt,uint32_t clr_fg,uint32_t clr_bg,uint8_t font);
 
+uint16_t UiLcdHy28_PrintTextRetained(uint16_t Xpos, uint16_t Ypos, const char *str, const uint32_t clr_fg, const uint32_t clr_bg, uchar font);
+uint16_t UiLcdHy28_PrintTextRetainedPitch(uint16_t Xpos, uint16_t Ypos, uint16_t pitch, const char *str, const uint32_t clr_fg, const uint32_t clr_bg, uchar font);
+uint16_t UiLcdHy28_PrintTextRightRetained(uint16_t Xpos, uint16_t Ypos, const char *str, const uint32_t clr_fg, const uint32_t clr_bg, uchar font);
+uint16_t UiLcdHy28_PrintTextCenteredRetained(const uint16_t bbX, const uint16_t bbY, const uint16_t bbW, const char* str, uint32_t clr_fg, uint32_t clr_bg, uint8_t font);
+void    UiLcdHy28_DrawFullRectRetained(ushort Xpos, ushort Ypos, ushort Height, ushort Width, ushort color);
+void    UiLcdHy28_DrawEmptyRectRetained(ushort Xpos, ushort Ypos, ushort Height, ushort Width, ushort color);
+void    UiLcdHy28_RetainedReset();
+
 uint16_t UiLcdHy28_TextWidth(const char *str, uchar font);
 uint16_t UiLcdHy28_TextHeight(uint8_t font);
 
@@ -146,9 +154,12 @@ void 	UiLcdHy28_DrawColorPoint(ushort x, ushort y, ushort color);
 void    UiLcdHy28_BulkPixel_OpenWrite(ushort x, ushort width, ushort y, ushort height);
 void    UiLcdHy28_BulkPixel_CloseWrite();
 void 	UiLcdHy28_BulkPixel_Put(uint16_t pixel);
-void    UiLcdHy28_BulkPixel_PutBuffer(uint16_t* pixel_buffer, uint32_t len);
+void    UiLcdHy28_BulkPixel_PutBuffer(const uint16_t* pixel_buffer, uint32_t len);
 void    UiLcdHy28_BulkPixel_BufferFlush();
 
+bool    UiLcdHy28_ScrollWindowInit(ushort x, ushort width, ushort y, ushort height);
+void    UiLcdHy28_ScrollWindowOffset(ushort y);
+
 uint8_t 	UiLcdHy28_Init();
 
 void    UiLcdHy28_BacklightEnable(bool on);
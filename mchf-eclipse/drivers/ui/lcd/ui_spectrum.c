@@ -242,6 +242,7 @@ static void UiSpectrum_UpdateSpectrumPixelParameters()
     {
         old_magnify = sd.magnify;
         sd.hz_per_pixel = IQ_SAMPLE_RATE_F/((1 << sd.magnify) * slayout.scope.w);     // magnify mode is on
+        sd.avg_count = 0;       // the averaged bins belong to the old span, start a new set
         force_update = true;
     }
 
@@ -291,7 +292,7 @@ static void UiSpectrum_UpdateSpectrumPixelParameters()
                 break;
 #endif
             case DigitalMode_RTTY:
-                mode_marker[0] = 915; // Mark Frequency
+                mode_marker[0] = RTTY_MARK_FREQ;
                 mode_marker[1] = mode_marker[0] + rtty_shifts[rtty_ctrl_config.shift_idx].value;
                 sd.marker_num = 2;
                 break;
@@ -305,7 +306,7 @@ static void UiSpectrum_UpdateSpectrumPixelParameters()
                 sd.marker_num = 1;
             }
 
-            for (uint16_t idx; idx < sd.marker_num; idx++)
+            for (uint16_t idx = 0; idx < sd.marker_num; idx++)
             {
                 mode_marker_offset[idx] = (ts.digi_lsb?-1.0:1.0)*(mode_marker[idx] / sd.hz_per_pixel);
             }
@@ -316,7 +317,7 @@ static void UiSpectrum_UpdateSpectrumPixelParameters()
             sd.marker_num = 1;
         }
 
-        for (uint16_t idx; idx < sd.marker_num; idx++)
+        for (uint16_t idx = 0; idx < sd.marker_num; idx++)
         {
             sd.marker_offset[idx] = tx_vfo_offset + mode_marker_offset[idx];
             sd.marker_pos[idx] = sd.rx_carrier_pos + sd.marker_offset[idx];
@@ -351,74 +352,123 @@ static void UiSpectrum_UpdateSpectrumPixelParameters()
 			0.187912223,0.185518832,0.183137304,0.180767729,0.178410196,0.176064795,0.173731614,0.17141074,0.169102262,0.166806267,0.16452284,0.162252069,0.159994038,0.157748834,0.15551654,0.153297242,0.151091022,0.148897964,0.146718151,0.144551664,0.142398586,0.140258998,0.138132981,0.136020614,0.133921978,0.131837151,0.129766213,0.127709241,0.125666312,0.123637505,0.121622896,0.11962256,0.117636572,0.115665009,0.113707945,0.111765452,0.109837605,0.107924475,0.106026136,0.104142659,0.102274115,0.100420575,0.098582108,0.096758783,0.09495067,0.093157837,0.091380351,0.089618279,0.087871689,0.086140645,0.084425213,0.082725458,0.081041443,0.079373234,0.077720891,0.076084478,0.074464057,0.072859688,0.071271432,0.069699349,0.068143498,0.066603939,0.065080728,0.063573924,0.062083583,0.060609762,0.059152516,0.0577119,0.056287968,0.054880775,0.053490372,0.052116814,0.050760151,0.049420435,0.048097716,0.046792044,0.045503469,0.044232039,0.042977801,0.041740804,0.040521094,0.039318717,0.038133718,0.036966142,0.035816033,0.034683435,0.03356839,0.03247094,0.031391127,0.030328991,0.029284572,0.028257911,0.027249045,0.026258012,0.025284851,0.024329597,0.023392287,0.022472956,0.021571639,0.020688369,0.019823181,0.018976107,0.018147178,0.017336426,0.016543882,0.015769575,0.015013535,0.01427579,0.013556368,0.012855296,0.012172601,0.011508308,0.010862443,0.010235029,0.009626091,0.009035651,0.008463732,0.007910355,0.007375542,0.006859311,0.006361684,0.005882678,0.005422311,0.004980602,0.004557566,0.00415322,0.003767578,0.003400657,0.003052468,0.002723026,0.002412342,0.002120429,0.001847298,0.001592958,0.00135742,0.001140693,0.000942783,0.0007637,0.00060345,0.000462038,0.00033947,0.000235751,0.000150885,8.48748E-05,3.77227E-05,9.43077E-06,0};
 #endif
 
+#ifndef USE_PREDEFINED_WINDOW_DATA
+// first half of the Hann window for the current FFT length, calculated once and not for each frame
+static float32_t spectrum_hann_window[FFT_IQ_BUFF_LEN/2];
+static uint16_t spectrum_hann_window_len;
+#endif
+
+/**
+ * @brief Hann window coefficients for sd.fft_iq_len, only the first half is used, the window is symmetric
+ */
+static const float32_t* UiSpectrum_HannWindow()
+{
+#ifdef USE_PREDEFINED_WINDOW_DATA
+    return sd.fft_iq_len==512?von_Hann_512:von_Hann_1024;
+#else
+    if (spectrum_hann_window_len != sd.fft_iq_len)
+    {
+        for(int i = 0; i < sd.fft_iq_len/2; i++)
+        {
+            spectrum_hann_window[i] = 0.5 * (1 - arm_cos_f32(PI*2 * (float32_t)i / (float32_t)(sd.fft_iq_len-1)));
+        }
+        spectrum_hann_window_len = sd.fft_iq_len;
+    }
+    return spectrum_hann_window;
+#endif
+}
+
+// log10 of the mantissa, indexed by its upper SPECTRUM_LOG10_LUT_BITS bits, see UiSpectrum_Log10
+#define SPECTRUM_LOG10_LUT_BITS 7
+static float32_t spectrum_log10_lut[1 << SPECTRUM_LOG10_LUT_BITS];
+
+static void UiSpectrum_Log10Init()
+{
+    for (int idx = 0; idx < (1 << SPECTRUM_LOG10_LUT_BITS); idx++)
+    {
+        // value in the middle of the mantissa interval, the error is below 0.02dB
+        spectrum_log10_lut[idx] = log10f(1.0 + (idx + 0.5) / (1 << SPECTRUM_LOG10_LUT_BITS));
+    }
+}
+
+/**
+ * @brief log10 by table lookup of the mantissa, for the power values of the spectrum
+ * @param value positive, normalized float, the spectrum clips its data to >= 1
+ */
+static inline float32_t UiSpectrum_Log10(const float32_t value)
+{
+    union
+    {
+        float32_t f;
+        uint32_t u;
+    } bits = { .f = value };
+
+    const int32_t exponent = (int32_t)((bits.u >> 23) & 0xff) - 127;
+    return exponent * 0.3010299956639812f + spectrum_log10_lut[(bits.u >> (23 - SPECTRUM_LOG10_LUT_BITS)) & ((1 << SPECTRUM_LOG10_LUT_BITS) - 1)];
+}
+
 static void UiSpectrum_FFTWindowFunction(char mode)
 {
 
 	const uint16_t  fft_iq_m1_half = (sd.fft_iq_len-1)/2;
+    const float32_t gcalc = 1.0/ads.codec_gain_calc;                // Get gain setting of codec and convert to multiplier factor, applied together with the window
 
     switch(mode)
     {
-    case FFT_WINDOW_RECTANGULAR:	// No processing at all
+    case FFT_WINDOW_RECTANGULAR:	// No window, just the gain
+        arm_scale_f32(sd.FFT_Samples,gcalc, sd.FFT_Samples, sd.fft_iq_len);
         break;
     case FFT_WINDOW_COSINE:			// Sine window function (a.k.a. "Cosine Window").  Kind of wide...
         for(int i = 0; i < sd.fft_iq_len; i++)
         {
-            sd.FFT_Samples[i] = arm_sin_f32((PI * (float32_t)i)/sd.fft_iq_len - 1) * sd.FFT_Samples[i];
+            sd.FFT_Samples[i] = arm_sin_f32((PI * (float32_t)i)/sd.fft_iq_len - 1) * gcalc * sd.FFT_Samples[i];
         }
         break;
     case FFT_WINDOW_BARTLETT:		// a.k.a. "Triangular" window - Bartlett (or Fej?r) window is special case where demonimator is "N-1". Somewhat better-behaved than Rectangular
         for(int i = 0; i < sd.fft_iq_len; i++)
         {
-            sd.FFT_Samples[i] = (1 - fabs(i - ((float32_t)fft_iq_m1_half))/(float32_t)fft_iq_m1_half) * sd.FFT_Samples[i];
+            sd.FFT_Samples[i] = (1 - fabs(i - ((float32_t)fft_iq_m1_half))/(float32_t)fft_iq_m1_half) * gcalc * sd.FFT_Samples[i];
         }
         break;
     case FFT_WINDOW_WELCH:			// Parabolic window function, fairly wide, comparable to Bartlett
         for(int i = 0; i < sd.fft_iq_len; i++)
         {
-            sd.FFT_Samples[i] = (1 - ((i - ((float32_t)fft_iq_m1_half))/(float32_t)fft_iq_m1_half)*((i - ((float32_t)fft_iq_m1_half))/(float32_t)fft_iq_m1_half)) * sd.FFT_Samples[i];
+            sd.FFT_Samples[i] = (1 - ((i - ((float32_t)fft_iq_m1_half))/(float32_t)fft_iq_m1_half)*((i - ((float32_t)fft_iq_m1_half))/(float32_t)fft_iq_m1_half)) * gcalc * sd.FFT_Samples[i];
         }
         break;
 
     case FFT_WINDOW_HANN:			// Raised Cosine Window (non zero-phase version) - This has the best sidelobe rejection of what is here, but not as narrow as Hamming.
-#ifndef USE_PREDEFINED_WINDOW_DATA
-    	for(int i = 0; i < sd.fft_iq_len; i++)
-    	{
-    		sd.FFT_Samples[i] = 0.5 * (float32_t)((1 - (arm_cos_f32(PI*2 * (float32_t)i / (float32_t)(sd.fft_iq_len-1)))) * sd.FFT_Samples[i]);
-    	}
-#else
-    	{
-    		const float32_t* WindowCoefficients= sd.fft_iq_len==512?von_Hann_512:von_Hann_1024;
-    		for(int i = 0; i < sd.fft_iq_len; i++)
-    		{
-    			sd.FFT_Samples[i] *= WindowCoefficients[i];
-    		}
-    	}
-#endif
+    {
+        // the window is symmetric, so each coefficient is fetched once for both halves
+        const float32_t* WindowCoefficients = UiSpectrum_HannWindow();
+        for(int i = 0; i < sd.fft_iq_len/2; i++)
+        {
+            const float32_t w = WindowCoefficients[i] * gcalc;
+            sd.FFT_Samples[i] *= w;
+            sd.FFT_Samples[sd.fft_iq_len - 1 - i] *= w;
+        }
         break;
+    }
 
     case FFT_WINDOW_HAMMING:		// Another Raised Cosine window - This is the narrowest with reasonably good sidelobe rejection.
         for(int i = 0; i < sd.fft_iq_len; i++)
         {
-            sd.FFT_Samples[i] = (0.53836 - (0.46164 * arm_cos_f32(PI*2 * (float32_t)i / (float32_t)(sd.fft_iq_len-1)))) * sd.FFT_Samples[i];
+            sd.FFT_Samples[i] = (0.53836 - (0.46164 * arm_cos_f32(PI*2 * (float32_t)i / (float32_t)(sd.fft_iq_len-1)))) * gcalc * sd.FFT_Samples[i];
         }
         break;
     case FFT_WINDOW_BLACKMAN:		// Approx. same "narrowness" as Hamming but not as good sidelobe rejection - probably best for "default" use.
         for(int i = 0; i < sd.fft_iq_len; i++)
         {
-            sd.FFT_Samples[i] = (0.42659 - (0.49656*arm_cos_f32((2*PI*(float32_t)i)/(float32_t)sd.fft_iq_len-1)) + (0.076849*arm_cos_f32((4*PI*(float32_t)i)/(float32_t)sd.fft_iq_len-1))) * sd.FFT_Samples[i];
+            sd.FFT_Samples[i] = (0.42659 - (0.49656*arm_cos_f32((2*PI*(float32_t)i)/(float32_t)sd.fft_iq_len-1)) + (0.076849*arm_cos_f32((4*PI*(float32_t)i)/(float32_t)sd.fft_iq_len-1))) * gcalc * sd.FFT_Samples[i];
         }
         break;
     case FFT_WINDOW_NUTTALL:		// Slightly wider than Blackman, comparable sidelobe rejection.
         for(int i = 0; i < sd.fft_iq_len; i++)
         {
-            sd.FFT_Samples[i] = (0.355768 - (0.487396*arm_cos_f32((2*PI*(float32_t)i)/(float32_t)sd.fft_iq_len-1)) + (0.144232*arm_cos_f32((4*PI*(float32_t)i)/(float32_t)sd.fft_iq_len-1)) - (0.012604*arm_cos_f32((6*PI*(float32_t)i)/(float32_t)sd.fft_iq_len-1))) * sd.FFT_Samples[i];
+            sd.FFT_Samples[i] = (0.355768 - (0.487396*arm_cos_f32((2*PI*(float32_t)i)/(float32_t)sd.fft_iq_len-1)) + (0.144232*arm_cos_f32((4*PI*(float32_t)i)/(float32_t)sd.fft_iq_len-1)) - (0.012604*arm_cos_f32((6*PI*(float32_t)i)/(float32_t)sd.fft_iq_len-1))) * gcalc * sd.FFT_Samples[i];
         }
         break;
     }
-
-    float32_t gcalc = 1.0/ads.codec_gain_calc;                // Get gain setting of codec and convert to multiplier factor
-    arm_scale_f32(sd.FFT_Samples,gcalc, sd.FFT_Samples, sd.fft_iq_len);
-
 }
 
 static void UiSpectrum_SpectrumTopBar_GetText(char* wfbartext)
@@ -650,7 +700,14 @@ static void UiSpectrum_CreateDrawArea()
 
 void UiSpectrum_Clear()
 {
+    if (sd.wfall_hw_scroll && sd.wfall_scroll_offset != 0)
+    {
+        // whatever is drawn next into the area (e.g. the menu) uses unscrolled coordinates
+        sd.wfall_scroll_offset = 0;
+        UiLcdHy28_ScrollWindowOffset(0);
+    }
     UiLcdHy28_DrawFullRect(slayout.full.x, slayout.full.y, slayout.full.h, slayout.full.w, Black);	// Clear screen under spectrum scope by drawing a single, black block (faster with SPI!)
+    sd.wfall_scroll_valid = false;
 }
 
 // This version of "Draw Scope" is revised from the original in that it interleaves the erasure with the drawing
@@ -939,6 +996,13 @@ static void UiSpectrum_InitSpectrumDisplayData()
     // Init publics
     sd.state 		= 0;
     sd.samp_ptr 	= 0;
+    sd.frames_filled = 0;
+    sd.frames_consumed = 0;
+    sd.frame_held   = false;
+    sd.FFT_Samples  = sd.FFT_Frame[0];
+    sd.slice_pos    = 0;
+    sd.avg_count    = 0;
+    sd.noise_floor_valid = false;
     sd.enabled		= 0;
     ts.dial_moved	= 0;
     sd.RedrawType   = 0;
@@ -958,6 +1022,15 @@ static void UiSpectrum_InitSpectrumDisplayData()
     	break;
     }
 
+#ifdef STM32F4
+    // the F4 does the averaging and scaling of the 512 bins in two slices, as the main loop gets little time with NR active
+    sd.slice_len = sd.spec_len > 256 ? sd.spec_len/2 : sd.spec_len;
+#else
+    sd.slice_len = sd.spec_len;
+#endif
+
+    UiSpectrum_Log10Init();
+
 
     sd.agc_rate = ((float32_t)ts.spectrum_agc_rate) / SPECTRUM_AGC_SCALING;	// calculate agc rate
     //
@@ -1049,7 +1122,13 @@ static void UiSpectrum_InitSpectrumDisplayData()
         sd.repeatWaterfallLine = 0;
     }*/
 
-    sd.repeatWaterfallLine = slayout.wfall.h/(sd.wfall_size);		//-1 for prewention of doubling lines for equal size
+    // no waterfall in scope only mode, the Cortex-M returns 0 for a division by 0 but other CPUs trap
+    sd.repeatWaterfallLine = sd.wfall_size != 0 ? slayout.wfall.h/(sd.wfall_size) : 0;		//-1 for prewention of doubling lines for equal size
+
+    // if the display can scroll the waterfall area, only the new lines are drawn
+    sd.wfall_hw_scroll = UiLcdHy28_ScrollWindowInit(slayout.wfall.x, slayout.wfall.w, slayout.wfall.y, slayout.wfall.h);
+    sd.wfall_scroll_offset = 0;
+    sd.wfall_scroll_valid = false;
 
     //no need for this variable because we have slayout.wfall.h
     //sd.wfall_disp_lines = sd.wfall_size * (sd.doubleWaterfallLine==true? 2:1);
@@ -1075,181 +1154,246 @@ void UiSpectrum_WaterfallClearData()
     // this assume sd.watefall being an array, not a pointer to one!
     memset(sd.waterfall,0, sizeof(sd.waterfall));
     memset(sd.waterfall_frequencies,0,sizeof(sd.waterfall_frequencies));
+    sd.wfall_scroll_valid = false;
 }
 
 
-static void UiSpectrum_DrawWaterfall()
+/**
+ * @brief converts the stored waterfall line lptr into RGB565 pixels, shifted to the center frequency cur_center_hz
+ * @param pixel_buf slayout.wfall.w pixels
+ */
+static void UiSpectrum_WaterfallLinePixels(uint16_t* pixel_buf, uint16_t lptr, int32_t cur_center_hz, const uint16_t* marker_line_pixel_pos)
 {
-    sd.wfall_line %= sd.wfall_size; // make sure that the circular buffer is clipped to the size of the display area
+    uint8_t  * const waterfallline_ptr = &sd.waterfall[lptr*slayout.wfall.w];
 
-    // Contrast:  100 = 1.00 multiply factor:  125 = multiply by 1.25 - "sd.wfall_contrast" already converted to 100=1.00
-    arm_scale_f32(sd.FFT_Samples, sd.wfall_contrast, sd.FFT_Samples, sd.spec_len);
 
+    const int32_t line_center_hz = sd.waterfall_frequencies[lptr];
 
-    UiSpectrum_UpdateSpectrumPixelParameters(); // before accessing pixel parameters, request update according to configuration
+    // if our old_center is lower than cur_center_hz -> find start idx in waterfall_line, end_idx is line end, and pad with black pixels;
+    // if our old_center is higher than cur_center_hz -> find start pixel x in end_idx is line end, first pad with black pixels until this point and then use pixel buffer;
+    // if identical -> well, no padding.
+    const int32_t diff_centers = (line_center_hz - cur_center_hz);
+    int32_t offset_pixel = diff_centers/sd.hz_per_pixel;
+    uint16_t pixel_start, pixel_count, left_padding_count, right_padding_count;
 
 
-    uint16_t marker_line_pixel_pos[SPECTRUM_MAX_MARKER];
-    for (uint16_t idx = 0; idx < sd.marker_num; idx++)
+    // here we actually create a single line pixel by pixel.
+
+    if (offset_pixel >= slayout.wfall.w || offset_pixel <= -slayout.wfall.w)
     {
-        marker_line_pixel_pos[idx] = sd.marker_pos[idx];
+        offset_pixel = slayout.wfall.w-1;
+    }
+    if (offset_pixel <= 0)
+    {
+        // we have to start -offset_pixel later and then pad with black
+        left_padding_count = 0;
+        pixel_start = -offset_pixel;
+        right_padding_count = -offset_pixel;
+        pixel_count = slayout.wfall.w + offset_pixel;
+    }
+    else
+    {
+        // we to start with offset_pixel black padding  and then draw the pixels until we reach spectrum width
+        left_padding_count = offset_pixel;
+        pixel_start = 0;
+        right_padding_count = 0;
+        pixel_count = slayout.wfall.w - offset_pixel;
     }
 
-    // After the above manipulation, clip the result to make sure that it is within the range of the palette table
-    //for(uint16_t i = 0; i < sd.spec_len; i++)
-    uint8_t  * const waterfallline_ptr = &sd.waterfall[sd.wfall_line*slayout.wfall.w];
 
-    for(uint16_t i = 0; i < slayout.wfall.w; i++)
+    uint16_t* pixel_buf_ptr = &pixel_buf[0];
+
+    // fill from the left border with black pixels
+    for(uint16_t i = 0; i < left_padding_count; i++)
+    {
+        *pixel_buf_ptr++ = Black;
+    }
+
+    for(uint16_t idx = pixel_start, i = 0; i < pixel_count; i++,idx++)
+    {
+        *pixel_buf_ptr++ = sd.waterfall_colours[waterfallline_ptr[idx]];    // write to memory using waterfall color from palette
+    }
+
+    // fill to the right border with black pixels
+    for(uint16_t i = 0; i < right_padding_count; i++)
     {
-        if(sd.FFT_Samples[i] >= NUMBER_WATERFALL_COLOURS)   // is there an illegal color value?
+        *pixel_buf_ptr++ = Black;
+    }
+
+    for (uint16_t idx = 0; idx < sd.marker_num; idx ++)
+    {
+        // Place center line marker on screen:  Location [64] (the 65th) of the palette is reserved is a special color reserved for this
+        if (marker_line_pixel_pos[idx] < slayout.wfall.w)
         {
-            sd.FFT_Samples[i] = NUMBER_WATERFALL_COLOURS - 1;   // yes - clip it
+            pixel_buf[marker_line_pixel_pos[idx]] = sd.waterfall_colours[NUMBER_WATERFALL_COLOURS];
         }
-
-        waterfallline_ptr[i] = sd.FFT_Samples[i]; // save the manipulated value in the circular waterfall buffer
     }
+}
 
-    sd.waterfall_frequencies[sd.wfall_line] = sd.FFT_frequency;
+/**
+ * @brief tells if the new lines can be added by hardware scrolling
+ * this is the case if the lines on screen and the new ones share the current center frequency
+ * and the markers have not moved, otherwise all lines have to be drawn again
+ */
+static bool UiSpectrum_WaterfallCanScroll(uint16_t new_lines, const uint16_t* marker_line_pixel_pos)
+{
+    bool retval = sd.wfall_hw_scroll && sd.wfall_scroll_valid
+            && sd.wfall_scroll_center == sd.FFT_frequency
+            && sd.wfall_scroll_marker_num == sd.marker_num
+            && new_lines * (sd.repeatWaterfallLine + 1) < slayout.wfall.h;
 
+    for (uint16_t idx = 0; retval && idx < sd.marker_num; idx++)
+    {
+        retval = sd.wfall_scroll_marker[idx] == marker_line_pixel_pos[idx];
+    }
 
-    // Draw lines from buffer
-    sd.wfall_line++;        // bump to the next line in the circular buffer for next go-around
+    for (uint16_t line = 0, lptr = sd.wfall_line; retval && line < new_lines; line++)
+    {
+        lptr = lptr?lptr-1 : sd.wfall_size-1;
+        retval = sd.waterfall_frequencies[lptr] == sd.FFT_frequency;
+    }
 
-    uint16_t lptr = sd.wfall_line;      // get current line of "bottom" of waterfall in circular buffer
+    return retval;
+}
 
-    sd.wfall_line_update++;                                 // update waterfall line count
-    sd.wfall_line_update %= ts.waterfall.vert_step_size;    // clip it to number of lines per iteration
+/**
+ * @brief moves the waterfall down by new_lines using the display scroll window and draws only the new lines on top
+ * The new rows are written to the memory rows which are currently visible at the bottom of the area,
+ * then the offset is changed so that they appear at the top.
+ */
+static void UiSpectrum_WaterfallScroll(uint16_t new_lines, const uint16_t* marker_line_pixel_pos)
+{
+    uint16_t spectrum_pixel_buf[slayout.wfall.w];
 
-    if(!sd.wfall_line_update)                               // if it's count is zero, it's time to move the waterfall up
-    {
-    	//if(sd.wfall_DrawDirection==1)
-    	//{
-    	    // can't use modulo here, doesn't work if we use uint16_t,
-    	    // since it 0-1 == 65536 and not -1 (it is an unsigned integer after all)
-    	    lptr = lptr?lptr-1 : sd.wfall_size-1;
-    	//}
+    // oldest of the new lines first
+    uint16_t lptr = (sd.wfall_line + sd.wfall_size - new_lines) % sd.wfall_size;
 
-        lptr %= sd.wfall_size;      // do modulus limit of spectrum high
+    for (uint16_t line = 0; line < new_lines; line++)
+    {
+        // the pixels are converted only once, all on screen lines stay as they are
+        UiSpectrum_WaterfallLinePixels(spectrum_pixel_buf, lptr, sd.FFT_frequency, marker_line_pixel_pos);
 
-        // set up LCD for bulk write, limited only to area of screen with waterfall display.  This allow data to start from the
-        // bottom-left corner and advance to the right and up to the next line automatically without ever needing to address
-        // the location of any of the display data - as long as we "blindly" write precisely the correct number of pixels per
-        // line and the number of lines.
+        for(uint8_t doubleLine = 0; doubleLine < sd.repeatWaterfallLine + 1; doubleLine++)
+        {
+            sd.wfall_scroll_offset = sd.wfall_scroll_offset? sd.wfall_scroll_offset-1 : slayout.wfall.h-1;
 
+            UiLcdHy28_BulkPixel_OpenWrite(slayout.wfall.x, slayout.wfall.w, slayout.wfall.y + sd.wfall_scroll_offset, 1);
+            UiLcdHy28_BulkPixel_PutBuffer(spectrum_pixel_buf, slayout.wfall.w);
+            UiLcdHy28_BulkPixel_CloseWrite();
+        }
 
+        lptr = (lptr + 1) % sd.wfall_size;
+    }
 
-        //UiLcdHy28_BulkPixel_OpenWrite(slayout.wfall.x, slayout.wfall.w, (sd.wfall_ystart), sd.wfall_disp_lines);
-        UiLcdHy28_BulkPixel_OpenWrite(slayout.wfall.x, slayout.wfall.w, slayout.wfall.y, slayout.wfall.h);
+    UiLcdHy28_ScrollWindowOffset(sd.wfall_scroll_offset);
+}
 
-        uint16_t spectrum_pixel_buf[slayout.wfall.w];
+static void UiSpectrum_DrawWaterfall()
+{
+    sd.wfall_line %= sd.wfall_size; // make sure that the circular buffer is clipped to the size of the display area
 
-        const int32_t cur_center_hz = sd.FFT_frequency;
+    UiSpectrum_UpdateSpectrumPixelParameters(); // before accessing pixel parameters, request update according to configuration
 
-        //uint16_t lcnt = 0;
-        //for(uint16_t lcnt = 0;lcnt < sd.wfall_size; lcnt++)                 // set up counter for number of lines defining height of waterfall
 
-        // we update the display unless there is a ptt request, in this case we skip to the end.
-        for(uint16_t lcnt = 0; ts.ptt_req == false && lcnt < slayout.wfall.h;)                 // set up counter for number of lines defining height of waterfall
-        {
-            uint8_t  * const waterfallline_ptr = &sd.waterfall[lptr*slayout.wfall.w];
+    uint16_t marker_line_pixel_pos[SPECTRUM_MAX_MARKER];
+    for (uint16_t idx = 0; idx < sd.marker_num; idx++)
+    {
+        marker_line_pixel_pos[idx] = sd.marker_pos[idx];
+    }
 
+    // Apply the contrast and clip the result to make sure that it is within the range of the palette table
+    uint8_t  * const waterfallline_ptr = &sd.waterfall[sd.wfall_line*slayout.wfall.w];
 
-            const int32_t line_center_hz = sd.waterfall_frequencies[lptr];
+    for(uint16_t i = 0; i < slayout.wfall.w; i++)
+    {
+        // Contrast:  100 = 1.00 multiply factor:  125 = multiply by 1.25 - "sd.wfall_contrast" already converted to 100=1.00
+        const float32_t colour = sd.FFT_Samples[i] * sd.wfall_contrast;
 
-            // if our old_center is lower than cur_center_hz -> find start idx in waterfall_line, end_idx is line end, and pad with black pixels;
-            // if our old_center is higher than cur_center_hz -> find start pixel x in end_idx is line end, first pad with black pixels until this point and then use pixel buffer;
-            // if identical -> well, no padding.
-            const int32_t diff_centers = (line_center_hz - cur_center_hz);
-            int32_t offset_pixel = diff_centers/sd.hz_per_pixel;
-            uint16_t pixel_start, pixel_count, left_padding_count, right_padding_count;
+        // save the palette index in the circular waterfall buffer, clipped if it is an illegal color value
+        waterfallline_ptr[i] = colour >= NUMBER_WATERFALL_COLOURS ? NUMBER_WATERFALL_COLOURS - 1 : colour;
+    }
 
+    sd.waterfall_frequencies[sd.wfall_line] = sd.FFT_frequency;
 
-            // here we actually create a single line pixel by pixel.
 
-            if (offset_pixel >= slayout.wfall.w || offset_pixel <= -slayout.wfall.w)
-            {
-                offset_pixel = slayout.wfall.w-1;
-            }
-            if (offset_pixel <= 0)
-            {
-                                // we have to start -offset_pixel later and then pad with black
-                left_padding_count = 0;
-                pixel_start = -offset_pixel;
-                right_padding_count = -offset_pixel;
-                pixel_count = slayout.wfall.w + offset_pixel;
-            }
-            else
-            {
-                // we to start with offset_pixel black padding  and then draw the pixels until we reach spectrum width
-                left_padding_count = offset_pixel;
-                pixel_start = 0;
-                right_padding_count = 0;
-                pixel_count = slayout.wfall.w - offset_pixel;
-            }
+    // Draw lines from buffer
+    sd.wfall_line++;        // bump to the next line in the circular buffer for next go-around
+    sd.wfall_line %= sd.wfall_size;
 
+    uint16_t lptr = sd.wfall_line;      // get current line of "bottom" of waterfall in circular buffer
 
-            uint16_t* pixel_buf_ptr = &spectrum_pixel_buf[0];
+    sd.wfall_line_update++;                                 // update waterfall line count
+    sd.wfall_line_update %= ts.waterfall.vert_step_size;    // clip it to number of lines per iteration
 
-            // fill from the left border with black pixels
-            for(uint16_t i = 0; i < left_padding_count; i++)
-            {
-                *pixel_buf_ptr++ = Black;
-            }
+    if(!sd.wfall_line_update)                               // if it's count is zero, it's time to move the waterfall up
+    {
+        // the lines added since the last update
+        const uint16_t new_lines = ts.waterfall.vert_step_size < sd.wfall_size ? ts.waterfall.vert_step_size : sd.wfall_size;
 
-            for(uint16_t idx = pixel_start, i = 0; i < pixel_count; i++,idx++)
+        if (ts.ptt_req == true)
+        {
+            // we skip the display update, the screen has to be redrawn completely next time
+            sd.wfall_scroll_valid = false;
+        }
+        else if (UiSpectrum_WaterfallCanScroll(new_lines, marker_line_pixel_pos))
+        {
+            UiSpectrum_WaterfallScroll(new_lines, marker_line_pixel_pos);
+        }
+        else
+        {
+            if (sd.wfall_hw_scroll && sd.wfall_scroll_offset != 0)
             {
-                *pixel_buf_ptr++ = sd.waterfall_colours[waterfallline_ptr[idx]];    // write to memory using waterfall color from palette
+                // we draw in unscrolled coordinates
+                sd.wfall_scroll_offset = 0;
+                UiLcdHy28_ScrollWindowOffset(0);
             }
 
-            // fill to the right border with black pixels
-            for(uint16_t i = 0; i < right_padding_count; i++)
-            {
-                *pixel_buf_ptr++ = Black;
-            }
+            // can't use modulo here, doesn't work if we use uint16_t,
+            // since it 0-1 == 65536 and not -1 (it is an unsigned integer after all)
+            lptr = lptr?lptr-1 : sd.wfall_size-1;
 
-            for (uint16_t idx = 0; idx < sd.marker_num; idx ++)
-            {
-                // Place center line marker on screen:  Location [64] (the 65th) of the palette is reserved is a special color reserved for this
-                if (marker_line_pixel_pos[idx] < slayout.wfall.w)
-                {
-                    spectrum_pixel_buf[marker_line_pixel_pos[idx]] = sd.waterfall_colours[NUMBER_WATERFALL_COLOURS];
-                }
-            }
+            // set up LCD for bulk write, limited only to area of screen with waterfall display.  This allow data to start from the
+            // bottom-left corner and advance to the right and up to the next line automatically without ever needing to address
+            // the location of any of the display data - as long as we "blindly" write precisely the correct number of pixels per
+            // line and the number of lines.
+            UiLcdHy28_BulkPixel_OpenWrite(slayout.wfall.x, slayout.wfall.w, slayout.wfall.y, slayout.wfall.h);
 
+            uint16_t spectrum_pixel_buf[slayout.wfall.w];
 
-            //UiLcdHy28_BulkPixel_PutBuffer(spectrum_pixel_buf, slayout.wfall.w);
+            const int32_t cur_center_hz = sd.FFT_frequency;
 
-            for(uint8_t doubleLine=0;doubleLine<sd.repeatWaterfallLine+1;doubleLine++)
+            uint16_t lcnt = 0;
+            // we update the display unless there is a ptt request, in this case we skip to the end.
+            while(ts.ptt_req == false && lcnt < slayout.wfall.h)                 // set up counter for number of lines defining height of waterfall
             {
-                UiLcdHy28_BulkPixel_PutBuffer(spectrum_pixel_buf, slayout.wfall.w);
-                lcnt++;
-                if(lcnt==slayout.wfall.h)	//preventing the window overlap if doubling oversize the display window
+                UiSpectrum_WaterfallLinePixels(spectrum_pixel_buf, lptr, cur_center_hz, marker_line_pixel_pos);
+
+                for(uint8_t doubleLine=0;doubleLine<sd.repeatWaterfallLine+1;doubleLine++)
                 {
-                	break;
+                    UiLcdHy28_BulkPixel_PutBuffer(spectrum_pixel_buf, slayout.wfall.w);
+                    lcnt++;
+                    if(lcnt==slayout.wfall.h)	//preventing the window overlap if doubling oversize the display window
+                    {
+                        break;
+                    }
                 }
-            }
-            lptr = lptr?lptr-1 : sd.wfall_size-1;
-            /*
-            // point to next/prev line in circular display buffer:
-            if(sd.wfall_DrawDirection==1)
-            {
                 lptr = lptr?lptr-1 : sd.wfall_size-1;
             }
-            else
-            {
-            	lptr++;                         //moving upward (water fountain, "normal" in 320x240)
-            }*/
-            lptr %= sd.wfall_size;              // clip to display height
+            UiLcdHy28_BulkPixel_CloseWrite();                   // we are done updating the display - return to normal full-screen mode
 
+            // from now on the lines can be scrolled in, as long as the frequency and the markers stay
+            sd.wfall_scroll_valid = lcnt == slayout.wfall.h;
+            sd.wfall_scroll_center = cur_center_hz;
+            sd.wfall_scroll_marker_num = sd.marker_num;
+            memcpy(sd.wfall_scroll_marker, marker_line_pixel_pos, sizeof(marker_line_pixel_pos[0]) * sd.marker_num);
         }
-        UiLcdHy28_BulkPixel_CloseWrite();                   // we are done updating the display - return to normal full-screen mode
     }
 
 }
 
-static float32_t  UiSpectrum_ScaleFFTValue(const float32_t value, float32_t* min_p)
+static float32_t  UiSpectrum_ScaleFFTValue(const float32_t value, const float32_t db_scale, float32_t* min_p)
 {
-    float32_t sig = sd.display_offset + log10f_fast(value) * sd.db_scale;     // take FFT data, do a log10 and multiply it to scale 10dB (fixed)
+    float32_t sig = sd.display_offset + UiSpectrum_Log10(value) * db_scale;     // take FFT data, do a log10 and multiply it to scale 10dB (fixed)
     // apply "AGC", vertical "sliding" offset (or brightness for waterfall)
 
     if (sig < *min_p)
@@ -1260,27 +1404,118 @@ static float32_t  UiSpectrum_ScaleFFTValue(const float32_t value, float32_t* min
     return  (sig < 1)? 1 : sig;
 }
 
-static void UiSpectrum_ScaleFFT(float32_t dest[], float32_t source[], float32_t* min_p )
+/**
+ * @brief maps the averaged power of the FFT bins to display rows (or waterfall colour values), bins put in frequency-sequential order
+ * @param from, to range of display indices to calculate, so that the work can be spread over several calls
+ */
+static void UiSpectrum_ScaleFFT(float32_t dest[], float32_t source[], uint16_t from, uint16_t to, float32_t* min_p )
 {
     // not an in-place algorithm
     assert(dest != source);
 
-    for(uint16_t i = 0; i < (sd.spec_len/2); i++)
+    // source holds power, log10(power) is 2 * log10(magnitude), the dB/division scaling is given for the magnitude
+    const float32_t db_scale = sd.db_scale / 2;
+    const uint16_t half_len = sd.spec_len/2;
+
+    for(uint16_t idx = from; idx < to; idx++)
     {
-        dest[sd.spec_len - i - 1] = UiSpectrum_ScaleFFTValue(source[i + sd.spec_len/2], min_p);
-        // take FFT data, do a log10 and multiply it to scale 10dB (fixed)
-        // apply "AGC", vertical "sliding" offset (or brightness for waterfall)
+        // left half of the display shows the upper half of the FFT bins (negative frequencies), right half the lower half
+        const uint16_t i = sd.spec_len - idx - 1;
+        dest[idx] = UiSpectrum_ScaleFFTValue(source[i < half_len ? i + half_len : i - half_len], db_scale, min_p);
     }
+}
 
+/**
+ * @brief keeps the power value away from zero, the log scaling relies on values >= 1
+ */
+static inline float32_t UiSpectrum_LimitPower(const float32_t value)
+{
+    return value < 1 ? 1 : value;
+}
+
+/**
+ * @brief averages the power of the new frame into FFT_AVGData in place, as selected by ts.spectrum_avg_mode
+ * and sums up the log10 of the new power for the noise floor estimate
+ * @param from, to range of bins to process
+ */
+static void UiSpectrum_AverageFFT(uint16_t from, uint16_t to)
+{
+    const float32_t filt_factor = 1/(float)ts.spectrum_filter;		// use stored filter setting inverted to allow multiplication
+    float32_t log_sum = 0;
 
-    for(uint16_t i = (sd.spec_len/2); i < (sd.spec_len); i++)
+    switch(ts.spectrum_avg_mode)
     {
-        // build right half of spectrum data
-        dest[sd.spec_len - i - 1] = UiSpectrum_ScaleFFTValue(source[i - sd.spec_len/2], min_p);
-        // take FFT data, do a log10 and multiply it to scale 10dB (fixed)
-        // apply "AGC", vertical "sliding" offset (or brightness for waterfall)
+    case SPECTRUM_AVG_LINEAR:
+    {
+        // running mean of the frames of the current set, the first frame of a set replaces the old data
+        const float32_t factor = 1/(float32_t)(sd.avg_count + 1);
+        for(uint32_t i = from; i < to; i++)
+        {
+            const float32_t power = UiSpectrum_LimitPower(sd.FFT_PowerData[i]);
+            sd.FFT_AVGData[i] += (power - sd.FFT_AVGData[i]) * factor;
+            log_sum += UiSpectrum_Log10(power);
+        }
+        break;
+    }
+    case SPECTRUM_AVG_PEAK:
+    {
+        const float32_t decay = powf(10.0, -0.3/ts.spectrum_filter);	// 3dB/strength per frame
+        for(uint32_t i = from; i < to; i++)
+        {
+            const float32_t power = UiSpectrum_LimitPower(sd.FFT_PowerData[i]);
+            const float32_t held = sd.FFT_AVGData[i] * decay;
+            sd.FFT_AVGData[i] = UiSpectrum_LimitPower(power > held ? power : held);
+            log_sum += UiSpectrum_Log10(power);
+        }
+        break;
+    }
+    case SPECTRUM_AVG_MIN:
+    {
+        const float32_t rise = powf(10.0, 0.3/ts.spectrum_filter);	// 3dB/strength per frame
+        for(uint32_t i = from; i < to; i++)
+        {
+            const float32_t power = UiSpectrum_LimitPower(sd.FFT_PowerData[i]);
+            // falling power is followed by the low pass, rising power is limited, so that signals hardly lift the floor
+            const float32_t filtered = sd.FFT_AVGData[i] + (power - sd.FFT_AVGData[i]) * filt_factor;
+            const float32_t held = sd.FFT_AVGData[i] * rise;
+            sd.FFT_AVGData[i] = UiSpectrum_LimitPower(filtered < held ? filtered : held);
+            log_sum += UiSpectrum_Log10(power);
+        }
+        break;
+    }
+    case SPECTRUM_AVG_EXPONENTIAL:
+    default:
+        for(uint32_t i = from; i < to; i++)
+        {
+            const float32_t power = UiSpectrum_LimitPower(sd.FFT_PowerData[i]);
+            // avg = avg - avg * filt_factor + new * filt_factor
+            sd.FFT_AVGData[i] = UiSpectrum_LimitPower(sd.FFT_AVGData[i] + (power - sd.FFT_AVGData[i]) * filt_factor);
+            log_sum += UiSpectrum_Log10(power);
+        }
+        break;
     }
 
+    sd.noise_floor_sum += log_sum;
+}
+
+/**
+ * @brief noise floor estimate from the log10 sums of the frame
+ * For noise only the power of a bin is exponentially distributed, the mean of its log10 is
+ * log10 of the mean power minus Euler's constant / ln(10). The result is smoothed over some frames.
+ */
+static void UiSpectrum_UpdateNoiseFloor()
+{
+    const float32_t noise_floor = sd.noise_floor_sum / sd.spec_len + 0.2507;
+
+    if (sd.noise_floor_valid)
+    {
+        sd.noise_floor += (noise_floor - sd.noise_floor) * 0.1;
+    }
+    else
+    {
+        sd.noise_floor = noise_floor;
+        sd.noise_floor_valid = true;
+    }
 }
 
 /**
@@ -1344,6 +1579,7 @@ static void UiSpectrum_RedrawSpectrum()
 	bool is_RedrawActive=(ts.menu_mode == false)					//if this flag is false we do only dBm calculation (for S-meter and tune helper)
 						&& (sd.enabled == true)
 						&& (ts.mem_disp == false)
+						&& (ts.skimmer_disp == false)
 						&& (ts.SpectrumResize_flag == false);
 
 
@@ -1351,14 +1587,25 @@ static void UiSpectrum_RedrawSpectrum()
     switch(sd.state)
     {
     case 0:
-        sd.reading_ringbuffer = true;
-        __DSB();
-        // we make sure the interrupt sees this variable value by ensure all memory operations have been done
-        // after this point
-        arm_copy_f32(&sd.FFT_RingBuffer[sd.samp_ptr],&sd.FFT_Samples[0],sd.fft_iq_len-sd.samp_ptr);
-        arm_copy_f32(&sd.FFT_RingBuffer[0],&sd.FFT_Samples[sd.fft_iq_len-sd.samp_ptr],sd.samp_ptr);
-        sd.reading_ringbuffer = false;
-        sd.state++;
+        // the frame of the last round is not needed anymore, hand it back to the audio driver
+        if (sd.frame_held)
+        {
+            sd.frames_consumed++;
+            sd.frame_held = false;
+        }
+        if (sd.frames_filled != sd.frames_consumed)
+        {
+            if (sd.frames_filled - sd.frames_consumed > 1)
+            {
+                // two frames are waiting, skip the older one
+                sd.frames_consumed++;
+            }
+            __DMB(); // read the frame content only after the count which announced it
+            // no copy, the FFT and all following stages work in place in the frame
+            sd.FFT_Samples = sd.FFT_Frame[sd.frames_consumed & 1];
+            sd.frame_held = true;
+            sd.state++;
+        }
         break;
 
     // Apply gain to collected IQ samples and then do FFT
@@ -1373,7 +1620,7 @@ static void UiSpectrum_RedrawSpectrum()
         sd.state++;
         break;
     }
-    case 2:		// Do FFT and calculate complex magnitude
+    case 2:		// Do FFT
     {
         arm_cfft_f32(sd.cfft_instance, sd.FFT_Samples,0,1);	// Do FFT
         sd.state++;
@@ -1381,8 +1628,8 @@ static void UiSpectrum_RedrawSpectrum()
     }
     case 3:
     {
-        // Calculate magnitude
-        arm_cmplx_mag_f32( sd.FFT_Samples, sd.FFT_MagData ,sd.spec_len);
+        // Calculate power, the log scaling later on makes the square root of the magnitude unnecessary
+        arm_cmplx_mag_squared_f32( sd.FFT_Samples, sd.FFT_PowerData ,sd.spec_len);
         // FIXME:
 
         // just for debugging purposes
@@ -1393,7 +1640,8 @@ static void UiSpectrum_RedrawSpectrum()
         	{
         	for(int bindx = 0; bindx < ts.NR_FFT_L / 2; bindx++)
         	{
-        		sd.FFT_MagData[(ts.NR_FFT_L / 2 - 1) - bindx] = NR.Hk[bindx] * 150.0;
+        		const float32_t mag = NR.Hk[bindx] * 150.0;
+        		sd.FFT_PowerData[(ts.NR_FFT_L / 2 - 1) - bindx] = mag * mag;
         	}
         	}
         	/*        	else
@@ -1415,40 +1663,60 @@ static void UiSpectrum_RedrawSpectrum()
         	// set all other pixels to a low value
         	for(int bindx = ts.NR_FFT_L / 2; bindx < sd.spec_len; bindx++)
         	{
-        		sd.FFT_MagData[bindx] = 10.0;
+        		sd.FFT_PowerData[bindx] = 100.0;
         	}
         }
 
+        sd.slice_pos = 0;
         sd.state++;
         break;
     }
 
-    //  Low-pass filter amplitude magnitude data
+    //  Average power data, sd.slice_len bins per call
     case 4:
     {
-        float32_t filt_factor = 1/(float)ts.spectrum_filter;		// use stored filter setting inverted to allow multiplication
-        arm_scale_f32(sd.FFT_AVGData, filt_factor, sd.FFT_Samples, sd.spec_len);	// get scaled version of previous data
-        arm_sub_f32(sd.FFT_AVGData, sd.FFT_Samples, sd.FFT_AVGData, sd.spec_len);	// subtract scaled information from old, average data
-        arm_scale_f32(sd.FFT_MagData, filt_factor, sd.FFT_Samples, sd.spec_len);	// get scaled version of new, input data
-        arm_add_f32(sd.FFT_Samples, sd.FFT_AVGData, sd.FFT_AVGData, sd.spec_len);	// add portion new, input data into average
+        const uint16_t slice_end = sd.slice_pos + sd.slice_len;
 
-        for(uint32_t i = 0; i < sd.spec_len; i++)	 		// guarantee that the result will always be >= 0
+        if (sd.slice_pos == 0)
         {
-            if(sd.FFT_AVGData[i] < 1)
-            {
-                sd.FFT_AVGData[i] = 1;
-            }
+            sd.noise_floor_sum = 0;
         }
+        UiSpectrum_AverageFFT(sd.slice_pos, slice_end);
 
+        sd.slice_pos = slice_end;
+        if (sd.slice_pos < sd.spec_len)
+        {
+            break;	// next bins in the next call
+        }
+        sd.slice_pos = 0;
+
+        UiSpectrum_UpdateNoiseFloor();
         UiSpectrum_CalculateDBm();
 
-        if (is_RedrawActive)
+        bool avg_complete = true;
+        if (ts.spectrum_avg_mode == SPECTRUM_AVG_LINEAR)
+        {
+            sd.avg_count++;
+            avg_complete = sd.avg_count >= ts.spectrum_filter;
+            if (avg_complete)
+            {
+                sd.avg_count = 0;
+            }
+        }
+
+        if (is_RedrawActive && avg_complete == false)
+        {
+            // the set of frames for the linear average is not complete, keep the redraw request for later
+            sd.state=0;
+        }
+        else if (is_RedrawActive)
         {   //continue if there is no objection to display spectrum or waterfall
             if(ts.dial_moved)
             {
                 ts.dial_moved = 0;	// Dial moved - reset indicator
                 UiSpectrum_DrawFrequencyBar();	// redraw frequency bar on the bottom of the display
             }
+            sd.scale_min = 100000;
         	sd.state++;
         }
         else
@@ -1459,16 +1727,20 @@ static void UiSpectrum_RedrawSpectrum()
         break;
     }
 
-    // De-linearize and normalize display data and do AGC processing
+    // De-linearize and normalize display data and do AGC processing, sd.slice_len bins per call
     case 5:
     	if (is_RedrawActive)		//this is needed for overwrite prevention if menu was drawn when sd.state>4
     	{
-    		float32_t	min1=100000;
     		// De-linearize data with dB/division
     		// Transfer data to the waterfall display circular buffer, putting the bins in frequency-sequential order!
-    		// TODO: if we would use a different data structure here (e.g. q15), we could speed up collection of enough samples in driver
-    		// we could let it run as soon as last FFT_Samples read has been done here
-    		UiSpectrum_ScaleFFT(sd.FFT_Samples,sd.FFT_AVGData,&min1);
+    		const uint16_t slice_end = sd.slice_pos + sd.slice_len;
+    		UiSpectrum_ScaleFFT(sd.FFT_Samples,sd.FFT_AVGData,sd.slice_pos,slice_end,&sd.scale_min);
+
+    		sd.slice_pos = slice_end;
+    		if (sd.slice_pos < sd.spec_len)
+    		{
+    			break;	// next bins in the next call
+    		}
 
     		if (sd.spec_len != slayout.scope.w)
     		{
@@ -1477,8 +1749,9 @@ static void UiSpectrum_RedrawSpectrum()
     		}
 
     		// Adjust the sliding window so that the lowest signal is always black
-    		sd.display_offset -= sd.agc_rate*min1/5;
+    		sd.display_offset -= sd.agc_rate*sd.scale_min/5;
     	}
+    	sd.slice_pos = 0;
     	sd.state++;
     	break;
 
@@ -1616,8 +1889,8 @@ void UiSpectrum_CalculateDisplayFilterBW(float32_t* width_pixel_, float32_t* lef
 void UiSpectrum_DisplayFilterBW()
 {
 
-    if(ts.menu_mode == 0)
-    {// bail out if in menu mode
+    if(ts.menu_mode == 0 && ts.skimmer_disp == false)
+    {// bail out if in menu mode or if the skimmer text occupies the spectrum area
         // Update screen indicator - first get the width and center-frequency offset of the currently-selected filter
 
         float32_t width_pixel;                          // calculate width of line in pixels
@@ -1675,6 +1948,10 @@ static void UiSpectrum_DrawFrequencyBar()
         {
             freq_calc = roundf(freq_calc/50) / 20; // round graticule frequency to the nearest 50Hz
         }
+        else
+        {
+            freq_calc = roundf(freq_calc/10) / 100; // round graticule frequency to the nearest 10Hz
+        }
 
 
         int16_t centerIdx = -100; // UiSpectrum_GetGridCenterLine(0);
@@ -1796,6 +2073,16 @@ static void UiSpectrum_DisplayDbm()
             val = sm.dbmhz;
             unit_label = "dBm/Hz";
             break;
+        case DISPLAY_S_METER_NOISE:
+            display_something = true;
+            val = sm.dbm_noise;
+            unit_label = "dBm NF";
+            break;
+        case DISPLAY_S_METER_SNR:
+            display_something = true;
+            val = sm.dbm - sm.dbm_noise;
+            unit_label = "dB SNR";
+            break;
         }
 
         if ((display_something == true) && (val!=oldVal))
@@ -2045,7 +2332,7 @@ static void UiSpectrum_CalculateDBm()
     //###########################################################################################################################################
     // dBm/Hz-display DD4WH June, 9th 2016
     // the dBm/Hz display gives an absolute measure of the signal strength of the sum of all signals inside the passband of the filter
-    // we take the FFT-magnitude values of the spectrum display FFT for this purpose (which are already calculated for the spectrum display),
+    // we take the FFT-power values of the spectrum display FFT for this purpose (which are already calculated for the spectrum display),
     // so the additional processor load and additional RAM usage should be close to zero
     // this code also calculates the basis for the S-Meter (in sm.dbm and sm.dbmhz)
     //
@@ -2155,13 +2442,15 @@ static void UiSpectrum_CalculateDBm()
             	Ubin = sd.spec_len-1;
             }
 
-            for(int32_t i = 0; i < (buff_len_int/4); i++)
-            {
-                sd.FFT_Samples[sd.spec_len - i - 1] = sd.FFT_MagData[i + buff_len_int/4] * SCOPE_PREAMP_GAIN;	// get data
-            }
-            for(int32_t i = buff_len_int/4; i < (buff_len_int/2); i++)
+            // magnitude in frequency-sequential order, only for the passband and its neighbour bins used by the SNAP interpolation,
+            // the spectrum itself works with the power and needs no square roots
+            const int32_t first_idx = Lbin > 0 ? (int32_t)Lbin - 1 : 0;
+            const int32_t last_idx = Ubin < (sd.spec_len-1) ? (int32_t)Ubin + 1 : sd.spec_len-1;
+            for(int32_t idx = first_idx; idx <= last_idx; idx++)
             {
-                sd.FFT_Samples[sd.spec_len - i - 1] = sd.FFT_MagData[i - buff_len_int/4] * SCOPE_PREAMP_GAIN;	// get data
+                const int32_t i = sd.spec_len - idx - 1;
+                const float32_t power = sd.FFT_PowerData[i < (buff_len_int/4) ? i + buff_len_int/4 : i - buff_len_int/4];
+                sd.FFT_Samples[idx] = sqrtf(power) * SCOPE_PREAMP_GAIN;	// get data
             }
 
             // here would be the right place to start with the SNAP mode!
@@ -2195,6 +2484,19 @@ static void UiSpectrum_CalculateDBm()
                 sm.dbmhz = -145.0;
             }
 
+            if (sd.noise_floor_valid)
+            {
+                const float32_t passband_bins = Ubin - Lbin + 1;
+                const float32_t noise_mag = powf(10.0, sd.noise_floor / 2);
+                // the magnitude of a bin with noise only is Rayleigh distributed, its mean is sqrt(pi)/2 times the rms value,
+                // so this is what the sum above shows without a signal
+                sm.dbm_noise = slope * log10f_fast (passband_bins * 0.886227 * noise_mag * SCOPE_PREAMP_GAIN) + cons;
+
+                // rms noise within the passband at the codec output, where the AGC input comes from:
+                // undo the codec gain correction of the window function, the Hann window has a noise power gain of 3/8
+                AudioDriver_AgcWdspSetNoiseLevel(ads.codec_gain_calc * noise_mag * sqrtf(passband_bins / 0.375) / sd.spec_len);
+            }
+
             // lowpass IIR filter
             // Wheatley 2011: two averagers with two time constants
             // IIR filter with one element analog to 1st order RC filter
@@ -144,6 +144,14 @@ enum
 #define	SPECTRUM_FILTER_MAX			20	// maximum filter setting
 #define SPECTRUM_FILTER_DEFAULT		4	// default filter setting
 //
+// spectrum averaging modes (ts.spectrum_avg_mode), the filter setting above is the strength of the averaging
+#define SPECTRUM_AVG_EXPONENTIAL	0	// IIR low pass with the factor 1/strength
+#define SPECTRUM_AVG_LINEAR			1	// mean of "strength" frames, the display is updated once per completed set
+#define SPECTRUM_AVG_PEAK			2	// peak hold, decays by 3dB/strength per frame
+#define SPECTRUM_AVG_MIN			3	// minimum hold (noise floor), follows falling power with the IIR low pass, rises by 3dB/strength per frame at most
+#define SPECTRUM_AVG_NUM			4
+#define SPECTRUM_AVG_DEFAULT		SPECTRUM_AVG_EXPONENTIAL
+//
 #define	SPECTRUM_SCOPE_AGC_MIN				1	// minimum spectrum scope AGC rate setting
 #define	SPECTRUM_SCOPE_AGC_MAX				50	// maximum spectrum scope AGC rate setting
 #define	SPECTRUM_SCOPE_AGC_DEFAULT			25	// default spectrum scope AGC rate setting
@@ -189,24 +197,24 @@ enum
 typedef struct SpectrumDisplay
 {
     // Samples buffer
-    float32_t   FFT_RingBuffer[FFT_IQ_BUFF_LEN];
-    float32_t   FFT_Samples[FFT_IQ_BUFF_LEN];
-    float32_t   FFT_MagData[SPEC_BUFF_LEN];
-    float32_t   FFT_AVGData[SPEC_BUFF_LEN];     // IIR low-pass filtered FFT buffer data
+    // the audio interrupt fills one I/Q frame while the spectrum state machine works on the other one, see UiSpectrum_RedrawSpectrum
+    float32_t   FFT_Frame[2][FFT_IQ_BUFF_LEN];
+    float32_t*  FFT_Samples;    // the frame the spectrum works on, it is also the work buffer of the later stages
+    float32_t   FFT_PowerData[SPEC_BUFF_LEN];   // power of the FFT bins, the square of the magnitude
+    float32_t   FFT_AVGData[SPEC_BUFF_LEN];     // averaged FFT power data, see ts.spectrum_avg_mode
     uint32_t    FFT_frequency; // center frequency of stored FFT
     // scope pixel data
     uint16_t    Old_PosData[SPECTRUM_WIDTH_MAX];
 
-    // Current data ptr
+    // Current data ptr, position in the frame the audio interrupt fills
     ulong   samp_ptr;
-    volatile bool    reading_ringbuffer;
-    // if the user level code wants to read the ring buffer
-    // simply set this, and the audio driver will stop writing
-    // to the buffer.  This means we loose some samples here but this is not a problem I would think.
-    // if we don't want or should do this,
-    // we have to add a little extra space to the ringbuffer (one audio driver sample block), which gives sufficient
-    // space to add data to while we are reading.
-
+    // single producer / single consumer frame queue of two slots, frame n goes to FFT_Frame[n & 1]
+    // frames_filled is only written by the audio interrupt, frames_consumed only by the spectrum
+    // if both frames are waiting, the interrupt stops collecting until the spectrum releases one,
+    // so every frame is a gap-free block of samples
+    volatile uint32_t frames_filled;
+    volatile uint32_t frames_consumed;
+    bool    frame_held;     // the spectrum works on frame frames_consumed
 
     // Addresses of vertical grid lines on x axis
     ushort  vert_grid_id[SPECTRUM_SCOPE_GRID_VERT_COUNT-1];
@@ -218,12 +226,23 @@ typedef struct SpectrumDisplay
 
     // State machine current state
     uchar   state;
+    // the averaging and scaling states work on slice_len bins per call, starting at bin slice_pos
+    uint16_t slice_len;
+    uint16_t slice_pos;
+    float32_t scale_min;    // lowest display value of the frame being scaled, for the display AGC
+    uint8_t avg_count;      // SPECTRUM_AVG_LINEAR: number of frames already averaged into the current set, 0 starts a new set
+
+    // noise floor estimate, log10 of the mean noise power of a bin, independent of the averaging mode
+    // it is the (bias corrected) mean of the log10 of all bins of a frame, which few signals do not change much
+    float32_t noise_floor;
+    float32_t noise_floor_sum;  // sum of log10 power of the bins of the frame being averaged
+    bool noise_floor_valid;
 
     // Init done flag
     uchar   enabled;
 
     // Variables used in spectrum display AGC
-    uint8_t   magnify;          // 2^magnify == zoom factor, max is 5
+    uint8_t   magnify;          // 2^magnify == zoom factor, max is 7
 
     uint16_t    spec_len;
     uint16_t    fft_iq_len;
@@ -248,6 +267,13 @@ typedef struct SpectrumDisplay
     //uint16_t wfall_disp_lines;        // vertical size of the waterfall on display
     uint16_t wfall_ystart;
 
+    bool     wfall_hw_scroll;       // the display scrolls the waterfall area, only new lines are drawn
+    bool     wfall_scroll_valid;    // the screen shows all lines at wfall_scroll_center with the markers below
+    uint16_t wfall_scroll_offset;   // current hardware scroll offset of the waterfall area
+    uint32_t wfall_scroll_center;
+    uint16_t wfall_scroll_marker[SPECTRUM_MAX_MARKER];
+    uint16_t wfall_scroll_marker_num;
+
     uint16_t scope_size;
     uint16_t scope_ystart;
 
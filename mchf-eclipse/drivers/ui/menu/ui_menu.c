@@ -33,6 +33,7 @@
 #include "radio_management.h"
 #include "soft_tcxo.h"
 #include "cw_decoder.h"
+#include "psk_skimmer.h"
 
 #include "osc_si5351a.h"
 #include "osc_si570.h"
@@ -827,6 +828,24 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
         //
         snprintf(options,32, "  %u", ts.dsp_nr_strength);
         break;
+    case MENU_DSP_NR_FFT_SIZE:  // frame length of the spectral noise reduction
+        var_change = UiDriverMenuItemChangeUInt8(var, mode, &ts.nr_fft_size,
+                                              NR_FFT_SIZE_SEL_128,
+                                              NR_FFT_SIZE_SEL_MAX,
+                                              NR_FFT_SIZE_SEL_256,
+                                              1
+                                             );
+        if(var_change)
+        {
+            AudioNr_ChangeFftSize(ts.nr_fft_size);
+        }
+        {
+            // the selected length, the NR may still be using the old one until its next frame
+            const uint16_t fft_len = NR_FFT_L_MIN << ts.nr_fft_size;
+            // frame duration at the NR sample rate of 12ksps
+            snprintf(options,32, "%3u %2ums", fft_len, (fft_len + 6) / 12);
+        }
+        break;
     case MENU_AM_DISABLE: // AM mode enable/disable
         UiMenu_HandleDemodModeDisable(var, mode, options, &clr, DEMOD_AM_DISABLE);
         break;
@@ -1149,6 +1168,14 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
         snprintf(options, 32, "  %ddB", ts.agc_wdsp_thresh);
         break;
 
+    case MENU_AGC_WDSP_THRESH_AUTO:      //
+        var_change = UiDriverMenuItemChangeEnableOnOff(var, mode, &ts.agc_wdsp_thresh_auto,0,options,&clr);
+        if(var_change)
+        {
+            AudioDriver_SetupAgcWdsp();
+        }
+        break;
+
     case MENU_AGC_WDSP_HANG_THRESH:      //
         var_change = UiDriverMenuItemChangeInt(var, mode, &ts.agc_wdsp_hang_thresh,
                                             -20,
@@ -2070,6 +2097,33 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
                                              );
         snprintf(options,32, "  %u", ts.spectrum_filter);
         break;
+    case MENU_SPECTRUM_AVG_MODE: // spectrum averaging mode
+        var_change = UiDriverMenuItemChangeUInt8(var, mode, &ts.spectrum_avg_mode,
+                                              0,
+                                              SPECTRUM_AVG_NUM-1,
+                                              SPECTRUM_AVG_DEFAULT,
+                                              1
+                                             );
+        if (var_change)
+        {
+            sd.avg_count = 0;   // the averaged data of the old mode is no start for a linear average
+        }
+        switch(ts.spectrum_avg_mode)
+        {
+        case SPECTRUM_AVG_LINEAR:
+            txt_ptr = "LINEAR";
+            break;
+        case SPECTRUM_AVG_PEAK:
+            txt_ptr = "  PEAK";
+            break;
+        case SPECTRUM_AVG_MIN:
+            txt_ptr = "   MIN";
+            break;
+        default:
+            txt_ptr = "   EXP";
+            break;
+        }
+        break;
     case MENU_SCOPE_TRACE_COLOUR:   // spectrum scope trace colour
         var_change = UiDriverMenuItemChangeUInt8(var, mode, &ts.scope_trace_colour,
                                               0,
@@ -2139,6 +2193,12 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
         case 5:
             txt_ptr = "x32";
             break;
+        case 6:
+            txt_ptr = "x64";
+            break;
+        case 7:
+            txt_ptr = "x128";
+            break;
         case 0:
         default:
             txt_ptr = " x1";
@@ -2268,19 +2328,25 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
     case    MENU_DBM_DISPLAY:
         var_change = UiDriverMenuItemChangeUInt8(var, mode, &ts.display_dbm,
                                               0,
-                                              2,
+                                              DISPLAY_S_METER_MAX,
                                               0,
                                               1
                                              );
 
        switch(ts.display_dbm)
         {
-        case 1:     //
+        case DISPLAY_S_METER_DBM:     //
             txt_ptr = "     dBm";       // dbm display
             break;
-        case 2: //
+        case DISPLAY_S_METER_DBMHZ: //
             txt_ptr = "  dBm/Hz";       // dbm/Hz display
             break;
+        case DISPLAY_S_METER_NOISE: //
+            txt_ptr = "   NOISE";       // noise floor display
+            break;
+        case DISPLAY_S_METER_SNR: //
+            txt_ptr = "     SNR";       // signal to noise display
+            break;
         default:
         txt_ptr =  "     OFF";      // dbm display off
             break;
@@ -4000,17 +4066,7 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
         //         var_change = UiDriverMenuItemChangeEnableOnOffBool(var, mode, &ts.new_nb,0,options,&clr);
         //         break;//
 //#if defined(STM32F7) || defined(STM32H7)
-/*     case MENU_DEBUG_NR_FFT_SIZE:
-                 var_change = UiDriverMenuItemChangeEnableOnOffBool(var, mode, &ts.nr_fft_256_enable,0,options,&clr);
-                 ts.NR_FFT_L = 128;
-                 ts.NR_FFT_LOOP_NO = 2;
-                 if(ts.nr_fft_256_enable)
-                 {
-                	 ts.NR_FFT_LOOP_NO = 1;
-                	 ts.NR_FFT_L = 256;
-                 }
-        break;
-     case MENU_DEBUG_NR_DEC_ENABLE:
+/*     case MENU_DEBUG_NR_DEC_ENABLE:
                  var_change = UiDriverMenuItemChangeEnableOnOffBool(var, mode, &ts.NR_decimation_enable,0,options,&clr);
         break;
 //#endif
@@ -4093,6 +4149,41 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
              Board_RedLed(LED_STATE_OFF);
          }
     	 break;
+     case MENU_CW_DECODER_BANK:
+         var_change = UiDriverMenuItemChangeUInt8(var, mode, &cw_decoder_config.bank_mode,
+                 0,
+                 CW_BANK_NUM-1,
+                 CW_BANK_OFF,
+                 1);
+         switch(cw_decoder_config.bank_mode)
+         {
+         case CW_BANK_OFF:
+             txt_ptr = " OFF";
+             break;
+         case CW_BANK_LOCK:
+             txt_ptr = "LOCK";
+             break;
+         case CW_BANK_SKIM:
+             txt_ptr = "SKIM";
+             break;
+         }
+         break;
+     case MENU_CW_DECODER_TIMING:
+         var_change = UiDriverMenuItemChangeUInt8(var, mode, &cw_decoder_config.timing,
+                 0,
+                 CW_TIMING_NUM-1,
+                 CW_TIMING_CLASSIC,
+                 1);
+         switch(cw_decoder_config.timing)
+         {
+         case CW_TIMING_CLASSIC:
+             txt_ptr = "CLASSIC";
+             break;
+         case CW_TIMING_BAYES:
+             txt_ptr = "  BAYES";
+             break;
+         }
+         break;
      case MENU_CW_DECODER_SNAP_ENABLE:
          var_change = UiDriverMenuItemChangeEnableOnOffBool(var, mode, &cw_decoder_config.snap_enable,0,options,&clr);
          if (var_change)
@@ -4117,6 +4208,39 @@ void UiMenu_UpdateItem(uint16_t select, uint16_t mode, int pos, int var, char* o
         snprintf(options,32,"     %s",digimodes[ts.digital_mode].label);
         clr = digimodes[ts.digital_mode].enabled?White:Red;
         break;
+    case MENU_DEBUG_PSK_SKIMMER:
+    {
+        // the audio interrupt runs the skimmer as soon as psk_ctrl_config.skimmer is on,
+        // so the new setting is applied only after the skimmer has been set up
+        uint8_t skimmer = psk_ctrl_config.skimmer;
+        var_change = UiDriverMenuItemChangeUInt8(var, mode, &skimmer,
+                0,
+                PSK_SKIM_NUM-1,
+                PSK_SKIM_OFF,
+                1);
+        if (var_change)
+        {
+            if (psk_ctrl_config.skimmer == PSK_SKIM_OFF)
+            {
+                PskSkimmer_Init();
+            }
+            // if it is running already, only the output changes
+            psk_ctrl_config.skimmer = skimmer;
+        }
+        switch(skimmer)
+        {
+        case PSK_SKIM_OFF:
+            txt_ptr = "     OFF";
+            break;
+        case PSK_SKIM_LCD:
+            txt_ptr = "     LCD";
+            break;
+        case PSK_SKIM_LCD_USB:
+            txt_ptr = " LCD+USB";
+            break;
+        }
+        break;
+    }
     case CONFIG_CAT_PTT_RTS:
         var_change = UiDriverMenuItemChangeEnableOnOffBool(var, mode, &ts.enable_ptt_rts,0,options,&clr);
         break;
@@ -16,6 +16,7 @@
 enum
 {
     MENU_DSP_NR_STRENGTH = 0,
+    MENU_DSP_NR_FFT_SIZE,
     MENU_AM_DISABLE,
     MENU_CW_DISABLE,
     MENU_DIGI_DISABLE,
@@ -34,6 +35,7 @@ enum
     MENU_AGC_WDSP_SLOPE,
     MENU_AGC_WDSP_TAU_DECAY,
     MENU_AGC_WDSP_THRESH,
+    MENU_AGC_WDSP_THRESH_AUTO,
     MENU_AGC_WDSP_HANG_ENABLE,
     MENU_AGC_WDSP_HANG_TIME,
     MENU_AGC_WDSP_HANG_THRESH,
@@ -65,10 +67,13 @@ enum
 	MENU_CW_DECODER_USE_3_GOERTZEL,
 	MENU_CW_DECODER_SNAP_ENABLE,
 	MENU_CW_DECODER_SHOW_CW_LED,
+	MENU_CW_DECODER_BANK,
+	MENU_CW_DECODER_TIMING,
     MENU_TCXO_MODE,
     MENU_TCXO_C_F,
     MENU_SCOPE_SPEED,
     MENU_SPECTRUM_FILTER_STRENGTH,
+    MENU_SPECTRUM_AVG_MODE,
     MENU_SCOPE_TRACE_COLOUR,
     MENU_SCOPE_TRACE_HL_COLOUR,
 	MENU_SCOPE_BACKGROUND_HL_COLOUR,
@@ -259,7 +264,6 @@ enum
 	MENU_DEBUG_NR_BETA,
 //	MENU_DEBUG_NR_Mode,
 //#if defined(STM32F7) || defined(STM32H7)
-//	MENU_DEBUG_NR_FFT_SIZE,
 //	MENU_DEBUG_NR_DEC_ENABLE,
 //#endif
 	MENU_DEBUG_NR_ASNR,
@@ -276,6 +280,7 @@ enum
 //	MENU_DEBUG_ANR_GAIN,
 //	MENU_DEBUG_ANR_LEAK,
 	MENU_DEBUG_OSC_SI5351_PLLRESET,
+	MENU_DEBUG_PSK_SKIMMER,
 
     CONFIG_RTC_START,
     CONFIG_RTC_HOUR,
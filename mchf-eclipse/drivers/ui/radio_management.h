@@ -50,11 +50,6 @@ typedef struct DialFrequency
 #define TCXO_UNIT_F 0xf0
 
 
-    // Virtual segments
-    uint8_t dial_digits[9];
-    // Second display
-    uint8_t sdial_digits[9];
-
 } DialFrequency;
 
 // ------------------------------------------------
@@ -18,6 +18,7 @@
 #include "ui_driver.h"
 
 #include "audio_driver.h"
+#include "audio_nr.h"
 
 #include "ui_spectrum.h"
 #include "radio_management.h"
@@ -176,7 +177,7 @@ const ConfigEntryDescriptor ConfigEntryInfo[] =
     { ConfigEntry_UInt8, EEPROM_CAT_XLAT,&ts.xlat,1,0,1},
     { ConfigEntry_UInt32_16, EEPROM_MANUAL_NOTCH,&ts.notch_frequency,800,200,5000},
     { ConfigEntry_UInt32_16, EEPROM_MANUAL_PEAK,&ts.peak_frequency,750,200,5000},
-    { ConfigEntry_UInt8, EEPROM_DISPLAY_DBM,&ts.display_dbm,0,0,2},
+    { ConfigEntry_UInt8, EEPROM_DISPLAY_DBM,&ts.display_dbm,0,0,DISPLAY_S_METER_MAX},
     { ConfigEntry_Int32_16, EEPROM_DBM_CALIBRATE,&ts.dbm_constant,0,-100,100},
 //    { ConfigEntry_UInt8, EEPROM_S_METER,&ts.s_meter,0,0,2},
     { ConfigEntry_UInt8, EEPROM_DIGI_MODE_CONF,&ts.digital_mode,0,0,DigitalMode_Num_Modes-1},
@@ -196,6 +197,9 @@ const ConfigEntryDescriptor ConfigEntryInfo[] =
     { ConfigEntry_UInt8, EEPROM_CW_DECODER_ENABLE,&ts.cw_decoder_enable,1,0,1},
 	{ ConfigEntry_UInt16, EEPROM_Scope_Graticule_Ypos,&ts.graticulePowerupYpos,0,0,480},
 	{ ConfigEntry_UInt8, EEPROM_Freq_Display_Font,&ts.FreqDisplayFont,0,0,1},
+	{ ConfigEntry_UInt8, EEPROM_NR_FFT_SIZE,&ts.nr_fft_size,NR_FFT_SIZE_SEL_256,NR_FFT_SIZE_SEL_128,NR_FFT_SIZE_SEL_MAX},
+	{ ConfigEntry_UInt8, EEPROM_SPECTRUM_AVG_MODE,&ts.spectrum_avg_mode,SPECTRUM_AVG_DEFAULT,0,SPECTRUM_AVG_NUM-1},
+	{ ConfigEntry_UInt8, EEPROM_AGC_WDSP_THRESH_AUTO,&ts.agc_wdsp_thresh_auto,0,0,1},
 
 
     UI_C_EEPROM_BAND_5W_PF( 0,80,m)
@@ -92,7 +92,7 @@ void		UiConfiguration_UpdateMacroCap(void);
 #define MAX_VOLUME_YELLOW_THRESH  16  // "MAX VOLUME" setting at or below which number will be YELLOW to warn user
 
 #define MAGNIFY_MIN                 0
-#define MAGNIFY_MAX                 5
+#define MAGNIFY_MAX                 7
 #define MAGNIFY_DEFAULT             0
 #define MAGNIFY_NUM                 (MAGNIFY_MAX+1)
 
@@ -585,8 +585,11 @@ void		UiConfiguration_UpdateMacroCap(void);
 #define EEPROM_CW_DECODER_ENABLE				404
 #define EEPROM_Scope_Graticule_Ypos				405
 #define EEPROM_Freq_Display_Font				406
+#define EEPROM_NR_FFT_SIZE						407
+#define EEPROM_SPECTRUM_AVG_MODE				408
+#define EEPROM_AGC_WDSP_THRESH_AUTO				409
 
-#define EEPROM_FIRST_UNUSED 				407		// change this if new value ids are introduced
+#define EEPROM_FIRST_UNUSED 				410		// change this if new value ids are introduced
 
 #define MAX_VAR_ADDR (EEPROM_FIRST_UNUSED - 1)
 
@@ -58,6 +58,8 @@
 #include "rtty.h"
 #include "cw_decoder.h"
 #include "psk.h"
+#include "psk_skimmer.h"
+#include "cw_bank.h"
 
 #define SPLIT_ACTIVE_COLOUR         		Yellow      // colour of "SPLIT" indicator when active
 #define SPLIT_INACTIVE_COLOUR           	Grey        // colour of "SPLIT" indicator when NOT active
@@ -73,6 +75,8 @@ static void 	UiDriver_DrawSMeter(ushort color);
 //
 static void 	UiDriver_UpdateTopMeterA(uchar val);
 static void 	UiDriver_UpdateBtmMeter(float val, uchar warn);
+static void     UiDriver_ResetMeters();
+static void     UiDriver_RefreshMeters();
 
 static void 	UiDriver_InitFrequency();
 //
@@ -558,6 +562,191 @@ void UiDriver_TextMsgPutSign(const char *s)
 	UiDriver_TextMsgPutChar('>');
 }
 
+#define UI_SKIM_FONT 3 // 8x12
+#define UI_SKIM_USB_LINE 40 // pending characters which are sent via USB as one line
+#define UI_SKIM_USB_IDLE 200 // sysclock ticks without a new character after which pending characters are sent anyway
+
+/**
+ * @brief copy characters of a skimmer channel into a zero terminated string
+ * @param first index of the first character, at most SKIMMER_TEXT_LEN before last
+ * @param last index after the last character
+ */
+static void UiDriver_SkimmerCopyText(char* dst, const SkimmerText* chan, uint32_t first, uint32_t last)
+{
+	for (uint32_t idx = first; idx < last; idx++)
+	{
+		*dst++ = chan->text[idx & (SKIMMER_TEXT_LEN - 1)];
+	}
+	*dst = '\0';
+}
+
+/**
+ * @brief send characters of a skimmer channel as one line "<frequency in Hz>: <text>" via USB
+ */
+static void UiDriver_SkimmerSendText(const SkimmerText* chan, uint32_t first, uint32_t last)
+{
+	char line[16 + SKIMMER_TEXT_LEN + 3];
+
+	uint32_t dial = RadioManagement_GetRXDialFrequency() / TUNE_MULT;
+	uint32_t freq = ts.digi_lsb ? dial - chan->freq : dial + chan->freq;
+
+	int len = snprintf(line, 16, "%lu: ", (unsigned long)freq);
+	UiDriver_SkimmerCopyText(&line[len], chan, first, last);
+	strcat(line, "\r\n");
+	CatDriver_SendText(line);
+}
+
+#define UI_SKIM_MAX_CHANNELS (PSK_SKIM_CHANNELS > CW_SKIM_CHANNELS ? PSK_SKIM_CHANNELS : CW_SKIM_CHANNELS)
+
+/**
+ * @brief Shows the text of the PSK or CW skimmer channels instead of the spectrum display, one line per carrier,
+ * and sends the PSK text line by line via USB if configured. Called from the main loop.
+ */
+static void UiDriver_SkimmerDisplay()
+{
+	static bool shown = false;
+	static const SkimmerText* shown_source = NULL;
+	static uint16_t chan_generation[UI_SKIM_MAX_CHANNELS];
+	static uint16_t chan_freq[UI_SKIM_MAX_CHANNELS];
+	static uint32_t chan_displayed[UI_SKIM_MAX_CHANNELS];
+	static uint32_t chan_sent[UI_SKIM_MAX_CHANNELS];
+	static uint32_t chan_last_char[UI_SKIM_MAX_CHANNELS];
+
+	const SkimmerText* source = NULL;
+	uint16_t channels = 0;
+	bool usb = false;
+
+	if (is_demod_psk() && psk_ctrl_config.skimmer != PSK_SKIM_OFF)
+	{
+		source = psk_skimmer_text;
+		channels = PSK_SKIM_CHANNELS;
+		usb = psk_ctrl_config.skimmer == PSK_SKIM_LCD_USB;
+	}
+	else if (ts.dmod_mode == DEMOD_CW && ts.cw_decoder_enable && cw_decoder_config.bank_mode == CW_BANK_SKIM)
+	{
+		source = cw_skimmer_text;
+		channels = CW_SKIM_CHANNELS;
+	}
+
+	bool show = source != NULL;
+
+	if (source != shown_source)
+	{
+		shown_source = source;
+		shown = false;		// a different skimmer, start from scratch
+		memset(chan_generation, 0, sizeof(chan_generation));
+		memset(chan_displayed, 0, sizeof(chan_displayed));
+		memset(chan_sent, 0, sizeof(chan_sent));
+	}
+
+	if (show != ts.skimmer_disp)
+	{
+		ts.skimmer_disp = show;
+		if (show == false && ts.menu_mode == false && ts.mem_disp == false)
+		{
+			UiSpectrum_Init();		// bring the spectrum display back
+		}
+	}
+
+	bool visible = show && ts.menu_mode == false && ts.mem_disp == false;
+	bool redraw = false;
+
+	if (visible != shown)
+	{
+		shown = visible;
+		if (visible)
+		{
+			UiSpectrum_Clear();
+			redraw = true;
+		}
+	}
+
+	if (show == false)
+	{
+		return;
+	}
+
+	const UiArea_t* area = &sd.Slayout->full;
+	uint16_t line_h = UiLcdHy28_TextHeight(UI_SKIM_FONT);
+	uint16_t char_w = UiLcdHy28_TextWidth("0", UI_SKIM_FONT);
+	uint16_t rows = area->h / line_h;
+	char line[64];
+	uint16_t cols = area->w / char_w;
+
+	if (rows > channels)
+	{
+		rows = channels;
+	}
+	if (cols > sizeof(line) - 1)
+	{
+		cols = sizeof(line) - 1;
+	}
+
+	for (int c = 0; c < channels; c++)
+	{
+		const SkimmerText* chan = &source[c];
+
+		bool active = chan->active;
+		__DMB();	// the audio interrupt sets active last when it assigns a carrier
+		uint16_t generation = chan->generation;
+		uint16_t freq = chan->freq;
+		uint32_t count = chan->text_count;
+
+		if (generation != chan_generation[c])
+		{
+			chan_generation[c] = generation;
+			chan_displayed[c] = 0;
+			chan_sent[c] = 0;
+			chan_last_char[c] = ts.sysclock;
+			redraw = redraw || c < rows;
+		}
+
+		if (usb)
+		{
+			if (count - chan_sent[c] > SKIMMER_TEXT_LEN)
+			{
+				chan_sent[c] = count - SKIMMER_TEXT_LEN;	// we were too slow, older characters are gone
+			}
+			if (count != chan_displayed[c])
+			{
+				chan_last_char[c] = ts.sysclock;
+			}
+			if (count > chan_sent[c] &&
+					(count - chan_sent[c] >= UI_SKIM_USB_LINE || active == false || ts.sysclock - chan_last_char[c] > UI_SKIM_USB_IDLE))
+			{
+				UiDriver_SkimmerSendText(chan, chan_sent[c], count);
+				chan_sent[c] = count;
+			}
+		}
+		else
+		{
+			chan_sent[c] = count;
+		}
+
+		if (visible && c < rows && (redraw || count != chan_displayed[c] || freq != chan_freq[c]))
+		{
+			uint16_t text_len = cols - 5;
+			uint32_t first = count > text_len ? count - text_len : 0;
+
+			memset(line, ' ', cols);
+			line[cols] = '\0';
+			if (active || count > 0)
+			{
+				snprintf(line, 6, "%4u ", freq);
+				UiDriver_SkimmerCopyText(&line[5], chan, first, count);
+				size_t len = strlen(line);
+				if (len < cols)
+				{
+					line[len] = ' ';	// pad the rest of the line with the spaces from above
+				}
+			}
+			UiLcdHy28_PrintText(area->x, area->y + c * line_h, line, active ? Yellow : Grey, Black, UI_SKIM_FONT);
+		}
+		chan_displayed[c] = count;
+		chan_freq[c] = freq;
+	}
+}
+
 static void UiDriver_LeftBoxDisplay(const uint8_t row, const char *label, bool encoder_active,
 		const char* text, uint32_t color, uint32_t clr_val, bool text_is_value)
 {
@@ -581,20 +770,20 @@ static void UiDriver_LeftBoxDisplay(const uint8_t row, const char *label, bool e
 	}
 
 
-	UiLcdHy28_DrawEmptyRect(posX, posY, LEFTBOX_ROW_H - 2, LEFTBOX_WIDTH - 2, brdr_color);
-	UiLcdHy28_PrintTextCentered(posX + 1, posY + 1,LEFTBOX_WIDTH - 3, label,
+	UiLcdHy28_DrawEmptyRectRetained(posX, posY, LEFTBOX_ROW_H - 2, LEFTBOX_WIDTH - 2, brdr_color);
+	UiLcdHy28_PrintTextCenteredRetained(posX + 1, posY + 1,LEFTBOX_WIDTH - 3, label,
 			label_color, bg_color, 0);
 
-	// this causes flicker, but I am too lazy to fix that now
-	UiLcdHy28_DrawFullRect(posX + 1, posY + 1 + 12, LEFTBOX_ROW_H - 4 - 11, LEFTBOX_WIDTH - 3, text_is_value?Black:bg_color);
+	// only drawn if the box changes between value and text display, no flicker
+	UiLcdHy28_DrawFullRectRetained(posX + 1, posY + 1 + 12, LEFTBOX_ROW_H - 4 - 11, LEFTBOX_WIDTH - 3, text_is_value?Black:bg_color);
 	if (text_is_value)
 	{
-		UiLcdHy28_PrintTextRight((posX + LEFTBOX_WIDTH - 4), (posY + 1 + LEFTBOX_ROW_2ND_OFF), text,
+		UiLcdHy28_PrintTextRightRetained((posX + LEFTBOX_WIDTH - 4), (posY + 1 + LEFTBOX_ROW_2ND_OFF), text,
 				clr_val, text_is_value?Black:bg_color, 0);
 	}
 	else
 	{
-		UiLcdHy28_PrintTextCentered((posX + 1), (posY + 1 + LEFTBOX_ROW_2ND_OFF),LEFTBOX_WIDTH - 3, text,
+		UiLcdHy28_PrintTextCenteredRetained((posX + 1), (posY + 1 + LEFTBOX_ROW_2ND_OFF),LEFTBOX_WIDTH - 3, text,
 				color, bg_color, 0);
 	}
 
@@ -888,7 +1077,7 @@ void UiDriver_Init()
 void UiDriver_DrawFButtonLabel(uint8_t button_num, const char* label, uint32_t label_color)
 {
 	//UiLcdHy28_PrintTextCentered(BOTTOM_BAR_F1_X + (button_num - 1)*(POS_BOTTOM_BAR_BUTTON_W+2), POS_BOTTOM_BAR_F1_Y, BOTTOM_BAR_LABEL_W, label,
-	UiLcdHy28_PrintTextCentered(ts.Layout->BOTTOM_BAR.x+POS_BOTTOM_BAR_F1_offset + (button_num - 1)*(ts.Layout->BOTTOM_BAR.w+2), ts.Layout->BOTTOM_BAR.y, BOTTOM_BAR_LABEL_W, label,
+	UiLcdHy28_PrintTextCenteredRetained(ts.Layout->BOTTOM_BAR.x+POS_BOTTOM_BAR_F1_offset + (button_num - 1)*(ts.Layout->BOTTOM_BAR.w+2), ts.Layout->BOTTOM_BAR.y, BOTTOM_BAR_LABEL_W, label,
 			label_color, Black, 0);
 }
 
@@ -904,18 +1093,18 @@ void UiDriver_EncoderDisplay(const uint8_t row, const uint8_t column, const char
 
 	if(ts.Layout->ENCODER_MODE==MODE_HORIZONTAL)
 	{
-		UiLcdHy28_DrawEmptyRect(ts.Layout->ENCODER_IND.x + ENC_COL_W *2 * column + row *ENC_COL_W+column*Xspacing, ts.Layout->ENCODER_IND.y , ENC_ROW_H - 2, ENC_COL_W - 2, brdr_color);
-		UiLcdHy28_PrintTextCentered((ts.Layout->ENCODER_IND.x + 1 + ENC_COL_W * 2 * column + row *ENC_COL_W+column*Xspacing), (ts.Layout->ENCODER_IND.y + 1),ENC_COL_W - 3, label,
+		UiLcdHy28_DrawEmptyRectRetained(ts.Layout->ENCODER_IND.x + ENC_COL_W *2 * column + row *ENC_COL_W+column*Xspacing, ts.Layout->ENCODER_IND.y , ENC_ROW_H - 2, ENC_COL_W - 2, brdr_color);
+		UiLcdHy28_PrintTextCenteredRetained((ts.Layout->ENCODER_IND.x + 1 + ENC_COL_W * 2 * column + row *ENC_COL_W+column*Xspacing), (ts.Layout->ENCODER_IND.y + 1),ENC_COL_W - 3, label,
 				label_color, bg_color, 0);
-		UiLcdHy28_PrintTextRight((ts.Layout->ENCODER_IND.x + ENC_COL_W - 4 + ENC_COL_W * 2 * column+ row *ENC_COL_W+column*Xspacing), (ts.Layout->ENCODER_IND.y + 1 + ENC_ROW_2ND_OFF), temp,
+		UiLcdHy28_PrintTextRightRetained((ts.Layout->ENCODER_IND.x + ENC_COL_W - 4 + ENC_COL_W * 2 * column+ row *ENC_COL_W+column*Xspacing), (ts.Layout->ENCODER_IND.y + 1 + ENC_ROW_2ND_OFF), temp,
 				color, Black, 0);
 	}
 	else
 	{
-		UiLcdHy28_DrawEmptyRect(ts.Layout->ENCODER_IND.x + ENC_COL_W * column, ts.Layout->ENCODER_IND.y + row * ENC_ROW_H, ENC_ROW_H - 2, ENC_COL_W - 2, brdr_color);
-		UiLcdHy28_PrintTextCentered((ts.Layout->ENCODER_IND.x + 1 + ENC_COL_W * column), (ts.Layout->ENCODER_IND.y + 1 + row * ENC_ROW_H),ENC_COL_W - 3, label,
+		UiLcdHy28_DrawEmptyRectRetained(ts.Layout->ENCODER_IND.x + ENC_COL_W * column, ts.Layout->ENCODER_IND.y + row * ENC_ROW_H, ENC_ROW_H - 2, ENC_COL_W - 2, brdr_color);
+		UiLcdHy28_PrintTextCenteredRetained((ts.Layout->ENCODER_IND.x + 1 + ENC_COL_W * column), (ts.Layout->ENCODER_IND.y + 1 + row * ENC_ROW_H),ENC_COL_W - 3, label,
 				label_color, bg_color, 0);
-		UiLcdHy28_PrintTextRight((ts.Layout->ENCODER_IND.x + ENC_COL_W - 4 + ENC_COL_W * column), (ts.Layout->ENCODER_IND.y + 1 + row * ENC_ROW_H + ENC_ROW_2ND_OFF), temp,
+		UiLcdHy28_PrintTextRightRetained((ts.Layout->ENCODER_IND.x + ENC_COL_W - 4 + ENC_COL_W * column), (ts.Layout->ENCODER_IND.y + 1 + row * ENC_ROW_H + ENC_ROW_2ND_OFF), temp,
 				color, Black, 0);
 	}
 
@@ -2019,21 +2208,17 @@ static void UiDriver_CreateMeters()
 		}
 	}
 	// Draw meters
-	UiDriver_UpdateTopMeterA(34);
+	UiDriver_ResetMeters();
 	UiDriver_UpdateTopMeterA(0);
-	UiDriver_UpdateBtmMeter(34, 34);
 	UiDriver_UpdateBtmMeter(0, 34);
 
 }
 
-//*----------------------------------------------------------------------------
-//* Function Name       : UiDriverUpdateTopMeterA
-//* Object              : redraw indicator, same like upper implementation
-//* Input Parameters    : but no hold
-//* Output Parameters   :
-//* Functions called    :
-//*----------------------------------------------------------------------------
 #define SMETER_MAX_LEVEL 33
+#define METER_SEGMENT_PITCH     5   // pixels from one segment to the next, segments are 3 pixels wide
+#define METER_SEGMENT_WIDTH     3
+#define METER_SEGMENT_HEIGHT    3
+#define METER_PEAK_HOLD         25  // refresh ticks the peak segment stays before it decays, 0.5s at 50 Hz
 
 enum
 {
@@ -2041,103 +2226,157 @@ enum
 	METER_BTM,
 	METER_NUM
 };
+
+/**
+ * The meters are drawn incrementally: the colour of each segment on the display is cached,
+ * a redraw only writes the runs of segments whose colour changed, each run in a single window.
+ * A cleared or newly created meter is marked invalid and redrawn completely.
+ */
 typedef struct MeterState_s
 {
-	uint8_t last;
-	uint8_t last_warn;
+	uint8_t val;            // number of active segments
+	uint8_t warn;           // first segment shown in warning colour
+	uint8_t peak;           // peak hold segment, drawn active above val
+	uint8_t peak_hold;      // refresh ticks until the peak decays
+	uint16_t color;         // colour of the active segments below warn
+	bool valid;             // drawn[] reflects the display
+	uint16_t drawn[SMETER_MAX_LEVEL+1];
 } MeterState;
 
 static MeterState meters[METER_NUM];
 
-//*----------------------------------------------------------------------------
-//* Function Name       : UiDriverUpdateBtmMeter
-//* Object              : redraw indicator
-//* Input Parameters    : val=indicated value, warn=red warning threshold
-//* Output Parameters   :
-//* Functions called    :
-//*----------------------------------------------------------------------------
-
-static void UiDriver_UpdateMeter(uchar val, uchar warn, uint32_t color_norm, uint8_t meterId)
+static uint16_t UiDriver_MeterSegmentColor(const MeterState* meter, uint8_t segment)
 {
-	uchar     i;
-	const uint8_t v_s = 3;
-	uint32_t       col = color_norm;
-	uint8_t from, to;
-	uint8_t from_warn = 255;
+	uint16_t retval = Grid;
+	if (segment <= meter->val || segment == meter->peak)
+	{
+		retval = segment >= meter->warn ? Red2 : meter->color;
+	}
+	return retval;
+}
 
-	uint16_t ypos = meterId==METER_TOP?(ts.Layout->SM_IND.y + 28):(ts.Layout->SM_IND.y + 51 - BTM_MINUS);
+/**
+ * @brief draws the segments from..to (inclusive) including the gaps between them in one window
+ */
+static void UiDriver_DrawMeterSegments(uint8_t meterId, uint8_t from, uint8_t to, const uint16_t colors[])
+{
+	const uint16_t ypos = meterId==METER_TOP?(ts.Layout->SM_IND.y + 28):(ts.Layout->SM_IND.y + 51 - BTM_MINUS);
+	const uint16_t width = (to - from) * METER_SEGMENT_PITCH + METER_SEGMENT_WIDTH;
 
-	// limit meter
-	if(val > SMETER_MAX_LEVEL)
+	UiLcdHy28_BulkPixel_OpenWrite(ts.Layout->SM_IND.x + 18 + from * METER_SEGMENT_PITCH, width, ypos - METER_SEGMENT_HEIGHT, METER_SEGMENT_HEIGHT);
+	for (uint16_t row = 0; row < METER_SEGMENT_HEIGHT; row++)
 	{
-		val = SMETER_MAX_LEVEL;
+		for (uint16_t x = 0; x < width; x++)
+		{
+			UiLcdHy28_BulkPixel_Put(x % METER_SEGMENT_PITCH < METER_SEGMENT_WIDTH ? colors[from + x / METER_SEGMENT_PITCH] : Black);
+		}
 	}
-	if (warn == 0)
+	UiLcdHy28_BulkPixel_CloseWrite();
+}
+
+/**
+ * @brief brings the meter on the display up to date, only changed segments are drawn
+ */
+static void UiDriver_DrawMeter(uint8_t meterId)
+{
+	MeterState* meter = &meters[meterId];
+	uint16_t colors[SMETER_MAX_LEVEL+1];
+
+	// we never draw a zero, so we start from 1 min
+	for (uint8_t i = 1; i <= SMETER_MAX_LEVEL; i++)
 	{
-		warn = SMETER_MAX_LEVEL+1;    // never warn if warn == 0
+		colors[i] = UiDriver_MeterSegmentColor(meter, i);
 	}
 
-	if(warn != meters[meterId].last_warn)
+	for (uint8_t i = 1; i <= SMETER_MAX_LEVEL; i++)
 	{
-		if (warn < meters[meterId].last_warn)
+		if (meter->valid == false || colors[i] != meter->drawn[i])
 		{
-			from_warn = warn;
-		}
-		else
-		{
-			from_warn = meters[meterId].last_warn;
+			// collect the run of changed segments starting here
+			uint8_t to = i;
+			while (to < SMETER_MAX_LEVEL && (meter->valid == false || colors[to+1] != meter->drawn[to+1]))
+			{
+				to++;
+			}
+			UiDriver_DrawMeterSegments(meterId, i, to, colors);
+			i = to;
 		}
 	}
 
+	memcpy(meter->drawn, colors, sizeof(colors));
+	meter->valid = true;
+}
 
-	if(val != meters[meterId].last || from_warn != 255)
+/**
+ * @brief forgets what is on the display and the peaks, the next update redraws the complete meters
+ */
+static void UiDriver_ResetMeters()
+{
+	for (uint8_t meterId = 0; meterId < METER_NUM; meterId++)
 	{
+		meters[meterId].valid = false;
+		meters[meterId].val = 0;
+		meters[meterId].peak = 0;
+		meters[meterId].peak_hold = 0;
+	}
+}
 
-		// decide if we need to draw more boxes or delete some
-		if (val > meters[meterId].last)
-		{
-			// we will draw more active boxes
-			from = meters[meterId].last;
-			to = val+1;
+/**
+ * @brief sets the value of a meter and draws the segments which changed
+ * @param val number of active segments, limited to SMETER_MAX_LEVEL
+ * @param warn first segment shown in warning colour, 0 for none
+ * @param color_norm colour of the active segments below warn
+ */
+static void UiDriver_UpdateMeter(uchar val, uchar warn, uint32_t color_norm, uint8_t meterId)
+{
+	MeterState* meter = &meters[meterId];
 
-		}
-		else
-		{
-			from = val;
-			to   = meters[meterId].last+1;
-		}
-		if (from_warn < from)
-		{
-			from = from_warn;
-		}
+	// limit meter
+	if(val > SMETER_MAX_LEVEL)
+	{
+		val = SMETER_MAX_LEVEL;
+	}
+	if (warn == 0)
+	{
+		warn = SMETER_MAX_LEVEL+1;    // never warn if warn == 0
+	}
 
-		// Draw indicator
-		// we never draw a zero, so we start from 1 min
-		if (from == 0)
-		{
-			from = 1;
-		}
+	meter->val = val;
+	meter->warn = warn;
+	meter->color = color_norm;
+	if (val >= meter->peak)
+	{
+		meter->peak = val;
+		meter->peak_hold = METER_PEAK_HOLD;
+	}
 
-		for(i = from; i < to; i++)
+	UiDriver_DrawMeter(meterId);
+}
+
+/**
+ * @brief lets the peak segments decay, called at the meter refresh rate (SCTimer_METER)
+ * independent of how often the measured values are updated
+ */
+static void UiDriver_RefreshMeters()
+{
+	for (uint8_t meterId = 0; meterId < METER_NUM; meterId++)
+	{
+		MeterState* meter = &meters[meterId];
+		if (meter->valid)
 		{
-			if (i>val)
+			if (meter->peak_hold > 0)
 			{
-				col = Grid;    // switch to delete color
+				meter->peak_hold--;
 			}
-			if((i >= warn) && warn && col != Grid)    // is level above "warning" color? (is "warn" is zero, disable warning)
+			else if (meter->peak > meter->val)
 			{
-				col = Red2;                 // yes - display values above that color in red
+				meter->peak--;
+				UiDriver_DrawMeter(meterId);
 			}
-			// Lines
-			UiLcdHy28_DrawStraightLineTriple(((ts.Layout->SM_IND.x + 18) + i*5),(ypos - v_s),v_s,LCD_DIR_VERTICAL,col);
 		}
-
-		meters[meterId].last = val;
-		meters[meterId].last_warn = warn;
 	}
 }
 
-
 static void UiDriver_UpdateTopMeterA(uchar val)
 {
 	ulong clr;
@@ -2201,17 +2440,6 @@ static void UiDriver_InitFrequency()
 	df.temp_factor	= 0;
 	df.temp_factor_changed = false;
 	df.temp_enabled = 0;		// startup state of TCXO
-
-	// Set virtual segments initial value (diff than zero!)
-	df.dial_digits[8]	= 0;
-	df.dial_digits[7]	= 0;
-	df.dial_digits[6]	= 0;
-	df.dial_digits[5]	= 0;
-	df.dial_digits[4]	= 0;
-	df.dial_digits[3]	= 0;
-	df.dial_digits[2]	= 0;
-	df.dial_digits[1]	= 0;
-	df.dial_digits[0]	= 0;
 }
 
 /**
@@ -2342,20 +2570,23 @@ void UiDriver_UpdateFrequency(bool force_update, enum UpdateFrequencyMode_t mode
 
 
 
-static void UiDriver_UpdateFreqDisplay(ulong dial_freq, uint8_t* dial_digits, ulong pos_x_loc, ulong font_width, ulong pos_y_loc, ushort color, uchar digit_size)
+/**
+ * @brief draws the frequency as one retained line of digits and dots,
+ * so only digits which actually changed are sent to the display
+ */
+static void UiDriver_UpdateFreqDisplay(ulong dial_freq, ulong pos_x_loc, ulong font_width, ulong pos_y_loc, ushort color, uchar digit_size)
 {
 	{
 
 #define MAX_DIGITS 9
 		ulong dial_freq_temp;
-		int8_t pos_mult[MAX_DIGITS] = {9, 8, 7, 5, 4, 3, 1, 0, -1};
+		// position of the digits in the line, the first character of the line is at pos_x_loc - font_width
+		const uint8_t pos_line[MAX_DIGITS] = {10, 9, 8, 6, 5, 4, 2, 1, 0};
 		uint32_t idx;
 		uint8_t digits[MAX_DIGITS];
-		char digit[2];
+		char line[MAX_DIGITS + 3];
 		uint8_t last_non_zero = 0;
 
-		// Terminate string for digit
-		digit[1] = 0;
 		// calculate the digits
 		dial_freq_temp = dial_freq;
 		for (idx = 0; idx < MAX_DIGITS; idx++)
@@ -2366,25 +2597,19 @@ static void UiDriver_UpdateFreqDisplay(ulong dial_freq, uint8_t* dial_digits, ul
 		}
 		for (idx = 0; idx < MAX_DIGITS; idx++)
 		{
-			// -----------------------
-			// See if digit needs update
-			if ((digits[idx] != dial_digits[idx]) || ts.refresh_freq_disp)
-			{
-				bool noshow = idx > last_non_zero;
-				// don't show leading zeros, except for the 0th digits
-				digit[0] = noshow?' ':0x30 + (digits[idx] & 0x0F);
-				// Update segment
-				UiLcdHy28_PrintText((pos_x_loc + pos_mult[idx] * font_width), pos_y_loc, digit, color, Black, digit_size);
-			}
+			bool noshow = idx > last_non_zero;
+			// don't show leading zeros, except for the 0th digits
+			line[pos_line[idx]] = noshow?' ':0x30 + (digits[idx] & 0x0F);
 		}
 
 		for (idx = 3; idx < MAX_DIGITS; idx+=3)
 		{
 			bool noshow = last_non_zero < idx;
-			digit[0] = noshow?' ':'.';
-			UiLcdHy28_PrintText(pos_x_loc+ (pos_mult[idx]+1) * font_width,pos_y_loc,digit,color,Black,digit_size);
+			line[pos_line[idx]+1] = noshow?' ':'.';
 		}
+		line[MAX_DIGITS + 2] = '\0';
 
+		UiLcdHy28_PrintTextRetainedPitch(pos_x_loc - font_width, pos_y_loc, font_width, line, color, Black, digit_size);
 	}
 }
 
@@ -2402,7 +2627,6 @@ static void UiDriver_UpdateLcdFreq(ulong dial_freq,ushort color, ushort mode)
 	ulong		pos_y_loc;
 	ulong		pos_x_loc;
 	ulong		font_width;
-	uint8_t*		digits_ptr;
 
 	//
 	//
@@ -2461,21 +2685,18 @@ static void UiDriver_UpdateLcdFreq(ulong dial_freq,ushort color, ushort mode)
 	switch(mode)
 	{
 	case UFM_SMALL_RX:
-		digits_ptr  = df.dial_digits;
 		digit_size = 0;
 		pos_y_loc = ts.Layout->TUNE_FREQ.y;
 		pos_x_loc = ts.Layout->TUNE_SPLIT_FREQ_X;
 		font_width = SMALL_FONT_WIDTH;
 		break;
 	case UFM_SMALL_TX:					// small digits in lower location
-		digits_ptr  = df.dial_digits;
 		digit_size = 0;
 		pos_y_loc = ts.Layout->TUNE_SPLIT_FREQ_Y_TX;
 		pos_x_loc = ts.Layout->TUNE_SPLIT_FREQ_X;
 		font_width = SMALL_FONT_WIDTH;
 		break;
 	case UFM_SECONDARY:
-		digits_ptr  = df.sdial_digits;
 		digit_size = 0;
 		pos_y_loc = ts.Layout->TUNE_SFREQ.y;
 		pos_x_loc = ts.Layout->TUNE_SFREQ.x;
@@ -2483,7 +2704,6 @@ static void UiDriver_UpdateLcdFreq(ulong dial_freq,ushort color, ushort mode)
 		break;
 	case UFM_LARGE:
 	default:			// default:  normal sized (large) digits
-		digits_ptr  = df.dial_digits;
 #ifdef USE_8bit_FONT
 		digit_size=ts.FreqDisplayFont==0?1:5;
 #else
@@ -2497,15 +2717,14 @@ static void UiDriver_UpdateLcdFreq(ulong dial_freq,ushort color, ushort mode)
 	// use small display for display of the carrier frequency that the PLL has locked to
 	if(((ts.dmod_mode == DEMOD_SAM && mode == UFM_SMALL_RX) || (ts.dmod_mode == DEMOD_SAM && mode == UFM_SECONDARY)))
 	{
-		digits_ptr  = df.sdial_digits;
 		digit_size = 0;
 		pos_y_loc = ts.Layout->TUNE_SFREQ.y;
 		pos_x_loc = ts.Layout->TUNE_SFREQ.x;
 		font_width = SMALL_FONT_WIDTH;
-		UiDriver_UpdateFreqDisplay(dial_freq + ads.carrier_freq_offset, digits_ptr, pos_x_loc, font_width, pos_y_loc, Yellow, digit_size);
+		UiDriver_UpdateFreqDisplay(dial_freq + ads.carrier_freq_offset, pos_x_loc, font_width, pos_y_loc, Yellow, digit_size);
 	}
 	else {
-		UiDriver_UpdateFreqDisplay(dial_freq, digits_ptr, pos_x_loc, font_width, pos_y_loc, color, digit_size);
+		UiDriver_UpdateFreqDisplay(dial_freq, pos_x_loc, font_width, pos_y_loc, color, digit_size);
 	}
 }
 
@@ -2726,6 +2945,7 @@ static void UiDriver_TxRxUiSwitch(enum TRX_States_t state)
 		}
 	}
 
+	UiDriver_ResetMeters();              // the peaks of RX and TX readings have nothing in common
 	UiDriver_UpdateBtmMeter(0,0);        // clear bottom meter of any outstanding indication when going back to RX
 	if((ts.menu_mode))              // update menu when we are (or WERE) in MENU mode
 	{
@@ -5944,7 +6164,7 @@ void UiAction_ChangeFrequencyByTouch()
 		{
 			step = 40;					// adjust to 10Hz
 		}
-		if(sd.magnify == 5)
+		if(sd.magnify >= 5)
 		{
 			step = 4;					// adjust to 1Hz
 		}
@@ -6553,6 +6773,7 @@ typedef enum {
 	SCTimer_LODRIFT, // 64 * 10ms
 	SCTimer_VOLTAGE, // 8 * 10ms
 	SCTimer_SMETER, // 4 * 10ms
+	SCTimer_METER, // 2 * 10ms
 	SCTimer_MAIN, // 4 * 10ms
 	SCTimer_LEDBLINK, // 64 * 10ms
     SCTimer_SAM, // 25 * 10ms
@@ -6718,6 +6939,12 @@ void UiDriver_TaskHandler_MainTasks()
 		RadioManagement_HandlePttOnOff();
 	}
 
+	// the meters are refreshed with 50 Hz, the readings are updated with 25 Hz in STATE_S_METER below
+	if (UiDriver_TimerExpireAndRewind(SCTimer_METER,now,2))
+	{
+		UiDriver_RefreshMeters();
+	}
+
 	UiSpectrum_Redraw();
 
 	// Expect the code below to be executed around every 40 - 80ms.
@@ -6760,6 +6987,7 @@ void UiDriver_TaskHandler_MainTasks()
 					}
 				}
 				UiDriver_TextMsgDisplay();
+				UiDriver_SkimmerDisplay();
 			}
 			break;
 		case STATE_LO_TEMPERATURE:
@@ -6768,6 +6996,9 @@ void UiDriver_TaskHandler_MainTasks()
 				UiDriver_HandleLoTemperature();
 #if 1
 				ProfilingTimedEvent* pe_ptr = profileTimedEventGet(ProfileAudioInterrupt);
+				// we don't reset the event, its statistics can be read via CAT, we just look at what happened since the last time
+				static uint64_t last_duration;
+				static uint32_t last_count;
 
 				// Percent audio interrupt load  = Num of cycles per audio interrupt  / ((max num of cycles between two interrupts ) / 100 )
 				//
@@ -6775,8 +7006,16 @@ void UiDriver_TaskHandler_MainTasks()
 				// Max num of cycles between two interrupts / 100 = HCLK frequency / Interruptfrequenz -> e.g. 168000000 / 1500 / 100 = 1120
 				// FIXME: Need to figure out which clock is being used, 168000000 in mcHF, I40 UI = 168.000.000 or 216.000.000 or something else...
 
-				uint32_t load =  pe_ptr->duration / (pe_ptr->count * (1120));
-				profileTimedEventReset(ProfileAudioInterrupt);
+				if (pe_ptr->count < last_count)
+				{
+					// has been reset in the meantime
+					last_count = 0;
+					last_duration = 0;
+				}
+				const uint32_t count = pe_ptr->count - last_count;
+				uint32_t load = count != 0 ? (pe_ptr->duration - last_duration) / (count * (1120)) : 0;
+				last_duration = pe_ptr->duration;
+				last_count = pe_ptr->count;
 				char str[20];
 				snprintf(str,20,"L%3u%%",(unsigned int)load);
 				if(ts.show_debug_info)
@@ -118,14 +118,18 @@ drivers/audio/filters/iq_rx_filter_am.c \
 drivers/audio/filters/iq_tx_filter.c \
 drivers/audio/cw/cw_gen.c \
 drivers/audio/cw/cw_decoder.c \
+drivers/audio/cw/cw_bank.c \
+drivers/audio/cw/cw_bayes.c \
 drivers/audio/codec/codec.c \
 drivers/audio/codec/uhsdr_hw_i2s.c \
 drivers/audio/audio_driver.c \
 drivers/audio/audio_filter.c \
 drivers/audio/audio_nr.c \
+drivers/audio/audio_polyphase.c \
 drivers/audio/audio_management.c \
 drivers/audio/freedv_uhsdr.c \
 drivers/audio/freedv_test_data.c \
 drivers/audio/rtty.c \
 drivers/audio/psk.c \
+drivers/audio/psk_skimmer.c \
 drivers/ui/lcd/ui_lcd_layouts.c \
@@ -777,6 +777,7 @@ typedef struct TransceiverState
 
     uint8_t spectrum_size;              // size of waterfall display (and other parameters) - size setting is in lower nybble, upper nybble/byte reserved
     uint8_t	spectrum_filter;	// strength of filter in spectrum scope
+    uint8_t spectrum_avg_mode;      // averaging mode of the spectrum scope, see SPECTRUM_AVG_EXPONENTIAL
     uint8_t spectrum_centre_line_colour;    // color of center line of scope grid
     uint8_t spectrum_freqscale_colour;  // color of spectrum scope frequency scale
     uint8_t spectrum_agc_rate;      // agc rate on the 'scope
@@ -947,6 +948,7 @@ typedef struct TransceiverState
     bool	audio_dac_muting_flag;			// when TRUE, audio is to be muted after PTT/keyup
     bool	vfo_mem_flag;				// when TRUE, memory mode is enabled
     bool	mem_disp;				// when TRUE, memory display is enabled
+    bool	skimmer_disp;			// when TRUE, the text of the PSK or CW skimmer is shown instead of the spectrum display
     bool	load_eeprom_defaults;			// when TRUE, load EEPROM defaults into RAM when "UiDriverLoadEepromValues()" is called - MUST be saved by user IF these are to take effect!
     ulong	fm_subaudible_tone_gen_select;		// lookup ("tone number") used to index the table tone generation (0 corresponds to "tone disabled")
     uint8_t	fm_tone_burst_mode;			// this is the setting for the tone burst generator
@@ -1003,6 +1005,7 @@ typedef struct TransceiverState
 	uint8_t agc_wdsp_slope;
 	uint8_t agc_wdsp_hang_enable;
 	int     agc_wdsp_thresh;
+	uint8_t agc_wdsp_thresh_auto;	// threshold follows the noise floor measured by the spectrum display, agc_wdsp_thresh is not used then
 	int     agc_wdsp_hang_thresh;
 	int agc_wdsp_hang_time;
 	uint8_t agc_wdsp_action;
@@ -1015,6 +1018,9 @@ typedef struct TransceiverState
 //#define DISPLAY_S_METER_STD   0
 #define DISPLAY_S_METER_DBM   1
 #define DISPLAY_S_METER_DBMHZ 2
+#define DISPLAY_S_METER_NOISE 3     // noise floor in dBm
+#define DISPLAY_S_METER_SNR   4     // dBm reading above the noise floor
+#define DISPLAY_S_METER_MAX   DISPLAY_S_METER_SNR
 
 //    #define TX_FILTER_NONE			0
     #define TX_FILTER_SOPRANO		1
@@ -1096,8 +1102,8 @@ typedef struct TransceiverState
 //	bool nr_long_tone_reset; // used to reset gains of the long tone detection to 1.0
 //	int16_t nr_vad_delay; // how many frames to delay the noise estimate after VAD has detected NOISE
 //	int16_t nr_mode;
-	bool nr_fft_256_enable; // debugging: enable FFT256 instead of FFT128 for spectral NR
-	uint16_t NR_FFT_L; // resulting FFT length: 128 or 256
+	uint8_t nr_fft_size; // frame length of the spectral NR: NR_FFT_SIZE_SEL_128 ... NR_FFT_SIZE_SEL_512
+	uint16_t NR_FFT_L; // resulting FFT length: 128, 256 or 512, set via AudioNr_SetFftSize()
 	uint8_t NR_FFT_LOOP_NO;
 	bool NR_decimation_enable; // set to true, if we want to use another decimation step for the spectral NR leading to 6ksps sample rate
 	uint8_t debug_si5351a_pllreset;
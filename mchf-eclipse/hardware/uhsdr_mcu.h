@@ -36,6 +36,10 @@ typedef enum {
 #include "stm32f4xx.h"
 #include "stm32f407xx.h"
 #endif
+#ifdef HOST_BUILD
+// host-native build of the DSP code, see host-dsp.mak
+#include "host_mcu.h"
+#endif
 
 inline mchf_cpu_t MchfHW_Cpu()
 {
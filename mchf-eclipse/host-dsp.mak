@@ -0,0 +1,168 @@
+# host-native build of the audio DSP chain, see support/host-dsp/host_dsp.c and bench/bench_dsp.c
+# the sources are compiled with the STM32F4 headers and HOST_BUILD defined,
+# CMSIS-DSP comes from the C sources of the library, support/host-dsp provides the rest
+# use EXTRACFLAGS / HOSTLDFLAGS for instrumented builds, e.g. -fsanitize=address
+
+HOSTDSP_SRC := \
+drivers/audio/audio_driver.c \
+drivers/audio/audio_filter.c \
+drivers/audio/audio_management.c \
+drivers/audio/audio_nr.c \
+drivers/audio/audio_polyphase.c \
+drivers/audio/rtty.c \
+drivers/audio/psk.c \
+drivers/audio/psk_skimmer.c \
+drivers/audio/cw/cw_gen.c \
+drivers/audio/cw/cw_decoder.c \
+drivers/audio/cw/cw_bank.c \
+drivers/audio/cw/cw_bayes.c \
+drivers/audio/softdds/dds_table.c \
+drivers/audio/softdds/softdds.c \
+drivers/audio/filters/fir_rx_decimate_4.c \
+drivers/audio/filters/fir_rx_decimate_4_min_lpf.c \
+drivers/audio/filters/fir_rx_interpolate_16.c \
+drivers/audio/filters/fir_rx_interpolate_16_10kHz.c \
+drivers/audio/filters/iir_10k.c \
+drivers/audio/filters/iir_10k_neu.c \
+drivers/audio/filters/iir_15k_hpf_fm_squelch.c \
+drivers/audio/filters/iir_1_4k.c \
+drivers/audio/filters/iir_1_6k.c \
+drivers/audio/filters/iir_1_8k.c \
+drivers/audio/filters/iir_2_1k.c \
+drivers/audio/filters/iir_2_3k.c \
+drivers/audio/filters/iir_2_5k.c \
+drivers/audio/filters/iir_2_7k.c \
+drivers/audio/filters/iir_2_9k.c \
+drivers/audio/filters/iir_2k7_tx_bpf.c \
+drivers/audio/filters/iir_2k7_tx_bpf_fm.c \
+drivers/audio/filters/iir_300hz.c \
+drivers/audio/filters/iir_3_2k.c \
+drivers/audio/filters/iir_3_4k.c \
+drivers/audio/filters/iir_3_6k.c \
+drivers/audio/filters/iir_3_8k.c \
+drivers/audio/filters/iir_3k.c \
+drivers/audio/filters/iir_4_2k.c \
+drivers/audio/filters/iir_4_4k.c \
+drivers/audio/filters/iir_4_6k.c \
+drivers/audio/filters/iir_4_8k.c \
+drivers/audio/filters/iir_4k.c \
+drivers/audio/filters/iir_500hz.c \
+drivers/audio/filters/iir_5_5k.c \
+drivers/audio/filters/iir_5k.c \
+drivers/audio/filters/iir_6_5k.c \
+drivers/audio/filters/iir_6k.c \
+drivers/audio/filters/iir_7_5k.c \
+drivers/audio/filters/iir_7k.c \
+drivers/audio/filters/iir_8_5k.c \
+drivers/audio/filters/iir_8k.c \
+drivers/audio/filters/iir_8k5_hpf_fm_squelch.c \
+drivers/audio/filters/iir_9_5k.c \
+drivers/audio/filters/iir_9k.c \
+drivers/audio/filters/iir_antialias.c \
+drivers/audio/filters/iq_rx_filter.c \
+drivers/audio/filters/iq_rx_filter_am.c \
+drivers/audio/filters/iq_tx_filter.c \
+misc/profiling.c \
+support/host-dsp/host_dsp.c \
+support/host-dsp/host_radio.c \
+support/host-dsp/host_stubs.c \
+support/host-dsp/host_stubs_lcd.c \
+support/host-dsp/arm_math_host.c \
+
+# the display benchmarks run the real display driver and spectrum display on top of the DSP objects,
+# the display itself is emulated by support/host-dsp/host_lcd.c
+HOSTLCD_SRC := \
+drivers/ui/lcd/ui_lcd_hy28.c \
+drivers/ui/lcd/ui_lcd_hy28_fonts.c \
+drivers/ui/lcd/ui_lcd_layouts.c \
+drivers/ui/lcd/ui_spectrum.c \
+support/host-dsp/host_lcd.c \
+support/host-dsp/host_ui.c \
+bench/bench_lcd.c \
+
+HOSTDSP_DSPLIB_SRC := \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_add_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_dot_prod_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_mult_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_negate_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_offset_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_scale_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/BasicMathFunctions/arm_sub_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/CommonTables/arm_common_tables.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/CommonTables/arm_const_structs.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/ComplexMathFunctions/arm_cmplx_mag_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/ComplexMathFunctions/arm_cmplx_mag_squared_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FastMathFunctions/arm_cos_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FastMathFunctions/arm_sin_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_biquad_cascade_df1_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_biquad_cascade_df1_init_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_fir_decimate_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_fir_decimate_init_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_fir_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_fir_init_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_fir_interpolate_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_fir_interpolate_init_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_iir_lattice_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_iir_lattice_init_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_lms_norm_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/FilteringFunctions/arm_lms_norm_init_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/StatisticsFunctions/arm_max_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/StatisticsFunctions/arm_mean_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/StatisticsFunctions/arm_min_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/StatisticsFunctions/arm_power_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/StatisticsFunctions/arm_var_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/SupportFunctions/arm_copy_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/SupportFunctions/arm_fill_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/TransformFunctions/arm_bitreversal.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/TransformFunctions/arm_cfft_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/TransformFunctions/arm_cfft_radix8_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/TransformFunctions/arm_rfft_fast_f32.c \
+basesw/mcHF/Drivers/CMSIS/DSP_Lib/Source/TransformFunctions/arm_rfft_fast_init_f32.c \
+
+HOSTDSP_SUBDIRS := \
+support/host-dsp \
+$(SUBDIRS) \
+basesw/mcHF/Inc \
+basesw/mcHF/Drivers/CMSIS/Device/ST/STM32F4xx/Include \
+basesw/mcHF/Drivers/STM32F4xx_HAL_Driver/Inc \
+basesw/mcHF/Drivers/CMSIS/Include \
+basesw/mcHF/Middlewares/ST/STM32_USB_Device_Library/Core/Inc \
+
+HOSTCC ?= gcc
+HOSTDSP := hostdsp-$(TRX_ID)
+HOSTDSP_OBJDIR := host-obj
+HOSTBENCH := hostbench-$(TRX_ID)
+HOSTLCD := hostlcd-$(TRX_ID)
+
+HOSTDSP_CFLAGS := -DHOST_BUILD -DARM_MATH_CM4 -DCORTEX_M4 -DSTM32F407xx -D__FPU_PRESENT=1U \
+	-DUSE_HAL_DRIVER -D_GNU_SOURCE -DTRX_ID=\"$(TRX_ID)\" -DTRX_NAME=\"$(TRX_NAME)\" $(CONFIGFLAGS) \
+	-O2 -g -Wall -Wno-unused-function -Wno-int-to-pointer-cast -Wno-pointer-to-int-cast $(EXTRACFLAGS)
+
+HOSTDSP_INC_DIRS = $(foreach d, $(HOSTDSP_SUBDIRS), -I$(ROOTLOC)/$d)
+
+HOSTDSP_OBJS := $(addprefix $(HOSTDSP_OBJDIR)/,$(HOSTDSP_SRC:.c=.o))
+# the benchmarks include audio_driver.c to reach the static kernels and have their own main()
+HOSTBENCH_OBJS := $(filter-out %/audio_driver.o %/host_dsp.o,$(HOSTDSP_OBJS)) $(HOSTDSP_OBJDIR)/bench/bench_dsp.o
+HOSTLCD_OBJS := $(filter-out %/host_dsp.o %/host_stubs_lcd.o,$(HOSTDSP_OBJS)) $(addprefix $(HOSTDSP_OBJDIR)/,$(HOSTLCD_SRC:.c=.o))
+HOSTDSP_DSPLIB_OBJS := $(addprefix $(HOSTDSP_OBJDIR)/,$(HOSTDSP_DSPLIB_SRC:.c=.o))
+
+$(HOSTDSP_DSPLIB_OBJS): HOSTDSP_EXTRA_CFLAGS:= -Wno-strict-aliasing
+
+$(HOSTDSP_OBJDIR)/%.o: %.c
+	$(ECHO) "  [HOSTCC] $@"
+	@mkdir -p $(dir $@)
+	@$(HOSTCC) $(HOSTDSP_CFLAGS) $(HOSTDSP_EXTRA_CFLAGS) -std=gnu11 -MMD -MP -c $(HOSTDSP_INC_DIRS) $< -o $@
+
+$(HOSTDSP): $(HOSTDSP_OBJS) $(HOSTDSP_DSPLIB_OBJS)
+	$(ECHO) "  [HOSTLD] $@"
+	@$(HOSTCC) $(HOSTLDFLAGS) -o $@ $^ -lm
+
+$(HOSTBENCH): $(HOSTBENCH_OBJS) $(HOSTDSP_DSPLIB_OBJS)
+	$(ECHO) "  [HOSTLD] $@"
+	@$(HOSTCC) $(HOSTLDFLAGS) -o $@ $^ -lm
+
+$(HOSTLCD): $(HOSTLCD_OBJS) $(HOSTDSP_DSPLIB_OBJS)
+	$(ECHO) "  [HOSTLD] $@"
+	@$(HOSTCC) $(HOSTLDFLAGS) -o $@ $^ -lm
+
+-include $(HOSTDSP_OBJS:.o=.d) $(HOSTBENCH_OBJS:.o=.d) $(HOSTLCD_OBJS:.o=.d)
@@ -20,9 +20,72 @@
  * In order to read the counters here, you'll need to connect
  * using a real-time debugger, pause execution and read values.
  * Not a big deal with ST-Link and Eclipse or gdb.
+ * Alternatively use the UHSDR_PROFILE_GET CAT command, see cat_driver.c
  */
 EventProfile_t eventProfile;
 
+// external definitions, used wherever the compiler decides not to inline
+extern inline void profileTimedEventStart(const ProfiledEventNames pe);
+extern inline void profileTimedEventStop(const ProfiledEventNames pe);
+extern inline uint32_t profileHistogramBin(uint32_t cycles);
+extern inline void profileTimedEventRecord(const ProfiledEventNames pe, const uint32_t cycles);
+extern inline void profileStageStart(const ProfiledEventNames pe);
+extern inline void profileStageStop(const ProfiledEventNames pe);
+
+static const char* const eventNames[EventProfileMax] =
+{
+    [ProfileAudioInterrupt] = "AudioInterrupt",
+    [ProfileTP1] = "TP1",
+    [ProfileTP2] = "TP2",
+    [ProfileTP3] = "TP3",
+    [ProfileTP4] = "TP4",
+    [ProfileTP5] = "TP5",
+    [ProfileTP6] = "TP6",
+    [ProfileTP7] = "TP7",
+    [ProfileTP8] = "TP8",
+    [ProfileTP9] = "TP9",
+    [ProfileFreeDV] = "FreeDV",
+    [FreeDVTXUnderrun] = "FreeDVTXUnderrun",
+    [ProfileIqCorrection] = "IqCorrection",
+    [ProfileFreqConversion] = "FreqConversion",
+    [ProfileDecimation] = "Decimation",
+    [ProfileDemod] = "Demod",
+    [ProfileAgc] = "Agc",
+    [ProfileNoiseReduction] = "NoiseReduction",
+    [ProfileNotch] = "Notch",
+    [ProfileInterpolation] = "Interpolation",
+    [ProfileSpectrumCollect] = "SpectrumCollect",
+    [ProfileTxAudioFilter] = "TxAudioFilter",
+    [ProfileNoiseReductionTask] = "NoiseReductionTask",
+    [NrOverrun] = "NrOverrun",
+    [NrUnderrun] = "NrUnderrun",
+    [NrLate] = "NrLate",
+    [NrSkipped] = "NrSkipped",
+};
+
+const char* profileTimedEventName(const ProfiledEventNames pe)
+{
+    return (pe < EventProfileMax && pe >= 0) ? eventNames[pe] : NULL;
+}
+
+/**
+ * @brief records the accumulated cycles of all audio interrupt stages which ran in this block
+ * to be called once at the end of each audio interrupt
+ */
+void profileStagesCommit()
+{
+#ifdef PROFILE_EVENTS
+    for (ProfiledEventNames pe = PROFILE_STAGE_FIRST; pe <= PROFILE_STAGE_LAST; pe++)
+    {
+        if (eventProfile.event[pe].pending != 0)
+        {
+            profileTimedEventRecord(pe, eventProfile.event[pe].pending);
+            eventProfile.event[pe].pending = 0;
+        }
+    }
+#endif
+}
+
 #if 0
 // the code below is only used to ease profiling with eclipse
 // you just need hover over a variable to get the value
@@ -28,14 +28,44 @@ typedef enum {
     ProfileTP9,
     ProfileFreeDV,
     FreeDVTXUnderrun,
+    // stages of the audio interrupt, recorded once per block with profileStagesCommit()
+    ProfileIqCorrection,
+    ProfileFreqConversion,
+    ProfileDecimation,
+    ProfileDemod,
+    ProfileAgc,
+    ProfileNoiseReduction,
+    ProfileNotch,
+    ProfileInterpolation,
+    ProfileSpectrumCollect,
+    ProfileTxAudioFilter,
+    // the noise reduction running outside the audio interrupt
+    ProfileNoiseReductionTask,
+    // frame accounting of the noise reduction, see alternateNR_handle()
+    NrOverrun, // audio interrupt dropped a frame, all NR buffers were in use
+    NrUnderrun, // audio interrupt found no processed frame and played the audio unprocessed
+    NrLate, // frame finished after the next one had arrived
+    NrSkipped, // frame passed through unprocessed to catch up
     EventProfileMax
 } ProfiledEventNames;
 
+#define PROFILE_STAGE_FIRST ProfileIqCorrection
+#define PROFILE_STAGE_LAST  ProfileTxAudioFilter
+
+// histogram bin 0 counts durations below 2^PROFILE_HIST_SHIFT cycles, each following bin covers twice the range of the previous one
+// the last bin counts everything above, at 168 MHz bin 8 contains the 0.66ms audio block period
+#define PROFILE_HIST_SHIFT 10
+#define PROFILE_HIST_BINS  10
+
 typedef struct {
     uint32_t count;
     uint32_t start;
     uint32_t stop;
     uint64_t duration; // to get average divide duration by count
+    uint32_t min;
+    uint32_t max;
+    uint32_t pending; // cycles of a stage accumulated during the current audio block
+    uint32_t hist[PROFILE_HIST_BINS];
 } ProfilingTimedEvent;
 
 typedef struct {
@@ -73,9 +103,15 @@ inline void profileEvent(const ProfiledEventNames pe) {
  * outer events include the overhead of the calculation of the duration
  * only the innermost events are more or less accurate unless you time the profile functions and
  * remove the overhead later.
+ *
+ * Besides count and total duration each event keeps min, max and a histogram
+ * of the durations. The audio interrupt stages use profileStageStart()/profileStageStop()
+ * instead, see there. All of it can be read over the CAT interface, see cat_driver.c.
  */
 
 void profileEventsTracePrint();
+void profileStagesCommit();
+const char* profileTimedEventName(const ProfiledEventNames pe);
 
 
 inline void profileTimedEventInit();
@@ -83,6 +119,8 @@ inline void profileTimedEventStart(const ProfiledEventNames pe);
 inline void profileTimedEventStop(const ProfiledEventNames pe);
 inline void profileTimedEventReset(const ProfiledEventNames pe);
 inline  ProfilingTimedEvent* profileTimedEventGet(const ProfiledEventNames pe);
+inline void profileStageStart(const ProfiledEventNames pe);
+inline void profileStageStop(const ProfiledEventNames pe);
 
 
 // INLINE IMPLEMENTATIONS
@@ -92,6 +130,24 @@ inline  ProfilingTimedEvent* profileTimedEventGet(const ProfiledEventNames pe);
 #define SCB_DEMCR     ((volatile uint32_t *)0xE000EDFC)
 #define DWT_LAR       ((volatile uint32_t *)0xE0001FB0)
 
+#ifdef HOST_BUILD
+// no DWT on the host, we use a cycle count derived from the host clock
+inline void profileCycleCount_reset(){
+}
+
+inline void profileCycleCount_start()
+{
+}
+
+inline void profileCycleCount_stop()
+{
+}
+
+inline uint32_t profileCycleCount_get()
+{
+    return HostMcu_CycleCount();
+}
+#else
 inline void profileCycleCount_reset(){
     *SCB_DEMCR   |= 0x01000000;
 #ifdef STM32F7
@@ -115,6 +171,7 @@ inline uint32_t profileCycleCount_get()
 {
     return *DWT_CYCCNT;
 }
+#endif
 
 inline void profileTimedEventInit()
 {
@@ -122,6 +179,44 @@ inline void profileTimedEventInit()
     profileCycleCount_start();
 }
 
+inline uint32_t profileHistogramBin(uint32_t cycles)
+{
+    uint32_t bin = 0;
+    cycles >>= PROFILE_HIST_SHIFT;
+    if (cycles != 0)
+    {
+        bin = 32 - __builtin_clz(cycles);
+        if (bin >= PROFILE_HIST_BINS)
+        {
+            bin = PROFILE_HIST_BINS - 1;
+        }
+    }
+    return bin;
+}
+
+/**
+ * @brief adds a single measured duration to the statistics of an event
+ */
+inline void profileTimedEventRecord(const ProfiledEventNames pe, const uint32_t cycles)
+{
+#ifdef PROFILE_EVENTS
+    if (pe<EventProfileMax && pe >= 0) {
+        ProfilingTimedEvent* ev = &eventProfile.event[pe];
+        if (ev->count == 0 || cycles < ev->min)
+        {
+            ev->min = cycles;
+        }
+        if (cycles > ev->max)
+        {
+            ev->max = cycles;
+        }
+        ev->count++;
+        ev->duration += cycles;
+        ev->hist[profileHistogramBin(cycles)]++;
+    }
+#endif
+}
+
 inline void profileTimedEventStart(const ProfiledEventNames pe)
 {
 #ifdef PROFILE_EVENTS
@@ -138,11 +233,31 @@ inline void profileTimedEventStop(const ProfiledEventNames pe)
     uint32_t stop = profileCycleCount_get();
     if (pe<EventProfileMax && pe >= 0) {
         eventProfile.event[pe].stop = stop;
-        eventProfile.event[pe].count++;
-        eventProfile.event[pe].duration += (eventProfile.event[pe].stop-eventProfile.event[pe].start);
+        profileTimedEventRecord(pe, eventProfile.event[pe].stop-eventProfile.event[pe].start);
     }
 #endif
 
+}
+
+/**
+ * Stages may be entered several times per audio block (e.g. the spectrum collect
+ * before and after the frequency conversion), so the stop only accumulates the cycles.
+ * profileStagesCommit() at the end of the audio interrupt records the sum as one event.
+ */
+inline void profileStageStart(const ProfiledEventNames pe)
+{
+    profileTimedEventStart(pe);
+}
+
+inline void profileStageStop(const ProfiledEventNames pe)
+{
+#ifdef PROFILE_EVENTS
+    uint32_t stop = profileCycleCount_get();
+    if (pe<EventProfileMax && pe >= 0) {
+        eventProfile.event[pe].stop = stop;
+        eventProfile.event[pe].pending += (stop - eventProfile.event[pe].start);
+    }
+#endif
 }
 inline void profileTimedEventReset(const ProfiledEventNames pe)
 {
@@ -152,6 +267,13 @@ inline void profileTimedEventReset(const ProfiledEventNames pe)
         eventProfile.event[pe].stop = 0;
         eventProfile.event[pe].count = 0;
         eventProfile.event[pe].duration = 0;
+        eventProfile.event[pe].min = 0;
+        eventProfile.event[pe].max = 0;
+        eventProfile.event[pe].pending = 0;
+        for (int bin = 0; bin < PROFILE_HIST_BINS; bin++)
+        {
+            eventProfile.event[pe].hist[bin] = 0;
+        }
     }
 #endif
 }
@@ -249,6 +249,7 @@ void TransceiverStateInit(void)
 
     // spectrum general settings
     ts.spectrum_filter      = SPECTRUM_FILTER_DEFAULT;  // default filter strength for spectrum scope
+    ts.spectrum_avg_mode    = SPECTRUM_AVG_DEFAULT;     // default averaging mode for spectrum scope
     ts.spectrum_centre_line_colour = SPEC_COLOUR_GRID_DEFAULT;      // color of center line of scope grid
     ts.spectrum_freqscale_colour    = SPEC_COLOUR_SCALE_DEFAULT;        // default colour for the spectrum scope frequency scale at the bottom
     ts.spectrum_db_scale = DB_DIV_10;               // default to 10dB/division
@@ -285,6 +286,7 @@ void TransceiverStateInit(void)
     ts.filter_disp_colour = FILTER_DISP_COLOUR_DEFAULT;
     ts.vfo_mem_flag = 0;						// when TRUE, memory mode is enabled
     ts.mem_disp = 0;						// when TRUE, memory display is enabled
+    ts.skimmer_disp = 0;					// when TRUE, the skimmer text replaces the spectrum display
     ts.load_eeprom_defaults = 0;					// when TRUE, defaults are loaded when "UiDriverLoadEepromValues()" is called - must be saved by user w/power-down to be permanent!
     ts.fm_subaudible_tone_gen_select = 0;				// lookup ("tone number") used to index the table generation (0 corresponds to "tone disabled")
     ts.fm_tone_burst_mode = 0;					// this is the setting for the tone burst generator
@@ -316,7 +318,7 @@ void TransceiverStateInit(void)
     ts.tx_bass_gain = 4;					// gain of the TX low shelf EQ filter
     ts.tx_treble_gain = 4;					// gain of the TX high shelf EQ filter
     ts.s_meter = 1;							// S-Meter configuration, 0 = old school, 1 = dBm-based, 2=dBm/Hz-based
-    ts.display_dbm = 0;						// style of dBm display, 0=OFF, 1= dbm, 2= dbm/Hz
+    ts.display_dbm = 0;						// style of dBm display, 0=OFF, 1= dbm, 2= dbm/Hz, 3= noise floor dBm, 4= SNR
 //    ts.dBm_count = 0;						// timer start
     ts.tx_filter = 0;						// which TX filter has been chosen by the user
     ts.iq_auto_correction = 1;              // disable/enable automatic IQ correction
@@ -330,6 +332,7 @@ void TransceiverStateInit(void)
     ts.agc_wdsp_hang_time = 500;
     ts.agc_wdsp_hang_thresh = 45;
     ts.agc_wdsp_thresh = 60;
+    ts.agc_wdsp_thresh_auto = 0;
     ts.agc_wdsp_action = 0;
     ts.agc_wdsp_switch_mode = 1;
     ts.agc_wdsp_hang_action = 0;
@@ -368,7 +371,7 @@ void TransceiverStateInit(void)
 	ts.nr_first_time = 1;
 //	ts.nr_vad_delay = 7;
 	ts.NR_decimation_enable = true;
-	ts.nr_fft_256_enable = true;
+	ts.nr_fft_size = NR_FFT_SIZE_SEL_256;
 	NR2.width = 4;
 	NR2.power_threshold = 0.40;
 	NR2.power_threshold_int = 40;
@@ -521,6 +524,10 @@ int mchfMain(void)
 	}
     profileTimedEventInit();
 
+#ifdef USE_ALTERNATE_NR
+    // derive the NR frame length from the loaded configuration
+    AudioNr_SetFftSize(ts.nr_fft_size);
+#endif
 
     // Audio HW init
     AudioDriver_Init();
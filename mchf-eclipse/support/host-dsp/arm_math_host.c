@@ -0,0 +1,61 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     arm_math_host.c                                                 **
+ **  Description:   portable versions of CMSIS-DSP functions for the host build     **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+/*
+ * The host-native DSP build uses the CMSIS-DSP C sources from basesw/mcHF/Drivers/CMSIS/DSP_Lib
+ * for all floating point functions, so results match the firmware closely.
+ * The functions here are those which exist only as ARM assembly or use ARM SIMD
+ * intrinsics in the CMSIS sources, plus C library functions newer glibc versions dropped.
+ */
+
+#include "arm_math.h"
+
+/**
+ * @brief C implementation of arm_bitreversal2.S, used by arm_cfft_f32()
+ */
+void arm_bitreversal_32(uint32_t * pSrc, const uint16_t bitRevLen, const uint16_t * pBitRevTab)
+{
+    for (uint32_t i = 0; i < bitRevLen; i += 2)
+    {
+        const uint32_t a = pBitRevTab[i] >> 2;
+        const uint32_t b = pBitRevTab[i + 1] >> 2;
+
+        uint32_t tmp = pSrc[a];
+        pSrc[a] = pSrc[b];
+        pSrc[b] = tmp;
+
+        tmp = pSrc[a + 1];
+        pSrc[a + 1] = pSrc[b + 1];
+        pSrc[b + 1] = tmp;
+    }
+}
+
+/**
+ * @brief replaces the CMSIS version which packs two samples with __PKHBT
+ */
+void arm_fill_q15(q15_t value, q15_t * pDst, uint32_t blockSize)
+{
+    for (uint32_t i = 0; i < blockSize; i++)
+    {
+        pDst[i] = value;
+    }
+}
+
+/**
+ * @brief newlib still has pow10f, glibc removed it in 2.27
+ */
+float pow10f(float x)
+{
+    return powf(10.0f, x);
+}
@@ -0,0 +1,390 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_dsp.c                                                      **
+ **  Description:   runs the firmware audio DSP chain on recorded files             **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+/*
+ * Feeds a 48ksps 16 bit stereo file (WAV or raw, little endian) block by block through
+ * AudioDriver_I2SCallback(), exactly as the I2S DMA interrupt does on the radio,
+ * and writes the codec output to another file.
+ *
+ * RX: input is I/Q (left = I, right = Q), output is speaker (left) / line out (right)
+ * TX: input is mic/line audio, output is I/Q
+ *
+ * Text from the CW/RTTY/PSK decoders is printed to stdout, timing statistics to stderr.
+ *
+ * Build with "make host-dsp", run without arguments for help.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "uhsdr_board.h"
+#include "profiling.h"
+#include "audio_driver.h"
+#include "audio_management.h"
+#include "audio_nr.h"
+#include "cw_decoder.h"
+#include "radio_management.h"
+#include "ui_configuration.h"
+#include "uhsdr_hw_i2s.h"
+#include "host_dsp.h"
+
+// one I2S interrupt processes half of the DMA buffer
+#define HOST_DSP_BLOCK_LEN  (BUFF_LEN/2)
+#define HOST_DSP_BLOCK_US   (1000000.0 * HOST_DSP_BLOCK_LEN / 2 / IQ_SAMPLE_RATE)
+#define HOST_DSP_BLOCKS_PER_SEC (IQ_SAMPLE_RATE * 2 / HOST_DSP_BLOCK_LEN)
+
+typedef struct
+{
+    const char* name;
+    uint8_t dmod_mode;
+    uint8_t digital_mode;
+    uint16_t width;         // default filter bandwidth in Hz
+} HostDspMode;
+
+static const HostDspMode host_dsp_modes[] =
+{
+    { "usb",  DEMOD_USB,  DigitalMode_None, 2700 },
+    { "lsb",  DEMOD_LSB,  DigitalMode_None, 2700 },
+    { "cw",   DEMOD_CW,   DigitalMode_None, 500 },
+    { "am",   DEMOD_AM,   DigitalMode_None, 5000 },
+    { "sam",  DEMOD_SAM,  DigitalMode_None, 5000 },
+    { "fm",   DEMOD_FM,   DigitalMode_None, 0 },
+#ifdef USE_RTTY_PROCESSOR
+    { "rtty", DEMOD_DIGI, DigitalMode_RTTY, 2700 },
+#endif
+    { "psk",  DEMOD_DIGI, DigitalMode_BPSK, 2700 },
+    { NULL,   0,          0,                0 }
+};
+
+static void HostDsp_Usage(const char* prog)
+{
+    fprintf(stderr,
+            "usage: %s [options] <infile> <outfile>\n"
+            "  infile/outfile: 48ksps 16 bit stereo, WAV if the name ends with .wav, raw otherwise\n"
+            "  -m <mode>   usb, lsb, cw, am, sam, fm, rtty, psk (default usb)\n"
+            "  -p <path>   filter path index (default: first path of the mode with the default width)\n"
+            "  -w <width>  use first filter path of the mode with at least this bandwidth in Hz\n"
+            "  -l          list filter paths applicable for the mode and exit\n"
+            "  -n          enable spectral noise reduction\n"
+            "  -f <len>    frame length of the noise reduction, %d ... %d (default 256)\n"
+            "  -a          enable automatic notch filter\n"
+            "  -b <level>  noise blanker setting\n"
+            "  -c <conv>   I/Q frequency conversion mode (default %d)\n"
+            "  -k <timing> timing of the CW decoder: classic, bayes (default classic)\n"
+            "  -t          transmit: infile is mic audio, outfile receives I/Q\n"
+            "  -s <blocks> hold off the PendSV tasks for this many blocks every second, as a busy CPU would\n"
+            "  -q          no timing statistics\n",
+            prog, NR_FFT_L_MIN, NR_FFT_L_MAX, FREQ_IQ_CONV_MODE_DEFAULT);
+}
+
+static bool HostDsp_IsWav(const char* name)
+{
+    const size_t len = strlen(name);
+    return len > 4 && strcasecmp(&name[len-4],".wav") == 0;
+}
+
+/**
+ * @brief skips the WAV header, only checks for the format we can process
+ * @returns true if the file can be read as 16 bit stereo
+ */
+static bool HostDsp_WavReadHeader(FILE* f)
+{
+    uint8_t hdr[12];
+    bool retval = false;
+
+    if (fread(hdr,1,12,f) == 12 && memcmp(hdr,"RIFF",4) == 0 && memcmp(&hdr[8],"WAVE",4) == 0)
+    {
+        uint8_t chunk[8];
+        while (fread(chunk,1,8,f) == 8)
+        {
+            const uint32_t chunk_len = chunk[4] | chunk[5] << 8 | chunk[6] << 16 | chunk[7] << 24;
+            if (memcmp(chunk,"fmt ",4) == 0)
+            {
+                uint8_t fmt[16];
+                if (chunk_len < 16 || fread(fmt,1,16,f) != 16)
+                {
+                    break;
+                }
+                const uint16_t channels = fmt[2] | fmt[3] << 8;
+                const uint32_t rate = fmt[4] | fmt[5] << 8 | fmt[6] << 16 | fmt[7] << 24;
+                const uint16_t bits = fmt[14] | fmt[15] << 8;
+                if (channels != 2 || bits != 16)
+                {
+                    fprintf(stderr,"WAV must be 16 bit stereo\n");
+                    break;
+                }
+                if (rate != IQ_SAMPLE_RATE)
+                {
+                    fprintf(stderr,"warning: WAV sample rate is %u, processing as %u\n", rate, IQ_SAMPLE_RATE);
+                }
+                fseek(f,chunk_len - 16 + (chunk_len & 1),SEEK_CUR);
+            }
+            else if (memcmp(chunk,"data",4) == 0)
+            {
+                retval = true;
+                break;
+            }
+            else
+            {
+                fseek(f,chunk_len + (chunk_len & 1),SEEK_CUR);
+            }
+        }
+    }
+    return retval;
+}
+
+static void HostDsp_Put16(uint8_t* p, uint16_t v)
+{
+    p[0] = v & 0xff;
+    p[1] = v >> 8;
+}
+
+static void HostDsp_Put32(uint8_t* p, uint32_t v)
+{
+    HostDsp_Put16(p, v & 0xffff);
+    HostDsp_Put16(p+2, v >> 16);
+}
+
+/**
+ * @brief writes a 16 bit stereo WAV header, call again with the final data length at the end
+ */
+static void HostDsp_WavWriteHeader(FILE* f, uint32_t data_len)
+{
+    uint8_t hdr[44];
+    memcpy(&hdr[0],"RIFF",4);
+    HostDsp_Put32(&hdr[4],36 + data_len);
+    memcpy(&hdr[8],"WAVEfmt ",8);
+    HostDsp_Put32(&hdr[16],16);
+    HostDsp_Put16(&hdr[20],1);                      // PCM
+    HostDsp_Put16(&hdr[22],2);                      // stereo
+    HostDsp_Put32(&hdr[24],IQ_SAMPLE_RATE);
+    HostDsp_Put32(&hdr[28],IQ_SAMPLE_RATE * 4);
+    HostDsp_Put16(&hdr[32],4);
+    HostDsp_Put16(&hdr[34],16);
+    memcpy(&hdr[36],"data",4);
+    HostDsp_Put32(&hdr[40],data_len);
+    fseek(f,0,SEEK_SET);
+    fwrite(hdr,1,sizeof(hdr),f);
+}
+
+int main(int argc, char* argv[])
+{
+    const HostDspMode* mode = &host_dsp_modes[0];
+    int filter_path = -1;
+    int width = -1;
+    bool list_paths = false;
+    bool transmit = false;
+    bool quiet = false;
+    int stall_blocks = 0;
+    uint8_t dsp_active = 0;
+    int opt;
+
+    HostDsp_TransceiverStateInit();
+
+    while ((opt = getopt(argc, argv, "m:p:w:lnf:ab:c:k:ts:q")) != -1)
+    {
+        switch (opt)
+        {
+        case 'm':
+            for (mode = host_dsp_modes; mode->name != NULL && strcmp(mode->name,optarg) != 0; mode++);
+            if (mode->name == NULL)
+            {
+                fprintf(stderr,"unknown mode %s\n",optarg);
+                return 1;
+            }
+            break;
+        case 'p':
+            filter_path = atoi(optarg);
+            if (filter_path < 0 || filter_path >= AUDIO_FILTER_PATH_NUM)
+            {
+                fprintf(stderr,"filter path must be 0..%d\n", AUDIO_FILTER_PATH_NUM - 1);
+                return 1;
+            }
+            break;
+        case 'w':
+            width = atoi(optarg);
+            break;
+        case 'l':
+            list_paths = true;
+            break;
+        case 'n':
+            dsp_active |= DSP_NR_ENABLE;
+            break;
+        case 'f':
+            for (ts.nr_fft_size = NR_FFT_SIZE_SEL_128; ts.nr_fft_size <= NR_FFT_SIZE_SEL_MAX && (NR_FFT_L_MIN << ts.nr_fft_size) != atoi(optarg); ts.nr_fft_size++);
+            if (ts.nr_fft_size > NR_FFT_SIZE_SEL_MAX)
+            {
+                fprintf(stderr,"frame length must be a power of two from %d to %d\n", NR_FFT_L_MIN, NR_FFT_L_MAX);
+                return 1;
+            }
+            break;
+        case 'a':
+            dsp_active |= DSP_NOTCH_ENABLE;
+            break;
+        case 'b':
+            ts.nb_setting = atoi(optarg);
+            break;
+        case 'c':
+            ts.iq_freq_mode = atoi(optarg);
+            break;
+        case 'k':
+            if (strcmp(optarg,"classic") == 0)
+            {
+                cw_decoder_config.timing = CW_TIMING_CLASSIC;
+            }
+            else if (strcmp(optarg,"bayes") == 0)
+            {
+                cw_decoder_config.timing = CW_TIMING_BAYES;
+            }
+            else
+            {
+                fprintf(stderr,"unknown CW decoder timing %s\n",optarg);
+                return 1;
+            }
+            break;
+        case 't':
+            transmit = true;
+            break;
+        case 's':
+            stall_blocks = atoi(optarg);
+            break;
+        case 'q':
+            quiet = true;
+            break;
+        default:
+            HostDsp_Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (list_paths)
+    {
+        const uint16_t filter_mode = AudioFilter_GetFilterModeFromDemodMode(mode->dmod_mode);
+        for (int idx = 0; idx < AUDIO_FILTER_PATH_NUM; idx++)
+        {
+            if (AudioFilter_IsApplicableFilterPath(PATH_ALL_APPLICABLE, filter_mode, idx))
+            {
+                const char* names[2];
+                AudioFilter_GetNamesOfFilterPath(idx, names);
+                printf("%2d: %s %s (%u ksps)\n", idx, names[0], names[1] != NULL ? names[1] : "",
+                        IQ_SAMPLE_RATE / 1000 / FilterPathInfo[idx].sample_rate_dec);
+            }
+        }
+        return 0;
+    }
+
+    if (argc - optind != 2)
+    {
+        HostDsp_Usage(argv[0]);
+        return 1;
+    }
+
+    FILE* in = fopen(argv[optind],"rb");
+    if (in == NULL)
+    {
+        perror(argv[optind]);
+        return 1;
+    }
+    if (HostDsp_IsWav(argv[optind]) && HostDsp_WavReadHeader(in) == false)
+    {
+        fprintf(stderr,"%s: not a usable WAV file\n", argv[optind]);
+        return 1;
+    }
+
+    FILE* out = fopen(argv[optind+1],"wb");
+    if (out == NULL)
+    {
+        perror(argv[optind+1]);
+        return 1;
+    }
+    const bool out_wav = HostDsp_IsWav(argv[optind+1]);
+    if (out_wav)
+    {
+        HostDsp_WavWriteHeader(out,0);
+    }
+
+    HostDsp_RadioInit();
+
+    ts.dsp_active = dsp_active;
+    HostDsp_SetDemodMode(mode->dmod_mode, mode->digital_mode, filter_path, width >= 0 ? width : mode->width);
+    AudioDriver_SetRxAudioProcessing(ts.dmod_mode, true);
+
+    if (transmit)
+    {
+        ts.txrx_mode = TRX_MODE_TX;
+    }
+
+    int16_t src[HOST_DSP_BLOCK_LEN], dst[HOST_DSP_BLOCK_LEN], audio_dst[HOST_DSP_BLOCK_LEN];
+    uint32_t blocks = 0;
+    uint32_t data_len = 0;
+    size_t samples;
+
+    for (ProfiledEventNames pe = 0; pe < EventProfileMax; pe++)
+    {
+        profileTimedEventReset(pe);
+    }
+
+    while ((samples = fread(src, sizeof(int16_t), HOST_DSP_BLOCK_LEN, in)) > 0)
+    {
+        // a partial block at the end of the file is padded with silence
+        memset(&src[samples], 0, (HOST_DSP_BLOCK_LEN - samples) * sizeof(int16_t));
+
+        profileTimedEventStart(ProfileAudioInterrupt);
+        AudioDriver_I2SCallback(src, dst, audio_dst, HOST_DSP_BLOCK_LEN);
+        profileTimedEventStop(ProfileAudioInterrupt);
+        profileStagesCommit();
+
+        // the interrupt requested the PendSV handler
+        if ((host_scb.ICSR & SCB_ICSR_PENDSVSET_Msk) && blocks % HOST_DSP_BLOCKS_PER_SEC >= stall_blocks)
+        {
+            host_scb.ICSR &= ~SCB_ICSR_PENDSVSET_Msk;
+            HostDsp_HighPrioTasks();
+        }
+
+        data_len += fwrite(dst, sizeof(int16_t), HOST_DSP_BLOCK_LEN, out) * sizeof(int16_t);
+        blocks++;
+    }
+
+    if (out_wav)
+    {
+        HostDsp_WavWriteHeader(out, data_len);
+    }
+    fclose(out);
+    fclose(in);
+
+    if (quiet == false && blocks > 0)
+    {
+        fprintf(stderr,"\n%u blocks of %d samples, mode %s, filter path %u, block period %.1f us\n",
+                blocks, HOST_DSP_BLOCK_LEN/2, mode->name, ts.filter_path, HOST_DSP_BLOCK_US);
+        fprintf(stderr,"%-20s %8s %10s %10s %10s\n", "event", "count", "min us", "mean us", "max us");
+        for (ProfiledEventNames pe = 0; pe < EventProfileMax; pe++)
+        {
+            const ProfilingTimedEvent* ev = profileTimedEventGet(pe);
+            if (ev->count != 0 && ev->duration != 0)
+            {
+                fprintf(stderr,"%-20s %8u %10.2f %10.2f %10.2f\n", profileTimedEventName(pe), ev->count,
+                        ev->min / 168.0, (double)ev->duration / ev->count / 168.0, ev->max / 168.0);
+            }
+            else if (ev->count != 0)
+            {
+                // events which are only counted
+                fprintf(stderr,"%-20s %8u %10s %10s %10s\n", profileTimedEventName(pe), ev->count, "-", "-", "-");
+            }
+        }
+    }
+
+    return 0;
+}
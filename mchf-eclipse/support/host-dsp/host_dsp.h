@@ -0,0 +1,31 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_dsp.h                                                      **
+ **  Description:   common functions of the host-native DSP programs                **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+#ifndef __HOST_DSP_H
+#define __HOST_DSP_H
+
+#include <stdint.h>
+
+void HostDsp_TransceiverStateInit(void);
+void HostDsp_RadioInit(void);
+uint8_t HostDsp_FindFilterPath(uint8_t dmod_mode, uint16_t width);
+void HostDsp_SetDemodMode(uint8_t dmod_mode, uint8_t digital_mode, int filter_path, uint16_t width);
+void HostDsp_HighPrioTasks(void);
+
+/**
+ * @brief receives the text of the CW/RTTY/PSK decoders, NULL prints it to stdout
+ */
+extern void (*HostDsp_TextOut)(char ch);
+
+#endif
@@ -0,0 +1,348 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_lcd.c                                                      **
+ **  Description:   parallel display emulator for the host-native UI build          **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+/*
+ * Only what ui_lcd_hy28.c uses is emulated, in the orientation the driver configures:
+ *
+ * ILI932x: R20h/R21h GRAM address (y/x), R50h-R53h window (y/x), R22h GRAM write,
+ *          reading R00h returns the device code
+ * ILI9486: 2Ah/2Bh column/page address with 4 byte parameters, 2Ch memory write,
+ *          D3h returns dummy, 0x00, 0x94, 0x86
+ *
+ * All other registers are accepted and ignored. GRAM writes fill the window line by line
+ * and wrap around to its start, like the controllers do.
+ *
+ * Optionally the emulator stands in for the vertical scroll window of the RA8875, which the
+ * driver programs through HostLcd_ScrollWindowInit() / HostLcd_ScrollWindowOffset() instead
+ * of the bus. The scroll offset applies to what is visible (hash and snapshots), not to GRAM.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "host_lcd.h"
+
+typedef struct
+{
+    uint16_t device_code;
+    uint16_t width, height;
+
+    uint16_t reg;               // last selected register
+    uint16_t param;             // parameter / read count since the register select
+    bool gram_write;            // data writes go to the framebuffer
+
+    uint16_t x_left, x_right, y_top, y_bottom;
+    uint16_t x, y;              // GRAM address counter
+
+    bool scroll_enabled;        // the scroll window is emulated
+    uint16_t scroll_x, scroll_w, scroll_y, scroll_h;
+    uint16_t scroll_offset;     // the top row of the scroll window shows GRAM row scroll_y + scroll_offset
+
+    uint16_t fb[HOST_LCD_WIDTH_MAX * HOST_LCD_HEIGHT_MAX];
+    HostLcd_Stats stats;
+} HostLcd;
+
+static HostLcd host_lcd;
+
+void HostLcd_Attach(uint16_t device_code)
+{
+    memset(&host_lcd, 0, sizeof(host_lcd));
+    host_lcd.device_code = device_code;
+    if (device_code == 0x9486)
+    {
+        host_lcd.width = 480;
+        host_lcd.height = 320;
+    }
+    else
+    {
+        host_lcd.width = 320;
+        host_lcd.height = 240;
+    }
+    host_lcd.x_right = host_lcd.width - 1;
+    host_lcd.y_bottom = host_lcd.height - 1;
+}
+
+uint16_t HostLcd_Width(void)
+{
+    return host_lcd.width;
+}
+
+uint16_t HostLcd_Height(void)
+{
+    return host_lcd.height;
+}
+
+uint16_t HostLcd_GetPixel(uint16_t x, uint16_t y)
+{
+    if (host_lcd.scroll_h != 0 && x >= host_lcd.scroll_x && x < host_lcd.scroll_x + host_lcd.scroll_w
+            && y >= host_lcd.scroll_y && y < host_lcd.scroll_y + host_lcd.scroll_h)
+    {
+        y = host_lcd.scroll_y + (y - host_lcd.scroll_y + host_lcd.scroll_offset) % host_lcd.scroll_h;
+    }
+    return x < host_lcd.width && y < host_lcd.height ? host_lcd.fb[y * host_lcd.width + x] : 0;
+}
+
+void HostLcd_ScrollWindowEnable(bool enable)
+{
+    host_lcd.scroll_enabled = enable;
+    host_lcd.scroll_h = 0;
+    host_lcd.scroll_offset = 0;
+}
+
+bool HostLcd_ScrollWindowInit(uint16_t x, uint16_t width, uint16_t y, uint16_t height)
+{
+    if (host_lcd.scroll_enabled)
+    {
+        host_lcd.scroll_x = x;
+        host_lcd.scroll_w = width;
+        host_lcd.scroll_y = y;
+        host_lcd.scroll_h = height;
+        host_lcd.scroll_offset = 0;
+    }
+    return host_lcd.scroll_enabled;
+}
+
+void HostLcd_ScrollWindowOffset(uint16_t y)
+{
+    host_lcd.stats.data_writes += 2;    // the RA8875 needs two register writes for the offset
+    host_lcd.scroll_offset = host_lcd.scroll_h != 0 ? y % host_lcd.scroll_h : 0;
+}
+
+void HostLcd_BusWriteReg(uint16_t reg)
+{
+    host_lcd.stats.index_writes++;
+    host_lcd.reg = reg;
+    host_lcd.param = 0;
+    host_lcd.gram_write = false;
+
+    switch (host_lcd.device_code)
+    {
+    case 0x9325:
+        if (reg == 0x22)
+        {
+            host_lcd.gram_write = true;
+        }
+        break;
+    case 0x9486:
+        if (reg == 0x2c)
+        {
+            host_lcd.gram_write = true;
+            host_lcd.x = host_lcd.x_left;
+            host_lcd.y = host_lcd.y_top;
+        }
+        break;
+    }
+
+    if (host_lcd.gram_write)
+    {
+        host_lcd.stats.windows++;
+    }
+}
+
+static void HostLcd_GramWrite(uint16_t pixel)
+{
+    host_lcd.stats.pixels++;
+    if (host_lcd.x < host_lcd.width && host_lcd.y < host_lcd.height)
+    {
+        uint16_t* fb = &host_lcd.fb[host_lcd.y * host_lcd.width + host_lcd.x];
+        if (*fb != pixel)
+        {
+            host_lcd.stats.pixels_changed++;
+            *fb = pixel;
+        }
+    }
+
+    if (host_lcd.x < host_lcd.x_right)
+    {
+        host_lcd.x++;
+    }
+    else
+    {
+        host_lcd.x = host_lcd.x_left;
+        host_lcd.y = host_lcd.y < host_lcd.y_bottom ? host_lcd.y + 1 : host_lcd.y_top;
+    }
+}
+
+// ILI9486 address commands: start high, start low, end high, end low
+static void HostLcd_SetRange(uint16_t* start, uint16_t* end, uint16_t param, uint16_t data)
+{
+    switch (param)
+    {
+    case 0:
+        *start = (data & 0xff) << 8;
+        break;
+    case 1:
+        *start |= data & 0xff;
+        break;
+    case 2:
+        *end = (data & 0xff) << 8;
+        break;
+    case 3:
+        *end |= data & 0xff;
+        break;
+    }
+}
+
+void HostLcd_BusWriteRam(uint16_t data)
+{
+    if (host_lcd.gram_write)
+    {
+        HostLcd_GramWrite(data);
+        return;
+    }
+
+    host_lcd.stats.data_writes++;
+
+    switch (host_lcd.device_code)
+    {
+    case 0x9325:
+        switch (host_lcd.reg)
+        {
+        case 0x20:
+            host_lcd.y = data;
+            break;
+        case 0x21:
+            host_lcd.x = data;
+            break;
+        case 0x50:
+            host_lcd.y_top = data;
+            break;
+        case 0x51:
+            host_lcd.y_bottom = data;
+            break;
+        case 0x52:
+            host_lcd.x_left = data;
+            break;
+        case 0x53:
+            host_lcd.x_right = data;
+            break;
+        }
+        break;
+    case 0x9486:
+        switch (host_lcd.reg)
+        {
+        case 0x2a:
+            HostLcd_SetRange(&host_lcd.x_left, &host_lcd.x_right, host_lcd.param, data);
+            break;
+        case 0x2b:
+            HostLcd_SetRange(&host_lcd.y_top, &host_lcd.y_bottom, host_lcd.param, data);
+            break;
+        }
+        break;
+    }
+    host_lcd.param++;
+}
+
+uint16_t HostLcd_BusReadReg(void)
+{
+    // status read, neither of the emulated controllers has one on this bus
+    host_lcd.stats.reads++;
+    return 0;
+}
+
+uint16_t HostLcd_BusReadRam(void)
+{
+    static const uint8_t ili9486_id[] = { 0x00, 0x00, 0x94, 0x86 };
+    uint16_t retval = 0;
+
+    host_lcd.stats.reads++;
+    switch (host_lcd.device_code)
+    {
+    case 0x9325:
+        if (host_lcd.reg == 0x00)
+        {
+            retval = host_lcd.device_code;
+        }
+        break;
+    case 0x9486:
+        if (host_lcd.reg == 0xd3 && host_lcd.param < sizeof(ili9486_id))
+        {
+            retval = ili9486_id[host_lcd.param];
+        }
+        break;
+    }
+    host_lcd.param++;
+    return retval;
+}
+
+void HostLcd_StatsReset(void)
+{
+    memset(&host_lcd.stats, 0, sizeof(host_lcd.stats));
+}
+
+const HostLcd_Stats* HostLcd_StatsGet(void)
+{
+    return &host_lcd.stats;
+}
+
+uint32_t HostLcd_BusWords(const HostLcd_Stats* stats)
+{
+    return stats->index_writes + stats->data_writes + stats->reads + stats->pixels;
+}
+
+uint32_t HostLcd_SpiBytes(const HostLcd_Stats* stats)
+{
+    uint32_t retval;
+    if (host_lcd.device_code == 0x9486)
+    {
+        // RPi display: register select by GPIO, 16 bit words, no reads
+        retval = 2 * (stats->index_writes + stats->data_writes + stats->pixels);
+    }
+    else
+    {
+        // HY28: every transfer starts with a start byte, reads with an additional dummy byte,
+        // the pixels of a GRAM write go out in a single transfer
+        retval = 3 * (stats->index_writes + stats->data_writes) + 4 * stats->reads + stats->windows + 2 * stats->pixels;
+    }
+    return retval;
+}
+
+uint32_t HostLcd_Hash(void)
+{
+    uint32_t hash = 2166136261u;
+    for (uint16_t y = 0; y < host_lcd.height; y++)
+    {
+        for (uint16_t x = 0; x < host_lcd.width; x++)
+        {
+            const uint16_t pixel = HostLcd_GetPixel(x, y);
+            hash = (hash ^ (pixel & 0xff)) * 16777619u;
+            hash = (hash ^ (pixel >> 8)) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+bool HostLcd_WritePpm(const char* filename)
+{
+    FILE* f = fopen(filename, "wb");
+    bool retval = f != NULL;
+
+    if (retval)
+    {
+        fprintf(f, "P6\n%d %d\n255\n", host_lcd.width, host_lcd.height);
+        for (uint32_t i = 0; retval && i < (uint32_t)host_lcd.width * host_lcd.height; i++)
+        {
+            const uint16_t pixel = HostLcd_GetPixel(i % host_lcd.width, i / host_lcd.width);
+            const uint8_t rgb[3] =
+            {
+                    ((pixel >> 11) & 0x1f) * 255 / 31,
+                    ((pixel >> 5) & 0x3f) * 255 / 63,
+                    (pixel & 0x1f) * 255 / 31,
+            };
+            retval = fwrite(rgb, 1, sizeof(rgb), f) == sizeof(rgb);
+        }
+        retval = fclose(f) == 0 && retval;
+    }
+    return retval;
+}
@@ -0,0 +1,89 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_lcd.h                                                      **
+ **  Description:   parallel display emulator for the host-native UI build          **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+#ifndef __HOST_LCD_H
+#define __HOST_LCD_H
+
+/*
+ * In the host build ui_lcd_hy28.c talks to an emulated controller on the parallel bus
+ * instead of the FSMC. The emulator understands the few commands the driver uses for drawing
+ * (window, cursor, GRAM write and the identification reads) of either an ILI932x (HY28B, 320x240)
+ * or an ILI9486 (480x320) and renders into an RGB565 framebuffer.
+ * Every bus access is counted, so that the cost of a drawing operation can be measured.
+ */
+
+#include "uhsdr_types.h"
+
+#define HOST_LCD_WIDTH_MAX      480
+#define HOST_LCD_HEIGHT_MAX     320
+
+typedef struct
+{
+    uint32_t index_writes;      // register selects, including the GRAM write commands
+    uint32_t data_writes;       // register values and command parameters
+    uint32_t reads;
+    uint32_t windows;           // GRAM write commands
+    uint32_t pixels;            // pixels written to GRAM
+    uint32_t pixels_changed;    // of these the pixels which got a different color
+} HostLcd_Stats;
+
+/**
+ * @brief connects an emulated controller to the bus, clears framebuffer and statistics
+ * @param device_code 0x9325 (ILI932x, 320x240) or 0x9486 (ILI9486, 480x320), 0 for no display
+ */
+void HostLcd_Attach(uint16_t device_code);
+
+uint16_t HostLcd_Width(void);
+uint16_t HostLcd_Height(void);
+/**
+ * @returns the visible pixel, i.e. with the scroll window offset applied
+ */
+uint16_t HostLcd_GetPixel(uint16_t x, uint16_t y);
+
+/**
+ * @brief lets the display scroll a window like the RA8875 does, off after HostLcd_Attach()
+ */
+void HostLcd_ScrollWindowEnable(bool enable);
+// the scroll window as seen by ui_lcd_hy28.c
+bool HostLcd_ScrollWindowInit(uint16_t x, uint16_t width, uint16_t y, uint16_t height);
+void HostLcd_ScrollWindowOffset(uint16_t y);
+
+// the bus as seen by ui_lcd_hy28.c
+void HostLcd_BusWriteReg(uint16_t reg);
+void HostLcd_BusWriteRam(uint16_t data);
+uint16_t HostLcd_BusReadReg(void);
+uint16_t HostLcd_BusReadRam(void);
+
+void HostLcd_StatsReset(void);
+const HostLcd_Stats* HostLcd_StatsGet(void);
+/**
+ * @returns 16 bit bus cycles on the FSMC
+ */
+uint32_t HostLcd_BusWords(const HostLcd_Stats* stats);
+/**
+ * @returns bytes the same drawing needs on the SPI bus of the SPI variant of the display
+ */
+uint32_t HostLcd_SpiBytes(const HostLcd_Stats* stats);
+
+/**
+ * @returns FNV-1a hash of the visible framebuffer, for regression tests
+ */
+uint32_t HostLcd_Hash(void);
+/**
+ * @brief writes the framebuffer as binary PPM (P6) image
+ * @returns false if the file could not be written
+ */
+bool HostLcd_WritePpm(const char* filename);
+
+#endif
@@ -0,0 +1,70 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_mcu.h                                                      **
+ **  Description:   peripheral redirection for the host-native DSP build            **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+#ifndef __HOST_MCU_H
+#define __HOST_MCU_H
+
+/*
+ * Included by uhsdr_mcu.h if HOST_BUILD is defined (see host-dsp.mak).
+ * The code is compiled with the STM32F4 device headers so that all types and
+ * constants are exactly those of the mcHF firmware, but the few peripherals the
+ * audio code touches directly (SCB for the PendSV trigger, GPIO for LEDs and paddles)
+ * are redirected to plain RAM structures so that accessing them does not crash the host.
+ */
+
+#include <stdint.h>
+
+extern SCB_Type host_scb;
+extern GPIO_TypeDef host_gpio[9];
+
+#undef SCB
+#define SCB     (&host_scb)
+
+#undef GPIOA
+#undef GPIOB
+#undef GPIOC
+#undef GPIOD
+#undef GPIOE
+#undef GPIOF
+#undef GPIOG
+#undef GPIOH
+#undef GPIOI
+#define GPIOA   (&host_gpio[0])
+#define GPIOB   (&host_gpio[1])
+#define GPIOC   (&host_gpio[2])
+#define GPIOD   (&host_gpio[3])
+#define GPIOE   (&host_gpio[4])
+#define GPIOF   (&host_gpio[5])
+#define GPIOG   (&host_gpio[6])
+#define GPIOH   (&host_gpio[7])
+#define GPIOI   (&host_gpio[8])
+
+// the hand-offs between audio interrupt and main loop use memory barriers, on the host a compiler barrier does
+#undef __DMB
+#define __DMB() __asm volatile ("" ::: "memory")
+
+// byte swap of the SPI display pixel buffers
+#undef __REV16
+#define __REV16(value) ((((uint32_t)(value) & 0xff00ff00u) >> 8) | (((uint32_t)(value) & 0x00ff00ffu) << 8))
+
+/**
+ * @brief replacement for the DWT cycle counter
+ * @returns elapsed host time scaled to cycles of a 168 MHz core clock
+ */
+uint32_t HostMcu_CycleCount(void);
+
+// newlib has it, glibc does not, see arm_math_host.c
+float pow10f(float x);
+
+#endif
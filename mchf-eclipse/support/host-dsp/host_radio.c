@@ -0,0 +1,226 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_radio.c                                                    **
+ **  Description:   transceiver state and mode setup for the host-native DSP build  **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+/*
+ * Shared by the DSP harness (host_dsp.c) and the kernel benchmarks (bench/bench_dsp.c):
+ * brings the transceiver state and the audio driver into the same condition
+ * the firmware reaches after startup and after a mode change.
+ */
+
+#include "uhsdr_board.h"
+#include "profiling.h"
+#include "audio_driver.h"
+#include "audio_management.h"
+#include "audio_nr.h"
+#include "radio_management.h"
+#include "ui_configuration.h"
+#include "ui_lcd_items.h"
+#include "host_dsp.h"
+
+/**
+ * @brief the subset of TransceiverStateInit() which is relevant for audio processing
+ */
+void HostDsp_TransceiverStateInit(void)
+{
+    // parallel display, so the audio driver uses the full sideband suppression filter
+    static mchf_display_t host_display = { .use_spi = false };
+    ts.display          = &host_display;
+    // all layout positions 0, the CW decoder prints its speed there
+    static LcdLayout host_layout;
+    ts.Layout           = &host_layout;
+
+    ts.txrx_mode        = TRX_MODE_RX;
+    ts.samp_rate        = I2S_AUDIOFREQ_48K;
+    ts.dmod_mode        = DEMOD_USB;
+
+    ts.rx_gain[RX_AUDIO_SPKR].value = AUDIO_GAIN_DEFAULT;
+    ts.rx_gain[RX_AUDIO_DIG].value = DIG_GAIN_DEFAULT;
+    ts.rx_gain[RX_AUDIO_SPKR].max = MAX_VOLUME_DEFAULT;
+    ts.rx_gain[RX_AUDIO_DIG].max = DIG_GAIN_MAX;
+    ts.rx_gain[RX_AUDIO_SPKR].active_value = 1;
+    ts.rx_gain[RX_AUDIO_DIG].active_value = 1;
+    ts.rf_gain          = DEFAULT_RF_GAIN;
+    ts.lineout_gain     = LINEOUT_GAIN_DEFAULT;
+    ts.rf_codec_gain    = DEFAULT_RF_CODEC_GAIN_VAL;
+
+    ts.cw_sidetone_gain = DEFAULT_SIDETONE_GAIN;
+    ts.cw_keyer_mode    = CW_KEYER_MODE_IAM_B;
+    ts.cw_keyer_speed   = CW_KEYER_SPEED_DEFAULT;
+    ts.cw_sidetone_freq = CW_SIDETONE_FREQ_DEFAULT;
+    ts.cw_rx_delay      = CW_TX2RX_DELAY_DEFAULT;
+    ts.cw_keyer_weight  = CW_KEYER_WEIGHT_DEFAULT;
+    ts.cw_offset_mode   = CW_OFFSET_USB_RX;
+
+    ts.tx_audio_source  = TX_AUDIO_MIC;
+    ts.tx_mic_gain_mult = MIC_GAIN_DEFAULT;
+    ts.tx_gain[TX_AUDIO_MIC]      = MIC_GAIN_DEFAULT;
+    ts.tx_gain[TX_AUDIO_LINEIN_L] = LINE_GAIN_DEFAULT;
+    ts.tx_gain[TX_AUDIO_LINEIN_R] = LINE_GAIN_DEFAULT;
+    ts.tx_gain[TX_AUDIO_DIG]      = LINE_GAIN_DEFAULT;
+    ts.tx_gain[TX_AUDIO_DIGIQ]    = LINE_GAIN_DEFAULT;
+    ts.tx_power_factor  = 0.50;
+
+    for (int i = 0; i < IQ_ADJUST_POINTS_NUM; i++)
+    {
+        for (int j = 0; j < IQ_TRANS_NUM; j++)
+        {
+            ts.tx_iq_gain_balance[i].value[j]   = IQ_BALANCE_OFF;
+            ts.tx_iq_phase_balance[i].value[j]  = IQ_BALANCE_OFF;
+            ts.rx_iq_gain_balance[i].value[j]   = IQ_BALANCE_OFF;
+            ts.rx_iq_phase_balance[i].value[j]  = IQ_BALANCE_OFF;
+        }
+    }
+
+    ts.alc_decay        = ALC_DECAY_DEFAULT;
+    ts.alc_decay_var    = ALC_DECAY_DEFAULT;
+    ts.alc_tx_postfilt_gain     = ALC_POSTFILT_GAIN_DEFAULT;
+    ts.alc_tx_postfilt_gain_var = ALC_POSTFILT_GAIN_DEFAULT;
+
+    ts.dsp_nr_strength  = 50;
+#ifdef USE_LMS_AUTONOTCH
+    ts.dsp_notch_numtaps = DSP_NOTCH_NUMTAPS_DEFAULT;
+    ts.dsp_notch_delaybuf_len = DSP_NOTCH_DELAYBUF_DEFAULT;
+    ts.dsp_notch_mu     = DSP_NOTCH_MU_DEFAULT;
+#endif
+    ts.iq_freq_mode     = FREQ_IQ_CONV_MODE_DEFAULT;
+    ts.fm_sql_threshold = FM_SQUELCH_DEFAULT;
+    ts.beep_active      = 0;
+    ts.beep_frequency   = DEFAULT_BEEP_FREQUENCY;
+    ts.beep_loudness    = DEFAULT_BEEP_LOUDNESS;
+    ts.notch_frequency  = 800;
+    ts.peak_frequency   = 750;
+    ts.bass_gain        = 2;
+    ts.treble_gain      = 0;
+    ts.tx_bass_gain     = 4;
+    ts.tx_treble_gain   = 4;
+    ts.s_meter          = 1;
+    ts.iq_auto_correction = 1;
+    ts.twinpeaks_tested = 2;
+
+    ts.agc_wdsp_mode    = 2;
+    ts.agc_wdsp_slope   = 70;
+    ts.agc_wdsp_hang_enable = 0;
+    ts.agc_wdsp_hang_time = 500;
+    ts.agc_wdsp_hang_thresh = 45;
+    ts.agc_wdsp_thresh  = 60;
+    ts.agc_wdsp_action  = 0;
+    ts.agc_wdsp_switch_mode = 1;
+    ts.agc_wdsp_hang_action = 0;
+    ts.agc_wdsp_tau_decay[0] = 4000;
+    ts.agc_wdsp_tau_decay[1] = 2000;
+    ts.agc_wdsp_tau_decay[2] = 500;
+    ts.agc_wdsp_tau_decay[3] = 250;
+    ts.agc_wdsp_tau_decay[4] = 50;
+    ts.agc_wdsp_tau_decay[5] = 500;
+    ts.agc_wdsp_tau_hang_decay = 200;
+
+    ts.nr_alpha         = 0.94;
+    ts.nr_alpha_int     = 940;
+    ts.nr_beta          = 0.96;
+    ts.nr_beta_int      = 960;
+    ts.NR_FFT_L         = 256;
+    ts.NR_FFT_LOOP_NO   = 1;
+    ts.nr_first_time    = 1;
+    ts.NR_decimation_enable = true;
+#ifdef USE_ALTERNATE_NR
+    ts.nr_fft_size      = NR_FFT_SIZE_SEL_256;
+    NR2.width           = 4;
+    NR2.power_threshold = 0.40;
+    NR2.power_threshold_int = 40;
+    NR2.asnr            = 30;
+#endif
+    // SAM PLL and fade leveler, defaults of the configuration table
+    ads.pll_fmax_int    = 2500;
+    ads.zeta_int        = 65;
+    ads.omegaN_int      = 250;
+    ads.fade_leveler    = 1;
+    ads.sam_sideband    = SAM_SIDEBAND_BOTH;
+
+    ts.rtty_atc_enable  = true;
+    ts.cw_decoder_enable = true;
+}
+
+/**
+ * @brief what UiDriver_TaskHandler_HighPrioTasks() does in the PendSV interrupt
+ */
+void HostDsp_HighPrioTasks(void)
+{
+#ifdef USE_ALTERNATE_NR
+    if ((ts.nb_setting > 0 || (ts.dsp_active & DSP_NR_ENABLE)) && (ads.decimation_rate == 4))
+    {
+        alternateNR_handle();
+    }
+#endif
+}
+
+/**
+ * @returns first filter path applicable for the mode with at least the requested bandwidth
+ */
+uint8_t HostDsp_FindFilterPath(uint8_t dmod_mode, uint16_t width)
+{
+    const uint16_t filter_mode = AudioFilter_GetFilterModeFromDemodMode(dmod_mode);
+    uint8_t retval = AudioFilter_NextApplicableFilterPath(PATH_ALL_APPLICABLE, filter_mode, 0);
+
+    for (int idx = 0; idx < AUDIO_FILTER_PATH_NUM; idx++)
+    {
+        if (AudioFilter_IsApplicableFilterPath(PATH_ALL_APPLICABLE, filter_mode, idx) && FilterInfo[FilterPathInfo[idx].id].width >= width)
+        {
+            retval = idx;
+            break;
+        }
+    }
+    return retval;
+}
+
+/**
+ * @brief switches demodulation mode and filter path the way a mode change on the radio does
+ * @param filter_path index into FilterPathInfo, or -1 to select the path by width
+ */
+void HostDsp_SetDemodMode(uint8_t dmod_mode, uint8_t digital_mode, int filter_path, uint16_t width)
+{
+    ts.digital_mode = digital_mode;
+    ts.dvmode = false;
+
+    ts.filter_path = filter_path >= 0 ? filter_path : HostDsp_FindFilterPath(dmod_mode, width);
+    // AudioDriver_SetRxAudioProcessing() always loads the last used path of the mode, so that is where it goes
+    ts.filter_path_mem[AudioFilter_GetFilterModeFromDemodMode(dmod_mode)][0] = ts.filter_path;
+
+    AudioDriver_SetRxAudioProcessing(dmod_mode, false);
+    AudioDriver_TxFilterInit(dmod_mode);
+    AudioManagement_SetSidetoneForDemodMode(dmod_mode, false);
+    ts.dmod_mode = dmod_mode;
+    ts.nr_first_time = 1;
+}
+
+/**
+ * @brief same sequence as mchfMain(), call after HostDsp_TransceiverStateInit() and any changes to ts
+ */
+void HostDsp_RadioInit(void)
+{
+    profileTimedEventInit();
+#ifdef USE_ALTERNATE_NR
+    AudioNr_SetFftSize(ts.nr_fft_size);
+#endif
+    AudioDriver_Init();
+    AudioManagement_CalcSubaudibleGenFreq();
+    AudioManagement_CalcSubaudibleDetFreq();
+    AudioManagement_LoadToneBurstMode();
+    AudioManagement_LoadBeepFreq();
+    AudioManagement_CalcTxCompLevel();
+    // the I/Q balance is interpolated over the frequency, 7 MHz is as good as any with the default calibration
+    AudioManagement_CalcIqPhaseGainAdjust(7000000);
+    AudioFilter_SetDefaultMemories();
+    // done by UiDriver_Init() on the radio
+    AudioFilter_InitTxHilbertFIR();
+}
@@ -0,0 +1,172 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_stubs.c                                                    **
+ **  Description:   state and hardware stubs for the host-native DSP build          **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+/*
+ * Everything the audio DSP code references outside of drivers/audio is provided here,
+ * either as the global state the firmware normally defines elsewhere (ts, ks, mmb)
+ * or as do-nothing replacement of the hardware / UI function.
+ * Keep this list short: if a function is pure computation, compile the real source instead.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "uhsdr_board.h"
+#include "ui_driver.h"
+#include "radio_management.h"
+#include "codec.h"
+#include "uhsdr_hw_i2s.h"
+#include "cat_driver.h"
+#include "usbd_audio_if.h"
+#include "freedv_uhsdr.h"
+#include "host_dsp.h"
+
+// global state normally owned by uhsdr_board.c, ui_driver.c and freedv_uhsdr.c, sd see host_stubs_lcd.c
+__IO TransceiverState ts;
+__IO KeypadState ks;
+MultiModeBuffer_t mmb;
+FDV_Audio_Buffer fdv_audio_buff[FDV_BUFFER_AUDIO_NUM];
+
+// peripheral replacements, see host_mcu.h
+SCB_Type host_scb;
+GPIO_TypeDef host_gpio[9];
+
+uint32_t HostMcu_CycleCount(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    // 168 cycles per microsecond, wraps like the DWT counter does
+    return (uint32_t)(((uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec) * 168 / 1000);
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin)
+{
+    // inputs are active low (paddles, ptt), so this means "not pressed"
+    return GPIO_PIN_SET;
+}
+
+// codec / I2S
+uint32_t Codec_Reset(uint32_t AudioFreq,uint32_t word_size)
+{
+    return HAL_OK;
+}
+
+void Codec_RestartI2S()
+{
+}
+
+void UhsdrHwI2s_Codec_StartDMA()
+{
+}
+
+void UhsdrHwI2s_Codec_ClearTxDmaBuffer()
+{
+}
+
+// USB audio
+void audio_in_put_buffer(int16_t sample)
+{
+}
+
+void audio_out_fill_tx_buffer(int16_t *buffer, uint32_t len)
+{
+    memset(buffer,0,len*sizeof(int16_t));
+}
+
+// CAT
+bool CatDriver_CWKeyPressed()
+{
+    return false;
+}
+
+bool CatDriver_CatPttActive()
+{
+    return false;
+}
+
+// UI: decoded text of the CW/RTTY/PSK decoders goes to stdout unless someone else wants it
+void (*HostDsp_TextOut)(char ch);
+
+void UiDriver_TextMsgPutChar(char ch)
+{
+    if (HostDsp_TextOut != NULL)
+    {
+        HostDsp_TextOut(ch);
+    }
+    else
+    {
+        putchar(ch);
+        fflush(stdout);
+    }
+}
+
+void UiDriver_TextMsgPutSign(const char *s)
+{
+    while (*s != '\0')
+    {
+        UiDriver_TextMsgPutChar(*s++);
+    }
+}
+
+void UiDriver_BacklightDimHandler()
+{
+}
+
+// radio management
+bool RadioManagement_CalculateCWSidebandMode()
+{
+    // there is no dial frequency, CW is received as USB unless the offset mode asks for LSB
+    return ts.cw_offset_mode == CW_OFFSET_LSB_RX || ts.cw_offset_mode == CW_OFFSET_LSB_TX || ts.cw_offset_mode == CW_OFFSET_LSB_SHIFT;
+}
+
+bool RadioManagement_FmDevIs5khz()
+{
+    return (ts.flags2 & FLAGS2_FM_MODE_DEVIATION_5KHZ) != 0;
+}
+
+// FreeDV is not part of the host build, the buffers are always empty
+int fdv_iq_buffer_remove(FDV_IQ_Buffer** c_ptr)
+{
+    return 0;
+}
+
+int fdv_iq_buffer_add(FDV_IQ_Buffer* c)
+{
+    return 0;
+}
+
+int32_t fdv_iq_has_data()
+{
+    return 0;
+}
+
+int fdv_audio_buffer_peek(FDV_Audio_Buffer** c_ptr)
+{
+    return 0;
+}
+
+int fdv_audio_buffer_remove(FDV_Audio_Buffer** c_ptr)
+{
+    return 0;
+}
+
+int fdv_audio_buffer_add(FDV_Audio_Buffer* c)
+{
+    return 0;
+}
+
+int32_t fdv_audio_has_data()
+{
+    return 0;
+}
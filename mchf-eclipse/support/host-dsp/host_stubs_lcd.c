@@ -0,0 +1,30 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_stubs_lcd.c                                                **
+ **  Description:   display stubs for the host-native DSP build                     **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+/*
+ * The DSP harness and the DSP benchmarks have no display, the display build
+ * (bench/bench_lcd.c) links ui_lcd_hy28.c and ui_spectrum.c instead of this file.
+ */
+
+#include "uhsdr_board.h"
+#include "ui_spectrum.h"
+#include "ui_lcd_hy28.h"
+
+// normally owned by ui_spectrum.c, the audio driver puts the spectrum frames here
+SpectrumDisplay sd;
+
+uint16_t UiLcdHy28_PrintText(uint16_t Xpos, uint16_t Ypos, const char *str,const uint32_t Color, const uint32_t bkColor, uchar font)
+{
+    return Xpos;
+}
@@ -0,0 +1,132 @@
+/*  -*-  mode: c; tab-width: 4; indent-tabs-mode: t; c-basic-offset: 4; coding: utf-8  -*-  */
+/************************************************************************************
+ **                                                                                 **
+ **                                        UHSDR                                    **
+ **               a powerful firmware for STM32 based SDR transceivers              **
+ **                                                                                 **
+ **---------------------------------------------------------------------------------**
+ **                                                                                 **
+ **  File name:     host_ui.c                                                       **
+ **  Description:   hardware and UI stubs for the host-native display build         **
+ **  Last Modified:                                                                 **
+ **  Licence:       GNU GPLv3                                                      **
+ ************************************************************************************/
+
+/*
+ * The display build (bench/bench_lcd.c) links the real ui_lcd_hy28.c and ui_spectrum.c
+ * on top of the audio DSP objects. What these need beyond that is here:
+ * the HAL functions of the display bus, which is emulated in host_lcd.c,
+ * the touchscreen actions referenced by the layout tables and the few
+ * radio management queries of the spectrum display.
+ */
+
+#include "uhsdr_board.h"
+#include "audio_driver.h"
+#include "ui_driver.h"
+#include "ui_menu.h"
+#include "radio_management.h"
+#include "spi.h"
+#include "fsmc.h"
+
+SPI_HandleTypeDef hspi2;
+SRAM_HandleTypeDef hsram1;
+
+// normally owned by radio_management.c
+DialFrequency df;
+
+// HAL
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init)
+{
+}
+
+void HAL_Delay(__IO uint32_t Delay)
+{
+}
+
+void MX_FSMC_Init(void)
+{
+}
+
+HAL_StatusTypeDef HAL_SRAM_DeInit(SRAM_HandleTypeDef* hsram)
+{
+    return HAL_OK;
+}
+
+// the SPI displays are not emulated, only the parallel ones are detected
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi)
+{
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size, uint32_t Timeout)
+{
+    memset(pRxData, 0, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size)
+{
+    return HAL_OK;
+}
+
+void Error_Handler(void)
+{
+}
+
+// colors as configured in the menu
+void UiMenu_MapColors(uint32_t color, char* options, volatile uint32_t* clr_ptr)
+{
+    static const uint16_t colors[SPEC_MAX_COLOUR] =
+    {
+            White, Grey, Blue, Red, Red2, Red3, Magenta, Green, Cyan, Yellow, Orange, Cream, Black,
+            Grey1, Grey2, Grey3, Grey4, Grey5, Grey6,
+    };
+    *clr_ptr = colors[color < SPEC_MAX_COLOUR ? color : SPEC_GREY];
+}
+
+// radio management, no VFO and no split: the dial frequency is df.tune_new
+uint32_t RadioManagement_GetRXDialFrequency()
+{
+    return df.tune_new;
+}
+
+uint32_t RadioManagement_GetTXDialFrequency()
+{
+    return df.tune_new;
+}
+
+int32_t RadioManagement_GetCWDialOffset()
+{
+    return 0;
+}
+
+bool RadioManagement_UsesBothSidebands(uint16_t dmod_mode)
+{
+    return dmod_mode == DEMOD_AM || (dmod_mode == DEMOD_SAM && ads.sam_sideband == SAM_SIDEBAND_BOTH) || dmod_mode == DEMOD_FM;
+}
+
+bool RadioManagement_LSBActive(uint16_t dmod_mode)
+{
+    return dmod_mode == DEMOD_LSB || (dmod_mode == DEMOD_SAM && ads.sam_sideband == SAM_SIDEBAND_LSB)
+            || (dmod_mode == DEMOD_CW && ts.cw_lsb) || (dmod_mode == DEMOD_DIGI && ts.digi_lsb);
+}
+
+// touchscreen actions of the layouts, there is no touchscreen
+void UiAction_ChangeLowerMeterUp() {}
+void UiAction_ToggleWaterfallScopeDisplay() {}
+void UiAction_ChangeSpectrumSize() {}
+void UiAction_ChangeSpectrumZoomLevelDown() {}
+void UiAction_ChangeSpectrumZoomLevelUp() {}
+void UiAction_CheckSpectrumTouchActions() {}
+void UiAction_ChangeFrequencyToNextKhz() {}
+void UiAction_ChangeDemodMode() {}
+void UiAction_ChangePowerLevel() {}
+void UiAction_ChangeAudioSource() {}
+void UiAction_ChangeBandDownOrUp() {}
+void UiAction_ChangeBandUpOrDown() {}
+void UiAction_ChangeFrequencyByTouch() {}
+void UiAction_ChangeDigitalMode() {}
+void UiAction_ChangeDynamicTuning() {}
+void UiAction_ChangeDebugInfoDisplay() {}
+void UiAction_ChangeRfModPresence() {}
+void UiAction_ChangeVhfUhfModPresence() {}